@@ -1,39 +1,88 @@
 #ifndef APPLICATION_HEADER
 #define APPLICATION_HEADER
 
+#include "Core/AABB.hpp"
+#include "Core/BenchmarkRecorder.hpp"
 #include "Core/Camera.hpp"
+#include "Core/CameraPath.hpp"
+#include "Core/Frustum.hpp"
+#include "Core/HudOverlay.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/MpscQueue.hpp"
+#include "Core/RangeAllocator.hpp"
 #include "Core/Window.hpp"
+#include "Map/SyntheticTileDataSource.hpp"
+#include "Map/TileDataSource.hpp"
 #include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+#include "Map/TileMeshBuilder.hpp"
+#include "Map/TilePrefetchPredictor.hpp"
+#include "Map/TilePyramid.hpp"
+#include "Map/TileRegistry.hpp"
+#include "Map/TileStageStats.hpp"
+#include "TileMesh.hpp"
 #include "Vertex.hpp"
 
 #include "Core/Vulkan/VulkanBuffer.hpp"
+#include "Core/Vulkan/VulkanGpuTimer.hpp"
 #include "Core/Vulkan/VulkanImage.hpp"
 #include "Core/Vulkan/VulkanImageView.hpp"
+#include "Core/Vulkan/VulkanPipelineCache.hpp"
+#include "Core/Vulkan/VulkanUniformBufferRing.hpp"
+#include "Core/Vulkan/VulkanUploadEngine.hpp"
 #include "glm/fwd.hpp"
 
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdalign>
+#include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <set>
+#include <string>
 #include <vector>
 
 class Application
 {
-private:
-    // Push constant data
-    struct PushConstant
+public:
+    // Options selected on the command line
+    struct LaunchOptions
     {
-        glm::mat4 lightProjView;
-        glm::mat4 projView; // Combined projection-view matrix
+        bool headless;                          // Flag indicating whether frames are rendered into offscreen images, without a window or presenting
+        uint32_t width;                         // Width of the rendered frames (in pixels)
+        uint32_t height;                        // Height of the rendered frames (in pixels)
+        uint64_t frameCount;                    // Number of frames to render before exiting. 0 to run until the window is closed.
+        std::set<uint64_t> dumpFrames;          // Frames (0-based) written to image files. Only used in headless mode.
+        std::string dumpDirectory;              // Directory that the dumped frames are written to
+        std::string cameraPathFile;             // Camera path replayed instead of the user input. Empty to disable the benchmark.
+        std::string benchmarkCsvFile;           // CSV file that the per-frame benchmark measurements are written to
+        std::string profileTraceFile;           // Chrome trace file that the profiler writes to at exit. Empty to only profile on request.
+        bool showHud;                           // Flag indicating whether the performance overlay is shown from the start
+        uint32_t uploadBudgetKilobytes;         // Maximum amount of tile vertices uploaded to the vertex buffer per frame (in KiB)
+        uint32_t uploadBudgetMicroseconds;      // Maximum time spent uploading tile vertices per frame (in microseconds)
+        float prefetchLookaheadSeconds;         // How far ahead the camera path is extrapolated to prefetch tiles (in seconds). 0 disables the prediction.
+        float prefetchSampleInterval;           // Time between samples along the extrapolated camera path (in seconds)
+        float prefetchVelocitySmoothing;        // Weight of the previous velocity when smoothing the camera velocity, in [0, 1)
+        float prefetchForwardBias;              // How much the extrapolated path is bent towards the camera's forward vector
+        std::string tileSources;                // Specification of the tile data sources, see TileDataSourceFactory
+        SyntheticTileDataSource::Settings syntheticTileSettings;    // Settings of the generated tiles
     };
 
-    // Uniform buffer for camera data
+private:
+    // Uniform buffer for camera data. The matrices are not push constants, so that
+    // the cached secondary command buffers stay valid while the camera moves.
     struct CameraData
     {
-        alignas(16) glm::vec3 position; // Camera position
+        glm::mat4 projView;                 // Combined projection-view matrix
+        glm::mat4 lightProjView;            // Combined projection-view matrix of the light
+        alignas(16) glm::vec3 position;     // Camera position
     };
 
     // Uniform buffer for light data 
@@ -46,18 +95,44 @@ private:
         alignas(16) glm::vec3 specular;         // Specular intensity
     };
 
+    // Secondary command buffers that draw a group of neighboring tiles. They are
+    // re-used across frames until the clusters drawn by the group change.
+    struct TileGroupCommands
+    {
+        uint32_t workerIndex;                   // Index of the recording worker whose command pool owns the command buffers
+        VkCommandBuffer shadowCommandBuffer;    // Secondary command buffer drawing the group in the shadow pass
+        VkCommandBuffer mainCommandBuffer;      // Secondary command buffer drawing the group in the main pass
+        std::vector<MeshCluster> clusters;      // Clusters drawn by the command buffers
+        AABB bounds;                            // Bounds of the clusters
+        std::array<uint32_t, 2> dynamicOffsets; // Uniform buffer offsets bound by the command buffers
+        uint32_t drawCalls;                     // Number of draw calls recorded into each command buffer
+        uint32_t triangleCount;                 // Number of triangles drawn by each command buffer
+        bool isRecorded;                        // Flag indicating whether the command buffers were recorded successfully
+        bool needsRecording;                    // Flag indicating whether the command buffers have to be recorded again
+    };
+
+    // Per-cluster data read by the culling compute shader (std430 layout)
+    struct ClusterCullData
+    {
+        glm::vec4 boundingSphere;               // Bounding sphere of the cluster (xyz = center, w = radius)
+        uint32_t firstVertex;                   // Index of the first vertex of the cluster
+        uint32_t vertexCount;                   // Number of vertices in the cluster
+        uint32_t padding[2];                    // Padding to keep a 16-byte stride
+    };
+
     // Struct containing data needed for a frame
     struct FrameData
     {
-        VulkanImage shadowMapImage;         // Image for the shadow map
-        VulkanImageView shadowMapImageView; // Image view for the shadow map image
-        VkFramebuffer shadowMapFramebuffer; // Framebuffer for the shadow map
-
         VkImage image;                      // Frame image
+        VulkanImage offscreenImage;         // Image rendered into instead of a swapchain image in headless mode
         VulkanImageView imageView;          // Image view for the frame image
         VkFramebuffer framebuffer;          // Framebuffer
         VkCommandBuffer commandBuffer;      // Command buffer
 
+        // --- Tile group secondary command buffers ---
+        std::vector<VkCommandPool> tileGroupCommandPools;           // Command pools of the secondary command buffers, one per recording worker
+        std::map<TileKey, TileGroupCommands> tileGroupCommands;     // Secondary command buffers of each drawn tile group
+
         // --- Synchronization ---
         VkSemaphore imageAvailableSemaphore;    // Semaphore signalled when the next image is available and ready for rendering
         VkSemaphore renderDoneSemaphore;        // Semaphore signalled when rendering is done and is ready for presenting
@@ -65,8 +140,16 @@ private:
 
         // --- Descriptor sets ---
         VkDescriptorSet descriptorSet;          // Descriptor set for this frame
-        VulkanBuffer lightDataUniformBuffer;    // Uniform buffer for the light data
-        VulkanBuffer cameraDataUniformBuffer;   // Uniform buffer for the camera data
+
+        // --- GPU culling ---
+        VulkanBuffer clusterCullDataBuffer;     // Data of each selected cluster read by the culling compute shader
+        ClusterCullData *clusterCullData;       // Persistently mapped memory of the cluster cull data buffer
+        VulkanBuffer drawCommandBuffer;         // Indirect draw commands written by the culling compute shader
+        VkDescriptorSet cullDescriptorSet;      // Descriptor set for the culling compute shader
+
+        // --- Performance overlay ---
+        VulkanBuffer hudVertexBuffer;           // Host-visible vertex buffer that the overlay vertices are written to every frame
+        VkCommandBuffer hudCommandBuffer;       // Secondary command buffer drawing the overlay, when the main pass only executes secondary command buffers
     };
 
     // Struct containing information about a retrieve tile job
@@ -74,34 +157,130 @@ private:
     {
         glm::ivec2 tileIndex;                   // Index of the tile to retrieve
         int zoomLevel;                          // Zoom level
-        bool addImmediately;                    // Flag indicating whether to prefetch or to add to active tiles immediately
+        std::chrono::steady_clock::time_point queueTime;    // Time the job was queued
+    };
+
+    static const size_t NUM_LOD_LEVELS = TileMesh::NUM_LOD_LEVELS;  // Number of LOD levels generated for each tile
+
+    // Specialization constants of the main pass fragment shader, for a single quality preset
+    struct ShaderQualitySettings
+    {
+        int32_t pcfKernelRadius;                // Radius of the shadow filtering kernel (in texels). Each tap is filtered by the hardware.
+        VkBool32 shadowsEnabled;                // Flag indicating whether the shadow map is sampled
+        VkBool32 specularEnabled;               // Flag indicating whether specular lighting is computed
+        const char *name;                       // Name of the preset. Not passed to the shader.
+    };
+
+    static const size_t NUM_SHADER_QUALITY_PRESETS = 3; // Number of shader quality presets, each with its own main pass pipeline
+
+    // Push constant data for the culling compute shader
+    struct CullPushConstant
+    {
+        glm::vec4 frustumPlanes[6];             // Frustum planes to cull against
+        uint32_t clusterCount;                  // Number of clusters to cull
+        uint32_t drawCommandOffset;             // Index of the first draw command to write to
+    };
+
+    // Culling statistics for a single render pass
+    struct CullingStats
+    {
+        uint32_t drawnTriangles;                // Number of triangles submitted for drawing
+        uint32_t culledTriangles;               // Number of triangles skipped by culling
+        uint32_t drawCalls;                     // Number of draw calls issued
+    };
+
+    // Tile whose vertices are in the vertex buffer
+    struct ResidentTile
+    {
+        uint32_t firstVertex;                   // Index of the first vertex of the tile's range in the vertex buffer
+        uint32_t vertexCount;                   // Number of vertices in the tile's range
+        TileMesh mesh;                          // Clusters and bounds of the tile, relative to the mesh origin. Vertices are only in the vertex buffer.
+    };
+
+    // Vertex buffer range that is freed once the frames in flight are done reading it
+    struct PendingVertexFree
+    {
+        uint64_t frameNumber;                   // Frame in which the range was released
+        uint32_t firstVertex;                   // Index of the first vertex of the range
+        uint32_t vertexCount;                   // Number of vertices in the range
+    };
+
+    // Tile upload statistics
+    struct UploadStats
+    {
+        uint32_t uploadedTiles;                 // Number of tiles uploaded to the vertex buffer
+        uint64_t uploadedBytes;                 // Number of bytes uploaded to the vertex buffer
+        uint32_t framesWithUploads;             // Number of frames that uploaded at least one tile
+        uint64_t totalUploadMicroseconds;       // Total time spent uploading (in microseconds)
+        uint32_t maxFrameUploadMicroseconds;    // Longest time spent uploading in a single frame (in microseconds)
+        size_t maxBacklogDepth;                 // Largest number of tiles waiting to be uploaded at the end of a frame
+        uint32_t framesWaitingForTransfer;      // Number of frames whose rendering waited on copies still running on the transfer queue
     };
 
     const double SCALE = 0.05;                  // World scale
+    const int BASE_ZOOM_LEVEL = 16;             // Zoom level of the tiles nearest to the camera
+    const int MIN_ZOOM_LEVEL = 13;              // Zoom level of the coarsest tiles at the edge of the view distance
+    const int MAX_VIEW_DISTANCE = 32;           // Maximum view distance (in base zoom level tiles)
+    const uint32_t MAX_VERTEX_COUNT = 4000000;  // Maximum number of vertices in the vertex buffer
+    const VkDeviceSize STAGING_BUFFER_SIZE = 32 * 1024 * 1024;  // Size of the staging buffer used to upload tiles through the transfer queue
+    const int MESH_ORIGIN_REBASE_DISTANCE = 64; // Distance from the mesh origin at which the vertex buffer is rebuilt around the camera (in base zoom level tiles)
+    const uint32_t MAX_CLUSTER_COUNT = 16384;   // Maximum number of clusters that can be culled on the GPU
+    const float MAX_SCREEN_SPACE_ERROR = 2.0f;  // Maximum projected geometric error (in pixels) allowed when picking a tile's LOD level
+    const int TILE_GROUP_ZOOM_OFFSET = 1;       // Tiles sharing the ancestor this many zoom levels up are drawn by the same secondary command buffers
+    const uint32_t MAX_RECORDING_WORKERS = 4;   // Maximum number of threads recording secondary command buffers
+    const char *PIPELINE_CACHE_FILE_PATH = "pipeline_cache.bin";    // File that the pipeline cache is persisted to between runs
+    const uint32_t OFFSCREEN_FRAME_COUNT = 3;   // Number of offscreen images rendered into in headless mode
+    const VkFormat OFFSCREEN_IMAGE_FORMAT = VK_FORMAT_B8G8R8A8_SRGB;    // Format of the offscreen images
+    const uint32_t MAX_GPU_ZONES_PER_FRAME = 8; // Maximum number of GPU timer zones in a frame's commands
+    const double TILE_STAGE_REPORT_INTERVAL = 30.0; // Time between reports of the tile pipeline stage times (in seconds)
+    const std::string DEFAULT_PROFILE_TRACE_FILE = "profile_trace.json";    // Trace file written when profiling is toggled off without --profile
+    const uint32_t MAX_HUD_VERTICES = 65536;    // Maximum number of vertices drawn by the performance overlay
+
+    // Shader quality presets, from cheapest to most expensive
+    const std::array<ShaderQualitySettings, NUM_SHADER_QUALITY_PRESETS> SHADER_QUALITY_SETTINGS =
+    {{
+        // Kernel radius, shadows, specular, name
+        { 0, VK_FALSE, VK_FALSE, "low" },       // No shadows, diffuse lighting only
+        { 0, VK_TRUE, VK_TRUE, "medium" },      // Single filtered shadow tap
+        { 1, VK_TRUE, VK_TRUE, "high" }         // 3x3 filtered shadow taps
+    }};
 
 private:
     bool m_isRunning;   // Flag indicating whether the application is running
+    bool m_exitRequested;   // Flag indicating whether the game loop should stop after the current frame
+    std::chrono::steady_clock::time_point m_startTime;  // Time at which the application started running
+    LaunchOptions m_launchOptions;  // Options selected on the command line
 
-    Window m_window;    // Window
+    Window m_window;    // Window. Not created in headless mode.
 
     VkSwapchainKHR m_vkSwapchain;           // Swapchain
     VkFormat m_vkSwapchainImageFormat;      // Swapchain image format
     VkExtent2D m_vkSwapchainImageExtent;    // Swapchain image extent
 
     uint32_t m_maxFramesInFlight;           // Maximum number of frames in flight
+    VulkanBuffer m_readbackBuffer;          // Host-visible buffer that dumped frames are copied into
 
     VkRenderPass m_shadowRenderPass;        // Render pass for the shadow pass
     VkRenderPass m_vkRenderPass;            // Render pass
     VkPipelineLayout m_shadowPipelineLayout;    // Pipeline layout for the shadow pass
     VkPipeline m_shadowPipeline;                // Pipeline object for the shadow pass
     VkPipelineLayout m_vkPipelineLayout;    // Pipeline layout
-    VkPipeline m_vkPipeline;                // Pipeline
+    std::array<VkPipeline, NUM_SHADER_QUALITY_PRESETS> m_qualityPipelines;  // Pipeline of each shader quality preset
+    size_t m_shaderQuality;                 // Index of the shader quality preset in use
+    VulkanPipelineCache m_pipelineCache;    // Pipeline cache shared by all pipelines, persisted between runs
+    VkPipelineLayout m_hudPipelineLayout;   // Pipeline layout for the performance overlay
+    VkPipeline m_hudPipeline;               // Pipeline drawing the performance overlay on top of the main pass
 
     VkCommandPool m_vkCommandPool;          // Command pool
 
     std::vector<FrameData> m_frameDataList; // List containing data for each frame
 
-    VulkanBuffer m_testVertexBuffer;        // Test vertex buffer
+    VulkanBuffer m_positionBuffer;          // Vertex buffer containing the positions of the tile vertices
+    VulkanBuffer m_attributeBuffer;         // Vertex buffer containing the other attributes of the tile vertices
+
+    VulkanUploadEngine m_uploadEngine;      // Copies tile vertices into the device-local vertex buffer through the transfer queue
+    bool m_uploadEngineEnabled;             // Flag indicating whether the upload engine is used. Otherwise, the vertex buffer is written directly by the host.
+    uint64_t m_vertexUploadValue;           // Timeline value signaled once all vertex uploads submitted so far are finished
 
     VulkanImage m_vkDepthBufferImage;           // Image for the depth buffer
     VulkanImageView m_vkDepthBufferImageView;   // Image view for the depth buffer image
@@ -111,28 +290,84 @@ private:
 
     VkSampler m_shadowMapSampler;           // sampler for the shadow map
 
+    VulkanImage m_shadowMapImage;           // Image for the shadow map. Shared by all frames, since it is only rendered when invalidated.
+    VulkanImageView m_shadowMapImageView;   // Image view for the shadow map image
+    VkFramebuffer m_shadowMapFramebuffer;   // Framebuffer for the shadow map
+
+    VulkanUniformBufferRing m_uniformBufferRing;    // Persistently mapped uniform buffer sub-allocated per frame
+
+    VkDescriptorSetLayout m_cullDescriptorSetLayout;    // Descriptor set layout for the culling compute shader
+    VkDescriptorPool m_cullDescriptorPool;              // Descriptor pool for the culling compute shader
+    VkPipelineLayout m_cullPipelineLayout;              // Pipeline layout for the culling compute shader
+    VkPipeline m_cullPipeline;                          // Pipeline for the culling compute shader
+    bool m_gpuCullingEnabled;                           // Flag indicating whether culling is done on the GPU instead of the CPU
+
     Camera m_camera;    // Camera
 
     glm::dvec2 m_origin;                    // Current global origin offset
-    glm::ivec2 m_currentTileIndex;          // Current tile index
-    std::vector<TileData> m_activeTiles;    // List of active tiles
-
-    RectI m_currentViewArea;                // Current view area (in tiles)
-    uint32_t m_numVertices;                 // Number of vertices to render
+    glm::ivec2 m_currentTileIndex;          // Current tile index (base zoom level)
+    bool m_residentTilesDirty;              // Flag indicating whether the resident tiles have to be reconciled with the visible tiles
+    glm::ivec2 m_meshOriginTileIndex;       // Tile whose min corner is the origin of the vertices in the vertex buffer (base zoom level)
+    glm::dvec2 m_meshOrigin;                // Origin of the vertices in the vertex buffer (lon/lat)
+
+    TilePyramid m_tilePyramid;              // Selects the tiles of each zoom level around the camera
+    int m_viewDistance;                     // View distance (in base zoom level tiles)
+    int m_prefetchDistance;                 // Distance beyond the view distance where tiles are prefetched (in base zoom level tiles)
+    std::vector<TileKey> m_visibleTiles;    // Tiles within the view distance, sorted from nearest to furthest
+    std::set<TileKey> m_visibleTileSet;     // Set of the visible tiles for lookups
+
+    TileRegistry m_tileRegistry;            // Lifecycle state of every tile, shared with the worker threads
+    TileStageStats m_tileStageStats;        // Time tiles spent in each stage of the pipeline, shared with the worker threads
+    TileMeshBuilder m_tileMeshBuilder;      // Generates the meshes of the tiles, shared with the worker threads
+    MpscQueue<std::shared_ptr<const TileMesh>> m_publishedTileMeshes;   // Meshes finished by the worker threads, waiting to be picked up by the render thread
+    std::map<TileKey, std::shared_ptr<const TileMesh>> m_readyTileMeshes;  // Tiles requested to be at least meshed, and their meshes once published. Render thread only.
+    TilePrefetchPredictor m_prefetchPredictor;  // Predicts the tiles needed along the camera path
+    RangeAllocator m_vertexAllocator;       // Allocates the vertex range of each resident tile in the vertex buffer
+    std::map<TileKey, ResidentTile> m_residentTiles;    // Tiles whose vertices are in the vertex buffer
+    std::vector<TileKey> m_uploadQueue;     // Visible tiles with a ready mesh waiting to be uploaded, nearest first
+    std::deque<PendingVertexFree> m_pendingVertexFrees; // Vertex ranges of evicted tiles that may still be read by frames in flight
+    uint64_t m_frameNumber;                 // Number of frames started so far
+    size_t m_uploadBudgetBytes;             // Maximum number of bytes uploaded to the vertex buffer per frame
+    uint32_t m_uploadBudgetMicroseconds;    // Maximum time spent uploading to the vertex buffer per frame (in microseconds)
+    UploadStats m_uploadStats;              // Tile upload statistics since the last report
+    std::vector<MeshCluster> m_selectedClusters;    // Clusters of the LOD level picked for each tile in the current frame
+    std::map<TileKey, std::vector<MeshCluster>> m_selectedTileGroups;   // Selected clusters of each tile group in the current frame
+    JobSystem m_recordingJobSystem;             // Workers recording the secondary command buffers of the tile groups
+    std::array<uint32_t, NUM_LOD_LEVELS> m_tileCountPerLod;    // Number of tiles drawn at each LOD level in the current frame
+    uint32_t m_gpuCullingOverflowTileCount;     // Number of tiles in the current frame whose clusters do not fit in the GPU cull buffer
+    uint32_t m_gpuCullingOverflowFrames;        // Number of frames culled on the CPU since the last report, because their clusters did not fit in the GPU cull buffer
+    uint32_t m_maxGpuCullingOverflowTileCount;  // Most tiles that did not fit in the GPU cull buffer in a frame since the last report
+    CullingStats m_mainPassCullingStats;        // Culling statistics of the main pass for the last frame
+    CullingStats m_shadowPassCullingStats;      // Culling statistics of the shadow pass for the last frame
+    glm::vec3 m_shadowMapAnchor;                // Texel-snapped point (relative to the mesh origin) that the cached shadow map is centered on
+    glm::mat4 m_shadowMapLightMatrix;           // Light projection-view matrix that the cached shadow map was rendered with
+    std::vector<MeshCluster> m_shadowMapClusters;   // Selected clusters inside the light box of the cached shadow map
+    bool m_shadowMapDirty;                      // Flag indicating whether the mesh origin moved since the shadow map was rendered
+    uint32_t m_shadowMapRenderCount;            // Number of frames that rendered the shadow map since the last report
+
+    CameraPath m_cameraPath;                    // Camera path replayed by the benchmark. Empty if not benchmarking.
+    BenchmarkRecorder m_benchmarkRecorder;      // Per-frame measurements of the benchmark
+    VulkanGpuTimer m_gpuTimer;                  // Measures the GPU time of each frame's passes. Unavailable if timestamps are unsupported.
+    std::vector<VulkanGpuTimer::ZoneResult> m_gpuZoneResults;   // GPU zones read back from the last finished frame
+    std::vector<double> m_frameTileLatencies;   // Request-to-resident latencies of the tiles uploaded in the current frame (in seconds)
+
+    HudOverlay m_hudOverlay;                    // On-screen performance overlay, toggled with the H key
+    double m_lastCpuFrameMilliseconds;          // Time the CPU spent on the last frame, excluding waits for the GPU
+    double m_lastGpuFrameMilliseconds;          // Time the GPU spent on the last finished frame. Negative if not measured.
 
     bool m_workerThreadRunning;             // Flag indicating whether the worker thread is running
+    std::unique_ptr<TileDataSource> m_tileDataSource;   // Hierarchy of tile data sources shared by the worker threads
 
     std::vector<RetrieveTileJob> m_retrieveTileJobs;    // List of retrieve tile jobs
     std::mutex m_retrieveTileJobsMutex;                 // Mutex for the retrieve tile jobs list
-
-    std::mutex m_tilesUpdateMutex;                      // Mutex for a tile update routine
-    bool m_tilesUpdated;                                // Flag indicating whether the tiles have recently been updated
+    std::atomic<size_t> m_retrieveTileJobCount;         // Number of retrieve tile jobs, readable without the mutex
 
 public:
     /**
      * @brief Constructor
+     * @param[in] launchOptions Options selected on the command line
      */
-    Application();
+    Application(const LaunchOptions &launchOptions);
 
     /**
      * @brief Destructor
@@ -157,12 +392,63 @@ private:
      */
     void Cleanup();
 
+    /**
+     * @brief Requests the game loop to stop after the current frame.
+     */
+    void RequestExit();
+
+    /**
+     * @brief Checks whether the game loop should stop.
+     * @return Returns true if an exit was requested, the window was closed or all requested frames were rendered.
+     * Returns false otherwise.
+     */
+    bool ShouldExit() const;
+
+    /**
+     * @brief Gets the time since the application started running.
+     * @return Elapsed time (in seconds)
+     */
+    double GetElapsedTime() const;
+
+    /**
+     * @brief Waits for a frame to finish rendering, and writes the image it was copied into to a file.
+     * @param[in] frameData Data of the frame, whose commands copied the rendered image into the readback buffer
+     * @param[in] frameNumber Number of the frame, used in the file name
+     * @return Returns true if the image was written successfully. Returns false otherwise.
+     */
+    bool DumpFrame(const FrameData &frameData, uint64_t frameNumber);
+
+    /**
+     * @brief Passes the GPU zones of the frame's last finished commands to the profiler,
+     * and the GPU time of the whole frame to the benchmark recorder.
+     * Must only be called once the frame's fence was signaled.
+     * @param[in] frameIndex Index of the frame in the frame data list
+     */
+    void CollectGpuTime(uint32_t frameIndex);
+
+    /**
+     * @brief Starts recording profiler events, or stops recording and writes the recorded events to the trace file.
+     */
+    void ToggleProfiling();
+
+    /**
+     * @brief Initializes the pipeline of the shadow pass. Requires the descriptor set layout.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitShadowPipeline();
+
     /**
      * @brief Initializes the Vulkan render pass.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     bool InitSwapchain();
 
+    /**
+     * @brief Initializes the offscreen images that are rendered into in headless mode, in place of a swapchain.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitOffscreenTargets();
+
     /**
      * @brief Initializes all things needed for a shadow pass
      * @return Returns true if the initialization was successful. Returns false otherwise.
@@ -200,32 +486,207 @@ private:
     bool InitCommandBuffers();
 
     /**
-     * @brief Initializes descriptors
+     * @brief Initializes the shadow map sampler and the descriptor set layout, which the pipelines depend on
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitDescriptorSetLayout();
+
+    /**
+     * @brief Initializes the uniform buffer and the descriptor sets. Requires the descriptor set layout.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     bool InitDescriptors();
 
+    /**
+     * @brief Initializes the pipelines of the shadow pass and the main pass. Can run on another
+     * thread while the rest of the initialization continues, once the render passes
+     * and the descriptor set layout exist.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitRenderPipelines();
+
     /**
      * @brief Create Vulkan graphics pipeline
      * @return Returns true if the creation was successful. Returns false otherwise.
      */
     bool InitGraphicsPipeline();
 
+    /**
+     * @brief Initializes the compute pipeline and resources used for GPU culling
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitCullingPipeline();
+
     /**
      * @brief Initializes the Vulkan synchronization tools.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     bool InitSynchronizationTools();
 
+    /**
+     * @brief Initializes the GPU timer used to measure the passes of each frame.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitGpuTimer();
+
+    /**
+     * @brief Initializes the pipeline of the performance overlay. Requires the main render pass.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitHudPipeline();
+
+    /**
+     * @brief Initializes the vertex buffer and the secondary command buffer of the performance overlay for each frame.
+     * @return Returns true if the initialization was successful. Returns false otherwise.
+     */
+    bool InitHudBuffers();
+
 private:
     /**
-     * @brief Appends geometry vertices of a tile into a destination buffer
-     * @param[in] tileData Tile whose geometry vertices to append
-     * @param[in] origin Origin that the vertices are relative to (lon/lat)
-     * @param[in] dest Destination buffer to append the vertices to
-     * @return Number of vertices appended
+     * @brief Picks up the tile meshes published by the worker threads
+     */
+    void CollectPublishedTileMeshes();
+
+    /**
+     * @brief Evicts the resident tiles that are no longer visible, and queues the
+     * visible tiles with a ready mesh for upload, nearest first.
+     */
+    void UpdateResidentTiles();
+
+    /**
+     * @brief Uploads queued tiles to the vertex buffer until the per-frame
+     * byte or time budget is used up. At least one tile is uploaded per frame,
+     * unless the staging buffer of the transfer queue is full.
+     */
+    void UploadQueuedTiles();
+
+    /**
+     * @brief Frees the vertex ranges of evicted tiles that are no longer read by any frame in flight
+     */
+    void ReleasePendingVertexRanges();
+
+    /**
+     * @brief Gets the position of the mesh origin relative to the current origin
+     * @return Offset of the mesh origin (world-space)
      */
-    uint32_t AppendTileGeometryVertices(const TileData &tileData, const glm::dvec2 &origin, std::vector<Vertex> &dest);
+    glm::vec3 GetMeshOriginOffset() const;
+
+    /**
+     * @brief Picks the LOD level of each tile by its projected geometric error, and gathers
+     * the clusters of the picked levels into the selected clusters list and the tile groups.
+     * Every visible tile is selected, even beyond MAX_CLUSTER_COUNT clusters; the tiles beyond
+     * it are counted, and such frames are culled on the CPU.
+     * @param[in] cameraPosition Camera position
+     * @param[in] viewportHeight Height of the viewport (in pixels)
+     */
+    void SelectTileLods(const glm::vec3 &cameraPosition, float viewportHeight);
+
+    /**
+     * @brief Checks whether the cached shadow map is still valid. If not, moves the shadow map
+     * to a texel-snapped anchor near the camera, so that re-rendered shadows do not shimmer.
+     * @param[in] cameraPosition Camera position, relative to the mesh origin
+     * @param[in] lightDirection Direction of the light
+     * @return Returns true if the shadow map has to be rendered again. Returns false if the cached one can be used.
+     */
+    bool UpdateShadowMapAnchor(const glm::vec3 &cameraPosition, const glm::vec3 &lightDirection);
+
+    /**
+     * @brief Gathers the selected clusters that intersect the light box of a shadow map
+     * @param[in] lightMatrix Light projection-view matrix of the shadow map
+     * @return Selected clusters inside the light box
+     */
+    std::vector<MeshCluster> GetShadowCasterClusters(const glm::mat4 &lightMatrix) const;
+
+    /**
+     * @brief Records draw commands for the clusters. Adjacent clusters are merged into a single draw call.
+     * @param[in] commandBuffer Command buffer to record the draw commands into
+     * @param[in] clusters Clusters to draw
+     * @return Number of recorded draw calls
+     */
+    uint32_t DrawClusters(VkCommandBuffer commandBuffer, const std::vector<MeshCluster> &clusters);
+
+    /**
+     * @brief Records the pipeline, viewport, vertex buffer, and descriptor set bindings of a pass
+     * @param[in] commandBuffer Command buffer to record the commands into
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] isShadowPass Flag indicating whether the state of the shadow pass or the main pass is bound
+     * @param[in] dynamicOffsets Uniform buffer offsets of the camera and light data
+     */
+    void BindPassState(VkCommandBuffer commandBuffer, const FrameData &frameData, bool isShadowPass, const std::array<uint32_t, 2> &dynamicOffsets);
+
+    /**
+     * @brief Matches the cached tile group command buffers of the frame with the selected tile groups.
+     * Groups that are no longer drawn are freed, and the new or changed ones are recorded in parallel.
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] dynamicOffsets Uniform buffer offsets of the camera and light data
+     */
+    void UpdateTileGroupCommands(FrameData &frameData, const std::array<uint32_t, 2> &dynamicOffsets);
+
+    /**
+     * @brief Records the shadow pass and main pass secondary command buffers of a tile group.
+     * Called on the recording worker that owns the command buffers.
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] tileGroup Tile group to record
+     */
+    void RecordTileGroupCommands(const FrameData &frameData, TileGroupCommands &tileGroup);
+
+    /**
+     * @brief Executes the secondary command buffers of the tile groups inside the frustum
+     * @param[in] commandBuffer Primary command buffer inside the render pass
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] isShadowPass Flag indicating whether the shadow pass or the main pass is recorded
+     * @param[in] frustum Frustum to cull the tile groups against
+     * @param[out] outStats Culling statistics for the executed draws
+     */
+    void ExecuteVisibleTileGroups(VkCommandBuffer commandBuffer, const FrameData &frameData, bool isShadowPass, const Frustum &frustum, CullingStats &outStats);
+
+    /**
+     * @brief Records a compute dispatch that culls all clusters against the frustum and writes
+     * one indirect draw command per cluster into the frame's draw command buffer.
+     * @param[in] commandBuffer Command buffer to record the dispatch into
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] frustum Frustum to cull the clusters against
+     * @param[in] drawCommandOffset Index of the first draw command to write to
+     */
+    void DispatchClusterCulling(VkCommandBuffer commandBuffer, FrameData &frameData, const Frustum &frustum, uint32_t drawCommandOffset);
+
+    /**
+     * @brief Records indirect draws for the commands written by the culling compute shader.
+     * @param[in] commandBuffer Command buffer to record the draw commands into
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] drawCommandOffset Index of the first draw command to consume
+     */
+    void DrawClustersIndirect(VkCommandBuffer commandBuffer, FrameData &frameData, uint32_t drawCommandOffset);
+
+    /**
+     * @brief Rebuilds the performance overlay from the current statistics, and writes its vertices to the frame's vertex buffer
+     * @param[in] frameData Data of the frame being recorded
+     * @return Number of vertices to draw
+     */
+    uint32_t UpdateHud(FrameData &frameData);
+
+    /**
+     * @brief Records the draw of the performance overlay
+     * @param[in] commandBuffer Command buffer inside the main pass to record the commands into
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] vertexCount Number of vertices to draw
+     */
+    void DrawHud(VkCommandBuffer commandBuffer, FrameData &frameData, uint32_t vertexCount);
+
+    /**
+     * @brief Records the draw of the performance overlay into the frame's secondary command buffer
+     * @param[in] frameData Data of the frame being recorded
+     * @param[in] vertexCount Number of vertices to draw
+     * @return Returns true if the recording was successful. Returns false otherwise.
+     */
+    bool RecordHudCommands(FrameData &frameData, uint32_t vertexCount);
+
+    /**
+     * @brief Gets the camera position of a camera path pose, relative to the current origin like the camera
+     * @param[in] pose Camera path pose
+     * @return Camera position
+     */
+    glm::vec3 GetCameraPathPosition(const CameraPath::Keyframe &pose) const;
 
     /**
      * @brief Performs the necessary setup to change to a new current tile.
@@ -233,6 +694,52 @@ private:
      */
     void UpdateCurrentTile(const glm::ivec2 &newCurrentTileIndex);
 
+    /**
+     * @brief Reselects the visible tiles around the current tile, updates the state
+     * each tile is requested to reach, and queues jobs for the tiles that need work.
+     */
+    void UpdateVisibleTiles();
+
+    /**
+     * @brief Queues jobs that prefetch and mesh the tiles predicted along the camera path
+     * @param[in] predictedTiles Predicted tiles, in the order they are expected to be needed
+     */
+    void QueuePredictedTiles(const std::vector<TileKey> &predictedTiles);
+
+    /**
+     * @brief Retrieves the data of a tile. Tiles coarser than the base zoom level
+     * are generated by merging the base zoom level tiles they cover.
+     * @param[in] dataSource Data source to retrieve the tile data from
+     * @param[in] tileKey Tile to retrieve
+     * @param[out] outTileData Retrieved tile data
+     * @return Returns true if the retrieval was successful. Returns false otherwise.
+     */
+    bool RetrieveTile(TileDataSource &dataSource, const TileKey &tileKey, TileData &outTileData);
+
+    /**
+     * @brief Queries whether the data of all base zoom level tiles covered by a tile is cached
+     * @param[in] dataSource Data source to query
+     * @param[in] tileKey Tile to query
+     * @return True if all the needed tile data is cached
+     */
+    bool IsTileCacheAvailable(TileDataSource &dataSource, const TileKey &tileKey);
+
+    /**
+     * @brief Prefetches the data of all base zoom level tiles covered by a tile
+     * @param[in] dataSource Data source to prefetch the tile data from
+     * @param[in] tileKey Tile to prefetch
+     * @return Returns true if all the needed tile data was prefetched. Returns false otherwise.
+     */
+    bool PrefetchTile(TileDataSource &dataSource, const TileKey &tileKey);
+
+    /**
+     * @brief Advances a tile through its lifecycle states until it reaches
+     * its requested state, or another worker owns it, and records the time spent in each stage.
+     * @param[in] dataSource Data source to retrieve the tile data from
+     * @param[in] job Job of the tile to process
+     */
+    void ProcessTile(TileDataSource &dataSource, const RetrieveTileJob &job);
+
     /**
      * @brief Function run by the worker thread where tiles are downloaded
      * in the background.
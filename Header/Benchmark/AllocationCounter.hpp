@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Counts the heap allocations of the process. The global operator new and
+ * operator delete are replaced in AllocationCounter.cpp, so the counts are only
+ * available in executables that link it (the benchmarks).
+ */
+class AllocationCounter
+{
+public:
+    // Allocations made so far
+    struct Counts
+    {
+        uint64_t allocations;   // Number of allocations
+        uint64_t bytes;         // Number of bytes allocated
+    };
+
+    /**
+     * @brief Gets the number of allocations made since the process started
+     * @return Allocation counts
+     */
+    static Counts GetCounts();
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Map/TileData.hpp"
+#include "Map/TileDataSource.hpp"
+#include "Map/TileKey.hpp"
+
+#include <glm/glm.hpp>
+#include <tinyxml2.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Benchmarks the stages that turn OSM tile files into tile meshes: XML parsing,
+ * extracting the features from the XML, projecting lon/lat to world coordinates,
+ * triangulating polygons and building the full tile mesh. Each benchmark runs over
+ * every tile file in a directory, or over tiles from a data source such as the
+ * synthetic one, and reports the time and allocations per item.
+ * Results can be written to JSON and compared against a previously written baseline.
+ */
+class MapBenchmark
+{
+public:
+    // Result of a single benchmark
+    struct Result
+    {
+        std::string name;               // Name of the benchmark
+        std::string itemName;           // What a single item of the benchmark is, e.g. "feature"
+        uint64_t itemCount;             // Number of items processed by each iteration
+        uint32_t iterations;            // Number of measured iterations
+        double nanosecondsPerItem;      // Median iteration time divided by the number of items
+        double itemsPerSecond;          // Items processed per second, at the median iteration time
+        double allocationsPerItem;      // Heap allocations per item
+        double bytesPerItem;            // Heap bytes allocated per item
+    };
+
+private:
+    // Tile file found in the tile directory
+    struct TileFile
+    {
+        TileKey tileKey;                // Tile stored in the file
+        std::string filePath;           // Path of the file
+        std::string xmlText;            // Contents of the file
+    };
+
+    const double MESH_SCALE = 0.05;     // Scale from meters to world units used for the mesh build, same as the viewer
+
+    uint32_t m_iterations;              // Number of measured iterations of each benchmark, after one warm-up iteration
+    std::vector<TileFile> m_tileFiles;  // Tile files the benchmarks run over
+    std::vector<std::unique_ptr<tinyxml2::XMLDocument>> m_documents;    // Parsed XML of each tile file
+    std::vector<TileData> m_tiles;      // Features extracted from each tile file
+    std::vector<Result> m_results;      // Results of the benchmarks run so far
+    double m_checksum;                  // Sum of the benchmark outputs, so that the measured work cannot be optimized away
+
+public:
+    /**
+     * @brief Constructor
+     */
+    MapBenchmark();
+
+    /**
+     * @brief Destructor
+     */
+    ~MapBenchmark();
+
+    /**
+     * @brief Sets the number of measured iterations of each benchmark
+     * @param[in] iterations Number of iterations
+     */
+    void SetIterations(uint32_t iterations);
+
+    /**
+     * @brief Loads every tile file (map_<zoom>-<x>-<y>.osm) in a directory
+     * @param[in] directory Directory containing the tile files
+     * @return Returns true if at least one tile was loaded. Returns false otherwise.
+     */
+    bool LoadTiles(const std::string &directory);
+
+    /**
+     * @brief Retrieves a square block of tiles from a tile data source, instead of loading tile files.
+     * The XML benchmarks are skipped for these tiles, since there is no XML.
+     * @param[in] dataSource Data source to retrieve the tiles from
+     * @param[in] firstTileIndex Tile index of the south-west corner of the block
+     * @param[in] zoomLevel Zoom level of the tiles
+     * @param[in] tilesPerSide Number of tiles along each side of the block
+     * @return Returns true if at least one tile was retrieved. Returns false otherwise.
+     */
+    bool GenerateTiles(TileDataSource &dataSource, const glm::ivec2 &firstTileIndex, int zoomLevel, int tilesPerSide);
+
+    /**
+     * @brief Runs all benchmarks over the loaded tiles
+     */
+    void Run();
+
+    /**
+     * @brief Gets the results of the benchmarks run so far
+     * @return Benchmark results
+     */
+    const std::vector<Result>& GetResults() const;
+
+    /**
+     * @brief Prints the results as a table
+     * @param[in] stream Stream to print to
+     */
+    void PrintResults(std::ostream &stream) const;
+
+    /**
+     * @brief Writes the results to a JSON file
+     * @param[in] filePath Path of the file
+     * @return Returns true if the file was written. Returns false otherwise.
+     */
+    bool WriteJson(const std::string &filePath) const;
+
+    /**
+     * @brief Reads the results from a JSON file written by WriteJson()
+     * @param[in] filePath Path of the file
+     * @param[out] outResults Results read from the file
+     * @return Returns true if the file was read. Returns false otherwise.
+     */
+    static bool ReadJson(const std::string &filePath, std::vector<Result> &outResults);
+
+    /**
+     * @brief Compares the time per item of each benchmark with a baseline, and prints the comparison as a table
+     * @param[in] baseline Baseline results
+     * @param[in] thresholdPercent Slowdown (in percent) above which a benchmark counts as a regression
+     * @param[in] stream Stream to print to
+     * @return Number of benchmarks that regressed
+     */
+    uint32_t CompareWithBaseline(const std::vector<Result> &baseline, double thresholdPercent, std::ostream &stream) const;
+
+private:
+    /**
+     * @brief Runs a benchmark once to warm up, then measures it for the configured number of iterations
+     * @param[in] name Name of the benchmark
+     * @param[in] itemName What a single item of the benchmark is
+     * @param[in] itemCount Number of items processed by each run of the body
+     * @param[in] body Work to measure
+     */
+    void Measure(const std::string &name, const std::string &itemName, uint64_t itemCount, const std::function<void()> &body);
+
+    /**
+     * @brief Gets the number of features (buildings, highways and water features) of all tiles
+     * @return Number of features
+     */
+    uint64_t GetFeatureCount() const;
+};
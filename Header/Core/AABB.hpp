@@ -0,0 +1,74 @@
+#ifndef AABB_HEADER
+#define AABB_HEADER
+
+#include <glm/glm.hpp>
+
+#include <limits>
+
+/**
+ * Struct representing an axis-aligned bounding box in 3D
+ */
+struct AABB
+{
+    glm::vec3 min;      // Min point
+    glm::vec3 max;      // Max point
+
+    /**
+     * @brief Constructs an empty bounding box that can be grown with Expand()
+     * @return Constructed AABB object
+     */
+    static AABB Empty()
+    {
+        const float maxFloat = std::numeric_limits<float>::max();
+        return { glm::vec3(maxFloat), glm::vec3(-maxFloat) };
+    }
+
+    /**
+     * @brief Grows the bounding box so that it contains the specified point
+     * @param[in] point Point
+     */
+    void Expand(const glm::vec3 &point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    /**
+     * @brief Grows the bounding box so that it contains the specified bounding box
+     * @param[in] other Bounding box
+     */
+    void Expand(const AABB &other)
+    {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    /**
+     * @brief Queries whether the bounding box contains at least one point
+     * @return True if the bounding box is not empty
+     */
+    bool IsValid() const
+    {
+        return (min.x <= max.x) && (min.y <= max.y) && (min.z <= max.z);
+    }
+
+    /**
+     * @brief Gets the center of the bounding box
+     * @return Center of the bounding box
+     */
+    glm::vec3 GetCenter() const
+    {
+        return (min + max) * 0.5f;
+    }
+
+    /**
+     * @brief Gets the half-extents of the bounding box
+     * @return Half-extents of the bounding box
+     */
+    glm::vec3 GetHalfExtents() const
+    {
+        return (max - min) * 0.5f;
+    }
+};
+
+#endif // AABB_HEADER
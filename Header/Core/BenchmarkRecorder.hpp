@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Collects per-frame timings and streaming statistics during a benchmark run,
+ * and summarizes them as percentiles, so that hitches show up instead of being
+ * averaged away.
+ */
+class BenchmarkRecorder
+{
+public:
+    // Measurements of a single frame
+    struct FrameSample
+    {
+        uint64_t frameNumber;           // Number of the frame
+        double time;                    // Time since the start of the benchmark at which the frame started (in seconds)
+        double frameMilliseconds;       // Wall-clock time of the whole frame
+        double cpuMilliseconds;         // Time the CPU spent on the frame, excluding waits for the GPU
+        double gpuMilliseconds;         // Time the GPU spent executing the frame's commands. Negative if not measured.
+        uint32_t arrivedTiles;          // Number of tiles that became resident in the frame
+        double maxTileLatencyMilliseconds;  // Longest time from request to resident among the arrived tiles
+        uint64_t uploadedBytes;         // Number of bytes uploaded to the vertex buffer in the frame
+    };
+
+    // Distribution of a measurement
+    struct Percentiles
+    {
+        size_t count;                   // Number of measurements
+        double p50;                     // Median
+        double p95;                     // 95th percentile
+        double p99;                     // 99th percentile
+        double max;                     // Maximum
+    };
+
+    // Distribution of every measurement of the run
+    struct Summary
+    {
+        Percentiles frameMilliseconds;  // Frame times
+        Percentiles cpuMilliseconds;    // CPU times
+        Percentiles gpuMilliseconds;    // GPU times of the frames where it was measured
+        Percentiles tileLatencyMilliseconds;    // Request-to-resident latencies of every arrived tile
+        Percentiles uploadedBytes;      // Uploaded bytes per frame
+        uint64_t totalUploadedBytes;    // Uploaded bytes over the whole run
+        uint32_t totalArrivedTiles;     // Tiles that became resident over the whole run
+    };
+
+private:
+    std::vector<FrameSample> m_samples;         // Samples of each recorded frame, in frame order
+    std::vector<double> m_tileLatencies;        // Request-to-resident latency of every arrived tile (in milliseconds)
+
+public:
+    /**
+     * @brief Constructor
+     */
+    BenchmarkRecorder();
+
+    /**
+     * @brief Destructor
+     */
+    ~BenchmarkRecorder();
+
+    /**
+     * @brief Records the measurements of a frame
+     * @param[in] sample Measurements of the frame
+     * @param[in] tileLatencies Request-to-resident latency of each tile that arrived in the frame (in seconds)
+     */
+    void AddFrame(const FrameSample &sample, const std::vector<double> &tileLatencies);
+
+    /**
+     * @brief Sets the GPU time of a recorded frame, once it is known
+     * @param[in] frameNumber Number of the frame
+     * @param[in] gpuMilliseconds Time the GPU spent executing the frame's commands
+     */
+    void SetGpuTime(uint64_t frameNumber, double gpuMilliseconds);
+
+    /**
+     * @brief Checks whether any frame was recorded
+     * @return Returns true if no frame was recorded. Returns false otherwise.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Computes the distribution of every measurement
+     * @return Summary of the run
+     */
+    Summary GetSummary() const;
+
+    /**
+     * @brief Writes the summary in a human-readable form
+     * @param[in] stream Stream to write to
+     */
+    void PrintSummary(std::ostream &stream) const;
+
+    /**
+     * @brief Writes the samples of every frame as CSV
+     * @param[in] filePath CSV file
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    bool WriteCsv(const std::string &filePath) const;
+
+    /**
+     * @brief Computes the distribution of a list of measurements, using the nearest-rank method
+     * @param[in] values Measurements
+     * @return Percentiles of the measurements. All zero if there are none.
+     */
+    static Percentiles ComputePercentiles(std::vector<double> values);
+};
@@ -18,6 +18,16 @@ private:
 	 */
 	float m_aspectRatio;
 
+	/**
+	 * Distance to the near clipping plane
+	 */
+	float m_nearPlane;
+
+	/**
+	 * Distance to the far clipping plane
+	 */
+	float m_farPlane;
+
 	/**
 	 * Camera position
 	 */
@@ -88,6 +98,25 @@ public:
 	 */
 	float GetAspectRatio() const;
 
+	/**
+	 * @brief Sets the distances to the camera's near and far clipping planes
+	 * @param[in] nearPlane Distance to the near clipping plane
+	 * @param[in] farPlane Distance to the far clipping plane
+	 */
+	void SetClipPlanes(const float& nearPlane, const float& farPlane);
+
+	/**
+	 * @brief Gets the distance to the camera's near clipping plane
+	 * @return Distance to the near clipping plane
+	 */
+	float GetNearPlane() const;
+
+	/**
+	 * @brief Gets the distance to the camera's far clipping plane
+	 * @return Distance to the far clipping plane
+	 */
+	float GetFarPlane() const;
+
 	/**
 	 * @brief Sets the camera's position
 	 * @param[in] position New position
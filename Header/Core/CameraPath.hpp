@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * Timestamped camera poses that are replayed instead of the user input,
+ * e.g. to benchmark the same flight over the map on every run.
+ * Poses between two keyframes are linearly interpolated.
+ *
+ * The path file has one keyframe per line, in increasing time:
+ *     <time (s)> <longitude> <latitude> <height (m)> <yaw (deg)> <pitch (deg)>
+ * Empty lines and lines starting with '#' are ignored.
+ */
+class CameraPath
+{
+public:
+    // Camera pose at a point in time
+    struct Keyframe
+    {
+        double time;            // Time since the start of the path (in seconds)
+        glm::dvec2 lonLat;      // Camera position (lon/lat)
+        double height;          // Camera height above the ground (in meters)
+        float yaw;              // Camera yaw (in degrees). Not wrapped, so that turns interpolate in the intended direction.
+        float pitch;            // Camera pitch (in degrees)
+    };
+
+private:
+    std::vector<Keyframe> m_keyframes;  // Keyframes, in increasing time
+
+public:
+    /**
+     * @brief Constructor
+     */
+    CameraPath();
+
+    /**
+     * @brief Destructor
+     */
+    ~CameraPath();
+
+    /**
+     * @brief Loads the keyframes from a path file. Previously loaded keyframes are replaced.
+     * @param[in] filePath Path file
+     * @return Returns true if the file was read and has at least one keyframe. Returns false otherwise.
+     */
+    bool LoadFromFile(const std::string &filePath);
+
+    /**
+     * @brief Checks whether the path has any keyframes
+     * @return Returns true if there are no keyframes. Returns false otherwise.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Gets the time of the last keyframe
+     * @return Duration of the path (in seconds). 0 if the path is empty.
+     */
+    double GetDuration() const;
+
+    /**
+     * @brief Gets the camera pose at the provided time. Times outside the path are clamped to its ends.
+     * Must not be called on an empty path.
+     * @param[in] time Time since the start of the path (in seconds)
+     * @return Interpolated camera pose
+     */
+    Keyframe Sample(double time) const;
+};
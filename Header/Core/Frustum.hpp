@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Core/AABB.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+/**
+ * View frustum represented by six inward-facing planes
+ */
+class Frustum
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    Frustum();
+
+    /**
+     * @brief Destructor
+     */
+    ~Frustum();
+
+    /**
+     * @brief Extracts the frustum planes from a combined projection-view matrix.
+     * The projection is expected to map depth to [0, 1] (Vulkan convention).
+     * @param[in] projView Combined projection-view matrix
+     * @return Frustum of the provided matrix
+     */
+    static Frustum FromMatrix(const glm::mat4 &projView);
+
+    /**
+     * @brief Checks whether the bounding box is at least partially inside the frustum.
+     * This is conservative, so boxes near the frustum corners may be reported as visible.
+     * @param[in] box Bounding box to test
+     * @return Returns true if the bounding box is potentially visible. Returns false otherwise.
+     */
+    bool IsAABBVisible(const AABB &box) const;
+
+    /**
+     * @brief Gets the frustum planes.
+     * Each plane is stored as (normal, distance), with the normal pointing inside the frustum.
+     * @return Frustum planes in the order left, right, bottom, top, near, far
+     */
+    const std::array<glm::vec4, 6>& GetPlanes() const;
+
+private:
+    std::array<glm::vec4, 6> m_planes;  // Frustum planes (left, right, bottom, top, near, far)
+};
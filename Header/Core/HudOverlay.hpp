@@ -0,0 +1,124 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Builds the geometry of the on-screen performance overlay: a translucent panel with
+ * lines of text above a graph of the recent frame times. Text is drawn with an embedded
+ * 5x7 pixel font, one quad per vertical run of lit pixels, so that a single untextured
+ * pipeline draws the whole overlay. The vertices are rebuilt on the CPU every frame.
+ */
+class HudOverlay
+{
+public:
+    // Vertex of the overlay
+    struct HudVertex
+    {
+        glm::vec2 position;     // Position (normalized device coordinates)
+        uint32_t color;         // Color (8 bits per channel, red in the lowest byte)
+    };
+
+private:
+    const uint32_t GLYPH_WIDTH = 5;                 // Width of a glyph of the font (in font pixels)
+    const uint32_t GLYPH_HEIGHT = 7;                // Height of a glyph of the font (in font pixels)
+    const float PIXEL_SCALE = 2.0f;                 // Size of a font pixel (in screen pixels)
+    const float MARGIN = 8.0f;                      // Space around the panel and around its contents (in screen pixels)
+    const size_t FRAME_HISTORY_SIZE = 120;          // Number of frame times shown in the graph
+    const float GRAPH_HEIGHT = 60.0f;               // Height of the frame time graph (in screen pixels)
+    const float GRAPH_BAR_WIDTH = 3.0f;             // Width of each bar of the frame time graph (in screen pixels)
+    const double GRAPH_MAX_MILLISECONDS = 50.0;     // Frame time at the top of the graph. Longer frames are clamped.
+    const double TARGET_MILLISECONDS_60 = 1000.0 / 60.0;    // Frame time of 60 FPS, drawn as a reference line
+    const double TARGET_MILLISECONDS_30 = 1000.0 / 30.0;    // Frame time of 30 FPS, drawn as a reference line
+
+    std::vector<double> m_frameTimes;       // Ring buffer of the recent frame times (in milliseconds)
+    size_t m_nextFrameTimeIndex;            // Index in the ring buffer that the next frame time is written to
+    size_t m_frameTimeCount;                // Number of frame times in the ring buffer
+    std::vector<HudVertex> m_vertices;      // Vertices built by the last call to Build()
+    glm::vec2 m_viewportSize;               // Size of the viewport the vertices are built for (in pixels)
+    bool m_isVisible;                       // Flag indicating whether the overlay is drawn
+
+public:
+    /**
+     * @brief Constructor
+     */
+    HudOverlay();
+
+    /**
+     * @brief Destructor
+     */
+    ~HudOverlay();
+
+    /**
+     * @brief Sets whether the overlay is drawn
+     * @param[in] isVisible Flag indicating whether the overlay is drawn
+     */
+    void SetVisible(bool isVisible);
+
+    /**
+     * @brief Checks whether the overlay is drawn
+     * @return Returns true if the overlay is drawn. Returns false otherwise.
+     */
+    bool IsVisible() const;
+
+    /**
+     * @brief Adds the time of a frame to the graph. Frame times are recorded even while
+     * the overlay is hidden, so that the graph is filled in as soon as it is shown.
+     * @param[in] milliseconds Frame time
+     */
+    void AddFrameTime(double milliseconds);
+
+    /**
+     * @brief Gets the average time of the frames in the graph
+     * @return Average frame time (in milliseconds). 0 if no frame was recorded.
+     */
+    double GetAverageFrameTime() const;
+
+    /**
+     * @brief Rebuilds the vertices of the overlay
+     * @param[in] viewportWidth Width of the viewport (in pixels)
+     * @param[in] viewportHeight Height of the viewport (in pixels)
+     * @param[in] lines Lines of text shown above the frame time graph. Only printable ASCII characters are drawn.
+     */
+    void Build(uint32_t viewportWidth, uint32_t viewportHeight, const std::vector<std::string> &lines);
+
+    /**
+     * @brief Gets the vertices built by the last call to Build(), as a triangle list
+     * @return Vertices of the overlay
+     */
+    const std::vector<HudVertex>& GetVertices() const;
+
+    /**
+     * @brief Packs a color into the format of the vertex colors
+     * @param[in] r Red
+     * @param[in] g Green
+     * @param[in] b Blue
+     * @param[in] a Alpha
+     * @return Packed color
+     */
+    static uint32_t PackColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+
+private:
+    /**
+     * @brief Adds an axis-aligned rectangle
+     * @param[in] x Left edge (in pixels from the left of the viewport)
+     * @param[in] y Top edge (in pixels from the top of the viewport)
+     * @param[in] width Width (in pixels)
+     * @param[in] height Height (in pixels)
+     * @param[in] color Packed color
+     */
+    void AddRect(float x, float y, float width, float height, uint32_t color);
+
+    /**
+     * @brief Adds a line of text
+     * @param[in] x Left edge of the first glyph (in pixels from the left of the viewport)
+     * @param[in] y Top edge of the glyphs (in pixels from the top of the viewport)
+     * @param[in] text Text to add
+     * @param[in] color Packed color
+     */
+    void AddText(float x, float y, const std::string &text, uint32_t color);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads that run a task in parallel on every worker.
+ * Each worker keeps its index for its whole lifetime, so per-thread resources
+ * (e.g. command pools) can be indexed by it without any further locking.
+ */
+class JobSystem
+{
+private:
+    std::vector<std::thread> m_workers;     // Worker threads
+    std::function<void(uint32_t)> m_task;   // Task of the current execution
+    uint64_t m_generation;                  // Number of executions started so far
+    uint32_t m_remainingWorkers;            // Number of workers that have not finished the current execution yet
+    bool m_isRunning;                       // Flag indicating whether the workers keep waiting for tasks
+
+    std::mutex m_mutex;                     // Mutex guarding the task and the counters
+    std::condition_variable m_taskReady;    // Notified when a new execution starts or the workers should stop
+    std::condition_variable m_taskDone;     // Notified when the last worker finished the current execution
+
+public:
+    /**
+     * @brief Constructor
+     */
+    JobSystem();
+
+    /**
+     * @brief Destructor
+     */
+    ~JobSystem();
+
+    /**
+     * @brief Starts the worker threads
+     * @param[in] workerCount Number of worker threads
+     */
+    void Start(uint32_t workerCount);
+
+    /**
+     * @brief Stops and joins the worker threads
+     */
+    void Stop();
+
+    /**
+     * @brief Runs the task once on every worker, and waits until all of them are done.
+     * Must only be called from one thread at a time.
+     * @param[in] task Task to run. Receives the index of the worker running it.
+     */
+    void Execute(const std::function<void(uint32_t)> &task);
+
+    /**
+     * @brief Gets the number of worker threads
+     * @return Number of worker threads
+     */
+    uint32_t GetWorkerCount() const;
+
+private:
+    /**
+     * @brief Worker thread function
+     * @param[in] workerIndex Index of the worker
+     * @param[in] startGeneration Number of executions started before the worker was started
+     */
+    void WorkerThreadFunc(uint32_t workerIndex, uint64_t startGeneration);
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Histogram of durations with a bounded relative error, in the style of HdrHistogram.
+ * Values below SUB_BUCKET_COUNT are counted exactly. Above that, every power of two is
+ * split into SUB_BUCKET_COUNT / 2 equal buckets, so percentiles are within about 3% of
+ * the recorded values, at a fixed memory cost independent of the number of values.
+ */
+class LatencyHistogram
+{
+private:
+    const uint32_t SUB_BUCKET_BITS = 6;                             // Bits of precision kept for each value
+    const uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;   // Number of exactly counted values
+    const uint32_t MAX_VALUE_BITS = 36;                             // Larger values are clamped (about 19 hours, in microseconds)
+
+    std::vector<uint64_t> m_counts;     // Number of values in each bucket
+    uint64_t m_totalCount;              // Number of recorded values
+    uint64_t m_minValue;                // Smallest recorded value
+    uint64_t m_maxValue;                // Largest recorded value
+    double m_sum;                       // Sum of the recorded values
+
+public:
+    /**
+     * @brief Constructor
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Destructor
+     */
+    ~LatencyHistogram();
+
+    /**
+     * @brief Records a value
+     * @param[in] microseconds Value to record
+     */
+    void Record(uint64_t microseconds);
+
+    /**
+     * @brief Removes all recorded values
+     */
+    void Reset();
+
+    /**
+     * @brief Gets the number of recorded values
+     * @return Number of recorded values
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * @brief Gets the smallest recorded value
+     * @return Smallest recorded value. 0 if nothing was recorded.
+     */
+    uint64_t GetMin() const;
+
+    /**
+     * @brief Gets the largest recorded value
+     * @return Largest recorded value. 0 if nothing was recorded.
+     */
+    uint64_t GetMax() const;
+
+    /**
+     * @brief Gets the mean of the recorded values
+     * @return Mean of the recorded values. 0 if nothing was recorded.
+     */
+    double GetMean() const;
+
+    /**
+     * @brief Gets the value that the given percentage of the recorded values are at or below
+     * @param[in] percentile Percentile, between 0 and 100
+     * @return Highest value of the bucket containing the percentile, clamped to the recorded range.
+     * 0 if nothing was recorded.
+     */
+    uint64_t GetValueAtPercentile(double percentile) const;
+
+private:
+    /**
+     * @brief Gets the bucket that a value is counted in
+     * @param[in] value Value
+     * @return Index of the bucket
+     */
+    size_t GetBucketIndex(uint64_t value) const;
+
+    /**
+     * @brief Gets the highest value counted in a bucket
+     * @param[in] bucketIndex Index of the bucket
+     * @return Highest value of the bucket
+     */
+    uint64_t GetBucketHighestValue(size_t bucketIndex) const;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Debug messages are compiled in unless disabled by the build, or in release builds
+#ifndef LOG_DEBUG_ENABLED
+#ifdef NDEBUG
+#define LOG_DEBUG_ENABLED 0
+#else
+#define LOG_DEBUG_ENABLED 1
+#endif
+#endif
+
+/**
+ * Logs a message built with stream insertions, e.g. LOG_INFO("Loaded " << count << " tiles").
+ * The message is only formatted if its level is enabled.
+ */
+#define LOG_MESSAGE(level, message) \
+    do \
+    { \
+        if (Logger::IsLevelEnabled(level)) \
+        { \
+            std::ostringstream logStream; \
+            logStream << message; \
+            Logger::Write(level, logStream.str()); \
+        } \
+    } while (false)
+
+#if LOG_DEBUG_ENABLED
+#define LOG_DEBUG(message) LOG_MESSAGE(Logger::Level::Debug, message)
+#else
+#define LOG_DEBUG(message) do { } while (false)
+#endif
+#define LOG_INFO(message) LOG_MESSAGE(Logger::Level::Info, message)
+#define LOG_WARNING(message) LOG_MESSAGE(Logger::Level::Warning, message)
+#define LOG_ERROR(message) LOG_MESSAGE(Logger::Level::Error, message)
+
+/**
+ * Asynchronous logger. Each thread writes its messages into its own lock-free
+ * single-producer ring buffer, which a background thread drains to the console,
+ * so logging neither serializes threads on a lock nor waits for the console.
+ * A thread whose buffer is full drops the message instead of waiting, and the
+ * number of dropped messages is reported. Until the background thread is started
+ * (and after it is stopped), messages are written directly.
+ */
+class Logger
+{
+public:
+    // Severity of a message
+    enum class Level
+    {
+        Debug = 0,  // Detailed diagnostics. Compiled out when LOG_DEBUG_ENABLED is 0.
+        Info,       // Progress and statistics. Written to the standard output.
+        Warning,    // Recoverable problems. Written to the standard error.
+        Error       // Failures. Written to the standard error.
+    };
+
+private:
+    static constexpr size_t MAX_MESSAGE_LENGTH = 512;   // Longer messages are truncated
+
+    // Message waiting to be written
+    struct Message
+    {
+        Level level;                        // Severity
+        int64_t timeNanoseconds;            // Time the message was logged, used to merge the messages of all threads
+        uint32_t length;                    // Number of characters in the text
+        char text[MAX_MESSAGE_LENGTH];      // Text, without a terminating newline
+    };
+
+    // Ring buffer of the messages of a single thread. Written only by its thread, read only by the drain thread.
+    struct ThreadBuffer
+    {
+        std::vector<Message> messages;      // Messages
+        std::atomic<uint64_t> writeCount;   // Number of messages written so far
+        std::atomic<uint64_t> readCount;    // Number of messages drained so far
+        std::atomic<uint64_t> droppedCount; // Number of messages dropped because the buffer was full
+    };
+
+    const size_t MESSAGES_PER_THREAD = 1024;        // Capacity of each thread's ring buffer
+    const uint32_t DRAIN_INTERVAL_MILLISECONDS = 10; // Time between drains of the ring buffers
+
+    std::atomic<int> m_minLevel;                                // Least severe level that is logged
+    std::atomic<bool> m_isRunning;                              // Flag indicating whether the drain thread is running
+    std::thread m_drainThread;                                  // Thread writing the buffered messages
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers; // Buffers of every thread that logged a message. Never removed, so that messages outlive their threads.
+    std::mutex m_threadBuffersMutex;                            // Mutex guarding the list of buffers
+    std::mutex m_outputMutex;                                   // Mutex serializing the writes to the console
+    std::mutex m_wakeMutex;                                     // Mutex used with the wake condition variable
+    std::condition_variable m_wakeCondition;                    // Wakes the drain thread before its interval elapses
+
+    static thread_local ThreadBuffer *s_currentThreadBuffer;    // Buffer of the current thread. nullptr until the thread logs its first message.
+
+public:
+    /**
+     * @brief Destructor
+     */
+    ~Logger();
+
+    /**
+     * @brief Starts the thread that writes the buffered messages
+     */
+    static void Start();
+
+    /**
+     * @brief Writes the remaining buffered messages and stops the drain thread.
+     * Messages logged afterwards are written directly.
+     */
+    static void Stop();
+
+    /**
+     * @brief Sets the least severe level that is logged
+     * @param[in] level Level
+     */
+    static void SetLevel(Level level);
+
+    /**
+     * @brief Checks whether messages of a level are logged
+     * @param[in] level Level
+     * @return Returns true if messages of the level are logged. Returns false otherwise.
+     */
+    static bool IsLevelEnabled(Level level);
+
+    /**
+     * @brief Logs a message. Use the LOG_* macros instead, so that disabled messages are not formatted.
+     * @param[in] level Severity of the message
+     * @param[in] text Text of the message, without a terminating newline
+     */
+    static void Write(Level level, const std::string &text);
+
+    /**
+     * @brief Parses the name of a level
+     * @param[in] name Name of the level (debug, info, warning or error)
+     * @param[out] outLevel Parsed level
+     * @return Returns true if the name is valid. Returns false otherwise.
+     */
+    static bool ParseLevel(const std::string &name, Level &outLevel);
+
+private:
+    /**
+     * @brief Constructor
+     */
+    Logger();
+
+    /**
+     * @brief Gets the singleton instance
+     * @return Singleton instance
+     */
+    static Logger& GetSingletonInstance();
+
+    /**
+     * @brief Gets the buffer of the current thread, creating it on first use
+     * @return Buffer of the current thread
+     */
+    ThreadBuffer& GetThreadBuffer();
+
+    /**
+     * @brief Function run by the drain thread
+     */
+    void DrainThreadFunc();
+
+    /**
+     * @brief Writes the buffered messages of every thread, oldest first
+     */
+    void Drain();
+
+    /**
+     * @brief Writes a message to the console stream of its level
+     * @param[in] level Severity of the message
+     * @param[in] text Text of the message
+     * @param[in] length Number of characters in the text
+     */
+    static void WriteToConsole(Level level, const char *text, size_t length);
+};
@@ -0,0 +1,91 @@
+#ifndef MPSC_QUEUE_HEADER
+#define MPSC_QUEUE_HEADER
+
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free queue with multiple producers and a single consumer.
+ * Producers never block each other or the consumer: pushing is a single atomic exchange.
+ */
+template <typename T>
+class MpscQueue
+{
+private:
+    // Node of the linked list. The consumer always owns one "stub" node whose value was already taken.
+    struct Node
+    {
+        std::atomic<Node*> next;    // Next node, written by the producer that pushed it
+        T value;                    // Value
+    };
+
+    std::atomic<Node*> m_head;      // Most recently pushed node. Shared by all producers.
+    Node *m_tail;                   // Stub node. Only accessed by the consumer.
+
+public:
+    /**
+     * @brief Constructor
+     */
+    MpscQueue()
+        : m_head(nullptr)
+        , m_tail(new Node())
+    {
+        m_tail->next.store(nullptr, std::memory_order_relaxed);
+        m_head.store(m_tail, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Destructor. No other thread may access the queue anymore.
+     */
+    ~MpscQueue()
+    {
+        while (m_tail != nullptr)
+        {
+            Node *next = m_tail->next.load(std::memory_order_relaxed);
+            delete m_tail;
+            m_tail = next;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Pushes a value to the queue. Can be called from any thread.
+     * @param[in] value Value to push
+     */
+    void Push(T value)
+    {
+        Node *node = new Node();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->value = std::move(value);
+
+        // Publish the node first, then link it. The consumer simply stops at
+        // a node that is published but not linked yet, and sees it next time.
+        Node *prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Pops the oldest value from the queue. Must only be called from the consumer thread.
+     * @param[out] outValue Popped value
+     * @return True if a value was popped. False if the queue is empty.
+     */
+    bool Pop(T &outValue)
+    {
+        Node *next = m_tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        // The popped node becomes the new stub
+        outValue = std::move(next->value);
+        next->value = T();
+        delete m_tail;
+        m_tail = next;
+        return true;
+    }
+};
+
+#endif // MPSC_QUEUE_HEADER
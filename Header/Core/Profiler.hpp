@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+/**
+ * Times the enclosing scope on the current thread. The name must be a string literal
+ * (or otherwise outlive the profiler), since only the pointer is stored.
+ */
+#define PROFILE_SCOPE(name) Profiler::ScopedTimer PROFILER_CONCAT(profileScope, __LINE__)(name)
+
+/**
+ * Lightweight frame profiler. Timed scopes are written into a ring buffer owned by
+ * the thread that ran them, so threads do not contend with each other, and only
+ * the most recent events are kept. GPU timings are added on a separate track.
+ * The events of every thread can be exported as Chrome trace-event JSON, which
+ * trace viewers such as chrome://tracing or Perfetto open directly.
+ */
+class Profiler
+{
+public:
+    // Timed scope
+    struct Event
+    {
+        const char *name;           // Name of the scope
+        int64_t startMicroseconds;  // Start time since the profiler epoch
+        int64_t durationMicroseconds;   // Duration
+    };
+
+    /**
+     * Times its own lifetime, if the profiler is enabled when it is constructed
+     */
+    class ScopedTimer
+    {
+    private:
+        const char *m_name;                                 // Name of the scope. nullptr if the profiler was disabled.
+        std::chrono::steady_clock::time_point m_startTime;  // Time the scope was entered
+
+    public:
+        /**
+         * @brief Constructor
+         * @param[in] name Name of the scope
+         */
+        ScopedTimer(const char *name);
+
+        /**
+         * @brief Destructor
+         */
+        ~ScopedTimer();
+    };
+
+private:
+    // Ring buffer of the events of a single thread
+    struct ThreadBuffer
+    {
+        uint32_t threadId;          // Id of the thread in the exported trace
+        std::string threadName;     // Name of the thread in the exported trace
+        std::mutex mutex;           // Mutex guarding the events against a concurrent export. Only contended while exporting.
+        std::vector<Event> events;  // Events, oldest overwritten first
+        size_t nextIndex;           // Index the next event is written to
+        size_t count;               // Number of valid events
+    };
+
+    const size_t EVENTS_PER_THREAD = 65536;    // Capacity of each thread's ring buffer
+
+    std::atomic<bool> m_enabled;                                // Flag indicating whether events are recorded
+    std::chrono::steady_clock::time_point m_epoch;              // Time that all event times are relative to
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers; // Buffers of every thread that recorded an event. Never removed, so that events outlive their threads.
+    std::unique_ptr<ThreadBuffer> m_gpuBuffer;                  // Buffer of the GPU track
+    std::mutex m_threadBuffersMutex;                            // Mutex guarding the list of buffers
+
+    static thread_local ThreadBuffer *s_currentThreadBuffer;    // Buffer of the current thread. nullptr until the thread records its first event.
+
+public:
+    /**
+     * @brief Destructor
+     */
+    ~Profiler();
+
+    /**
+     * @brief Enables or disables the recording of events. Recorded events are kept.
+     * @param[in] enabled Flag indicating whether events are recorded
+     */
+    static void SetEnabled(bool enabled);
+
+    /**
+     * @brief Checks whether events are recorded
+     * @return Returns true if events are recorded. Returns false otherwise.
+     */
+    static bool IsEnabled();
+
+    /**
+     * @brief Names the current thread in the exported trace
+     * @param[in] name Name of the thread
+     */
+    static void SetThreadName(const std::string &name);
+
+    /**
+     * @brief Records an event on the current thread, if the profiler is enabled
+     * @param[in] name Name of the event
+     * @param[in] startTime Start time
+     * @param[in] endTime End time
+     */
+    static void AddEvent(const char *name, std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime);
+
+    /**
+     * @brief Records an event on the GPU track, if the profiler is enabled
+     * @param[in] name Name of the event
+     * @param[in] startMicroseconds Start time since the profiler epoch
+     * @param[in] durationMicroseconds Duration
+     */
+    static void AddGpuEvent(const char *name, int64_t startMicroseconds, int64_t durationMicroseconds);
+
+    /**
+     * @brief Converts a point in time to the profiler timeline
+     * @param[in] time Point in time
+     * @return Time since the profiler epoch (in microseconds)
+     */
+    static int64_t ToMicroseconds(std::chrono::steady_clock::time_point time);
+
+    /**
+     * @brief Writes the recorded events of every thread as Chrome trace-event JSON
+     * @param[in] filePath Trace file
+     * @return Returns true if the file was written successfully. Returns false otherwise.
+     */
+    static bool ExportChromeTrace(const std::string &filePath);
+
+private:
+    /**
+     * @brief Constructor
+     */
+    Profiler();
+
+    /**
+     * @brief Gets the singleton instance
+     * @return Singleton instance
+     */
+    static Profiler& GetSingletonInstance();
+
+    /**
+     * @brief Gets the buffer of the current thread, creating it on first use
+     * @return Buffer of the current thread
+     */
+    ThreadBuffer& GetThreadBuffer();
+
+    /**
+     * @brief Creates an empty buffer
+     * @param[in] threadId Id of the thread in the exported trace
+     * @param[in] threadName Name of the thread in the exported trace
+     * @return Created buffer
+     */
+    std::unique_ptr<ThreadBuffer> CreateBuffer(uint32_t threadId, const std::string &threadName) const;
+
+    /**
+     * @brief Writes an event into a buffer, overwriting the oldest event if it is full
+     * @param[in] buffer Buffer to write to
+     * @param[in] event Event to write
+     */
+    static void PushEvent(ThreadBuffer &buffer, const Event &event);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+/**
+ * First-fit allocator of contiguous ranges within a fixed-size space, e.g. the
+ * vertices of a vertex buffer. Freed ranges are merged with their free neighbors.
+ */
+class RangeAllocator
+{
+private:
+    uint32_t m_capacity;                        // Size of the whole space
+    uint32_t m_allocatedSize;                   // Total size of the allocated ranges
+    std::map<uint32_t, uint32_t> m_freeRanges;  // Free ranges (offset -> size), sorted by offset
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] capacity Size of the whole space
+     */
+    RangeAllocator(uint32_t capacity);
+
+    /**
+     * @brief Destructor
+     */
+    ~RangeAllocator();
+
+    /**
+     * @brief Allocates a contiguous range
+     * @param[in] size Size of the range
+     * @param[out] outOffset Offset of the allocated range
+     * @return Returns true if the allocation was successful. Returns false if there is no free range large enough.
+     */
+    bool Allocate(uint32_t size, uint32_t &outOffset);
+
+    /**
+     * @brief Frees a range previously returned by Allocate()
+     * @param[in] offset Offset of the range
+     * @param[in] size Size of the range
+     */
+    void Free(uint32_t offset, uint32_t size);
+
+    /**
+     * @brief Frees all ranges
+     */
+    void Reset();
+
+    /**
+     * @brief Gets the total size of the allocated ranges
+     * @return Allocated size
+     */
+    uint32_t GetAllocatedSize() const;
+
+    /**
+     * @brief Gets the size of the largest free range
+     * @return Size of the largest free range
+     */
+    uint32_t GetLargestFreeRange() const;
+};
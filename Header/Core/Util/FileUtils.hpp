@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -12,5 +13,15 @@ namespace FileUtils
      * @return Returns true if the file was successfully read. Returns false otherwise.
      */
     extern bool ReadFileAsBinary(const std::string& filePath, std::vector<char>& outFileContents);
+
+    /**
+     * @brief Write an 8-bit RGB image to the specified file in the binary PPM format.
+     * @param[in] filePath File path
+     * @param[in] width Width of the image in pixels
+     * @param[in] height Height of the image in pixels
+     * @param[in] rgbPixels Pixels of the image, row by row from the top, 3 bytes per pixel
+     * @return Returns true if the file was successfully written. Returns false otherwise.
+     */
+    extern bool WriteImageAsPPM(const std::string& filePath, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgbPixels);
 }
 
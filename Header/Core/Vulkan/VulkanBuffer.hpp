@@ -27,9 +27,11 @@ public:
      * @param[in] bufferSize Buffer size
      * @param[in] usageFlags Vulkan flags describing how the buffer will be used
      * @param[in] memoryProperties Vulkan memory properties on how the buffer should be allocated in memory
+     * @param[in] queueFamilyIndices Queue families that access the buffer. If these are several distinct
+     * families, the buffer is shared between them concurrently. Otherwise, it is exclusive to one family.
      * @return Returns true if the creation was successful. Returns false otherwise.
      */
-    bool Create(VkDeviceSize bufferSize, VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties);
+    bool Create(VkDeviceSize bufferSize, VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties, const std::vector<uint32_t> &queueFamilyIndices = {});
 
     /**
      * @brief Maps GPU memory allocated for this buffer to a memory location in RAM
@@ -65,6 +67,11 @@ private:
      */
     VkDeviceMemory m_vkMemory;
 
+    /**
+     * Size of the memory allocated for this buffer
+     */
+    VkDeviceSize m_memorySize;
+
 private:
     /**
      * @brief Find the index of a suitable memory type given the requirements
@@ -0,0 +1,54 @@
+#ifndef VULKAN_COMPUTE_PIPELINE_BUILDER_HEADER
+#define VULKAN_COMPUTE_PIPELINE_BUILDER_HEADER
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+#include <vector>
+
+/**
+ * Builder class for a Vulkan compute pipeline
+ */
+class VulkanComputePipelineBuilder
+{
+private:
+    VkPipelineLayout m_pipelineLayout;
+    VkPipeline m_pipeline;
+    VkPipelineCache m_pipelineCache;
+
+    VkPipelineLayoutCreateInfo m_pipelineLayoutCreateInfo;
+    VkPipelineShaderStageCreateInfo m_computeShaderCreateInfo;
+
+    std::string m_computeShaderFilePath;
+
+public:
+    VulkanComputePipelineBuilder();
+    ~VulkanComputePipelineBuilder();
+
+    // --- Pipeline layout ---
+    VulkanComputePipelineBuilder& SetDescriptorSetLayouts(const std::vector<VkDescriptorSetLayout> &layouts);
+    VulkanComputePipelineBuilder& SetPushConstantRanges(const std::vector<VkPushConstantRange> &ranges);
+
+    // --- Shaders ---
+    VulkanComputePipelineBuilder& SetComputeShaderFilePath(const std::string &computeShaderFilePath);
+
+    // --- Pipeline cache ---
+    VulkanComputePipelineBuilder& SetPipelineCache(const VkPipelineCache &pipelineCache);
+
+    bool Build();
+
+    VkPipelineLayout GetPipelineLayout();
+    VkPipeline GetPipeline();
+
+private:
+    /**
+     * @brief Create a shader module from the provided shader file path.
+     * @param[in] shaderFilePath Shader file path
+     * @param[in] device Logical device
+     * @param[out] outShaderModule Shader module
+     * @return Returns true if the shader module creation was successful. Returns false otherwise.
+     */
+    bool CreateShaderModule(const std::string& shaderFilePath, VkDevice device, VkShaderModule& outShaderModule);
+};
+
+#endif // VULKAN_COMPUTE_PIPELINE_BUILDER_HEADER
@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
 #include <optional>
 #include <vector>
 
@@ -22,7 +23,7 @@ public:
 
     /**
      * @brief Initializes the Vulkan manager.
-     * @param[in] window GLFW window
+     * @param[in] window GLFW window. If nullptr, the context is headless and has no surface to present to.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     static bool Initialize(GLFWwindow* window);
@@ -68,6 +69,13 @@ public:
      */
     static VkQueue GetPresentQueue();
 
+    /**
+     * @brief Gets the Vulkan transfer queue. This is a queue of a dedicated transfer
+     * queue family if the device has one, so that uploads can overlap rendering.
+     * @return Returns the Vulkan transfer queue.
+     */
+    static VkQueue GetTransferQueue();
+
     /**
      * @brief Gets the index of the graphics queue family.
      * @return Returns the index of the graphics queue family.
@@ -80,6 +88,42 @@ public:
      */
     static uint32_t GetPresentQueueIndex();
 
+    /**
+     * @brief Gets the index of the transfer queue family.
+     * @return Returns the index of the transfer queue family.
+     */
+    static uint32_t GetTransferQueueIndex();
+
+    /**
+     * @brief Gets the physical device features that were enabled on the logical device.
+     * @return Returns the enabled physical device features.
+     */
+    static const VkPhysicalDeviceFeatures& GetEnabledFeatures();
+
+    /**
+     * @brief Checks whether timeline semaphores were enabled on the logical device.
+     * @return Returns true if timeline semaphores can be used. Returns false otherwise.
+     */
+    static bool IsTimelineSemaphoreEnabled();
+
+    /**
+     * @brief Records that device memory was allocated. Called by the buffer and image classes.
+     * @param[in] size Size of the allocation
+     */
+    static void AddAllocatedMemory(VkDeviceSize size);
+
+    /**
+     * @brief Records that device memory was freed. Called by the buffer and image classes.
+     * @param[in] size Size of the freed allocation
+     */
+    static void RemoveAllocatedMemory(VkDeviceSize size);
+
+    /**
+     * @brief Gets the total size of the device memory allocated by the buffer and image classes.
+     * @return Size of the allocated memory (in bytes)
+     */
+    static VkDeviceSize GetAllocatedMemorySize();
+
 private:
     /**
      * Struct containing the indices for each queue type
@@ -95,6 +139,12 @@ private:
          * Present queue family index
          */
         std::optional<uint32_t> presentQueueFamilyIndex;
+
+        /**
+         * Transfer queue family index. Families that only support transfers are preferred,
+         * followed by families without graphics support, and finally the graphics family.
+         */
+        std::optional<uint32_t> transferQueueFamilyIndex;
     };
 
 private:
@@ -133,6 +183,27 @@ private:
      */
     VkQueue m_vkPresentQueue;
 
+    /**
+     * Vulkan transfer queue
+     */
+    VkQueue m_vkTransferQueue;
+
+    /**
+     * Physical device features enabled on the logical device
+     */
+    VkPhysicalDeviceFeatures m_enabledFeatures;
+
+    /**
+     * Flag indicating whether timeline semaphores were enabled on the logical device
+     */
+    bool m_timelineSemaphoreEnabled;
+
+    /**
+     * Total size of the device memory allocated by the buffer and image classes.
+     * Buffers can be created from any thread.
+     */
+    std::atomic<VkDeviceSize> m_allocatedMemorySize;
+
 private:
     /**
      * @brief Constructor
@@ -147,7 +218,7 @@ private:
 
     /**
      * @brief Initialization code implemented as a member function.
-     * @param[in] window GLFW window
+     * @param[in] window GLFW window. If nullptr, the context is headless and has no surface to present to.
      * @return Returns true if the initialization was successful. Returns false otherwise.
      */
     bool InitInternal(GLFWwindow* window);
@@ -158,13 +229,14 @@ private:
     void CleanupInternal();
 
     /**
-     * @brief Gets the first graphics card that is suitable for our application.
+     * @brief Gets the most suitable graphics card for our application. Discrete GPUs are preferred,
+     * followed by integrated GPUs, virtual GPUs, and finally software (CPU) implementations.
      * @param[in] instance Vulkan instance
      * @param[in] requiredExtensions Required extensions if any
      * @return Returns the handle to the graphics card that we found suitable. If a suitable
      * device was not found, returns VK_NULL_HANDLE.
      */
-    VkPhysicalDevice GetFirstSuitablePhysicalDevice(const VkInstance& instance, const std::vector<const char*>& requiredExtensions);
+    VkPhysicalDevice GetMostSuitablePhysicalDevice(const VkInstance& instance, const std::vector<const char*>& requiredExtensions);
 
     /**
      * @brief Checks whether the physical device supports all the provided extensions identified by
@@ -175,6 +247,13 @@ private:
      */
     bool CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice, const std::vector<const char*>& extensionNames);
 
+    /**
+     * @brief Checks whether all the provided instance layers are installed.
+     * @param[in] layerNames List of layer names to check support
+     * @return Returns true if all the provided layers are supported. Returns false otherwise.
+     */
+    bool CheckInstanceLayerSupport(const std::vector<const char*>& layerNames);
+
     /**
      * @brief Gets the indices of each queue type in the physical device's queue family.
      * @param[in] physicalDevice Physical device
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Measures named zones of the graphics queue's work with timestamp queries.
+ * Each frame in flight has its own range of queries, which is read back once the
+ * frame's fence was waited on, so reading the results never stalls.
+ * Zone times are mapped onto the CPU timeline of the profiler, using a single
+ * calibration at creation, so that they line up with the CPU events in a trace.
+ */
+class VulkanGpuTimer
+{
+public:
+    // Measured zone
+    struct ZoneResult
+    {
+        const char *name;               // Name of the zone
+        int64_t startMicroseconds;      // Start time on the profiler timeline
+        double durationMilliseconds;    // Duration
+    };
+
+private:
+    // Zone written into the commands of a frame
+    struct Zone
+    {
+        const char *name;               // Name of the zone
+        uint32_t firstQuery;            // Query of the start timestamp. The end timestamp is the next query.
+    };
+
+    // Zones of a single frame in flight
+    struct FrameZones
+    {
+        std::vector<Zone> zones;        // Zones written into the frame's commands
+        uint64_t frameNumber;           // Number of the frame that wrote the zones
+        bool isSubmitted;               // Flag indicating whether the commands with the zones were submitted
+    };
+
+    VkQueryPool m_queryPool;            // Query pool with a range of queries per frame in flight
+    uint32_t m_maxZonesPerFrame;        // Maximum number of zones per frame
+    double m_timestampPeriod;           // Nanoseconds per timestamp tick
+    uint64_t m_timestampMask;           // Mask of the valid timestamp bits
+    uint64_t m_calibrationTimestamp;    // Timestamp written at the calibration
+    int64_t m_calibrationMicroseconds;  // Profiler time matching the calibration timestamp
+    std::vector<FrameZones> m_frames;   // Zones of each frame in flight
+
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanGpuTimer();
+
+    /**
+     * @brief Destructor
+     */
+    ~VulkanGpuTimer();
+
+    /**
+     * @brief Creates the query pool, and calibrates the timestamps against the CPU clock
+     * by submitting a timestamp to the graphics queue and waiting for it.
+     * @param[in] frameCount Number of frames in flight
+     * @param[in] maxZonesPerFrame Maximum number of zones per frame
+     * @return Returns true if the creation was successful. Returns false otherwise,
+     * e.g. if the graphics queue does not support timestamps.
+     */
+    bool Create(uint32_t frameCount, uint32_t maxZonesPerFrame);
+
+    /**
+     * @brief Cleans up all resources used by the timer.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Checks whether the timer was created successfully
+     * @return Returns true if zones can be measured. Returns false otherwise.
+     */
+    bool IsAvailable() const;
+
+    /**
+     * @brief Resets the queries of a frame in flight. Must be recorded before any zone of the frame,
+     * outside of a render pass, and after the results of the frame's previous commands were read.
+     * @param[in] commandBuffer Command buffer of the frame
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] frameNumber Number of the frame
+     */
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint64_t frameNumber);
+
+    /**
+     * @brief Writes the start timestamp of a zone
+     * @param[in] commandBuffer Command buffer of the frame
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] name Name of the zone. Must outlive the timer.
+     * @return Index of the zone, to end it with. UINT32_MAX if the frame has no queries left.
+     */
+    uint32_t BeginZone(VkCommandBuffer commandBuffer, uint32_t frameIndex, const char *name);
+
+    /**
+     * @brief Writes the end timestamp of a zone
+     * @param[in] commandBuffer Command buffer of the frame
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[in] zoneIndex Index of the zone returned when it was started
+     */
+    void EndZone(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t zoneIndex);
+
+    /**
+     * @brief Marks the commands of a frame as submitted, so that their results are read back
+     * @param[in] frameIndex Index of the frame in flight
+     */
+    void SetSubmitted(uint32_t frameIndex);
+
+    /**
+     * @brief Reads back the zones of the frame's last submitted commands, once. Must only be called
+     * after the frame's fence was waited on.
+     * @param[in] frameIndex Index of the frame in flight
+     * @param[out] outFrameNumber Number of the frame that wrote the zones
+     * @param[out] outResults Measured zones
+     * @return Returns true if there were results to read. Returns false otherwise.
+     */
+    bool GetResults(uint32_t frameIndex, uint64_t &outFrameNumber, std::vector<ZoneResult> &outResults);
+
+private:
+    /**
+     * @brief Writes a timestamp and waits for it, to pair a timestamp value with a CPU time
+     * @param[in] queueFamilyIndex Queue family of the graphics queue
+     * @return Returns true if the calibration was successful. Returns false otherwise.
+     */
+    bool Calibrate(uint32_t queueFamilyIndex);
+};
@@ -14,6 +14,7 @@ class VulkanGraphicsPipelineBuilder
 private:
     VkPipelineLayout m_pipelineLayout;
     VkPipeline m_pipeline;
+    VkPipelineCache m_pipelineCache;
 
     // Create info structs for each pipeline stage
     VkPipelineVertexInputStateCreateInfo m_vertexInputCreateInfo;
@@ -27,6 +28,8 @@ private:
     VkPipelineLayoutCreateInfo m_pipelineLayoutCreateInfo;
     VkPipelineShaderStageCreateInfo m_vertexShaderCreateInfo;
     VkPipelineShaderStageCreateInfo m_fragmentShaderCreateInfo;
+    VkSpecializationInfo m_vertexSpecializationInfo;
+    VkSpecializationInfo m_fragmentSpecializationInfo;
 
     VkPipelineColorBlendAttachmentState m_colorBlendAttachment;
 
@@ -65,6 +68,7 @@ public:
     VulkanGraphicsPipelineBuilder& SetDepthCompareOp(const VkCompareOp &compareOp);
 
     // --- Color blending ---
+    VulkanGraphicsPipelineBuilder& SetAlphaBlendingEnabled(const VkBool32 &flag);
 
     // --- Dynamic state ---
     VulkanGraphicsPipelineBuilder& SetDynamicStates(const std::vector<VkDynamicState> &dynamicStates);
@@ -77,9 +81,17 @@ public:
     VulkanGraphicsPipelineBuilder& SetVertexShaderFilePath(const std::string &vertexShaderFilePath);
     VulkanGraphicsPipelineBuilder& SetFragmentShaderFilePath(const std::string &fragmentShaderFilePath);
 
+    // --- Specialization constants ---
+    // (The map entries and data are only referenced, so they have to stay alive until Build() is called)
+    VulkanGraphicsPipelineBuilder& SetVertexShaderSpecialization(const std::vector<VkSpecializationMapEntry> &mapEntries, const void *data, size_t dataSize);
+    VulkanGraphicsPipelineBuilder& SetFragmentShaderSpecialization(const std::vector<VkSpecializationMapEntry> &mapEntries, const void *data, size_t dataSize);
+
     // --- Render pass ---
     VulkanGraphicsPipelineBuilder& SetRenderPass(const VkRenderPass &renderPass);
 
+    // --- Pipeline cache ---
+    VulkanGraphicsPipelineBuilder& SetPipelineCache(const VkPipelineCache &pipelineCache);
+
     bool Build();
 
     VkPipelineLayout GetPipelineLayout();
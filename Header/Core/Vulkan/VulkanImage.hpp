@@ -56,6 +56,11 @@ private:
      */
     VkDeviceMemory m_vkMemory;
 
+    /**
+     * Size of the memory allocated for this image
+     */
+    VkDeviceSize m_memorySize;
+
     /**
      * @brief Find the index of a suitable memory type given the requirements
      * @param[in] memoryTypeBits Flag containing the supported memory types
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Pipeline cache that is persisted to disk between runs. The cache data is only
+ * loaded if it was saved on the same device with the same driver version, since
+ * the driver would not be able to use it otherwise. Pipeline creation with the
+ * cache can happen from multiple threads at once.
+ */
+class VulkanPipelineCache
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanPipelineCache();
+
+    /**
+     * @brief Destructor
+     */
+    ~VulkanPipelineCache();
+
+    /**
+     * @brief Creates the pipeline cache, with the data of the cache file if it is valid for the current device.
+     * @param[in] filePath Path of the cache file
+     * @return Returns true if the creation was successful, even if the cache file was missing or invalid.
+     * Returns false otherwise.
+     */
+    bool Create(const std::string &filePath);
+
+    /**
+     * @brief Writes the data of the pipeline cache to the cache file
+     * @return Returns true if the data was written successfully. Returns false otherwise.
+     */
+    bool Save();
+
+    /**
+     * @brief Cleans up all resources used by the pipeline cache.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Gets the handle to the pipeline cache
+     * @return Returns the pipeline cache
+     */
+    VkPipelineCache GetHandle() const;
+
+    /**
+     * @brief Gets the size of the data that was loaded from the cache file
+     * @return Size of the loaded data in bytes. 0 if the cache file was missing or invalid.
+     */
+    size_t GetLoadedDataSize() const;
+
+private:
+    // Header written in front of the cache data, identifying the device and driver that produced it
+    struct FileHeader
+    {
+        uint32_t magic;                             // Identifies the file as a pipeline cache of this application
+        uint32_t fileVersion;                       // Version of the file layout
+        uint32_t vendorID;                          // Vendor of the device
+        uint32_t deviceID;                          // Device
+        uint32_t driverVersion;                     // Version of the driver
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];    // Pipeline cache UUID reported by the driver
+        uint64_t dataSize;                          // Size of the cache data following the header
+    };
+
+    const uint32_t FILE_MAGIC = 0x4D565043;         // "MVPC"
+    const uint32_t FILE_VERSION = 1;
+
+    VkPipelineCache m_vkPipelineCache;  // Pipeline cache
+    std::string m_filePath;             // Path of the cache file
+    size_t m_loadedDataSize;            // Size of the data that was loaded from the cache file
+
+private:
+    /**
+     * @brief Fills in a file header for the current device
+     * @param[out] outHeader File header
+     */
+    void GetDeviceHeader(FileHeader &outHeader) const;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Core/Vulkan/VulkanBuffer.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+
+/**
+ * Persistently mapped uniform buffer that is split into one slice per frame in flight.
+ * Each slice is sub-allocated linearly, and allocations are meant to be bound
+ * through VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptors using the returned offsets.
+ */
+class VulkanUniformBufferRing
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanUniformBufferRing();
+
+    /**
+     * @brief Destructor
+     */
+    ~VulkanUniformBufferRing();
+
+    /**
+     * @brief Creates the ring buffer and maps its memory for the lifetime of the ring.
+     * @param[in] numFrames Number of frame slices
+     * @param[in] frameSize Size of each frame slice in bytes
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool Create(uint32_t numFrames, VkDeviceSize frameSize);
+
+    /**
+     * @brief Cleans up all resources used by the ring buffer.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Starts sub-allocating from the slice of the specified frame.
+     * Must only be called once the GPU is done with the previous use of that frame.
+     * @param[in] frameIndex Index of the frame
+     */
+    void BeginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief Sub-allocates a block from the current frame slice.
+     * @param[in] size Size of the block in bytes
+     * @param[out] outDynamicOffset Offset of the block from the start of the buffer, to be used as a dynamic offset
+     * @return Returns a pointer to the mapped memory of the block. Returns nullptr if the current frame slice is full.
+     */
+    void* Allocate(VkDeviceSize size, uint32_t &outDynamicOffset);
+
+    /**
+     * @brief Sub-allocates a block large enough for an object of type T from the current frame slice.
+     * @param[out] outDynamicOffset Offset of the block from the start of the buffer, to be used as a dynamic offset
+     * @return Returns a pointer to the mapped memory of the block. Returns nullptr if the current frame slice is full.
+     */
+    template <typename T>
+    T* Allocate(uint32_t &outDynamicOffset)
+    {
+        return reinterpret_cast<T*>(Allocate(sizeof(T), outDynamicOffset));
+    }
+
+    /**
+     * @brief Gets the native Vulkan handle for the underlying buffer
+     * @return Returns the native Vulkan handle for the underlying buffer
+     */
+    VkBuffer GetHandle();
+
+    /**
+     * @brief Gets the alignment that all allocations are rounded up to
+     * @return Returns the allocation alignment in bytes
+     */
+    VkDeviceSize GetAlignment() const;
+
+private:
+    VulkanBuffer m_buffer;          // Underlying uniform buffer
+    uint8_t *m_mappedMemory;        // Pointer to the persistently mapped memory of the buffer
+
+    VkDeviceSize m_alignment;       // Alignment of each allocation (minUniformBufferOffsetAlignment)
+    VkDeviceSize m_frameSize;       // Size of each frame slice, rounded up to the alignment
+    uint32_t m_numFrames;           // Number of frame slices
+
+    VkDeviceSize m_frameStart;      // Start of the current frame slice
+    VkDeviceSize m_frameCursor;     // Offset of the next free byte in the current frame slice
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Core/Vulkan/VulkanBuffer.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * Streams data into device-local buffers through the transfer queue.
+ * Data is written into a persistently mapped staging ring buffer, and the copies are
+ * submitted in batches that each signal the next value of a timeline semaphore.
+ * Consumers wait on that value only for submissions that use the uploaded data
+ * before the host has observed that the copy finished.
+ */
+class VulkanUploadEngine
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanUploadEngine();
+
+    /**
+     * @brief Destructor
+     */
+    ~VulkanUploadEngine();
+
+    /**
+     * @brief Creates the staging buffer, command pool, and timeline semaphore.
+     * Requires timeline semaphores to be enabled on the logical device.
+     * @param[in] stagingBufferSize Size of the staging ring buffer in bytes
+     * @return Returns true if the creation was successful. Returns false otherwise.
+     */
+    bool Create(VkDeviceSize stagingBufferSize);
+
+    /**
+     * @brief Cleans up all resources used by the upload engine.
+     * The transfer queue must be idle.
+     */
+    void Cleanup();
+
+    /**
+     * @brief Queues a copy of data into a buffer. The data is written into the staging buffer
+     * by the provided function, and copied once the batch is submitted. Can be called from any thread.
+     * @param[in] dstBuffer Buffer to copy the data to
+     * @param[in] dstOffset Offset in the destination buffer
+     * @param[in] size Size of the data in bytes
+     * @param[in] writeFunc Function that writes the data to the provided staging memory
+     * @return Returns true if the copy was queued. Returns false if the staging buffer
+     * has no room for the data until earlier copies finish.
+     */
+    bool Upload(VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, const std::function<void(void*)> &writeFunc);
+
+    /**
+     * @brief Records and submits all queued copies to the transfer queue. Can be called from
+     * any thread, but must not race with other submissions to the same queue.
+     * @param[out] outSignalValue Timeline value that is signaled once the copies finish
+     * @return Returns true if the submission was successful, or if there was nothing to submit.
+     * Returns false otherwise.
+     */
+    bool Submit(uint64_t &outSignalValue);
+
+    /**
+     * @brief Gets the timeline value of the latest finished submission, and recycles
+     * the staging memory and command buffers of all finished submissions.
+     * @return Returns the latest timeline value that the transfer queue has signaled.
+     */
+    uint64_t GetCompletedValue();
+
+    /**
+     * @brief Gets the timeline semaphore signaled by the submissions
+     * @return Returns the timeline semaphore
+     */
+    VkSemaphore GetTimelineSemaphore() const;
+
+private:
+    // Copy waiting for the next submission
+    struct PendingCopy
+    {
+        VkBuffer dstBuffer;         // Buffer to copy to
+        VkBufferCopy region;        // Source (staging) and destination range
+    };
+
+    // Submission that the transfer queue may still be working on
+    struct InFlightSubmission
+    {
+        uint64_t signalValue;           // Timeline value signaled once the submission finishes
+        VkDeviceSize stagingBytes;      // Staging bytes used by the submission, including padding from wrapping around
+        VkCommandBuffer commandBuffer;  // Command buffer of the submission
+    };
+
+    const VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    VulkanBuffer m_stagingBuffer;       // Host-visible staging ring buffer
+    uint8_t *m_stagingMemory;           // Pointer to the persistently mapped memory of the staging buffer
+    VkDeviceSize m_stagingSize;         // Size of the staging buffer
+    VkDeviceSize m_stagingHead;         // Offset of the next free byte in the staging buffer
+    VkDeviceSize m_stagingUsedBytes;    // Staging bytes that are queued or in flight
+    VkDeviceSize m_pendingStagingBytes; // Staging bytes used by the queued copies
+
+    VkCommandPool m_vkCommandPool;                          // Command pool of the transfer queue family
+    std::vector<VkCommandBuffer> m_freeCommandBuffers;      // Command buffers that are not in flight
+    VkSemaphore m_vkTimelineSemaphore;                      // Timeline semaphore signaled by the submissions
+    uint64_t m_lastSignalValue;                             // Timeline value of the latest submission
+
+    std::vector<PendingCopy> m_pendingCopies;               // Copies waiting for the next submission
+    std::deque<InFlightSubmission> m_inFlightSubmissions;   // Submissions that may not be finished yet, oldest first
+
+    std::mutex m_mutex;                                     // Mutex guarding the whole upload engine
+
+private:
+    /**
+     * @brief Recycles the resources of the finished submissions. Must be called with the lock held.
+     * @return Returns the latest timeline value that the transfer queue has signaled.
+     */
+    uint64_t RecycleFinishedSubmissions();
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_core.h>
+
+#include <vector>
+
+/**
+ * Vertex input layout of the Vertex struct. The vertex is split into two streams:
+ * the position (binding 0) and the rest of the attributes (binding 1), so that
+ * passes that only need positions fetch only those.
+ */
+class VulkanVertexLayout
+{
+public:
+    /**
+     * @brief Gets the list of binding descriptions for a vertex
+     * @param[in] positionsOnly Flag indicating whether only the position stream is bound
+     * @return List of binding descriptions for a vertex
+     */
+    static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions(bool positionsOnly = false);
+
+    /**
+     * @brief Gets the list of attribute descriptions for a vertex
+     * @param[in] positionsOnly Flag indicating whether only the position is read
+     * @return List of attribute descriptions for a vertex
+     */
+    static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions(bool positionsOnly = false);
+};
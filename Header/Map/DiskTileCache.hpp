@@ -0,0 +1,132 @@
+#ifndef DISK_TILE_CACHE_HEADER
+#define DISK_TILE_CACHE_HEADER
+
+#include "Map/OSMXmlParser.hpp"
+#include "Map/TileCacheLayer.hpp"
+#include "Map/TileData.hpp"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+
+/**
+ * Cache layer that keeps one file per tile in a directory. Tiles are stored either as the
+ * OSM XML they were downloaded as (map_<zoom>-<x>-<y>.osm, the format of the bundled tiles),
+ * or in the binary encoding of TileDataSerializer (map_<zoom>-<x>-<y>.tile), which skips the
+ * XML parse and node join when the tile is read back.
+ */
+class DiskTileCache : public TileCacheLayer
+{
+public:
+    // Format of the tile files
+    enum class Format
+    {
+        OsmXml = 0,     // OSM XML, as downloaded
+        Binary          // Encoded by TileDataSerializer
+    };
+
+private:
+    std::string m_directory;    // Directory containing the tile files
+    Format m_format;            // Format of the tile files
+    OSMXmlParser m_parser;      // Parser of the OSM XML tile files
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] directory Directory containing the tile files
+     * @param[in] format Format of the tile files
+     * @param[in] next Data source behind the layer. nullptr if there is none.
+     * @param[in] writeBackPolicy When tiles are kept in the layer
+     */
+    DiskTileCache(const std::string &directory, Format format, std::unique_ptr<TileDataSource> next, WriteBackPolicy writeBackPolicy);
+
+    /**
+     * @brief Destructor
+     */
+    ~DiskTileCache();
+
+    /**
+     * @brief Retrieves the tile as OSM XML. An OSM XML tile file is read as it is.
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outXmlText OSM XML of the tile
+     * @return True if the operation was successful. False if no data source has OSM XML of the tile.
+     */
+    bool RetrieveOsmXml(const glm::ivec2 &tileIndex, const int &zoomLevel, std::string &outXmlText) override;
+
+    /**
+     * @brief Gets a short description of the data source, used in the statistics
+     * @return Name of the data source
+     */
+    std::string GetName() const override;
+
+protected:
+    /**
+     * @brief Queries whether the layer itself has the tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return True if the layer has the tile
+     */
+    bool HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Reads and decodes a tile file
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the loaded tile data
+     * @return True if the operation was successful.
+     */
+    bool Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) override;
+
+    /**
+     * @brief Writes a tile file in the binary format. Decoded tiles cannot be turned back into
+     * OSM XML, so this fails for the OSM XML format.
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[in] tileData Tile data to keep
+     * @return True if the operation was successful.
+     */
+    bool Store(const glm::ivec2 &tileIndex, const int &zoomLevel, const TileData &tileData) override;
+
+    /**
+     * @brief Retrieves a tile the layer does not have from the next data source, and keeps it
+     * in the layer unless the write-back policy is Never. The OSM XML format keeps the XML of
+     * the next data source as it is, if the next data source has XML.
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the retrieved tile data. nullptr when
+     * prefetching, in which case the tile only needs to be kept.
+     * @return True if the operation was successful.
+     */
+    bool Fill(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData *outTileData) override;
+
+private:
+    /**
+     * @brief Gets the path of the file of a tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return File path for the specified tile index and zoom level
+     */
+    std::string GetTileFilePath(const glm::ivec2 &tileIndex, const int &zoomLevel) const;
+
+    /**
+     * @brief Reads a tile file, and records the time as the disk read stage
+     * @param[in] filePath Path of the file
+     * @param[out] outContents Contents of the file
+     * @return True if the file was read.
+     */
+    bool ReadTileFile(const std::string &filePath, std::string &outContents);
+
+    /**
+     * @brief Writes a tile file. The file is written under a temporary name first, so that
+     * a reader never sees a partially written file. The temporary name is unique to the
+     * calling thread, so that threads writing the same tile do not write into each other's file.
+     * @param[in] filePath Path of the file
+     * @param[in] contents Contents of the file
+     * @return True if the file was written.
+     */
+    bool WriteTileFile(const std::string &filePath, const std::string &contents);
+};
+
+#endif // DISK_TILE_CACHE_HEADER
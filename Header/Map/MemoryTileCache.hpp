@@ -0,0 +1,85 @@
+#ifndef MEMORY_TILE_CACHE_HEADER
+#define MEMORY_TILE_CACHE_HEADER
+
+#include "Map/TileCacheLayer.hpp"
+#include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Cache layer that keeps the decoded data of the most recently used tiles in memory,
+ * so that revisiting a tile skips the disk read and the decode. The cache is shared by
+ * all threads using the hierarchy.
+ */
+class MemoryTileCache : public TileCacheLayer
+{
+private:
+    // Tile kept in the cache
+    struct Entry
+    {
+        TileData tileData;                                  // Decoded tile data
+        std::list<TileKey>::iterator recentUseIterator;     // Position of the tile in the recent use list
+    };
+
+    mutable std::mutex m_mutex;         // Mutex guarding the kept tiles
+    size_t m_capacity;                  // Maximum number of tiles kept
+    std::map<TileKey, Entry> m_entries; // Tiles kept in the cache
+    std::list<TileKey> m_recentUse;     // Tiles kept in the cache, from the most to the least recently used
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] capacity Maximum number of tiles kept
+     * @param[in] next Data source behind the layer. nullptr if there is none.
+     * @param[in] writeBackPolicy When tiles are kept in the layer
+     */
+    MemoryTileCache(size_t capacity, std::unique_ptr<TileDataSource> next, WriteBackPolicy writeBackPolicy);
+
+    /**
+     * @brief Destructor
+     */
+    ~MemoryTileCache();
+
+    /**
+     * @brief Gets a short description of the data source, used in the statistics
+     * @return Name of the data source
+     */
+    std::string GetName() const override;
+
+protected:
+    /**
+     * @brief Queries whether the layer itself has the tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return True if the layer has the tile
+     */
+    bool HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Loads a tile the layer has, and marks it as the most recently used
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the loaded tile data
+     * @return True if the operation was successful.
+     */
+    bool Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) override;
+
+    /**
+     * @brief Keeps a tile in the layer, evicting the least recently used tile if the cache is full
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[in] tileData Tile data to keep
+     * @return True if the operation was successful.
+     */
+    bool Store(const glm::ivec2 &tileIndex, const int &zoomLevel, const TileData &tileData) override;
+};
+
+#endif // MEMORY_TILE_CACHE_HEADER
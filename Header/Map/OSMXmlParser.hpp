@@ -0,0 +1,122 @@
+#ifndef OSM_XML_PARSER_HEADER
+#define OSM_XML_PARSER_HEADER
+
+#include "Map/BuildingData.hpp"
+#include "Map/TileData.hpp"
+#include "Map/TileStageStats.hpp"
+
+#include <glm/fwd.hpp>
+#include <tinyxml2.h>
+
+#include <map>
+#include <string>
+
+/**
+ * Extracts the buildings, highways and water features of a tile from OSM XML,
+ * wherever the XML came from.
+ */
+class OSMXmlParser
+{
+private:
+    const char *OSM_ELEMENT_STR = "osm";
+    const char *NODE_ELEMENT_STR = "node";
+    const char *NODE_ID_ATTRIBUTE_STR = "id";
+    const char *NODE_LAT_ATTRIBUTE_STR = "lat";
+    const char *NODE_LON_ATTRIBUTE_STR = "lon";
+    const char *WAY_ELEMENT_STR = "way";
+    const char *WAY_NODE_ELEMENT_STR = "nd";
+    const char *WAY_NODE_REF_ATTRIBUTE_STR = "ref";
+    const char *TAG_ELEMENT_STR = "tag";
+    const char *TAG_KEY_ATTRIBUTE_STR = "k";
+    const char *TAG_VALUE_ATTRIBUTE_STR = "v";
+
+    const char *BUILDING_TAG_KEY_STR = "building";
+    const char *BUILDING_PART_TAG_KEY_STR = "building:part";
+    const char *BUILDING_LEVELS_TAG_KEY_STR = "building:levels";
+    const char *BUILDING_MIN_LEVELS_TAG_KEY_STR = "building:min_levels";
+    const char *BUILDING_HEIGHT_TAG_KEY_STR = "height";
+    const char *BUILDING_MIN_HEIGHT_TAG_KEY_STR = "min_height";
+
+    const char *HIGHWAY_TAG_KEY_STR = "highway";
+    const char *HIGHWAY_LANES_TAG_KEY_STR = "lanes";
+
+    const char *NATURAL_KEY_STR = "natural";
+    const char *NATURAL_WATER_VALUE_STR = "water";
+    const char *WATER_KEY_STR = "water";
+    const char *WATERWAY_KEY_STR = "waterway";
+
+    const double METERS_PER_LEVEL = 3.0;
+    const double PRIMARY_HIGHWAY_LANE_WIDTH_METERS = 2.0;
+    const double RESIDENTIAL_HIGHWAY_LANE_WIDTH_METERS = 1.0;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    OSMXmlParser();
+
+    /**
+     * @brief Destructor
+     */
+    ~OSMXmlParser();
+
+    /**
+     * @brief Parses the OSM XML of a tile and retrieves its tile data. The XML parse
+     * and the node join are timed as separate stages.
+     * @param[in] xmlText OSM XML of the tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the retrieved tile data
+     * @param[in,out] ioStageTimes Stage times that the parse and join times are added to
+     * @return True if the operation was successful.
+     */
+    bool ParseTile(const std::string &xmlText, const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData, TileStageStats::StageTimes &ioStageTimes);
+
+    /**
+     * @brief Retrieves tile data from the given xml document
+     * @param[in] xml XML document object
+     * @param[out] outTileData TileData object that will contain the retrieved tile data
+     * @return True if the operation was successful.
+     */
+    bool RetrieveFromXML(const tinyxml2::XMLDocument &xml, TileData &outTileData);
+
+private:
+    /**
+     * @brief Retrieves building data from the given xml element
+     * @param[in] element XML element object
+     * @param[in] nodeIDToLonLat Map containing the mapping between a node ID and its lon/lat position
+     * @param[out] outBuildingData BuildingData object that will contain the retrieved building data
+     * @return True if the operation was successful.
+     */
+    bool RetrieveBuildingData(const tinyxml2::XMLElement *element, const std::map<int32_t, glm::dvec2> &nodeIDToLonLat, BuildingData &outBuildingData);
+
+    /**
+     * @brief Retrieves highway data from the given xml element
+     * @param[in] element XML element object
+     * @param[in] nodeIDToLonLat Map containing the mapping between a node ID and its lon/lat position
+     * @param[out] outHighwayData HighwayData object that will contain the retrieved highway data
+     * @return True if the operation was successful.
+     */
+    bool RetrieveHighwayData(const tinyxml2::XMLElement *element, const std::map<int32_t, glm::dvec2> &nodeIDToLonLat, HighwayData &outHighwayData);
+
+    /**
+     * @brief Retrieve water feature data from the given xml element
+     * @param[in] element XML element object
+     * @param[in] nodeIDToLonLat Map containing the mapping between a node ID and its lon/lat position
+     * @param[out] outWaterData WaterFeatureData object that will contain the retrieved water feature data
+     * @return True if the operation was successful.
+     */
+    bool RetrieveWaterData(const tinyxml2::XMLElement *element, const std::map<int32_t, glm::dvec2> &nodeIDToLonLat, WaterFeatureData &outWaterData);
+
+    bool HasChildTag(const tinyxml2::XMLElement *parent, const char *key);
+    const tinyxml2::XMLAttribute* GetChildTagValue(const tinyxml2::XMLElement *parent, const char *key);
+
+    /**
+     * @brief Checks whether the given xml element contains data for a water feature
+     * @param[in] element XML element
+     * @return True if the given XML element contains data for a water feature
+     */
+    bool HasWaterData(const tinyxml2::XMLElement *element);
+};
+
+#endif // OSM_XML_PARSER_HEADER
@@ -0,0 +1,105 @@
+#ifndef OFFLINE_TILE_PACK_HEADER
+#define OFFLINE_TILE_PACK_HEADER
+
+#include "Map/TileCacheLayer.hpp"
+#include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only cache layer backed by a single pack file holding many tiles, for deployments
+ * without network access. The pack starts with an index of its tiles, followed by the
+ * tiles in the binary encoding of TileDataSerializer. Packs are built with Write().
+ */
+class OfflineTilePack : public TileCacheLayer
+{
+private:
+    // Location of a tile in the pack file
+    struct IndexEntry
+    {
+        uint64_t offset;    // Offset of the encoded tile from the start of the file
+        uint64_t size;      // Size of the encoded tile
+    };
+
+    static constexpr uint32_t MAGIC = 0x5054564d;   // "MVTP"
+    static constexpr uint32_t VERSION = 1;          // Version of the pack layout, bumped whenever it changes
+
+    std::string m_filePath;                     // Path of the pack file
+    std::mutex m_fileMutex;                     // Mutex guarding the reads of the pack file
+    std::ifstream m_file;                       // Pack file, kept open while the layer exists
+    std::map<TileKey, IndexEntry> m_index;      // Location of each tile in the pack file
+
+public:
+    /**
+     * @brief Constructor. Reads the index of the pack; a missing or damaged pack is logged
+     * and treated as empty.
+     * @param[in] filePath Path of the pack file
+     * @param[in] next Data source behind the layer. nullptr if there is none.
+     */
+    OfflineTilePack(const std::string &filePath, std::unique_ptr<TileDataSource> next);
+
+    /**
+     * @brief Destructor
+     */
+    ~OfflineTilePack();
+
+    /**
+     * @brief Queries whether the pack file was opened
+     * @return True if the index of the pack was read
+     */
+    bool IsOpen() const;
+
+    /**
+     * @brief Gets a short description of the data source, used in the statistics
+     * @return Name of the data source
+     */
+    std::string GetName() const override;
+
+    /**
+     * @brief Builds a pack file from tiles retrieved from a data source
+     * @param[in] filePath Path of the pack file
+     * @param[in] dataSource Data source to retrieve the tiles from
+     * @param[in] tileKeys Tiles to put in the pack
+     * @return Returns true if the pack was written. Tiles that cannot be retrieved are
+     * logged and left out. Returns false if no tile could be retrieved, or the file cannot be written.
+     */
+    static bool Write(const std::string &filePath, TileDataSource &dataSource, const std::vector<TileKey> &tileKeys);
+
+protected:
+    /**
+     * @brief Queries whether the layer itself has the tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return True if the layer has the tile
+     */
+    bool HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Reads and decodes a tile from the pack file
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the loaded tile data
+     * @return True if the operation was successful.
+     */
+    bool Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) override;
+
+    /**
+     * @brief Packs are read-only, so nothing is kept
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[in] tileData Tile data to keep
+     * @return False
+     */
+    bool Store(const glm::ivec2 &tileIndex, const int &zoomLevel, const TileData &tileData) override;
+};
+
+#endif // OFFLINE_TILE_PACK_HEADER
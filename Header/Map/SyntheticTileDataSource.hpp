@@ -0,0 +1,137 @@
+#ifndef SYNTHETIC_TILE_DATA_SOURCE_HEADER
+#define SYNTHETIC_TILE_DATA_SOURCE_HEADER
+
+#include "Map/TileDataSource.hpp"
+#include "Map/TileData.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Source of generated tile data, for measuring how the viewer scales with the amount
+ * and shape of the map data. Every tile is generated from the seed and the tile index
+ * alone, so the same settings always produce the same city, on every platform and in
+ * any order of retrieval. Tiles are generated on demand, so any number of tiles is available.
+ */
+class SyntheticTileDataSource : public TileDataSource
+{
+public:
+    // Settings of the generated tiles
+    struct Settings
+    {
+        uint32_t seed;                      // Seed of the generated city
+        uint32_t buildingsPerTile;          // Number of buildings in each tile
+        uint32_t verticesPerOutline;        // Number of vertices of each building outline (at least 3)
+        double concavity;                   // How deep every other outline vertex is pulled towards the center, in [0, 1). 0 for convex outlines.
+        uint32_t roadsPerTile;              // Number of roads crossing each tile
+        double waterAreaFraction;           // Fraction of each tile covered by a water feature, in [0, 1). 0 for no water.
+        uint32_t verticesPerWaterOutline;   // Number of vertices of each water feature outline (at least 3)
+    };
+
+private:
+    const double MIN_BUILDING_RADIUS = 5.0;     // Smallest distance from a building center to its outline (in meters)
+    const double MAX_BUILDING_RADIUS = 20.0;    // Largest distance from a building center to its outline (in meters)
+    const double MIN_BUILDING_HEIGHT = 6.0;     // Height of the lowest buildings (in meters)
+    const double MAX_BUILDING_HEIGHT = 60.0;    // Height of the tallest buildings (in meters)
+    const uint32_t ROAD_SEGMENTS = 8;           // Number of segments of each road
+    const double ROAD_WOBBLE = 0.02;            // Largest sideways deviation of a road point (as a fraction of the tile size)
+    const double LANE_WIDTH = 2.0;              // Width of a road lane (in meters)
+    const uint32_t MAX_LANES = 4;               // Largest number of lanes of a road
+
+    Settings m_settings;                        // Settings of the generated tiles
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] settings Settings of the generated tiles
+     */
+    SyntheticTileDataSource(const Settings &settings);
+
+    /**
+     * @brief Destructor
+     */
+    ~SyntheticTileDataSource();
+
+    /**
+     * @brief Generates the tile data
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the generated tile data
+     * @return True if the operation was successful.
+     */
+    bool Retrieve(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) override;
+
+    /**
+     * @brief Queries whether there is a tile cache available for the specified tile index and zoom level.
+     * Every tile can be generated, so there always is.
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return True
+     */
+    bool IsTileCacheAvailable(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Prefetches the tile data. Tiles are generated when they are retrieved, so there is nothing to do.
+     * @param[in] tileIndex Tile index of the tile to prefetch
+     * @param[in] zoomLevel Zoom level
+     * @return True
+     */
+    bool Prefetch(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Gets a short description of the data source, used in the statistics
+     * @return Name of the data source
+     */
+    std::string GetName() const override;
+
+    /**
+     * @brief Gets the settings of the generated tiles
+     * @return Settings
+     */
+    const Settings& GetSettings() const;
+
+    /**
+     * @brief Gets the default settings, which generate tiles about as dense as the bundled OSM tiles
+     * @return Default settings
+     */
+    static Settings GetDefaultSettings();
+
+    /**
+     * @brief Applies a command line option to the settings, if it is one of the --synthetic-* options
+     * @param[in] name Name of the option
+     * @param[in] value Value of the option
+     * @param[in,out] ioSettings Settings to apply the option to
+     * @return Returns true if the option is a setting of the synthetic tiles. Returns false otherwise.
+     * Throws std::invalid_argument or std::out_of_range if the value is not a valid number.
+     */
+    static bool ParseOption(const char *name, const char *value, Settings &ioSettings);
+
+private:
+    /**
+     * @brief Gets a uniformly distributed random number. Computed from the raw output of the
+     * generator, which unlike the standard distributions is the same on every platform.
+     * @param[in,out] ioRandom Random number generator
+     * @param[in] min Smallest value
+     * @param[in] max Largest value
+     * @return Random number in [min, max)
+     */
+    static double GetRandom(std::mt19937 &ioRandom, double min, double max);
+
+    /**
+     * @brief Generates a star-shaped polygon around a center. The outline never intersects
+     * itself, since its vertices are sorted by angle around the center.
+     * @param[in,out] ioRandom Random number generator
+     * @param[in] center Center of the polygon (world-space, in meters)
+     * @param[in] radius Distance from the center to the outer vertices (in meters)
+     * @param[in] vertexCount Number of vertices
+     * @param[in] concavity How deep every other vertex is pulled towards the center, in [0, 1)
+     * @param[out] outOutline Outline of the polygon (lon/lat)
+     */
+    void GenerateOutline(std::mt19937 &ioRandom, const glm::dvec2 &center, double radius, uint32_t vertexCount, double concavity, std::vector<glm::dvec2> &outOutline) const;
+};
+
+#endif // SYNTHETIC_TILE_DATA_SOURCE_HEADER
@@ -0,0 +1,172 @@
+#ifndef TILE_CACHE_LAYER_HEADER
+#define TILE_CACHE_LAYER_HEADER
+
+#include "Map/TileDataSource.hpp"
+#include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+
+/**
+ * Base class for cache layers, which sit in front of another data source. A tile
+ * the layer has is served from it. Otherwise the tile is retrieved from the next
+ * data source, and kept in the layer as allowed by its write-back policy. Layers
+ * chain, e.g. memory -> disk -> network.
+ * Threads missing the same tile at the same time are coalesced: one of them fills the
+ * layer, and the others wait for it and are then served from the layer.
+ */
+class TileCacheLayer : public TileDataSource
+{
+public:
+    // When tiles retrieved from the next data source are kept in the layer
+    enum class WriteBackPolicy
+    {
+        Never = 0,      // Read-only, the layer only serves what it already has
+        OnRetrieve,     // Tiles retrieved through the layer are kept
+        Always          // Tiles retrieved or prefetched through the layer are kept
+    };
+
+protected:
+    std::unique_ptr<TileDataSource> m_next;     // Data source behind the layer. nullptr if there is none.
+    WriteBackPolicy m_writeBackPolicy;          // When tiles are kept in the layer
+
+private:
+    std::mutex m_fillMutex;                     // Mutex guarding the tiles being filled
+    std::condition_variable m_fillDone;         // Notified when a thread finished filling a tile
+    std::set<TileKey> m_fillingTiles;           // Tiles that a thread is filling the layer with
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] next Data source behind the layer. nullptr if there is none.
+     * @param[in] writeBackPolicy When tiles are kept in the layer
+     */
+    TileCacheLayer(std::unique_ptr<TileDataSource> next, WriteBackPolicy writeBackPolicy);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~TileCacheLayer();
+
+    /**
+     * @brief Retrieves the tile data from the layer, or from the next data source if the layer does not have it
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the retrieved tile data
+     * @return True if the operation was successful.
+     */
+    bool Retrieve(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) override;
+
+    /**
+     * @brief Queries whether the layer or any data source behind it has the tile without downloading it
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return True if there is a tile cache available
+     */
+    bool IsTileCacheAvailable(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Prefetches the tile data. With the Always write-back policy, a tile the layer
+     * does not have is retrieved and kept. Otherwise the next data source prefetches it.
+     * @param[in] tileIndex Tile index of the tile to prefetch
+     * @param[in] zoomLevel Zoom level
+     * @return True if the operation was successful
+     */
+    bool Prefetch(const glm::ivec2 &tileIndex, const int &zoomLevel) override;
+
+    /**
+     * @brief Retrieves the tile as OSM XML from the next data source
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outXmlText OSM XML of the tile
+     * @return True if the operation was successful. False if no data source has OSM XML of the tile.
+     */
+    bool RetrieveOsmXml(const glm::ivec2 &tileIndex, const int &zoomLevel, std::string &outXmlText) override;
+
+    /**
+     * @brief Prints the row of the statistics table of this layer, and of the data sources behind it
+     * @param[in] stream Stream to print to
+     */
+    void PrintStatsRows(std::ostream &stream) const override;
+
+    /**
+     * @brief Gets how many lookups this layer and the cache layers behind it served, and
+     * how many fell through all of them
+     * @param[out] outCacheHits Number of lookups served by a cache layer
+     * @param[out] outCacheMisses Number of lookups that no cache layer could serve
+     */
+    void GetCacheCounts(uint64_t &outCacheHits, uint64_t &outCacheMisses) const override;
+
+    /**
+     * @brief Gets the write-back policy of the layer
+     * @return Write-back policy
+     */
+    WriteBackPolicy GetWriteBackPolicy() const;
+
+    /**
+     * @brief Gets the name of a write-back policy, as used in the data source specification
+     * @param[in] writeBackPolicy Write-back policy
+     * @return Name of the write-back policy
+     */
+    static const char* GetWriteBackPolicyName(WriteBackPolicy writeBackPolicy);
+
+protected:
+    /**
+     * @brief Queries whether the layer itself has the tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @return True if the layer has the tile
+     */
+    virtual bool HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel) = 0;
+
+    /**
+     * @brief Loads a tile the layer has
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the loaded tile data
+     * @return True if the operation was successful.
+     */
+    virtual bool Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) = 0;
+
+    /**
+     * @brief Keeps a tile in the layer
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[in] tileData Tile data to keep
+     * @return True if the operation was successful.
+     */
+    virtual bool Store(const glm::ivec2 &tileIndex, const int &zoomLevel, const TileData &tileData) = 0;
+
+    /**
+     * @brief Retrieves a tile the layer does not have from the next data source, and keeps it
+     * in the layer unless the write-back policy is Never.
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the retrieved tile data. nullptr when
+     * prefetching, in which case the tile only needs to be kept.
+     * @return True if the operation was successful.
+     */
+    virtual bool Fill(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData *outTileData);
+
+private:
+    /**
+     * @brief Claims the filling of a tile for the calling thread. Waits while another thread fills it.
+     * @param[in] tileKey Tile to fill
+     */
+    void BeginFill(const TileKey &tileKey);
+
+    /**
+     * @brief Releases the filling of a tile, and wakes the threads waiting for it
+     * @param[in] tileKey Tile that was filled
+     */
+    void EndFill(const TileKey &tileKey);
+};
+
+#endif // TILE_CACHE_LAYER_HEADER
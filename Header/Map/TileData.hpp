@@ -19,6 +19,7 @@ struct WaterFeatureData
 struct TileData
 {
     glm::ivec2 index;                       // Tile index
+    int zoomLevel = 0;                      // Zoom level of the tile
     RectD bounds;                           // Tile bounds (lon/lat, world-space)
 
     std::vector<BuildingData> buildings;    // List of building data
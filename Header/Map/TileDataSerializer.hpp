@@ -0,0 +1,39 @@
+#ifndef TILE_DATA_SERIALIZER_HEADER
+#define TILE_DATA_SERIALIZER_HEADER
+
+#include "Map/TileData.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Compact binary encoding of tile data, used by the binary disk cache and the offline
+ * tile packs. Decoding is a straight copy of the features, without the XML parse and
+ * node join that OSM XML needs. Numbers are stored in the byte order of the machine
+ * that encoded them, so the files are not meant to be moved between architectures.
+ */
+class TileDataSerializer
+{
+private:
+    static constexpr uint32_t MAGIC = 0x4454564d;   // "MVTD"
+    static constexpr uint32_t VERSION = 1;          // Version of the encoding, bumped whenever the layout changes
+
+public:
+    /**
+     * @brief Encodes tile data
+     * @param[in] tileData Tile data to encode
+     * @param[out] outBytes Encoded tile data
+     */
+    static void Serialize(const TileData &tileData, std::string &outBytes);
+
+    /**
+     * @brief Decodes tile data encoded by Serialize()
+     * @param[in] bytes Encoded tile data
+     * @param[out] outTileData Decoded tile data
+     * @return Returns true if the tile data was decoded. Returns false if the bytes are
+     * truncated, or were encoded by another version.
+     */
+    static bool Deserialize(const std::string &bytes, TileData &outTileData);
+};
+
+#endif // TILE_DATA_SERIALIZER_HEADER
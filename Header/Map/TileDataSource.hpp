@@ -1,29 +1,39 @@
 #ifndef TILE_DATA_SOURCE_HEADER
 #define TILE_DATA_SOURCE_HEADER
 
+#include "Core/LatencyHistogram.hpp"
 #include "Map/TileData.hpp"
+#include "Map/TileStageStats.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
 #include <string>
 
 /**
- * Base class for tile data sources
- */ 
+ * Base class for tile data sources. A data source can be a single layer of a hierarchy
+ * of caches (see TileCacheLayer), so each one counts the retrievals it served itself.
+ * Data sources can be used by several threads at once.
+ */
 class TileDataSource
 {
+protected:
+    mutable std::mutex m_statsMutex;            // Mutex guarding the hit and miss statistics
+    uint64_t m_hitCount;                        // Number of retrievals and prefetches served by this data source
+    uint64_t m_missCount;                       // Number of retrievals and prefetches this data source could not serve by itself
+    LatencyHistogram m_hitLatencies;            // Time taken by the retrievals and prefetches served by this data source (in microseconds)
+
 public:
     /**
      * @brief Constructor
      */
-    TileDataSource()
-    {
-    }
+    TileDataSource();
 
     /**
      * @brief Destructor
      */
-    virtual ~TileDataSource()
-    {
-    }
+    virtual ~TileDataSource();
 
     /**
      * @brief Retrieves the tile data
@@ -41,6 +51,83 @@ public:
      * @return True if there is a tile cache available
      */
     virtual bool IsTileCacheAvailable(const glm::ivec2 &tileIndex, const int &zoomLevel) = 0;
+
+    /**
+     * @brief Prefetches the tile data at the specified tile index and zoom level, and
+     * caches the result locally.
+     * @param[in] tileIndex Tile index of the tile to prefetch
+     * @param[in] zoomLevel Zoom level
+     * @return True if the operation was successful
+     */
+    virtual bool Prefetch(const glm::ivec2 &tileIndex, const int &zoomLevel) = 0;
+
+    /**
+     * @brief Retrieves the tile as OSM XML, for caches that store the XML as it is
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outXmlText OSM XML of the tile
+     * @return True if the operation was successful. False if the data source has no OSM XML of the tile.
+     */
+    virtual bool RetrieveOsmXml(const glm::ivec2 &tileIndex, const int &zoomLevel, std::string &outXmlText);
+
+    /**
+     * @brief Gets a short description of the data source, used in the statistics
+     * @return Name of the data source
+     */
+    virtual std::string GetName() const = 0;
+
+    /**
+     * @brief Adds the time that the data sources spent in each tile pipeline stage on the
+     * calling thread since the last reset
+     * @param[in,out] ioStageTimes Stage times that the times of the data sources are added to
+     */
+    static void AddStageTimes(TileStageStats::StageTimes &ioStageTimes);
+
+    /**
+     * @brief Resets the time that the data sources spent in each stage on the calling thread
+     */
+    static void ResetStageTimes();
+
+    /**
+     * @brief Prints the hits, misses and hit latencies of the data source as a table
+     * @param[in] stream Stream to print to
+     * @param[in] title Title of the table
+     */
+    void PrintStats(std::ostream &stream, const std::string &title) const;
+
+    /**
+     * @brief Prints the row of the statistics table of this data source, and of the data sources behind it
+     * @param[in] stream Stream to print to
+     */
+    virtual void PrintStatsRows(std::ostream &stream) const;
+
+    /**
+     * @brief Gets how many lookups the cache layers of the hierarchy served, and how many
+     * fell through them to the data source at the end. A data source that is not a cache
+     * layer counts every lookup it received as a cache miss.
+     * @param[out] outCacheHits Number of lookups served by a cache layer
+     * @param[out] outCacheMisses Number of lookups that no cache layer could serve
+     */
+    virtual void GetCacheCounts(uint64_t &outCacheHits, uint64_t &outCacheMisses) const;
+
+protected:
+    /**
+     * @brief Gets the time that the data sources spent in each stage on the calling thread.
+     * Each thread works on one tile at a time, so the times belong to its current tile.
+     * @return Stage times of the calling thread
+     */
+    static TileStageStats::StageTimes& GetThreadStageTimes();
+
+    /**
+     * @brief Records a retrieval served by this data source
+     * @param[in] startTime Time the retrieval started
+     */
+    void RecordHit(const std::chrono::steady_clock::time_point &startTime);
+
+    /**
+     * @brief Records a retrieval this data source could not serve by itself
+     */
+    void RecordMiss();
 };
 
 #endif // TILE_DATA_SOURCE_HEADER
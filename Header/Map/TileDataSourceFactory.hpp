@@ -0,0 +1,73 @@
+#ifndef TILE_DATA_SOURCE_FACTORY_HEADER
+#define TILE_DATA_SOURCE_FACTORY_HEADER
+
+#include "Map/SyntheticTileDataSource.hpp"
+#include "Map/TileCacheLayer.hpp"
+#include "Map/TileDataSource.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Builds a hierarchy of tile data sources from a specification, so that deployments can
+ * choose where tiles come from without code changes. The specification lists the layers
+ * from front to back, separated by commas. Each layer is a type followed by its settings,
+ * separated by colons:
+ *   memory[:<tiles>]                   Most recently used tiles in memory (default: 256 tiles)
+ *   disk[:<directory>[:osm|binary]]    One file per tile (default: Resources, osm)
+ *   pack:<file>                        Read-only offline tile pack
+ *   network[:<host>]                   Overpass API server (default: overpass-api.de)
+ *   synthetic                          Generated city
+ * The memory and disk layers also take write=never|retrieve|always, the write-back policy
+ * (default: retrieve for memory, always for disk). The network and synthetic sources can
+ * only be the last layer.
+ * Examples: "pack:city.pack" for an offline kiosk,
+ * "memory:512,disk:cache:binary,disk:Resources:osm:write=never,network" for a workstation.
+ */
+class TileDataSourceFactory
+{
+public:
+    /**
+     * @brief Builds the hierarchy of data sources given by a specification
+     * @param[in] specification Specification of the hierarchy
+     * @param[in] syntheticSettings Settings of the generated tiles, used by the synthetic source
+     * @return Front layer of the hierarchy. Returns nullptr if the specification is invalid.
+     */
+    static std::unique_ptr<TileDataSource> Create(const std::string &specification, const SyntheticTileDataSource::Settings &syntheticSettings);
+
+    /**
+     * @brief Gets the specification used when none is given: the bundled OSM tiles,
+     * with downloaded tiles added next to them
+     * @return Default specification
+     */
+    static const char* GetDefaultSpecification();
+
+private:
+    /**
+     * @brief Builds a single layer
+     * @param[in] fields Type and settings of the layer
+     * @param[in] next Data source behind the layer. nullptr if there is none.
+     * @param[in] syntheticSettings Settings of the generated tiles, used by the synthetic source
+     * @return Layer. Returns nullptr if the layer specification is invalid.
+     */
+    static std::unique_ptr<TileDataSource> CreateLayer(const std::vector<std::string> &fields, std::unique_ptr<TileDataSource> next, const SyntheticTileDataSource::Settings &syntheticSettings);
+
+    /**
+     * @brief Parses the name of a write-back policy
+     * @param[in] name Name of the policy
+     * @param[out] outWriteBackPolicy Parsed write-back policy
+     * @return Returns true if the name is a write-back policy. Returns false otherwise.
+     */
+    static bool ParseWriteBackPolicy(const std::string &name, TileCacheLayer::WriteBackPolicy &outWriteBackPolicy);
+
+    /**
+     * @brief Splits a string at a separator
+     * @param[in] text String to split
+     * @param[in] separator Separator
+     * @return Parts of the string
+     */
+    static std::vector<std::string> Split(const std::string &text, char separator);
+};
+
+#endif // TILE_DATA_SOURCE_FACTORY_HEADER
@@ -0,0 +1,53 @@
+#ifndef TILE_KEY_HEADER
+#define TILE_KEY_HEADER
+
+#include <glm/glm.hpp>
+
+/**
+ * Struct identifying a tile in the tile pyramid
+ */
+struct TileKey
+{
+    glm::ivec2 index;                       // Tile index
+    int zoomLevel;                          // Zoom level
+
+    /**
+     * @brief Checks whether the two tile keys refer to the same tile
+     * @param[in] other Tile key to compare with
+     * @return True if both keys refer to the same tile
+     */
+    bool operator==(const TileKey &other) const
+    {
+        return (zoomLevel == other.zoomLevel) && (index == other.index);
+    }
+
+    /**
+     * @brief Checks whether the two tile keys refer to different tiles
+     * @param[in] other Tile key to compare with
+     * @return True if the keys refer to different tiles
+     */
+    bool operator!=(const TileKey &other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief Strict ordering of tile keys, so that they can be used in ordered containers
+     * @param[in] other Tile key to compare with
+     * @return True if this key is ordered before the other key
+     */
+    bool operator<(const TileKey &other) const
+    {
+        if (zoomLevel != other.zoomLevel)
+        {
+            return zoomLevel < other.zoomLevel;
+        }
+        if (index.x != other.index.x)
+        {
+            return index.x < other.index.x;
+        }
+        return index.y < other.index.y;
+    }
+};
+
+#endif // TILE_KEY_HEADER
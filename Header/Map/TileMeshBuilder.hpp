@@ -0,0 +1,141 @@
+#ifndef TILE_MESH_BUILDER_HEADER
+#define TILE_MESH_BUILDER_HEADER
+
+#include "Core/Rect.hpp"
+#include "Map/BuildingData.hpp"
+#include "Map/HighwayData.hpp"
+#include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+#include "Map/TileStageStats.hpp"
+#include "TileMesh.hpp"
+#include "Vertex.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Generates the tile-local mesh of every LOD level of a tile from its map data.
+ * The builder holds no state other than its settings, so a single builder can be
+ * shared by all worker threads.
+ */
+class TileMeshBuilder
+{
+public:
+    static const size_t NUM_LOD_LEVELS = TileMesh::NUM_LOD_LEVELS;  // Number of LOD levels generated for each tile
+
+private:
+    // Settings used when generating the mesh of a tile for a single LOD level
+    struct LodSettings
+    {
+        double geometricError;                  // Maximum deviation from the full detail mesh (in meters)
+        double simplifyTolerance;               // Douglas-Peucker tolerance for outlines and lines (in meters). 0 to disable.
+        double minBuildingArea;                 // Buildings with a smaller footprint are dropped (in square meters)
+        bool useOrientedBoxes;                  // Flag indicating whether building outlines are replaced by their oriented bounding boxes
+        bool includeBottomFaces;                // Flag indicating whether the bottom faces of buildings are generated
+    };
+
+    const size_t CLUSTER_GRID_SIZE = 4;         // Number of cluster cells along each side of a tile
+
+    // Settings of each LOD level, from finest to coarsest
+    const std::array<LodSettings, NUM_LOD_LEVELS> LOD_SETTINGS =
+    {{
+        // Error, tolerance, min area, boxes, bottom faces
+        { 0.0, 0.0, 0.0, false, true },         // LOD0: Full detail
+        { 2.0, 2.0, 50.0, false, false },       // LOD1: Simplified outlines, small buildings dropped
+        { 10.0, 10.0, 200.0, true, false }      // LOD2: Oriented boxes, only large buildings
+    }};
+
+    double m_scale;                             // Scale from meters to world units
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] scale Scale from meters to world units
+     */
+    TileMeshBuilder(double scale);
+
+    /**
+     * @brief Destructor
+     */
+    ~TileMeshBuilder();
+
+    /**
+     * @brief Generates the tile-local mesh of every LOD level of a tile
+     * @param[in] tileKey Tile
+     * @param[in] tileData Data of the tile
+     * @param[out] outTileMesh Generated tile mesh
+     * @param[in,out] ioStageTimes Stage times of the tile job, which the triangulation and mesh build times are added to
+     */
+    void Build(const TileKey &tileKey, const TileData &tileData, TileMesh &outTileMesh, TileStageStats::StageTimes &ioStageTimes) const;
+
+    /**
+     * @brief Gets the maximum deviation of a LOD level from the full detail mesh
+     * @param[in] lodLevel LOD level
+     * @return Geometric error of the LOD level (in meters)
+     */
+    double GetGeometricError(size_t lodLevel) const;
+
+private:
+    /**
+     * @brief Appends geometry vertices of a tile into a destination buffer
+     * @param[in] tileData Tile whose geometry vertices to append
+     * @param[in] origin Origin that the vertices are relative to (lon/lat)
+     * @param[in] lodLevel LOD level to generate the vertices for
+     * @param[in] dest Destination buffer to append the vertices to
+     * @param[out] outClusters List where the clusters making up the appended vertices will be added to
+     * @param[in,out] ioTriangulationSeconds Time spent triangulating polygons, which the triangulation time of the tile is added to
+     * @return Number of vertices appended
+     */
+    uint32_t AppendTileGeometryVertices(const TileData &tileData, const glm::dvec2 &origin, size_t lodLevel, std::vector<Vertex> &dest, std::vector<MeshCluster> &outClusters, double &ioTriangulationSeconds) const;
+
+    /**
+     * @brief Appends the geometry vertices of a building into a destination buffer
+     * @param[in] building Building whose geometry vertices to append
+     * @param[in] tileCenter Origin that the vertices are relative to (world-space)
+     * @param[in] lodSettings Settings of the LOD level to generate the vertices for
+     * @param[in] dest Destination buffer to append the vertices to
+     * @param[in,out] ioTriangulationSeconds Time spent triangulating polygons, which the triangulation time of the roof is added to
+     */
+    void AppendBuildingVertices(const BuildingData &building, const glm::dvec2 &tileCenter, const LodSettings &lodSettings, std::vector<Vertex> &dest, double &ioTriangulationSeconds) const;
+
+    /**
+     * @brief Appends the geometry vertices of a highway into a destination buffer
+     * @param[in] highway Highway whose geometry vertices to append
+     * @param[in] tileCenter Origin that the vertices are relative to (world-space)
+     * @param[in] lodSettings Settings of the LOD level to generate the vertices for
+     * @param[in] dest Destination buffer to append the vertices to
+     */
+    void AppendHighwayVertices(const HighwayData &highway, const glm::dvec2 &tileCenter, const LodSettings &lodSettings, std::vector<Vertex> &dest) const;
+
+    /**
+     * @brief Appends the geometry vertices of a water feature into a destination buffer
+     * @param[in] water Water feature whose geometry vertices to append
+     * @param[in] tileCenter Origin that the vertices are relative to (world-space)
+     * @param[in] lodSettings Settings of the LOD level to generate the vertices for
+     * @param[in] dest Destination buffer to append the vertices to
+     * @param[in,out] ioTriangulationSeconds Time spent triangulating polygons, which the triangulation time of the water feature is added to
+     */
+    void AppendWaterFeatureVertices(const WaterFeatureData &water, const glm::dvec2 &tileCenter, const LodSettings &lodSettings, std::vector<Vertex> &dest, double &ioTriangulationSeconds) const;
+
+    /**
+     * @brief Gets the index of the clustering grid cell that contains the specified point
+     * @param[in] tileBounds Tile bounds (lon/lat)
+     * @param[in] lonLat Point (lon/lat)
+     * @return Index of the grid cell containing the point
+     */
+    size_t GetClusterCellIndex(const RectD &tileBounds, const glm::dvec2 &lonLat) const;
+
+    /**
+     * @brief Adds a cluster for the vertices appended since firstVertex, if there are any
+     * @param[in] vertices Vertex buffer containing the cluster vertices
+     * @param[in] firstVertex Index of the first vertex of the cluster
+     * @param[out] outClusters List where the cluster will be added to
+     */
+    void AppendMeshCluster(const std::vector<Vertex> &vertices, uint32_t firstVertex, std::vector<MeshCluster> &outClusters) const;
+};
+
+#endif // TILE_MESH_BUILDER_HEADER
@@ -0,0 +1,140 @@
+#ifndef TILE_PREFETCH_PREDICTOR_HEADER
+#define TILE_PREFETCH_PREDICTOR_HEADER
+
+#include "Map/TileKey.hpp"
+#include "Map/TilePyramid.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * Predicts the tiles that will become visible by extrapolating the camera path
+ * from its recent velocity and forward direction, so that they can be prefetched
+ * and decoded before they are needed.
+ */
+class TilePrefetchPredictor
+{
+public:
+    // Prediction statistics
+    struct Stats
+    {
+        uint32_t hits;                  // Newly visible tiles that were predicted in advance
+        uint32_t misses;                // Newly visible tiles that were not predicted
+        uint32_t predictedTiles;        // Number of tiles predicted
+        uint32_t expiredTiles;          // Predicted tiles that did not become visible in time
+    };
+
+private:
+    const size_t MAX_TILES_PER_PREDICTION = 32;    // Maximum number of tiles returned by a single prediction
+
+    float m_lookaheadSeconds;           // How far ahead the camera path is extrapolated (in seconds)
+    float m_sampleInterval;             // Time between samples along the extrapolated path (in seconds)
+    float m_velocitySmoothing;          // Weight of the previous velocity when smoothing, in [0, 1)
+    float m_forwardBias;                // How much the path is bent towards the forward vector when moving forward
+
+    double m_currentTime;               // Accumulated time since the predictor was created (in seconds)
+    glm::dvec2 m_position;              // Latest camera position (world-space, in meters)
+    glm::dvec2 m_velocity;              // Smoothed camera velocity (world-space, in meters per second)
+    glm::dvec2 m_forward;               // Latest camera forward direction projected onto the ground
+
+    std::vector<glm::ivec2> m_lastPredictedPath;    // Base zoom level tiles along the last extrapolated path
+    std::map<TileKey, double> m_pendingTiles;       // Predicted tiles that have not become visible yet, and the time they were predicted
+
+    Stats m_stats;                      // Prediction statistics since the last reset
+
+public:
+    /**
+     * @brief Constructor
+     */
+    TilePrefetchPredictor();
+
+    /**
+     * @brief Destructor
+     */
+    ~TilePrefetchPredictor();
+
+    /**
+     * @brief Sets how far ahead the camera path is extrapolated
+     * @param[in] lookaheadSeconds Lookahead time (in seconds)
+     */
+    void SetLookaheadSeconds(float lookaheadSeconds);
+
+    /**
+     * @brief Sets the time between samples along the extrapolated path
+     * @param[in] sampleInterval Sample interval (in seconds)
+     */
+    void SetSampleInterval(float sampleInterval);
+
+    /**
+     * @brief Sets the weight of the previous velocity when smoothing the camera velocity
+     * @param[in] velocitySmoothing Smoothing weight in [0, 1). 0 disables smoothing.
+     */
+    void SetVelocitySmoothing(float velocitySmoothing);
+
+    /**
+     * @brief Sets how much the extrapolated path is bent towards the camera's forward vector
+     * @param[in] forwardBias Forward bias. 0 follows the velocity only.
+     */
+    void SetForwardBias(float forwardBias);
+
+    /**
+     * @brief Updates the camera motion used for the prediction. Called once per frame.
+     * @param[in] position Camera position (world-space, in meters)
+     * @param[in] displacement Camera displacement during the frame (world-space, in meters)
+     * @param[in] forward Camera forward vector projected onto the ground
+     * @param[in] deltaTime Frame time (in seconds)
+     */
+    void Update(const glm::dvec2 &position, const glm::dvec2 &displacement, const glm::dvec2 &forward, float deltaTime);
+
+    /**
+     * @brief Forgets the camera motion, so that a camera placed somewhere else is not taken as moving there
+     */
+    void ResetMotion();
+
+    /**
+     * @brief Extrapolates the camera path and gets the tiles that will become visible along it.
+     * Nothing is returned if the path still crosses the same tiles as the last prediction.
+     * @param[in] tilePyramid Tile pyramid used to select the visible tiles
+     * @param[in] viewDistance View distance (in base zoom level tiles)
+     * @param[in] visibleTiles Tiles that are currently visible
+     * @param[out] outTiles Newly predicted tiles, in the order they are expected to be needed
+     * @return True if new tiles were predicted
+     */
+    bool PredictTiles(const TilePyramid &tilePyramid, int viewDistance, const std::set<TileKey> &visibleTiles, std::vector<TileKey> &outTiles);
+
+    /**
+     * @brief Queries whether a tile was predicted and has not become visible or expired yet
+     * @param[in] tileKey Tile to query
+     * @return True if the tile prediction is still pending
+     */
+    bool IsPending(const TileKey &tileKey) const;
+
+    /**
+     * @brief Gets the tiles that were predicted and have not become visible or expired yet
+     * @param[out] outTiles Pending tiles
+     */
+    void GetPendingTiles(std::vector<TileKey> &outTiles) const;
+
+    /**
+     * @brief Records the tiles that just became visible, to measure the prediction hit rate
+     * @param[in] newlyVisibleTiles Tiles that just became visible
+     */
+    void RecordNewlyVisibleTiles(const std::vector<TileKey> &newlyVisibleTiles);
+
+    /**
+     * @brief Gets the prediction statistics since the last reset
+     * @return Prediction statistics
+     */
+    const Stats& GetStats() const;
+
+    /**
+     * @brief Resets the prediction statistics
+     */
+    void ResetStats();
+};
+
+#endif // TILE_PREFETCH_PREDICTOR_HEADER
@@ -0,0 +1,114 @@
+#ifndef TILE_PYRAMID_HEADER
+#define TILE_PYRAMID_HEADER
+
+#include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/**
+ * Selects tiles of multiple zoom levels around the camera, using fine tiles
+ * near the camera and coarser tiles further out. Coarser tiles are generated
+ * by merging and simplifying the data of the base zoom level tiles they cover.
+ */
+class TilePyramid
+{
+private:
+    // Settings used to simplify base tiles when they are merged into a coarser tile
+    struct SimplificationSettings
+    {
+        double simplifyTolerance;       // Douglas-Peucker tolerance for outlines and lines (in meters)
+        double minFeatureArea;          // Buildings and water features with a smaller area are dropped (in square meters)
+        double minRoadWidth;            // Roads that are narrower are dropped (in meters)
+    };
+
+    // A tile is split into its four children while it is closer to the camera than this many child tile widths.
+    // This is what keeps the number of tiles of each ring, and thus its cost, bounded.
+    const int SPLIT_DISTANCE = 2;
+
+    const size_t MAX_BUILDINGS_PER_TILE = 4096; // Maximum number of buildings kept in a merged tile. Largest buildings are kept first.
+    const size_t MAX_HIGHWAYS_PER_TILE = 2048;  // Maximum number of highways kept in a merged tile. Widest roads are kept first.
+
+    int m_baseZoomLevel;    // Zoom level of the tiles nearest to the camera
+    int m_minZoomLevel;     // Zoom level of the coarsest tiles
+
+public:
+    /**
+     * @brief Constructor
+     * @param[in] baseZoomLevel Zoom level of the tiles nearest to the camera
+     * @param[in] minZoomLevel Zoom level of the coarsest tiles
+     */
+    TilePyramid(int baseZoomLevel, int minZoomLevel);
+
+    /**
+     * @brief Destructor
+     */
+    ~TilePyramid();
+
+    /**
+     * @brief Gets the zoom level of the tiles nearest to the camera
+     * @return Base zoom level
+     */
+    int GetBaseZoomLevel() const;
+
+    /**
+     * @brief Gets the zoom level of the coarsest tiles
+     * @return Minimum zoom level
+     */
+    int GetMinZoomLevel() const;
+
+    /**
+     * @brief Selects the tiles that cover the area within the view distance of the camera.
+     * The selected tiles do not overlap, and are sorted from nearest to furthest.
+     * @param[in] baseTileIndex Index of the base zoom level tile containing the camera
+     * @param[in] viewDistance View distance (in base zoom level tiles)
+     * @param[out] outTiles List of selected tiles
+     */
+    void SelectTiles(const glm::ivec2 &baseTileIndex, int viewDistance, std::vector<TileKey> &outTiles) const;
+
+    /**
+     * @brief Gets the indices of the base zoom level tiles covered by the specified tile
+     * @param[in] tileKey Tile
+     * @param[out] outIndices List of base zoom level tile indices
+     */
+    void GetBaseTileIndices(const TileKey &tileKey, std::vector<glm::ivec2> &outIndices) const;
+
+    /**
+     * @brief Merges the data of base zoom level tiles into a single coarser tile.
+     * The merged features are simplified based on the zoom level of the coarser tile.
+     * @param[in] tileKey Coarser tile to generate
+     * @param[in] baseTiles Data of the base zoom level tiles covered by the coarser tile
+     * @param[out] outTileData Merged tile data
+     * @return Returns true if the merge was successful. Returns false otherwise.
+     */
+    bool MergeTiles(const TileKey &tileKey, const std::vector<TileData> &baseTiles, TileData &outTileData) const;
+
+private:
+    /**
+     * @brief Gets the distance of a tile from the camera, in base zoom level tiles
+     * @param[in] tileKey Tile
+     * @param[in] baseTileIndex Index of the base zoom level tile containing the camera
+     * @return Chebyshev distance between the tile and the camera tile
+     */
+    int GetBaseDistance(const TileKey &tileKey, const glm::ivec2 &baseTileIndex) const;
+
+    /**
+     * @brief Adds the tile to the selection, or its children if it is close enough to the camera
+     * @param[in] tileKey Tile
+     * @param[in] baseTileIndex Index of the base zoom level tile containing the camera
+     * @param[in] viewDistance View distance (in base zoom level tiles)
+     * @param[out] outTiles List of selected tiles
+     */
+    void SelectTilesRecursive(const TileKey &tileKey, const glm::ivec2 &baseTileIndex, int viewDistance, std::vector<TileKey> &outTiles) const;
+
+    /**
+     * @brief Gets the settings used to simplify features merged into a tile of the specified zoom level
+     * @param[in] zoomLevel Zoom level of the merged tile
+     * @return Simplification settings
+     */
+    SimplificationSettings GetSimplificationSettings(int zoomLevel) const;
+};
+
+#endif // TILE_PYRAMID_HEADER
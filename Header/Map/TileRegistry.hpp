@@ -0,0 +1,200 @@
+#ifndef TILE_REGISTRY_HEADER
+#define TILE_REGISTRY_HEADER
+
+#include "Map/TileData.hpp"
+#include "Map/TileKey.hpp"
+#include "TileMesh.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/**
+ * Central registry of every tile the application knows about, keyed by (z, x, y).
+ * Each tile moves through explicit states, and all transitions happen under the
+ * registry lock, so duplicate requests coalesce onto the work already in flight.
+ */
+class TileRegistry
+{
+public:
+    // Lifecycle state of a tile
+    enum class TileState
+    {
+        Absent = 0,     // Not available locally
+        Downloading,    // Being downloaded into the disk cache
+        Cached,         // Available in the disk cache
+        Decoding,       // Being parsed (and merged, for coarse tiles) from the disk cache
+        Decoded,        // Parsed tile data is in memory
+        Meshed,         // Tile-local mesh is in memory
+        Resident,       // Mesh was picked up by the render thread and is being drawn
+        Count
+    };
+
+    // Registry statistics
+    struct Stats
+    {
+        std::array<uint32_t, static_cast<size_t>(TileState::Count)> tileCountPerState;  // Number of tiles in each state
+        size_t decodedBytes;            // Approximate memory used by decoded tile data
+        size_t meshBytes;               // Approximate memory used by tile meshes
+        uint32_t coalescedRequests;     // Requests that were merged into work already queued or in flight
+        uint32_t residentLatencyCount;  // Number of tiles that became resident
+        double totalResidentLatency;    // Sum of the times from a resident request until the tile became resident (in seconds)
+    };
+
+private:
+    // Registry entry of a single tile
+    struct TileEntry
+    {
+        TileState state;                // Current state
+        TileState targetState;          // State the tile is requested to reach
+        bool inFlight;                  // Flag indicating whether a worker is currently working on the tile
+        bool queued;                    // Flag indicating whether a job for the tile is waiting in the job queue
+        std::shared_ptr<const TileData> tileData;   // Decoded tile data. Only kept until the tile is meshed.
+        std::shared_ptr<const TileMesh> tileMesh;   // Tile mesh
+        size_t memoryBytes;             // Approximate memory used by the tile data or mesh
+        std::chrono::steady_clock::time_point residentRequestTime;  // Time the tile was requested to become resident
+    };
+
+    std::map<TileKey, TileEntry> m_entries; // Tile entries
+    mutable std::mutex m_mutex;             // Mutex guarding the whole registry
+
+    uint32_t m_coalescedRequests;           // Requests that were merged into work already queued or in flight
+    uint32_t m_residentLatencyCount;        // Number of tiles that became resident since the last reset
+    double m_totalResidentLatency;          // Sum of resident latencies since the last reset (in seconds)
+
+public:
+    /**
+     * @brief Constructor
+     */
+    TileRegistry();
+
+    /**
+     * @brief Destructor
+     */
+    ~TileRegistry();
+
+    /**
+     * @brief Requests a tile to reach the specified state. Requesting a lower state than the
+     * current one releases the memory of the tile. The request is coalesced if work for the
+     * tile is already queued or in flight.
+     * @param[in] tileKey Tile
+     * @param[in] targetState State the tile should reach
+     * @return True if a job has to be queued for the tile
+     */
+    bool Request(const TileKey &tileKey, TileState targetState);
+
+    /**
+     * @brief Releases all tiles that are not in the provided set.
+     * Queued jobs of the released tiles are expected to be dropped by the caller.
+     * @param[in] requestedTiles Tiles to keep
+     */
+    void ReleaseUnrequested(const std::set<TileKey> &requestedTiles);
+
+    /**
+     * @brief Gets the current state of a tile
+     * @param[in] tileKey Tile
+     * @return Current state. Absent if the tile is not in the registry.
+     */
+    TileState GetState(const TileKey &tileKey) const;
+
+    /**
+     * @brief Marks the tile as being worked on, if there is any work left to do for it.
+     * Work stops at the Meshed state, since making a tile resident is done by the render thread.
+     * @param[in] tileKey Tile
+     * @param[out] outState State the tile was in before the work started
+     * @param[out] outTileData Decoded tile data, if the tile is Decoded
+     * @return True if there is work to do. The caller must call one of the Finish functions afterwards.
+     */
+    bool BeginWork(const TileKey &tileKey, TileState &outState, std::shared_ptr<const TileData> &outTileData);
+
+    /**
+     * @brief Finishes the download of a tile
+     * @param[in] tileKey Tile
+     * @param[in] success Flag indicating whether the tile is now in the disk cache
+     */
+    void FinishDownload(const TileKey &tileKey, bool success);
+
+    /**
+     * @brief Finishes the decoding of a tile
+     * @param[in] tileKey Tile
+     * @param[in] tileData Decoded tile data. nullptr if the decoding failed.
+     */
+    void FinishDecode(const TileKey &tileKey, std::shared_ptr<const TileData> tileData);
+
+    /**
+     * @brief Finishes the meshing of a tile
+     * @param[in] tileKey Tile
+     * @param[in] tileMesh Tile mesh
+     * @return True if the mesh is still needed and should be published to the render thread
+     */
+    bool FinishMesh(const TileKey &tileKey, std::shared_ptr<const TileMesh> tileMesh);
+
+    /**
+     * @brief Marks the meshed tiles that the render thread started drawing as Resident
+     * @param[in] tileKeys Tiles being drawn
+     * @param[out] outLatencies Time from the resident request until the tile became resident, for each tile that became resident (in seconds)
+     */
+    void MarkResident(const std::vector<TileKey> &tileKeys, std::vector<double> &outLatencies);
+
+    /**
+     * @brief Gets the registry statistics. Latency statistics are accumulated since the last reset.
+     * @return Registry statistics
+     */
+    Stats GetStats() const;
+
+    /**
+     * @brief Resets the accumulated statistics
+     */
+    void ResetStats();
+
+    /**
+     * @brief Gets the name of a tile state
+     * @param[in] state Tile state
+     * @return Name of the state
+     */
+    static const char* GetStateName(TileState state);
+
+private:
+    /**
+     * @brief Drops the in-memory data of a tile that goes beyond its target state.
+     * Must be called with the registry lock held.
+     * @param[in] entry Tile entry
+     */
+    void ReleaseExcessData(TileEntry &entry);
+
+    /**
+     * @brief Queries whether a worker still has work to do for the tile.
+     * Must be called with the registry lock held.
+     * @param[in] entry Tile entry
+     * @return True if the tile has not reached min(target state, Meshed) yet
+     */
+    bool NeedsWork(const TileEntry &entry) const;
+
+    /**
+     * @brief Removes the entry if it is idle and no longer requested.
+     * Must be called with the registry lock held.
+     * @param[in] it Iterator to the tile entry
+     */
+    void EraseIfUnused(std::map<TileKey, TileEntry>::iterator it);
+
+    /**
+     * @brief Estimates the memory used by decoded tile data
+     * @param[in] tileData Tile data
+     * @return Approximate size (in bytes)
+     */
+    static size_t EstimateTileDataBytes(const TileData &tileData);
+
+    /**
+     * @brief Estimates the memory used by a tile mesh
+     * @param[in] tileMesh Tile mesh
+     * @return Approximate size (in bytes)
+     */
+    static size_t EstimateTileMeshBytes(const TileMesh &tileMesh);
+};
+
+#endif // TILE_REGISTRY_HEADER
@@ -0,0 +1,96 @@
+#ifndef TILE_STAGE_STATS_HEADER
+#define TILE_STAGE_STATS_HEADER
+
+#include "Core/LatencyHistogram.hpp"
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+
+/**
+ * Distribution of the time tiles spend in each stage of the tile pipeline,
+ * from waiting in the job queue to being uploaded to the vertex buffer.
+ * Each stage has its own histogram, so that the slowest stage on a given
+ * machine stands out. Stages are recorded from the worker threads and the
+ * render thread alike.
+ */
+class TileStageStats
+{
+public:
+    // Stage of the tile pipeline
+    enum class Stage
+    {
+        QueueWait = 0,  // Waiting in the job queue for a worker
+        Download,       // Downloading the tile into the disk cache
+        DiskRead,       // Reading the cached tile file
+        XmlParse,       // Parsing the XML of the tile file
+        NodeJoin,       // Resolving the node references of the ways into buildings, highways and water features
+        Triangulation,  // Triangulating the polygons of the tile mesh
+        MeshBuild,      // Building the tile mesh, excluding triangulation
+        Upload,         // Writing the tile mesh into the vertex buffer or the staging buffer
+        Count
+    };
+
+    static const size_t NUM_STAGES = static_cast<size_t>(Stage::Count);
+
+    // Time a single tile job spent in each stage
+    struct StageTimes
+    {
+        std::array<double, NUM_STAGES> seconds; // Time spent in each stage (in seconds). 0 if the job skipped the stage.
+    };
+
+private:
+    std::array<LatencyHistogram, NUM_STAGES> m_histograms;  // Times of each stage (in microseconds)
+    mutable std::mutex m_mutex;                             // Mutex guarding the histograms
+
+public:
+    /**
+     * @brief Constructor
+     */
+    TileStageStats();
+
+    /**
+     * @brief Destructor
+     */
+    ~TileStageStats();
+
+    /**
+     * @brief Records the stages that a tile job went through. Skipped stages are not recorded.
+     * @param[in] stageTimes Time the job spent in each stage
+     */
+    void AddTile(const StageTimes &stageTimes);
+
+    /**
+     * @brief Records the time a tile spent in a single stage
+     * @param[in] stage Stage
+     * @param[in] seconds Time spent in the stage (in seconds)
+     */
+    void AddStageTime(Stage stage, double seconds);
+
+    /**
+     * @brief Removes all recorded times
+     */
+    void Reset();
+
+    /**
+     * @brief Prints the count, percentiles and maximum of each stage as a table
+     * @param[in] stream Stream to print to
+     */
+    void Print(std::ostream &stream) const;
+
+    /**
+     * @brief Creates a record of a tile job that skipped every stage
+     * @return Empty stage times
+     */
+    static StageTimes CreateEmptyStageTimes();
+
+    /**
+     * @brief Gets the name of a stage
+     * @param[in] stage Stage
+     * @return Name of the stage
+     */
+    static const char* GetStageName(Stage stage);
+};
+
+#endif // TILE_STAGE_STATS_HEADER
@@ -0,0 +1,38 @@
+#ifndef TILE_MESH_HEADER
+#define TILE_MESH_HEADER
+
+#include "Core/AABB.hpp"
+#include "Map/TileKey.hpp"
+#include "Vertex.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Contiguous range of vertices in a vertex buffer that is culled as a unit
+ */
+struct MeshCluster
+{
+    uint32_t firstVertex;                   // Index of the first vertex of the cluster
+    uint32_t vertexCount;                   // Number of vertices in the cluster
+    AABB bounds;                            // Bounding box of the cluster
+};
+
+/**
+ * Mesh of a single tile, containing the clusters of every LOD level
+ */
+struct TileMesh
+{
+    static const size_t NUM_LOD_LEVELS = 3; // Number of LOD levels generated for each tile
+
+    TileKey tileKey;                        // Tile this mesh was generated from
+    glm::dvec2 origin;                      // Origin that the vertices and bounds are relative to (lon/lat)
+    AABB bounds;                            // Bounding box of the tile (all LOD levels)
+    std::array<std::vector<MeshCluster>, NUM_LOD_LEVELS> lodClusters;   // Clusters of each LOD level, from finest to coarsest
+    std::vector<Vertex> vertices;           // Vertices of all LOD levels
+};
+
+#endif // TILE_MESH_HEADER
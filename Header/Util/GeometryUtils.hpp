@@ -16,6 +16,38 @@ extern bool IsPointInsideTriangle(const glm::dvec2& point, const glm::dvec2& a,
 extern bool IsPolygonCCW(const std::vector<glm::dvec2> &polygonPoints);
 extern void PolygonTriangulation(const std::vector<glm::dvec2> &polygonPoints, std::vector<glm::dvec2> &outPoints);
 
+/**
+ * @brief Computes the absolute area of the provided polygon
+ * @param[in] polygonPoints Polygon points
+ * @return Area of the polygon (in the squared units of the points)
+ */
+extern double PolygonArea(const std::vector<glm::dvec2> &polygonPoints);
+
+/**
+ * @brief Simplifies the provided line using the Douglas-Peucker algorithm
+ * @param[in] linePoints Line points
+ * @param[in] tolerance Maximum allowed distance between the original and the simplified line
+ * @param[out] outPoints Simplified line points. The first and last points are always kept.
+ */
+extern void SimplifyLine(const std::vector<glm::dvec2> &linePoints, const double &tolerance, std::vector<glm::dvec2> &outPoints);
+
+/**
+ * @brief Simplifies the provided closed polygon outline using the Douglas-Peucker algorithm
+ * @param[in] polygonPoints Polygon points. The outline is treated as closed.
+ * @param[in] tolerance Maximum allowed distance between the original and the simplified outline
+ * @param[out] outPoints Simplified polygon points. Empty if the polygon collapsed to less than 3 points.
+ */
+extern void SimplifyPolygon(const std::vector<glm::dvec2> &polygonPoints, const double &tolerance, std::vector<glm::dvec2> &outPoints);
+
+/**
+ * @brief Computes the minimum-area oriented bounding box of the provided polygon.
+ * The box is aligned to one of the polygon edges.
+ * @param[in] polygonPoints Polygon points
+ * @param[out] outCorners Corners of the oriented bounding box, in counter-clockwise order
+ * @return Returns true if the box was computed. Returns false if the polygon has less than 3 points.
+ */
+extern bool ComputeOrientedBoundingBox(const std::vector<glm::dvec2> &polygonPoints, std::vector<glm::dvec2> &outCorners);
+
 /**
  * @brief Converts the provided longitude-latitude coordinates to cartesian coordinates
  * @param[in] lonlat Longitude-latitude coordinates
@@ -2,13 +2,32 @@
 
 #include <glm/glm.hpp>
 
-#include <vulkan/vulkan.hpp>
+/**
+ * Struct containing the attributes of a vertex other than its position.
+ * Stored in their own vertex stream, separate from the tightly packed positions.
+ */
+struct VertexAttributes
+{
+    /**
+	 * Color
+     */
+    glm::vec3 color;
 
-#include <array>
-#include <vulkan/vulkan_core.h>
+    /**
+	 * Texture coordinates
+     */
+    glm::vec2 uv;
+
+    /**
+	 * Normal
+     */
+    glm::vec3 normal;
+};
 
 /**
- * Struct containing data about a vertex
+ * Struct containing data about a vertex.
+ * On the GPU, the vertex is split into two streams: the position and the rest
+ * of the attributes (see VulkanVertexLayout).
  */
 struct Vertex
 {
@@ -33,57 +52,11 @@ struct Vertex
     glm::vec3 normal;
 
     /**
-     * @brief Gets the list of binding descriptions for this vertex
-     * @return List of binding descriptions for this vertex
-     */
-    static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions()
-    {
-        std::vector<VkVertexInputBindingDescription> ret = {};
-
-        ret.emplace_back();
-        ret.back().binding = 0;
-        ret.back().stride = sizeof(Vertex);
-        ret.back().inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-        return ret;
-    }
-
-    /**
-     * @brief Gets the list of attribute descriptions for this vertex
-     * @return List of attribute descriptions for this vertex
+     * @brief Gets the attributes of this vertex other than its position
+     * @return Attributes stored in the attribute stream
      */
-    static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions()
+    VertexAttributes GetAttributes() const
     {
-        std::vector<VkVertexInputAttributeDescription> ret = {};
-
-        // Position
-        ret.emplace_back();
-        ret.back().binding = 0;
-        ret.back().location = 0;
-        ret.back().offset = offsetof(Vertex, position);
-        ret.back().format = VK_FORMAT_R32G32B32_SFLOAT; // Three 32-bit signed floats
-
-        // Color
-        ret.emplace_back();
-        ret.back().binding = 0;
-        ret.back().location = 1;
-        ret.back().offset = offsetof(Vertex, color);
-        ret.back().format = VK_FORMAT_R32G32B32_SFLOAT; // Three 32-bit signed floats
-
-        // UV
-        ret.emplace_back();
-        ret.back().binding = 0;
-        ret.back().location = 2;
-        ret.back().offset = offsetof(Vertex, uv);
-        ret.back().format = VK_FORMAT_R32G32_SFLOAT; // Two 32-bit signed floats
-
-        // Normal
-        ret.emplace_back();
-        ret.back().binding = 0;
-        ret.back().location = 3;
-        ret.back().offset = offsetof(Vertex, normal);
-        ret.back().format = VK_FORMAT_R32G32B32_SFLOAT; // Three 32-bit signed floats
-
-        return ret;
+        return { color, uv, normal };
     }
 };
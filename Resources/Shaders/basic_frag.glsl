@@ -10,6 +10,8 @@ layout(location = 0) out vec4 finalFragColor;
 
 layout (set = 0, binding = 0) uniform CameraData
 {
+    mat4 projView;
+    mat4 lightProjView;
     vec3 position;
 } cameraData;
 
@@ -22,33 +24,33 @@ layout (set = 0, binding = 1) uniform LightData
     vec3 specular;
 } lightData;
 
-layout (set = 0, binding = 2) uniform sampler2D shadowMapSampler;
+layout (set = 0, binding = 2) uniform sampler2DShadow shadowMapSampler;
 
-// Returns 1 if in shadow, 0 if not
-float ShadowSample(vec3 fragLightSpaceNDC)
-{
-    float bias = 0.005;
-    float sampledDepth = texture(shadowMapSampler, fragLightSpaceNDC.xy).r + bias;
-    return sampledDepth < fragLightSpaceNDC.z ? 1.0 : 0.0;
-}
+// Quality preset, set when the pipeline is created
+layout (constant_id = 0) const int PCF_KERNEL_RADIUS = 1;   // Radius of the filtering kernel (in texels)
+layout (constant_id = 1) const bool SHADOWS_ENABLED = true;  // Whether the shadow map is sampled
+layout (constant_id = 2) const bool SPECULAR_ENABLED = true; // Whether specular lighting is computed
 
 // Returns percentage in shadow (0 ~ 1, 0 = 0% shadow, 1 = 100% shadow)
 float PCF(vec3 fragLightSpaceNDC)
 {
-    float ret = 0.0;
+    // The sampler compares against the shadow map, and filters the results of the neighboring texels
+    float bias = 0.005;
+    float referenceDepth = fragLightSpaceNDC.z - bias;
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMapSampler, 0));
 
-    float offsetSize = 0.001;
-    for (int dx = -1; dx <= 1; ++dx)
+    float lit = 0.0;
+    for (int dx = -PCF_KERNEL_RADIUS; dx <= PCF_KERNEL_RADIUS; ++dx)
     {
-        for (int dy = -1; dy <= 1; ++dy)
+        for (int dy = -PCF_KERNEL_RADIUS; dy <= PCF_KERNEL_RADIUS; ++dy)
         {
-            vec3 offset = vec3(dx * offsetSize, dy * offsetSize, 0.0);
-            ret += ShadowSample(fragLightSpaceNDC + offset);
+            vec2 uv = fragLightSpaceNDC.xy + vec2(dx, dy) * texelSize;
+            lit += texture(shadowMapSampler, vec3(uv, referenceDepth));
         }
     }
-    ret /= 9.0;
 
-    return ret;
+    float kernelWidth = float(2 * PCF_KERNEL_RADIUS + 1);
+    return 1.0 - lit / (kernelWidth * kernelWidth);
 }
 
 void main()
@@ -56,7 +58,7 @@ void main()
     vec3 fragLightSpaceNDC = fragLightSpacePosition.xyz / fragLightSpacePosition.w;
     fragLightSpaceNDC.xy = (fragLightSpaceNDC.xy + 1.0) / 2.0;
 
-    float shadow = PCF(fragLightSpaceNDC);
+    float shadow = SHADOWS_ENABLED ? PCF(fragLightSpaceNDC) : 0.0;
 
     vec3 ambient = vec3(0.0);
     vec3 diffuse = vec3(0.0);
@@ -77,11 +79,14 @@ void main()
     diffuse = diff * lightData.diffuse;
 
     // Specular
-    float shininess = 8.0;
-    vec3 dirToEye = normalize(cameraData.position - fragPosition);
-    vec3 r = reflect(-dirToLight, fragNormal);
-    float spec = pow(max(dot(dirToEye, r), 0.0), shininess);
-    specular = spec * lightData.specular;
+    if (SPECULAR_ENABLED)
+    {
+        float shininess = 8.0;
+        vec3 dirToEye = normalize(cameraData.position - fragPosition);
+        vec3 r = reflect(-dirToLight, fragNormal);
+        float spec = pow(max(dot(dirToEye, r), 0.0), shininess);
+        specular = spec * lightData.specular;
+    }
 
     vec3 finalColor = (ambient + (1.0 - shadow) * (diffuse + specular)) * fragColor;
     finalFragColor = vec4(finalColor, 1.0);
@@ -10,18 +10,19 @@ layout (location = 1) out vec3 fragColor;
 layout (location = 2) out vec3 fragNormal;
 layout (location = 3) out vec4 fragLightSpacePosition;
 
-layout (push_constant) uniform PushConstants
+layout (set = 0, binding = 0) uniform CameraData
 {
-    mat4 lightProjView;
     mat4 projView;
-} pushConstants;
+    mat4 lightProjView;
+    vec3 position;
+} cameraData;
 
 void main()
 {
-    gl_Position = pushConstants.projView * vec4(position, 1.0);
+    gl_Position = cameraData.projView * vec4(position, 1.0);
 
     fragPosition = position;
     fragColor = color;
     fragNormal = normal;
-    fragLightSpacePosition = pushConstants.lightProjView * vec4(position, 1.0);
+    fragLightSpacePosition = cameraData.lightProjView * vec4(position, 1.0);
 }
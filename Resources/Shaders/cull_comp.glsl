@@ -0,0 +1,66 @@
+#version 460
+
+layout (local_size_x = 64) in;
+
+struct ClusterCullData
+{
+    vec4 boundingSphere;    // xyz = center, w = radius
+    uint firstVertex;
+    uint vertexCount;
+    uint padding0;
+    uint padding1;
+};
+
+struct DrawCommand
+{
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+};
+
+layout (std430, set = 0, binding = 0) readonly buffer ClusterCullDataBuffer
+{
+    ClusterCullData clusters[];
+};
+
+layout (std430, set = 0, binding = 1) writeonly buffer DrawCommandBuffer
+{
+    DrawCommand drawCommands[];
+};
+
+layout (push_constant) uniform PushConstants
+{
+    vec4 frustumPlanes[6];  // xyz = inward-facing normal, w = distance
+    uint clusterCount;
+    uint drawCommandOffset; // Index of the first draw command to write to
+} pushConstants;
+
+void main()
+{
+    uint clusterIndex = gl_GlobalInvocationID.x;
+    if (clusterIndex >= pushConstants.clusterCount)
+    {
+        return;
+    }
+
+    ClusterCullData cluster = clusters[clusterIndex];
+
+    bool visible = true;
+    for (int i = 0; i < 6; ++i)
+    {
+        vec4 plane = pushConstants.frustumPlanes[i];
+        if (dot(plane.xyz, cluster.boundingSphere.xyz) + plane.w < -cluster.boundingSphere.w)
+        {
+            visible = false;
+            break;
+        }
+    }
+
+    // Culled clusters are kept as empty draws so that the draw count stays fixed
+    uint drawIndex = pushConstants.drawCommandOffset + clusterIndex;
+    drawCommands[drawIndex].vertexCount = cluster.vertexCount;
+    drawCommands[drawIndex].instanceCount = visible ? 1 : 0;
+    drawCommands[drawIndex].firstVertex = cluster.firstVertex;
+    drawCommands[drawIndex].firstInstance = 0;
+}
@@ -3,13 +3,14 @@
 
 layout (location = 0) in vec3 position;
 
-layout (push_constant) uniform PushConstants
+layout (set = 0, binding = 0) uniform CameraData
 {
-    mat4 lightProjView; // Technically not needed, but for the sake of reusing the PushContants struct in the C++ app
     mat4 projView;
-} pushConstants;
+    mat4 lightProjView;
+    vec3 position;
+} cameraData;
 
 void main()
 {
-    gl_Position = pushConstants.projView * vec4(position, 1.0);
+    gl_Position = cameraData.lightProjView * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -2,15 +2,18 @@
 
 #include "Core/Camera.hpp"
 #include "Core/Input.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
 #include "Core/Util/FileUtils.hpp"
-#include "Map/BuildingData.hpp"
-#include "Map/HighwayData.hpp"
 #include "Map/TileData.hpp"
-#include "Map/OSMTileDataSource.hpp"
+#include "Map/TileDataSourceFactory.hpp"
 #include "Util/GeometryUtils.hpp"
 #include "Vertex.hpp"
+#include "Core/Vulkan/VulkanComputePipelineBuilder.hpp"
 #include "Core/Vulkan/VulkanGraphicsPipelineBuilder.hpp"
 #include "Core/Vulkan/VulkanContext.hpp"
+#include "Core/Vulkan/VulkanPipelineCache.hpp"
+#include "Core/Vulkan/VulkanVertexLayout.hpp"
 #include "glm/ext/matrix_transform.hpp"
 #include "glm/fwd.hpp"
 #include "glm/geometric.hpp"
@@ -20,27 +23,100 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <memory>
 #include <thread>
 
 const uint32_t SHADOW_MAP_WIDTH = 1024;
 const uint32_t SHADOW_MAP_HEIGHT = 1024;
+const float SHADOW_MAP_HALF_EXTENT = 20.0f;         // Half of the area covered by the shadow map (world-space)
+const float SHADOW_MAP_REFRESH_DISTANCE = 4.0f;     // Distance from the shadow map anchor at which the shadow map is rendered again (world-space)
 
 /**
  * @brief Constructor
+ * @param[in] launchOptions Options selected on the command line
  */
-Application::Application()
+Application::Application(const LaunchOptions &launchOptions)
     : m_isRunning(false)
+    , m_exitRequested(false)
+    , m_startTime()
+    , m_launchOptions(launchOptions)
+    , m_qualityPipelines()
+    , m_shaderQuality(NUM_SHADER_QUALITY_PRESETS - 1)
+    , m_hudPipelineLayout(VK_NULL_HANDLE)
+    , m_hudPipeline(VK_NULL_HANDLE)
+    , m_uploadEngine()
+    , m_uploadEngineEnabled(false)
+    , m_vertexUploadValue(0)
+    , m_cullDescriptorSetLayout(VK_NULL_HANDLE)
+    , m_cullDescriptorPool(VK_NULL_HANDLE)
+    , m_cullPipelineLayout(VK_NULL_HANDLE)
+    , m_cullPipeline(VK_NULL_HANDLE)
+    , m_gpuCullingEnabled(false)
     , m_camera()
+    , m_residentTilesDirty(false)
+    , m_meshOriginTileIndex(0)
+    , m_meshOrigin(0.0)
+    , m_tilePyramid(BASE_ZOOM_LEVEL, MIN_ZOOM_LEVEL)
+    , m_viewDistance(4)
+    , m_prefetchDistance(1)
+    , m_visibleTiles()
+    , m_visibleTileSet()
+    , m_tileRegistry()
+    , m_tileStageStats()
+    , m_tileMeshBuilder(SCALE)
+    , m_publishedTileMeshes()
+    , m_readyTileMeshes()
+    , m_prefetchPredictor()
+    , m_vertexAllocator(MAX_VERTEX_COUNT)
+    , m_residentTiles()
+    , m_uploadQueue()
+    , m_pendingVertexFrees()
+    , m_frameNumber(0)
+    , m_uploadBudgetBytes(static_cast<size_t>(launchOptions.uploadBudgetKilobytes) * 1024)
+    , m_uploadBudgetMicroseconds(launchOptions.uploadBudgetMicroseconds)
+    , m_uploadStats()
+    , m_selectedClusters()
+    , m_selectedTileGroups()
+    , m_recordingJobSystem()
+    , m_tileCountPerLod()
+    , m_gpuCullingOverflowTileCount(0)
+    , m_gpuCullingOverflowFrames(0)
+    , m_maxGpuCullingOverflowTileCount(0)
+    , m_mainPassCullingStats()
+    , m_shadowPassCullingStats()
+    , m_shadowMapAnchor(0.0f)
+    , m_shadowMapLightMatrix(1.0f)
+    , m_shadowMapClusters()
+    , m_shadowMapDirty(true)
+    , m_shadowMapRenderCount(0)
+    , m_cameraPath()
+    , m_benchmarkRecorder()
+    , m_gpuTimer()
+    , m_gpuZoneResults()
+    , m_frameTileLatencies()
+    , m_hudOverlay()
+    , m_lastCpuFrameMilliseconds(0.0)
+    , m_lastGpuFrameMilliseconds(-1.0)
     , m_workerThreadRunning(true)
+    , m_tileDataSource()
     , m_retrieveTileJobs()
     , m_retrieveTileJobsMutex()
-    , m_tilesUpdateMutex()
-    , m_tilesUpdated(false)
+    , m_retrieveTileJobCount(0)
 {
+    m_hudOverlay.SetVisible(m_launchOptions.showHud);
+    m_prefetchPredictor.SetLookaheadSeconds(m_launchOptions.prefetchLookaheadSeconds);
+    m_prefetchPredictor.SetSampleInterval(m_launchOptions.prefetchSampleInterval);
+    m_prefetchPredictor.SetVelocitySmoothing(m_launchOptions.prefetchVelocitySmoothing);
+    m_prefetchPredictor.SetForwardBias(m_launchOptions.prefetchForwardBias);
 }
 
 /**
@@ -62,32 +138,84 @@ void Application::Run()
         return;
     }
     m_isRunning = true;
+    m_startTime = std::chrono::steady_clock::now();
+
+    if (!m_launchOptions.cameraPathFile.empty() && !m_cameraPath.LoadFromFile(m_launchOptions.cameraPathFile))
+    {
+        LOG_ERROR("[Application] Failed to load camera path " << m_launchOptions.cameraPathFile << "!");
+        return;
+    }
+
+    // The workers share one hierarchy of data sources, so its caches and memory budget are shared as well
+    m_tileDataSource = TileDataSourceFactory::Create(m_launchOptions.tileSources, m_launchOptions.syntheticTileSettings);
+    if (m_tileDataSource == nullptr)
+    {
+        LOG_ERROR("[Application] Invalid tile sources " << m_launchOptions.tileSources << "!");
+        return;
+    }
 
     if (!Init())
     {
-        std::cout << "[Application] Failed to initialize application!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize application!");
         return;
     }
 
-    const uint32_t MAX_VERTEX_COUNT = 1000000;
-    if (!m_testVertexBuffer.Create(sizeof(Vertex) * MAX_VERTEX_COUNT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    // Tiles are streamed into device-local memory through the transfer queue if possible.
+    // Otherwise, the vertex buffer lives in host-visible memory and is written directly.
+    m_uploadEngineEnabled = m_uploadEngine.Create(STAGING_BUFFER_SIZE);
+    if (m_uploadEngineEnabled)
     {
-        std::cerr << "Failed to create vertex buffer!" << std::endl;
+        std::vector<uint32_t> queueFamilyIndices = { VulkanContext::GetGraphicsQueueIndex(), VulkanContext::GetTransferQueueIndex() };
+        if (!m_positionBuffer.Create(sizeof(glm::vec3) * MAX_VERTEX_COUNT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queueFamilyIndices)
+            || !m_attributeBuffer.Create(sizeof(VertexAttributes) * MAX_VERTEX_COUNT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queueFamilyIndices))
+        {
+            LOG_ERROR("Failed to create vertex buffer!");
+        }
+    }
+    else
+    {
+        m_uploadEngine.Cleanup();
+        LOG_INFO("[Application] Uploading tiles without the transfer queue");
+        if (!m_positionBuffer.Create(sizeof(glm::vec3) * MAX_VERTEX_COUNT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+            || !m_attributeBuffer.Create(sizeof(VertexAttributes) * MAX_VERTEX_COUNT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        {
+            LOG_ERROR("Failed to create vertex buffer!");
+        }
     }
 
-    const int ZOOM_LEVEL = 16;
-    glm::ivec2 tileIndex = GeometryUtils::LonLatToTileIndex(139.75, 35.6, 16);
+    // The benchmark starts where its camera path does
+    glm::dvec2 startLonLat = m_cameraPath.IsEmpty() ? glm::dvec2(139.75, 35.6) : m_cameraPath.Sample(0.0).lonLat;
+    glm::ivec2 tileIndex = GeometryUtils::LonLatToTileIndex(startLonLat.x, startLonLat.y, BASE_ZOOM_LEVEL);
     UpdateCurrentTile(tileIndex);
 
-    double prevTime = glfwGetTime();
+    double prevTime = GetElapsedTime();
+    double prevCullingStatsReportTime = prevTime;
+    double prevTileStageReportTime = prevTime;
+    double loopStartTime = prevTime;
 
     m_camera.SetFieldOfView(60.0f);
-    m_camera.SetAspectRatio(m_window.GetWidth() * 1.0f / m_window.GetHeight());
+    m_camera.SetAspectRatio(m_vkSwapchainImageExtent.width * 1.0f / m_vkSwapchainImageExtent.height);
     m_camera.SetPosition(glm::vec3(0.0f, 2.0f, 0.0f));
     m_camera.SetWorldUpVector(glm::vec3(0.0f, 1.0f, 0.0f));
 
+    // The benchmark camera is placed at the start of its path, and the predictor must not take that jump as motion
+    if (!m_cameraPath.IsEmpty())
+    {
+        CameraPath::Keyframe pose = m_cameraPath.Sample(0.0);
+        m_camera.SetPosition(GetCameraPathPosition(pose));
+        m_camera.SetYaw(pose.yaw);
+        m_camera.SetPitch(glm::clamp(pose.pitch, -89.0f, 89.0f));
+        m_prefetchPredictor.ResetMotion();
+    }
+
     glm::vec3 dirLightDirection = glm::vec3(0.0f, -1.0f, 1.0f);
 
+    Profiler::SetThreadName("Render");
+    if (!m_launchOptions.profileTraceFile.empty())
+    {
+        Profiler::SetEnabled(true);
+    }
+
     m_workerThreadRunning = true;
     std::thread workerThread1(std::bind(&Application::WorkerThreadFunc, this, true)); // Worker thread that downloads data if needed
     std::thread workerThread2(std::bind(&Application::WorkerThreadFunc, this, false)); // Worker thread that only focuses on cached tiles
@@ -95,51 +223,210 @@ void Application::Run()
     uint32_t currentFrame = 0;
 
     // Game loop
-    while (!m_window.IsClosed())
+    while (!ShouldExit())
     {
-        double currentTime = glfwGetTime();
+        PROFILE_SCOPE("Frame");
+
+        double currentTime = GetElapsedTime();
         float deltaTime = static_cast<float>(currentTime - prevTime);
         prevTime = currentTime;
+        m_hudOverlay.AddFrameTime(deltaTime * 1000.0);
 
-        // --- Camera input ---
-        glm::vec3 cameraMovement(0.0f);
-        if (Input::IsKeyDown(Input::Key::W))
+        // The benchmark ends with its camera path
+        double pathTime = currentTime - loopStartTime;
+        if (!m_cameraPath.IsEmpty() && (pathTime > m_cameraPath.GetDuration()))
+        {
+            RequestExit();
+            continue;
+        }
+
+        if (Input::IsKeyPressed(Input::Key::G) && (m_cullPipeline != VK_NULL_HANDLE))
+        {
+            m_gpuCullingEnabled = !m_gpuCullingEnabled;
+            LOG_INFO("[Application] Culling is now done on the " << (m_gpuCullingEnabled ? "GPU" : "CPU"));
+        }
+
+        if (Input::IsKeyPressed(Input::Key::P))
         {
-            cameraMovement.z =  1.0f;
+            ToggleProfiling();
         }
-        if (Input::IsKeyDown(Input::Key::S))
+
+        if (Input::IsKeyPressed(Input::Key::H))
         {
-            cameraMovement.z = -1.0f;
+            m_hudOverlay.SetVisible(!m_hudOverlay.IsVisible());
         }
-        if (Input::IsKeyDown(Input::Key::A))
+
+        if (Input::IsKeyPressed(Input::Key::Q))
         {
-            cameraMovement.x = -1.0f;
+            m_shaderQuality = (m_shaderQuality + 1) % NUM_SHADER_QUALITY_PRESETS;
+            LOG_INFO("[Application] Shader quality is now " << SHADER_QUALITY_SETTINGS[m_shaderQuality].name);
+
+            // The cached main pass command buffers bind the pipeline of the previous preset
+            for (FrameData &frameData : m_frameDataList)
+            {
+                for (auto &pair : frameData.tileGroupCommands)
+                {
+                    pair.second.isRecorded = false;
+                }
+            }
         }
-        if (Input::IsKeyDown(Input::Key::D))
+
+        if (Input::IsKeyPressed(Input::Key::UP) || Input::IsKeyPressed(Input::Key::DOWN))
         {
-            cameraMovement.x =  1.0f;
+            int viewDistance = m_viewDistance + (Input::IsKeyPressed(Input::Key::UP) ? 1 : -1);
+            viewDistance = glm::clamp(viewDistance, 1, MAX_VIEW_DISTANCE);
+            if (viewDistance != m_viewDistance)
+            {
+                m_viewDistance = viewDistance;
+                UpdateVisibleTiles();
+                LOG_INFO("[Application] View distance is now " << m_viewDistance << " tiles (" << m_visibleTiles.size() << " tiles visible)");
+            }
         }
-        if (glm::dot(cameraMovement, cameraMovement) > 0.0f)
+
+        // Report the time tiles spent in each pipeline stage so far
+        if (currentTime - prevTileStageReportTime >= TILE_STAGE_REPORT_INTERVAL)
         {
-            cameraMovement = glm::normalize(cameraMovement);
+            prevTileStageReportTime = currentTime;
+            m_tileStageStats.Print(std::cout);
         }
-        cameraMovement *= 10.0f * deltaTime;
 
-        float yaw = m_camera.GetYaw() + Input::GetMouseDeltaX() * 0.25f;
-        float pitch = m_camera.GetPitch() - Input::GetMouseDeltaY() * 0.25f;
-        pitch = glm::clamp(pitch, -89.0f, 89.0f);
-        m_camera.SetYaw(yaw);
-        m_camera.SetPitch(pitch);
+        // Report the LOD and culling results of the last frame every few seconds.
+        // GPU culling results stay on the GPU, so only CPU culling is reported.
+        if (currentTime - prevCullingStatsReportTime >= 5.0)
+        {
+            prevCullingStatsReportTime = currentTime;
 
-        m_camera.SetPosition
-        (
-            m_camera.GetPosition() + cameraMovement.x * m_camera.GetRightVector() + cameraMovement.z * m_camera.GetForwardVector()
-        );
+            uint32_t selectedVertexCount = 0;
+            for (const MeshCluster &cluster : m_selectedClusters)
+            {
+                selectedVertexCount += cluster.vertexCount;
+            }
+            std::ostringstream lodReport;
+            lodReport << "[Application] Tiles per LOD level:";
+            for (size_t i = 0; i < NUM_LOD_LEVELS; ++i)
+            {
+                lodReport << " " << m_tileCountPerLod[i];
+            }
+            LOG_INFO(lodReport.str() << ". " << selectedVertexCount << " vertices selected.");
+
+            const TilePrefetchPredictor::Stats &predictionStats = m_prefetchPredictor.GetStats();
+            uint32_t newlyVisibleTiles = predictionStats.hits + predictionStats.misses;
+            if ((newlyVisibleTiles > 0) || (predictionStats.predictedTiles > 0))
+            {
+                LOG_INFO("[Application] Prefetch prediction: " << (newlyVisibleTiles > 0 ? 100 * predictionStats.hits / newlyVisibleTiles : 0) << "% hit rate ("
+                    << predictionStats.hits << " of " << newlyVisibleTiles << " newly visible tiles predicted), "
+                    << predictionStats.predictedTiles << " tiles predicted, " << predictionStats.expiredTiles << " expired.");
+            }
+            m_prefetchPredictor.ResetStats();
+
+            TileRegistry::Stats registryStats = m_tileRegistry.GetStats();
+            std::ostringstream registryReport;
+            registryReport << "[Application] Tile states:";
+            for (size_t i = 0; i < registryStats.tileCountPerState.size(); ++i)
+            {
+                registryReport << " " << TileRegistry::GetStateName(static_cast<TileRegistry::TileState>(i)) << "=" << registryStats.tileCountPerState[i];
+            }
+            registryReport << ". " << registryStats.meshBytes / (1024 * 1024) << " MB meshes, " << registryStats.decodedBytes / (1024 * 1024) << " MB decoded data, "
+                << registryStats.coalescedRequests << " duplicate requests coalesced";
+            if (registryStats.residentLatencyCount > 0)
+            {
+                registryReport << ", " << static_cast<int>(1000.0 * registryStats.totalResidentLatency / registryStats.residentLatencyCount) << " ms average time to resident";
+            }
+            LOG_INFO(registryReport.str() << ".");
+            m_tileRegistry.ResetStats();
+
+            std::ostringstream uploadReport;
+            uploadReport << "[Application] Uploads: " << m_uploadStats.uploadedTiles << " tiles, " << m_uploadStats.uploadedBytes / (1024 * 1024) << " MB in "
+                << m_uploadStats.framesWithUploads << " frames (";
+            if (m_uploadStats.framesWithUploads > 0)
+            {
+                uploadReport << m_uploadStats.totalUploadMicroseconds / m_uploadStats.framesWithUploads << " us average, ";
+            }
+            uploadReport << m_uploadStats.maxFrameUploadMicroseconds << " us max per frame). Backlog: " << m_uploadQueue.size() << " tiles ("
+                << m_uploadStats.maxBacklogDepth << " max). Vertex buffer: " << m_vertexAllocator.GetAllocatedSize() << " of " << MAX_VERTEX_COUNT << " vertices used. "
+                << m_uploadStats.framesWaitingForTransfer << " frames waited on the transfer queue.";
+            LOG_INFO(uploadReport.str());
+            m_uploadStats = {};
+
+            if (!m_gpuCullingEnabled)
+            {
+                LOG_INFO("[Application] Main pass: " << m_mainPassCullingStats.drawnTriangles << " triangles drawn, "
+                    << m_mainPassCullingStats.culledTriangles << " culled, " << m_mainPassCullingStats.drawCalls << " draw calls. "
+                    << "Shadow pass: " << m_shadowPassCullingStats.drawnTriangles << " triangles drawn, "
+                    << m_shadowPassCullingStats.culledTriangles << " culled, " << m_shadowPassCullingStats.drawCalls << " draw calls.");
+            }
+            if (m_gpuCullingOverflowFrames > 0)
+            {
+                LOG_WARNING("[Application] " << m_gpuCullingOverflowFrames << " frames had more than " << MAX_CLUSTER_COUNT << " clusters and were culled on the CPU, with up to "
+                    << m_maxGpuCullingOverflowTileCount << " tiles beyond the GPU cull buffer.");
+                m_gpuCullingOverflowFrames = 0;
+                m_maxGpuCullingOverflowTileCount = 0;
+            }
+            LOG_INFO("[Application] Shadow map rendered in " << m_shadowMapRenderCount << " frames, cached in the others.");
+            m_shadowMapRenderCount = 0;
+        }
+
+        // --- Camera input ---
+        glm::vec3 cameraDisplacement(0.0f);
+        if (!m_cameraPath.IsEmpty())
+        {
+            // The camera path replaces the user input, and is relative to the current origin like the camera
+            CameraPath::Keyframe pose = m_cameraPath.Sample(pathTime);
+            cameraDisplacement = GetCameraPathPosition(pose) - m_camera.GetPosition();
+            m_camera.SetYaw(pose.yaw);
+            m_camera.SetPitch(glm::clamp(pose.pitch, -89.0f, 89.0f));
+        }
+        else
+        {
+            glm::vec3 cameraMovement(0.0f);
+            if (Input::IsKeyDown(Input::Key::W))
+            {
+                cameraMovement.z =  1.0f;
+            }
+            if (Input::IsKeyDown(Input::Key::S))
+            {
+                cameraMovement.z = -1.0f;
+            }
+            if (Input::IsKeyDown(Input::Key::A))
+            {
+                cameraMovement.x = -1.0f;
+            }
+            if (Input::IsKeyDown(Input::Key::D))
+            {
+                cameraMovement.x =  1.0f;
+            }
+            if (glm::dot(cameraMovement, cameraMovement) > 0.0f)
+            {
+                cameraMovement = glm::normalize(cameraMovement);
+            }
+            cameraMovement *= 10.0f * deltaTime;
+
+            float yaw = m_camera.GetYaw() + Input::GetMouseDeltaX() * 0.25f;
+            float pitch = m_camera.GetPitch() - Input::GetMouseDeltaY() * 0.25f;
+            pitch = glm::clamp(pitch, -89.0f, 89.0f);
+            m_camera.SetYaw(yaw);
+            m_camera.SetPitch(pitch);
+
+            cameraDisplacement = cameraMovement.x * m_camera.GetRightVector() + cameraMovement.z * m_camera.GetForwardVector();
+        }
+
+        m_camera.SetPosition(m_camera.GetPosition() + cameraDisplacement);
 
         glm::dvec2 playerWorldPosition = { m_camera.GetPosition().x / SCALE, m_camera.GetPosition().z / SCALE };
         playerWorldPosition += GeometryUtils::LonLatToXY(m_origin);
         glm::dvec2 playerLonLat = GeometryUtils::XYToLonLat(playerWorldPosition.x, playerWorldPosition.y);
-        glm::ivec2 newTileIndex = GeometryUtils::LonLatToTileIndex(playerLonLat.x, playerLonLat.y, ZOOM_LEVEL);
+
+        // Feed the camera motion (in world-space meters) to the prefetch predictor
+        glm::vec3 cameraForward = m_camera.GetForwardVector();
+        m_prefetchPredictor.Update
+        (
+            playerWorldPosition,
+            glm::dvec2(cameraDisplacement.x, cameraDisplacement.z) / SCALE,
+            glm::dvec2(cameraForward.x, cameraForward.z),
+            deltaTime
+        );
+
+        glm::ivec2 newTileIndex = GeometryUtils::LonLatToTileIndex(playerLonLat.x, playerLonLat.y, BASE_ZOOM_LEVEL);
         if (newTileIndex != m_currentTileIndex)
         {
             UpdateCurrentTile(newTileIndex);
@@ -151,35 +438,26 @@ void Application::Run()
             m_camera.SetPosition(glm::vec3(playerWorldPosition.x, m_camera.GetPosition().y, playerWorldPosition.y));
         }
 
-        if (m_tilesUpdateMutex.try_lock())
+        std::vector<TileKey> predictedTiles;
+        if (m_prefetchPredictor.PredictTiles(m_tilePyramid, m_viewDistance, m_visibleTileSet, predictedTiles))
         {
-            if (m_tilesUpdated)
-            {
-                std::vector<Vertex> vertices;
-
-                const uint32_t MAX_VERTEX_COUNT = 1000000;
-                Vertex *data = reinterpret_cast<Vertex*>(m_testVertexBuffer.MapMemory(0, MAX_VERTEX_COUNT * sizeof(Vertex)));
-
-                m_numVertices = 0;
-                for (size_t i = 0; i < m_activeTiles.size(); ++i)
-                {
-                    vertices.clear();
-                    AppendTileGeometryVertices(m_activeTiles[i], m_origin, vertices);
-                    memcpy(data + m_numVertices, vertices.data(), sizeof(Vertex) * vertices.size());
-                    m_numVertices += vertices.size();
-                }
-
-                m_testVertexBuffer.UnmapMemory();
-
-                m_tilesUpdated = false;
-            }
+            QueuePredictedTiles(predictedTiles);
+        }
 
-            m_tilesUpdateMutex.unlock();
+        // Tiles finished by the worker threads, a new origin, or a new set of
+        // visible tiles change what is in the vertex buffer
+        CollectPublishedTileMeshes();
+        if (m_residentTilesDirty)
+        {
+            PROFILE_SCOPE("Update resident tiles");
+            UpdateResidentTiles();
+            m_residentTilesDirty = false;
         }
 
         // --- Draw frame start ---
 
         // Wait for the current frame to be done rendering
+        std::chrono::steady_clock::time_point fenceWaitStartTime = std::chrono::steady_clock::now();
         vkWaitForFences
         (
             VulkanContext::GetLogicalDevice(),
@@ -188,95 +466,221 @@ void Application::Run()
             VK_TRUE,
             UINT64_MAX
         );
+        std::chrono::steady_clock::time_point fenceWaitEndTime = std::chrono::steady_clock::now();
+        double fenceWaitMilliseconds = std::chrono::duration<double, std::milli>(fenceWaitEndTime - fenceWaitStartTime).count();
+        Profiler::AddEvent("Wait for frame fence", fenceWaitStartTime, fenceWaitEndTime);
+
+        // The GPU is done with this frame's slice of the uniform buffer, so it can be reused.
+        // The slice size is checked in InitDescriptors, so a failure here is fatal. The loop
+        // exits before the fence is reset, so that the final wait on the fence does not block.
+        m_uniformBufferRing.BeginFrame(currentFrame);
+        std::array<uint32_t, 2> dynamicOffsets = { 0, 0 };
+        CameraData *cameraDataUBO = m_uniformBufferRing.Allocate<CameraData>(dynamicOffsets[0]);
+        LightData *lightDataUBO = m_uniformBufferRing.Allocate<LightData>(dynamicOffsets[1]);
+        if ((cameraDataUBO == nullptr) || (lightDataUBO == nullptr))
+        {
+            LOG_ERROR("[Application] Failed to allocate the frame's uniforms!");
+            RequestExit();
+            continue;
+        }
+
         vkResetFences
         (
             VulkanContext::GetLogicalDevice(), 
             1, 
             &m_frameDataList[currentFrame].renderDoneFence
         );
+        CollectGpuTime(currentFrame);
 
-        uint32_t nextImageIndex;
-        VkResult acquireImageResult = vkAcquireNextImageKHR
-        (
-            VulkanContext::GetLogicalDevice(), 
-            m_vkSwapchain, 
-            UINT64_MAX, 
-            m_frameDataList[currentFrame].imageAvailableSemaphore, 
-            VK_NULL_HANDLE, 
-            &nextImageIndex
-        );
-        if ((acquireImageResult != VK_SUCCESS) && (acquireImageResult != VK_SUBOPTIMAL_KHR))
+        // Upload a bounded amount of the queued tiles, into vertex ranges that no frame in flight reads
+        ReleasePendingVertexRanges();
+        uint64_t uploadedBytesBefore = m_uploadStats.uploadedBytes;
+        m_frameTileLatencies.clear();
         {
-            std::cerr << "Failed to acquire next image!" << std::endl;
-            glfwSetWindowShouldClose(m_window.GetHandle(), GLFW_TRUE);
-            continue;
+            PROFILE_SCOPE("Upload queued tiles");
+            UploadQueuedTiles();
+        }
+        uint64_t frameUploadedBytes = m_uploadStats.uploadedBytes - uploadedBytesBefore;
+
+        // Vertices are relative to the mesh origin, so rendering is done relative to it as well
+        glm::vec3 meshOriginOffset = GetMeshOriginOffset();
+        glm::vec3 renderCameraPosition = m_camera.GetPosition() - meshOriginOffset;
+
+        // Pick the LOD level of each tile. The GPU is also done with this frame's
+        // cluster data buffer, so the selected clusters can be written to it.
+        {
+            PROFILE_SCOPE("Select tile LODs");
+            SelectTileLods(renderCameraPosition, static_cast<float>(m_vkSwapchainImageExtent.height));
+        }
+
+        // The GPU cull buffer holds MAX_CLUSTER_COUNT clusters. Frames with more are culled on the CPU.
+        bool useGpuCulling = m_gpuCullingEnabled && !m_selectedClusters.empty() && (m_gpuCullingOverflowTileCount == 0);
+        if (m_gpuCullingEnabled && (m_gpuCullingOverflowTileCount > 0))
+        {
+            ++m_gpuCullingOverflowFrames;
+            m_maxGpuCullingOverflowTileCount = glm::max(m_maxGpuCullingOverflowTileCount, m_gpuCullingOverflowTileCount);
+        }
+        if (useGpuCulling)
+        {
+            ClusterCullData *clusterData = m_frameDataList[currentFrame].clusterCullData;
+            for (size_t i = 0; i < m_selectedClusters.size(); ++i)
+            {
+                const MeshCluster &cluster = m_selectedClusters[i];
+                clusterData[i].boundingSphere = glm::vec4(cluster.bounds.GetCenter(), glm::length(cluster.bounds.GetHalfExtents()));
+                clusterData[i].firstVertex = cluster.firstVertex;
+                clusterData[i].vertexCount = cluster.vertexCount;
+            }
+        }
+
+        // In headless mode, each frame renders into its own offscreen image, so there is nothing to acquire
+        uint32_t nextImageIndex = currentFrame;
+        if (!m_launchOptions.headless)
+        {
+            PROFILE_SCOPE("Acquire image");
+            VkResult acquireImageResult = vkAcquireNextImageKHR
+            (
+                VulkanContext::GetLogicalDevice(), 
+                m_vkSwapchain, 
+                UINT64_MAX, 
+                m_frameDataList[currentFrame].imageAvailableSemaphore, 
+                VK_NULL_HANDLE, 
+                &nextImageIndex
+            );
+            if ((acquireImageResult != VK_SUCCESS) && (acquireImageResult != VK_SUBOPTIMAL_KHR))
+            {
+                LOG_ERROR("Failed to acquire next image!");
+                RequestExit();
+                continue;
+            }
         }
+        bool dumpFrame = m_launchOptions.headless && (m_readbackBuffer.GetHandle() != VK_NULL_HANDLE) && (m_launchOptions.dumpFrames.count(m_frameNumber) > 0);
 
         // --- Build render commands ---
-        
+
+        // The shadow map is only rendered again when the camera left its anchor or the drawn tiles changed
+        bool renderShadowMap = UpdateShadowMapAnchor(renderCameraPosition, dirLightDirection);
+        glm::mat4 lightMatrix = m_shadowMapLightMatrix;
+        glm::mat4 projView = m_camera.GetProjectionMatrix() * m_camera.GetViewMatrix() * glm::translate(glm::mat4(1.0f), meshOriginOffset);
+
+        // Update camera UBO
+        cameraDataUBO->projView = projView;
+        cameraDataUBO->lightProjView = lightMatrix;
+        cameraDataUBO->position = renderCameraPosition;
+
+        // Update LightData UBO
+        lightDataUBO->lightPosition = glm::vec4(dirLightDirection, 0.0f);
+        lightDataUBO->ambient = { 0.1f, 0.1f, 0.1f };
+        lightDataUBO->diffuse = { 1.0f, 1.0f, 1.0f };
+        lightDataUBO->specular = { 1.0f, 1.0f, 1.0 };
+
+        // Without GPU culling, the tile groups are drawn by cached secondary command buffers.
+        // Only the groups whose clusters changed are recorded again, in parallel.
+        if (!useGpuCulling)
+        {
+            PROFILE_SCOPE("Update tile group commands");
+            UpdateTileGroupCommands(m_frameDataList[currentFrame], dynamicOffsets);
+        }
+        VkSubpassContents subpassContents = useGpuCulling ? VK_SUBPASS_CONTENTS_INLINE : VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+
+        // The overlay is drawn last in the main pass, on top of the tiles. When the main pass
+        // only executes secondary command buffers, the overlay is drawn by one as well.
+        uint32_t hudVertexCount = 0;
+        if (m_hudOverlay.IsVisible() && (m_hudPipeline != VK_NULL_HANDLE))
+        {
+            PROFILE_SCOPE("Update HUD");
+            hudVertexCount = UpdateHud(m_frameDataList[currentFrame]);
+            if ((hudVertexCount > 0) && !useGpuCulling && !RecordHudCommands(m_frameDataList[currentFrame], hudVertexCount))
+            {
+                hudVertexCount = 0;
+            }
+        }
+
         // Start command buffer recording
+        std::chrono::steady_clock::time_point recordStartTime = std::chrono::steady_clock::now();
         VkCommandBuffer &commandBuffer = m_frameDataList[currentFrame].commandBuffer;
         vkResetCommandBuffer(commandBuffer, 0);
         VkCommandBufferBeginInfo commandBufferBeginInfo {};
         commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS)
         {
-            std::cout << "Failed to begin recording command buffer!" << std::endl;
-            glfwSetWindowShouldClose(m_window.GetHandle(), GLFW_TRUE);
+            LOG_ERROR("Failed to begin recording command buffer!");
+            RequestExit();
             continue;
         }
 
-        glm::mat4 lightProj = glm::orthoRH_ZO(-20.0f, 20.0f, -20.0f, 20.0f, 1.0f, 50.0f);
-        lightProj[1][1] *= -1.0f;
-        glm::mat4 lightView = glm::lookAt(m_camera.GetPosition() - dirLightDirection * 5.0f, m_camera.GetPosition(), glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 lightMatrix = lightProj * lightView;
+        // The GPU time of the frame spans all of its commands
+        m_gpuTimer.BeginFrame(commandBuffer, currentFrame, m_frameNumber);
+        uint32_t frameZone = m_gpuTimer.BeginZone(commandBuffer, currentFrame, "Frame");
+
+        // Cull the clusters on the GPU for both passes before any rendering starts.
+        // Shadow pass commands are written after the main pass commands.
+        if (useGpuCulling)
+        {
+            uint32_t cullingZone = m_gpuTimer.BeginZone(commandBuffer, currentFrame, "Cluster culling");
+            DispatchClusterCulling(commandBuffer, m_frameDataList[currentFrame], Frustum::FromMatrix(projView), 0);
+            if (renderShadowMap)
+            {
+                DispatchClusterCulling(commandBuffer, m_frameDataList[currentFrame], Frustum::FromMatrix(lightMatrix), MAX_CLUSTER_COUNT);
+            }
+
+            VkBufferMemoryBarrier drawCommandBarrier = {};
+            drawCommandBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            drawCommandBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            drawCommandBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+            drawCommandBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            drawCommandBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            drawCommandBarrier.buffer = m_frameDataList[currentFrame].drawCommandBuffer.GetHandle();
+            drawCommandBarrier.offset = 0;
+            drawCommandBarrier.size = VK_WHOLE_SIZE;
+            vkCmdPipelineBarrier
+            (
+                commandBuffer,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                0,
+                0, nullptr,
+                1, &drawCommandBarrier,
+                0, nullptr
+            );
+            m_gpuTimer.EndZone(commandBuffer, currentFrame, cullingZone);
+        }
+
+        if (renderShadowMap)
         {
             // Begin shadow pass
+            uint32_t shadowPassZone = m_gpuTimer.BeginZone(commandBuffer, currentFrame, "Shadow pass");
             VkRenderPassBeginInfo shadowPassBeginInfo {};
             shadowPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
             shadowPassBeginInfo.renderPass = m_shadowRenderPass;
-            shadowPassBeginInfo.framebuffer = m_frameDataList[currentFrame].shadowMapFramebuffer;
+            shadowPassBeginInfo.framebuffer = m_shadowMapFramebuffer;
             shadowPassBeginInfo.renderArea.offset = { 0, 0 };
             shadowPassBeginInfo.renderArea.extent = { SHADOW_MAP_WIDTH, SHADOW_MAP_HEIGHT };
             std::array<VkClearValue, 1> shadowClearValues;
             shadowClearValues[0].depthStencil = { 1.0f, 0 };
             shadowPassBeginInfo.clearValueCount = static_cast<uint32_t>(shadowClearValues.size());
             shadowPassBeginInfo.pClearValues = shadowClearValues.data();
-            vkCmdBeginRenderPass(commandBuffer, &shadowPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-            // Viewport and scissors are dynamic, so we set here as a command
-            float viewportHeight = static_cast<float>(SHADOW_MAP_HEIGHT);
-            VkViewport viewport {};
-            viewport.x = 0.0f;
-            viewport.y = 0.0f;
-            viewport.width = static_cast<float>(SHADOW_MAP_WIDTH);
-            viewport.height = viewportHeight;
-            viewport.minDepth = 0.0f;
-            viewport.maxDepth = 1.0f;
-            vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-            VkRect2D scissor {};
-            scissor.offset = { 0, 0 };
-            scissor.extent = { SHADOW_MAP_WIDTH, SHADOW_MAP_HEIGHT } ;
-            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadowPipeline);
-
-            VkDeviceSize offset = 0;
-            VkBuffer vertexBuffers[] = { m_testVertexBuffer.GetHandle() };
-            vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, &offset);
-            
-            // Push constants
-            PushConstant pushConstant;
-            pushConstant.projView = lightMatrix;
-            vkCmdPushConstants(commandBuffer, m_shadowPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstant), &pushConstant);
-
-            vkCmdDraw(commandBuffer, m_numVertices, 1, 0, 0);
+            vkCmdBeginRenderPass(commandBuffer, &shadowPassBeginInfo, subpassContents);
+
+            if (useGpuCulling)
+            {
+                BindPassState(commandBuffer, m_frameDataList[currentFrame], true, dynamicOffsets);
+                DrawClustersIndirect(commandBuffer, m_frameDataList[currentFrame], MAX_CLUSTER_COUNT);
+            }
+            else
+            {
+                ExecuteVisibleTileGroups(commandBuffer, m_frameDataList[currentFrame], true, Frustum::FromMatrix(lightMatrix), m_shadowPassCullingStats);
+            }
 
             vkCmdEndRenderPass(commandBuffer);
+            m_gpuTimer.EndZone(commandBuffer, currentFrame, shadowPassZone);
+        }
+        else
+        {
+            m_shadowPassCullingStats = {};
         }
 
         // Begin render pass
+        uint32_t mainPassZone = m_gpuTimer.BeginZone(commandBuffer, currentFrame, "Main pass");
         VkRenderPassBeginInfo renderPassBeginInfo {};
         renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         renderPassBeginInfo.renderPass = m_vkRenderPass;
@@ -288,77 +692,110 @@ void Application::Run()
         clearValues[1].depthStencil = { 1.0f, 0 };
         renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
         renderPassBeginInfo.pClearValues = clearValues.data();
-        vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-        // Viewport and scissors are dynamic, so we set here as a command
-        float viewportHeight = static_cast<float>(m_vkSwapchainImageExtent.height);
-        VkViewport viewport {};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_vkSwapchainImageExtent.width);
-        viewport.height = viewportHeight; // Supported from Vulkan 1.1 to switch from Y=down convention
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-        VkRect2D scissor {};
-        scissor.offset = { 0, 0 };
-        scissor.extent = m_vkSwapchainImageExtent;
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipeline);
-
-        VkDeviceSize offset = 0;
-        VkBuffer vertexBuffers[] = { m_testVertexBuffer.GetHandle() };
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, &offset);
+        vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, subpassContents);
 
-        // Update camera UBO
-        CameraData *cameraDataUBO = reinterpret_cast<CameraData*>(m_frameDataList[currentFrame].cameraDataUniformBuffer.MapMemory(0, sizeof(CameraData)));
-        cameraDataUBO->position = m_camera.GetPosition();
-        m_frameDataList[currentFrame].cameraDataUniformBuffer.UnmapMemory();
+        if (useGpuCulling)
+        {
+            BindPassState(commandBuffer, m_frameDataList[currentFrame], false, dynamicOffsets);
+            DrawClustersIndirect(commandBuffer, m_frameDataList[currentFrame], 0);
+        }
+        else
+        {
+            ExecuteVisibleTileGroups(commandBuffer, m_frameDataList[currentFrame], false, Frustum::FromMatrix(projView), m_mainPassCullingStats);
+        }
 
-        // Update LightData UBO
-        LightData *lightDataUBO = reinterpret_cast<LightData*>(m_frameDataList[currentFrame].lightDataUniformBuffer.MapMemory(0, sizeof(LightData)));
-        lightDataUBO->lightPosition = glm::vec4(dirLightDirection, 0.0f);
-        lightDataUBO->ambient = { 0.1f, 0.1f, 0.1f };
-        lightDataUBO->diffuse = { 1.0f, 1.0f, 1.0f };
-        lightDataUBO->specular = { 1.0f, 1.0f, 1.0 };
-        m_frameDataList[currentFrame].lightDataUniformBuffer.UnmapMemory();
+        if (hudVertexCount > 0)
+        {
+            if (useGpuCulling)
+            {
+                DrawHud(commandBuffer, m_frameDataList[currentFrame], hudVertexCount);
+            }
+            else
+            {
+                vkCmdExecuteCommands(commandBuffer, 1, &m_frameDataList[currentFrame].hudCommandBuffer);
+            }
+        }
 
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 0, 1, &m_frameDataList[currentFrame].descriptorSet, 0, nullptr);
+        vkCmdEndRenderPass(commandBuffer);
+        m_gpuTimer.EndZone(commandBuffer, currentFrame, mainPassZone);
 
-        glm::mat4 projView = m_camera.GetProjectionMatrix() * m_camera.GetViewMatrix();
-        // Push constants
-        PushConstant pushConstant;
-        pushConstant.lightProjView = lightMatrix;
-        pushConstant.projView = projView;
-        vkCmdPushConstants(commandBuffer, m_vkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstant), &pushConstant);
-        vkCmdDraw(commandBuffer, m_numVertices, 1, 0, 0);
+        // The render pass leaves the offscreen image ready to be copied from
+        if (dumpFrame)
+        {
+            VkBufferImageCopy copyRegion = {};
+            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.layerCount = 1;
+            copyRegion.imageExtent = { m_vkSwapchainImageExtent.width, m_vkSwapchainImageExtent.height, 1 };
+            vkCmdCopyImageToBuffer(commandBuffer, m_frameDataList[currentFrame].image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbackBuffer.GetHandle(), 1, &copyRegion);
+
+            VkBufferMemoryBarrier readbackBarrier = {};
+            readbackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            readbackBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+            readbackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            readbackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            readbackBarrier.buffer = m_readbackBuffer.GetHandle();
+            readbackBarrier.offset = 0;
+            readbackBarrier.size = VK_WHOLE_SIZE;
+            vkCmdPipelineBarrier
+            (
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_HOST_BIT,
+                0,
+                0, nullptr,
+                1, &readbackBarrier,
+                0, nullptr
+            );
+        }
+
+        m_gpuTimer.EndZone(commandBuffer, currentFrame, frameZone);
 
-        vkCmdEndRenderPass(commandBuffer);
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
         {
-            std::cerr << "Failed to end recording of command buffer!" << std::endl;
-            glfwSetWindowShouldClose(m_window.GetHandle(), GLFW_TRUE);
+            LOG_ERROR("Failed to end recording of command buffer!");
+            RequestExit();
             continue;
         }
+        Profiler::AddEvent("Record commands", recordStartTime, std::chrono::steady_clock::now());
 
         // --- Submit ---
         VkSubmitInfo submitInfo {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-        VkSemaphore waitSemaphores[] = { m_frameDataList[currentFrame].imageAvailableSemaphore };
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
+        // Nothing was acquired in headless mode, so the image available semaphore is skipped
+        uint32_t firstWaitSemaphore = m_launchOptions.headless ? 1 : 0;
+        VkSemaphore waitSemaphores[] = { m_frameDataList[currentFrame].imageAvailableSemaphore, VK_NULL_HANDLE };
+        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT };
+        submitInfo.waitSemaphoreCount = 1 - firstWaitSemaphore;
+        submitInfo.pWaitSemaphores = waitSemaphores + firstWaitSemaphore;
+        submitInfo.pWaitDstStageMask = waitStages + firstWaitSemaphore;
+
+        // Vertex fetching waits for tile copies that the host has not seen finishing yet.
+        // A wait only orders its own submission, so it is repeated until the copies are done.
+        uint64_t waitValues[] = { 0, m_vertexUploadValue };
+        VkTimelineSemaphoreSubmitInfo timelineSubmitInfo {};
+        if (m_uploadEngineEnabled && (m_vertexUploadValue > m_uploadEngine.GetCompletedValue()))
+        {
+            waitSemaphores[1] = m_uploadEngine.GetTimelineSemaphore();
+            submitInfo.waitSemaphoreCount = 2 - firstWaitSemaphore;
+
+            timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineSubmitInfo.waitSemaphoreValueCount = 2 - firstWaitSemaphore;
+            timelineSubmitInfo.pWaitSemaphoreValues = waitValues + firstWaitSemaphore;
+            submitInfo.pNext = &timelineSubmitInfo;
+
+            ++m_uploadStats.framesWaitingForTransfer;
+        }
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
+        // Nothing waits for the render done semaphore in headless mode, since nothing is presented
         VkSemaphore signalSemaphores[] = { m_frameDataList[currentFrame].renderDoneSemaphore };
-        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.signalSemaphoreCount = m_launchOptions.headless ? 0 : 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
+        std::chrono::steady_clock::time_point submitStartTime = std::chrono::steady_clock::now();
         VkResult submitResult = vkQueueSubmit
         (
             VulkanContext::GetGraphicsQueue(),
@@ -366,12 +803,41 @@ void Application::Run()
             &submitInfo,
             m_frameDataList[currentFrame].renderDoneFence
         );
+        Profiler::AddEvent("Submit", submitStartTime, std::chrono::steady_clock::now());
         if (submitResult != VK_SUCCESS)
         {
-            std::cerr << "Failed to submit!" << std::endl;
-            glfwSetWindowShouldClose(m_window.GetHandle(), GLFW_TRUE);
+            LOG_ERROR("Failed to submit!");
+            RequestExit();
             continue;
         }
+        m_gpuTimer.SetSubmitted(currentFrame);
+
+        if (dumpFrame)
+        {
+            PROFILE_SCOPE("Dump frame");
+            if (!DumpFrame(m_frameDataList[currentFrame], m_frameNumber))
+            {
+                LOG_ERROR("[Application] Failed to dump frame " << m_frameNumber << "!");
+            }
+        }
+
+        double frameMilliseconds = (GetElapsedTime() - currentTime) * 1000.0;
+        m_lastCpuFrameMilliseconds = frameMilliseconds - fenceWaitMilliseconds;
+
+        // The GPU time is only known once the frame's fence is waited on again
+        if (!m_cameraPath.IsEmpty())
+        {
+            BenchmarkRecorder::FrameSample sample = {};
+            sample.frameNumber = m_frameNumber;
+            sample.time = pathTime;
+            sample.frameMilliseconds = frameMilliseconds;
+            sample.cpuMilliseconds = m_lastCpuFrameMilliseconds;
+            sample.gpuMilliseconds = -1.0;
+            sample.arrivedTiles = static_cast<uint32_t>(m_frameTileLatencies.size());
+            sample.maxTileLatencyMilliseconds = m_frameTileLatencies.empty() ? 0.0 : *std::max_element(m_frameTileLatencies.begin(), m_frameTileLatencies.end()) * 1000.0;
+            sample.uploadedBytes = frameUploadedBytes;
+            m_benchmarkRecorder.AddFrame(sample, m_frameTileLatencies);
+        }
 
         // --- Present ---
         VkPresentInfoKHR presentInfo {};
@@ -385,17 +851,28 @@ void Application::Run()
         presentInfo.pImageIndices = &nextImageIndex;
 
         currentFrame = (currentFrame + 1) % m_maxFramesInFlight;
+        ++m_frameNumber;
 
-        VkResult presentResult = vkQueuePresentKHR
-        (
-            VulkanContext::GetPresentQueue(),
-            &presentInfo
-        );
-        if (presentResult != VK_SUCCESS)
+        if (!m_launchOptions.headless)
         {
-            std::cerr << "Failed to present!" << std::endl;
-            glfwSetWindowShouldClose(m_window.GetHandle(), GLFW_TRUE);
-            continue;
+            PROFILE_SCOPE("Present");
+            VkResult presentResult = vkQueuePresentKHR
+            (
+                VulkanContext::GetPresentQueue(),
+                &presentInfo
+            );
+            if (presentResult != VK_SUCCESS)
+            {
+                LOG_ERROR("Failed to present!");
+                RequestExit();
+                continue;
+            }
+        }
+
+        if (m_frameNumber == 1)
+        {
+            int64_t timeToFirstFrame = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+            LOG_INFO("[Application] Time to first frame: " << timeToFirstFrame << " ms");
         }
 
         // --- Draw frame end ---
@@ -403,14 +880,51 @@ void Application::Run()
         //m_sceneManager.GetActiveScene()->Draw();
 
         Input::Prepare();
-        m_window.PollEvents();
+        if (!m_launchOptions.headless)
+        {
+            m_window.PollEvents();
+        }
     }
 
     vkDeviceWaitIdle(VulkanContext::GetLogicalDevice());
+    for (uint32_t i = 0; i < m_frameDataList.size(); ++i)
+    {
+        CollectGpuTime(i);
+    }
+
+    if (!m_benchmarkRecorder.IsEmpty())
+    {
+        m_benchmarkRecorder.PrintSummary(std::cout);
+        if (m_benchmarkRecorder.WriteCsv(m_launchOptions.benchmarkCsvFile))
+        {
+            LOG_INFO("[Application] Benchmark measurements written to " << m_launchOptions.benchmarkCsvFile);
+        }
+        else
+        {
+            LOG_ERROR("[Application] Failed to write benchmark measurements to " << m_launchOptions.benchmarkCsvFile << "!");
+        }
+    }
+
+    double loopSeconds = GetElapsedTime() - loopStartTime;
+    std::ostringstream loopReport;
+    loopReport << "[Application] Rendered " << m_frameNumber << " frames in " << loopSeconds << " s";
+    if (m_frameNumber > 0)
+    {
+        loopReport << " (" << loopSeconds * 1000.0 / m_frameNumber << " ms per frame on average)";
+    }
+    LOG_INFO(loopReport.str());
 
     m_workerThreadRunning = false;
     workerThread1.join();
     workerThread2.join();
+    m_tileStageStats.Print(std::cout);
+    m_tileDataSource->PrintStats(std::cout, "Tile sources");
+
+    // Profiling that is still running at exit is written out, including the last events of the worker threads
+    if (Profiler::IsEnabled())
+    {
+        ToggleProfiling();
+    }
 
     Cleanup();
 }
@@ -422,66 +936,115 @@ void Application::Run()
  */
 bool Application::Init()
 {
-    if (glfwInit() == GLFW_FALSE)
+    // Headless mode needs neither a window nor GLFW, so it also runs where no display is available
+    GLFWwindow* windowHandle = nullptr;
+    if (!m_launchOptions.headless)
     {
-        std::cout << "[Application] Failed to initialize GLFW!" << std::endl;
-        return false;
+        if (glfwInit() == GLFW_FALSE)
+        {
+            LOG_ERROR("[Application] Failed to initialize GLFW!");
+            return false;
+        }
+
+        if (!m_window.Init(static_cast<int>(m_launchOptions.width), static_cast<int>(m_launchOptions.height), "Map Viewer 3D"))
+        {
+            LOG_ERROR("[Application] Failed to create GLFW window!");
+            return false;
+        }
+
+        windowHandle = m_window.GetHandle();
     }
 
-    if (!m_window.Init(800, 600, "Map Viewer 3D"))
+    if (!VulkanContext::Initialize(windowHandle))
     {
-        std::cout << "[Application] Failed to create GLFW window!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan context!");
         return false;
     }
-
-    // --- Register callbacks ---
-    GLFWwindow* windowHandle = m_window.GetHandle();
-
-    if (!VulkanContext::Initialize(windowHandle))
+    if (!m_pipelineCache.Create(PIPELINE_CACHE_FILE_PATH))
+    {
+        LOG_ERROR("[Application] Failed to initialize pipeline cache!");
+    }
+    if (m_launchOptions.headless)
     {
-        std::cerr << "[Application] Failed to initialize Vulkan context!" << std::endl;
+        if (!InitOffscreenTargets())
+        {
+            LOG_ERROR("[Application] Failed to initialize offscreen render targets!");
+        }
     }
-    if (!InitSwapchain())
+    else if (!InitSwapchain())
     {
-        std::cerr << "[Application] Failed to initialize Vulkan swapchain!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan swapchain!");
     }
     if (!InitShadowPass())
     {
-        std::cerr << "[Application] Failed to initialize resources for shadow pass!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize resources for shadow pass!");
     }
     if (!InitRenderPass())
     {
-        std::cerr << "[Application] Failed to initialize Vulkan renderpass!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan renderpass!");
+    }
+    if (!InitDescriptorSetLayout())
+    {
+        LOG_ERROR("[Application] Failed to initialize descriptor set layout!");
     }
+
+    // Pipeline creation is the slowest part of a cold start, so it runs while the remaining
+    // resources are created. It only reads the render passes and the descriptor set layout.
+    std::chrono::steady_clock::time_point pipelineStartTime = std::chrono::steady_clock::now();
+    std::future<bool> renderPipelinesResult = std::async(std::launch::async, &Application::InitRenderPipelines, this);
+
     if (!InitDepthStencilImage())
     {
-        std::cerr << "[Application] Failed to initialize Vulkan depth/stencil image!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan depth/stencil image!");
     }
     if (!InitFramebuffers())
     {
-        std::cerr << "[Application] Failed to initialize Vulkan framebuffers!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan framebuffers!");
     }
     if (!InitCommandPool())
     {
-        std::cerr << "[Application] Failed to initialize Vulkan command pool" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan command pool");
     }
     if (!InitCommandBuffers())
     {
-        std::cerr << "[Application] Failed to initialize Vulkan command buffers!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize Vulkan command buffers!");
+    }
+    if (!InitHudBuffers())
+    {
+        LOG_WARNING("[Application] Failed to initialize performance overlay buffers! The overlay will not be shown.");
     }
     if (!InitDescriptors())
     {
-        std::cerr << "[Application] Failed to initialize descriptor sets!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize descriptor sets!");
     }
-    if (!InitGraphicsPipeline())
+    if (!InitCullingPipeline())
     {
-        std::cerr << "[Application] Failed to initialize graphics pipeline!" << std::endl;
+        LOG_WARNING("[Application] Failed to initialize GPU culling pipeline! Culling will be done on the CPU.");
     }
     if (!InitSynchronizationTools())
     {
-        std::cerr << "[Application] Failed to initialize synchronization tools!" << std::endl;
+        LOG_ERROR("[Application] Failed to initialize synchronization tools!");
+    }
+    if (!InitGpuTimer())
+    {
+        LOG_WARNING("[Application] Failed to initialize GPU timer! GPU times will not be measured.");
     }
 
+    if (!renderPipelinesResult.get())
+    {
+        LOG_ERROR("[Application] Failed to initialize render pipelines!");
+    }
+    int64_t pipelineMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - pipelineStartTime).count();
+    LOG_INFO("[Application] Pipelines ready after " << pipelineMilliseconds << " ms, " << m_pipelineCache.GetLoadedDataSize() / 1024
+        << " KB loaded from the pipeline cache");
+
+    if (m_launchOptions.headless)
+    {
+        return true;
+    }
+
+    // --- Register callbacks ---
+
     // Set the callback function for when the framebuffer size changed
 	//glfwSetFramebufferSizeCallback(windowHandle, Application::FramebufferSizeChangedCallback);
 
@@ -512,7 +1075,14 @@ bool Application::Init()
  */
 void Application::Cleanup()
 {
-    m_testVertexBuffer.Cleanup();
+    m_positionBuffer.Cleanup();
+    m_attributeBuffer.Cleanup();
+    if (m_uploadEngineEnabled)
+    {
+        m_uploadEngine.Cleanup();
+    }
+
+    m_gpuTimer.Cleanup();
 
     for (size_t i = 0; i < m_frameDataList.size(); i++)
     {
@@ -525,15 +1095,44 @@ void Application::Cleanup()
     m_shadowPipeline = VK_NULL_HANDLE;
     vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_shadowPipelineLayout, nullptr);
     m_shadowPipelineLayout = VK_NULL_HANDLE;
-    vkDestroyPipeline(VulkanContext::GetLogicalDevice(), m_vkPipeline, nullptr);
-    m_vkPipeline = VK_NULL_HANDLE;
+    for (VkPipeline &pipeline : m_qualityPipelines)
+    {
+        vkDestroyPipeline(VulkanContext::GetLogicalDevice(), pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
+    }
     vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_vkPipelineLayout, nullptr);
     m_vkPipelineLayout = VK_NULL_HANDLE;
+    vkDestroyPipeline(VulkanContext::GetLogicalDevice(), m_hudPipeline, nullptr);
+    m_hudPipeline = VK_NULL_HANDLE;
+    vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_hudPipelineLayout, nullptr);
+    m_hudPipelineLayout = VK_NULL_HANDLE;
 
+    // Pipelines created during this run are reused by the next one
+    if (!m_pipelineCache.Save())
+    {
+        LOG_ERROR("[Application] Failed to save pipeline cache!");
+    }
+    m_pipelineCache.Cleanup();
+
+    m_uniformBufferRing.Cleanup();
+
+    vkDestroyPipeline(VulkanContext::GetLogicalDevice(), m_cullPipeline, nullptr);
+    m_cullPipeline = VK_NULL_HANDLE;
+    vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_cullPipelineLayout, nullptr);
+    m_cullPipelineLayout = VK_NULL_HANDLE;
+    vkDestroyDescriptorPool(VulkanContext::GetLogicalDevice(), m_cullDescriptorPool, nullptr);
+    m_cullDescriptorPool = VK_NULL_HANDLE;
+    vkDestroyDescriptorSetLayout(VulkanContext::GetLogicalDevice(), m_cullDescriptorSetLayout, nullptr);
+    m_cullDescriptorSetLayout = VK_NULL_HANDLE;
     for (size_t i = 0; i < m_frameDataList.size(); i++)
     {
-        m_frameDataList[i].cameraDataUniformBuffer.Cleanup();
-        m_frameDataList[i].lightDataUniformBuffer.Cleanup();
+        if (m_frameDataList[i].clusterCullData != nullptr)
+        {
+            m_frameDataList[i].clusterCullDataBuffer.UnmapMemory();
+            m_frameDataList[i].clusterCullData = nullptr;
+        }
+        m_frameDataList[i].clusterCullDataBuffer.Cleanup();
+        m_frameDataList[i].drawCommandBuffer.Cleanup();
     }
 
     vkDestroyDescriptorPool(VulkanContext::GetLogicalDevice(), m_vkDescriptorPool, nullptr);
@@ -547,15 +1146,32 @@ void Application::Cleanup()
     m_vkDepthBufferImageView.Cleanup();
     m_vkDepthBufferImage.Cleanup();
 
+    vkDestroyFramebuffer(VulkanContext::GetLogicalDevice(), m_shadowMapFramebuffer, nullptr);
+    m_shadowMapFramebuffer = VK_NULL_HANDLE;
+    m_shadowMapImageView.Cleanup();
+    m_shadowMapImage.Cleanup();
+
     for (size_t i = 0; i < m_frameDataList.size(); i++)
     {
-        vkDestroyFramebuffer(VulkanContext::GetLogicalDevice(), m_frameDataList[i].shadowMapFramebuffer, nullptr);
-        m_frameDataList[i].shadowMapImageView.Cleanup();
-        m_frameDataList[i].shadowMapImage.Cleanup();
         vkDestroyFramebuffer(VulkanContext::GetLogicalDevice(), m_frameDataList[i].framebuffer, nullptr);
         m_frameDataList[i].imageView.Cleanup();
+        m_frameDataList[i].offscreenImage.Cleanup();
         vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), m_vkCommandPool, 1, &m_frameDataList[i].commandBuffer);
+        if (m_frameDataList[i].hudCommandBuffer != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), m_vkCommandPool, 1, &m_frameDataList[i].hudCommandBuffer);
+        }
+        m_frameDataList[i].hudVertexBuffer.Cleanup();
+
+        // Destroying the pools frees the secondary command buffers of the tile groups
+        for (VkCommandPool commandPool : m_frameDataList[i].tileGroupCommandPools)
+        {
+            vkDestroyCommandPool(VulkanContext::GetLogicalDevice(), commandPool, nullptr);
+        }
+        m_frameDataList[i].tileGroupCommandPools.clear();
+        m_frameDataList[i].tileGroupCommands.clear();
     }
+    m_recordingJobSystem.Stop();
     m_frameDataList.clear();
 
     vkDestroyCommandPool(VulkanContext::GetLogicalDevice(), m_vkCommandPool, nullptr);
@@ -566,13 +1182,94 @@ void Application::Cleanup()
     vkDestroyRenderPass(VulkanContext::GetLogicalDevice(), m_shadowRenderPass, nullptr);
     m_shadowRenderPass = VK_NULL_HANDLE;
 
-    vkDestroySwapchainKHR(VulkanContext::GetLogicalDevice(), m_vkSwapchain, nullptr);
-    m_vkSwapchain = VK_NULL_HANDLE;
+    m_readbackBuffer.Cleanup();
+
+    if (m_vkSwapchain != VK_NULL_HANDLE)
+    {
+        vkDestroySwapchainKHR(VulkanContext::GetLogicalDevice(), m_vkSwapchain, nullptr);
+        m_vkSwapchain = VK_NULL_HANDLE;
+    }
 
     VulkanContext::Cleanup();
 
-    m_window.Cleanup();
-    glfwTerminate();
+    if (!m_launchOptions.headless)
+    {
+        m_window.Cleanup();
+        glfwTerminate();
+    }
+}
+
+/**
+ * @brief Requests the game loop to stop after the current frame.
+ */
+void Application::RequestExit()
+{
+    m_exitRequested = true;
+}
+
+/**
+ * @brief Checks whether the game loop should stop.
+ * @return Returns true if an exit was requested, the window was closed or all requested frames were rendered.
+ * Returns false otherwise.
+ */
+bool Application::ShouldExit() const
+{
+    return m_exitRequested
+        || (!m_launchOptions.headless && m_window.IsClosed())
+        || ((m_launchOptions.frameCount > 0) && (m_frameNumber >= m_launchOptions.frameCount));
+}
+
+/**
+ * @brief Gets the time since the application started running.
+ * @return Elapsed time (in seconds)
+ */
+double Application::GetElapsedTime() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+/**
+ * @brief Waits for a frame to finish rendering, and writes the image it was copied into to a file.
+ * @param[in] frameData Data of the frame, whose commands copied the rendered image into the readback buffer
+ * @param[in] frameNumber Number of the frame, used in the file name
+ * @return Returns true if the image was written successfully. Returns false otherwise.
+ */
+bool Application::DumpFrame(const FrameData &frameData, uint64_t frameNumber)
+{
+    // The fence stays signaled, so waiting on it again at the start of the frame returns immediately
+    if (vkWaitForFences(VulkanContext::GetLogicalDevice(), 1, &frameData.renderDoneFence, VK_TRUE, UINT64_MAX) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    uint32_t width = m_vkSwapchainImageExtent.width;
+    uint32_t height = m_vkSwapchainImageExtent.height;
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * 4;
+    const uint8_t *bgraPixels = reinterpret_cast<const uint8_t*>(m_readbackBuffer.MapMemory(0, imageSize));
+    if (bgraPixels == nullptr)
+    {
+        return false;
+    }
+
+    // The offscreen images are BGRA, while the image file is RGB
+    std::vector<uint8_t> rgbPixels(static_cast<size_t>(width) * height * 3);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+    {
+        rgbPixels[i * 3 + 0] = bgraPixels[i * 4 + 2];
+        rgbPixels[i * 3 + 1] = bgraPixels[i * 4 + 1];
+        rgbPixels[i * 3 + 2] = bgraPixels[i * 4 + 0];
+    }
+    m_readbackBuffer.UnmapMemory();
+
+    std::stringstream filePath;
+    filePath << m_launchOptions.dumpDirectory << "/frame_" << std::setw(6) << std::setfill('0') << frameNumber << ".ppm";
+    if (!FileUtils::WriteImageAsPPM(filePath.str(), width, height, rgbPixels))
+    {
+        return false;
+    }
+
+    LOG_INFO("[Application] Frame " << frameNumber << " written to " << filePath.str());
+    return true;
 }
 
 /**
@@ -593,7 +1290,7 @@ bool Application::InitSwapchain()
     vkGetPhysicalDeviceSurfaceFormatsKHR(VulkanContext::GetPhysicalDevice(), VulkanContext::GetVulkanSurface(), &numAvailableSurfaceFormats, nullptr);
     if (numAvailableSurfaceFormats == 0)
     {
-        std::cout << "Selected physical device has no supported surface formats!" << std::endl;
+        LOG_ERROR("Selected physical device has no supported surface formats!");
         return false;
     }
     std::vector<VkSurfaceFormatKHR> availableSurfaceFormats(numAvailableSurfaceFormats);
@@ -604,7 +1301,7 @@ bool Application::InitSwapchain()
     vkGetPhysicalDeviceSurfacePresentModesKHR(VulkanContext::GetPhysicalDevice(), VulkanContext::GetVulkanSurface(), &numAvailablePresentModes, nullptr);
     if (numAvailablePresentModes == 0)
     {
-        std::cout << "Selected physical device has no supported present modes!" << std::endl;
+        LOG_ERROR("Selected physical device has no supported present modes!");
         return false;
     }
     std::vector<VkPresentModeKHR> availablePresentModes(numAvailablePresentModes);
@@ -702,7 +1399,7 @@ bool Application::InitSwapchain()
     // Actually create the swapchain
     if (vkCreateSwapchainKHR(VulkanContext::GetLogicalDevice(), &swapchainCreateInfo, nullptr, &m_vkSwapchain) != VK_SUCCESS)
     {
-        std::cout << "Failed to create swapchain!" << std::endl;
+        LOG_ERROR("Failed to create swapchain!");
         return false;
     }
 
@@ -721,7 +1418,7 @@ bool Application::InitSwapchain()
         m_frameDataList.back().image = swapchainImages[i];
         if (!m_frameDataList.back().imageView.Create(swapchainImages[i], m_vkSwapchainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT))
         {
-            std::cout << "Failed to create swapchain image views!" << std::endl;
+            LOG_ERROR("Failed to create swapchain image views!");
             return false;
         }
     }
@@ -731,6 +1428,57 @@ bool Application::InitSwapchain()
     return true;
 }
 
+/**
+ * @brief Initializes the offscreen images that are rendered into in headless mode, in place of a swapchain.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitOffscreenTargets()
+{
+    m_vkSwapchainImageFormat = OFFSCREEN_IMAGE_FORMAT;
+    m_vkSwapchainImageExtent = { m_launchOptions.width, m_launchOptions.height };
+
+    // Each frame in flight gets its own image, like the images of a swapchain
+    for (uint32_t i = 0; i < OFFSCREEN_FRAME_COUNT; ++i)
+    {
+        m_frameDataList.emplace_back();
+
+        FrameData &frameData = m_frameDataList.back();
+        if (!frameData.offscreenImage.Create(
+                m_vkSwapchainImageExtent.width,
+                m_vkSwapchainImageExtent.height,
+                m_vkSwapchainImageFormat,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+        {
+            LOG_ERROR("Failed to create offscreen image!");
+            return false;
+        }
+
+        frameData.image = frameData.offscreenImage.GetHandle();
+        if (!frameData.imageView.Create(frameData.image, m_vkSwapchainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT))
+        {
+            LOG_ERROR("Failed to create offscreen image views!");
+            return false;
+        }
+    }
+
+    m_maxFramesInFlight = OFFSCREEN_FRAME_COUNT;
+
+    // Dumped frames are copied into a host-visible buffer, one at a time
+    if (!m_launchOptions.dumpFrames.empty())
+    {
+        VkDeviceSize imageSize = static_cast<VkDeviceSize>(m_vkSwapchainImageExtent.width) * m_vkSwapchainImageExtent.height * 4;
+        if (!m_readbackBuffer.Create(imageSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        {
+            LOG_ERROR("Failed to create readback buffer!");
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * @brief Initializes all things needed for a shadow pass
  * @return Returns true if the initialization was successful. Returns false otherwise.
@@ -759,16 +1507,27 @@ bool Application::InitShadowPass()
     subpassDescription.pColorAttachments = nullptr;
     subpassDescription.pDepthStencilAttachment = &depthAttachmentReference;
 
+    // The shadow map is shared by all frames, so the main passes of earlier frames
+    // may still be sampling it (write-after-read)
     VkSubpassDependency depthDependency = {};
     depthDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    depthDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
     depthDependency.srcAccessMask = 0;
     depthDependency.dstSubpass = 0;
     depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
     depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
+    // The main passes of this and later frames sample the depth written here
+    VkSubpassDependency samplingDependency = {};
+    samplingDependency.srcSubpass = 0;
+    samplingDependency.srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    samplingDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    samplingDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    samplingDependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    samplingDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
     std::array<VkAttachmentDescription, 1> attachments = { depthAttachment };
-    std::array<VkSubpassDependency, 1> dependencies = { depthDependency };
+    std::array<VkSubpassDependency, 2> dependencies = { depthDependency, samplingDependency };
     VkRenderPassCreateInfo renderPassCreateInfo = {};
     renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
@@ -780,66 +1539,96 @@ bool Application::InitShadowPass()
 
     if (vkCreateRenderPass(VulkanContext::GetLogicalDevice(), &renderPassCreateInfo, nullptr, &m_shadowRenderPass) != VK_SUCCESS)
     {
-        std::cout << "Failed to create render pass for the shadow map!" << std::endl;
+        LOG_ERROR("Failed to create render pass for the shadow map!");
         return false;
     }
     
-    // --- Image and image view
-    for (size_t i = 0; i < m_frameDataList.size(); ++i)
+    // --- Image and image view ---
+    // A single shadow map is shared by all frames. It is only rendered again when it is invalidated,
+    // and the render pass dependencies order that against the reads of frames still in flight.
+    if (!m_shadowMapImage.Create(
+        SHADOW_MAP_WIDTH, 
+        SHADOW_MAP_HEIGHT,
+        VK_FORMAT_D32_SFLOAT,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    ))
     {
-        if (!m_frameDataList[i].shadowMapImage.Create(
-            SHADOW_MAP_WIDTH, 
-            SHADOW_MAP_HEIGHT,
-            VK_FORMAT_D32_SFLOAT,
-            VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-        ))
-        {
-            std::cout << "Failed to create image for the shadow map!" << std::endl;
-            return false;
-        }
+        LOG_ERROR("Failed to create image for the shadow map!");
+        return false;
+    }
 
-        if (!m_frameDataList[i].shadowMapImageView.Create(
-            m_frameDataList[i].shadowMapImage.GetHandle(),
-            VK_FORMAT_D32_SFLOAT, 
-            VK_IMAGE_ASPECT_DEPTH_BIT))
-        {
-            std::cout << "Failed to create image view for the shadow map!" << std::endl;
-            return false;
-        }
+    if (!m_shadowMapImageView.Create(
+        m_shadowMapImage.GetHandle(),
+        VK_FORMAT_D32_SFLOAT, 
+        VK_IMAGE_ASPECT_DEPTH_BIT))
+    {
+        LOG_ERROR("Failed to create image view for the shadow map!");
+        return false;
     }
 
     // --- Framebuffer ---
-    for (size_t i = 0; i < m_frameDataList.size(); ++i)
+    std::array<VkImageView, 1> framebufferAttachments =
     {
-        std::array<VkImageView, 1> attachments =
-        {
-            m_frameDataList[i].shadowMapImageView.GetHandle(),
-        };
+        m_shadowMapImageView.GetHandle(),
+    };
+
+    VkFramebufferCreateInfo framebufferCreateInfo = {};
+    framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferCreateInfo.renderPass = m_shadowRenderPass;
+    framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(framebufferAttachments.size());
+    framebufferCreateInfo.pAttachments = framebufferAttachments.data();
+    framebufferCreateInfo.width = SHADOW_MAP_WIDTH;
+    framebufferCreateInfo.height = SHADOW_MAP_HEIGHT;
+    framebufferCreateInfo.layers = 1;
+
+    if (vkCreateFramebuffer(VulkanContext::GetLogicalDevice(), &framebufferCreateInfo, nullptr, &m_shadowMapFramebuffer) != VK_SUCCESS)
+    {
+        LOG_ERROR("Failed to create a framebuffer for the shadow map!");
+        return false;
+    }
 
-        VkFramebufferCreateInfo framebufferCreateInfo = {};
-        framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferCreateInfo.renderPass = m_shadowRenderPass;
-        framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        framebufferCreateInfo.pAttachments = attachments.data();
-        framebufferCreateInfo.width = SHADOW_MAP_WIDTH;
-        framebufferCreateInfo.height = SHADOW_MAP_HEIGHT;
-        framebufferCreateInfo.layers = 1;
+    return true;
+}
 
-        if (vkCreateFramebuffer(VulkanContext::GetLogicalDevice(), &framebufferCreateInfo, nullptr, &m_frameDataList[i].shadowMapFramebuffer) != VK_SUCCESS)
-        {
-            std::cout << "Failed to create a framebuffer for the shadow map!" << std::endl;
-            return false;
-        }
+/**
+ * @brief Initializes the pipelines of the shadow pass and the main pass. Can run on another
+ * thread while the rest of the initialization continues, once the render passes
+ * and the descriptor set layout exist.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitRenderPipelines()
+{
+    if (!InitShadowPipeline())
+    {
+        LOG_ERROR("[Application] Failed to initialize shadow pipeline!");
+        return false;
     }
+    if (!InitGraphicsPipeline())
+    {
+        LOG_ERROR("[Application] Failed to initialize graphics pipeline!");
+        return false;
+    }
+    if (!InitHudPipeline())
+    {
+        LOG_WARNING("[Application] Failed to initialize performance overlay pipeline! The overlay will not be shown.");
+    }
+    return true;
+}
 
-    // --- Pipeline ---
+/**
+ * @brief Initializes the pipeline of the shadow pass. Requires the descriptor set layout.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitShadowPipeline()
+{
     VulkanGraphicsPipelineBuilder builder {};
 
     // --- Vertex input ---
-    std::vector<VkVertexInputBindingDescription> bindings = Vertex::GetBindingDescriptions();
-    std::vector<VkVertexInputAttributeDescription> attributes = Vertex::GetAttributeDescriptions();
+    // Only the positions are needed for depth
+    std::vector<VkVertexInputBindingDescription> bindings = VulkanVertexLayout::GetBindingDescriptions(true);
+    std::vector<VkVertexInputAttributeDescription> attributes = VulkanVertexLayout::GetAttributeDescriptions(true);
     builder
         .SetVertexBindingDescriptions(bindings)
         .SetVertexAttributeDescriptions(attributes);
@@ -874,12 +1663,9 @@ bool Application::InitShadowPass()
     builder.SetDynamicStates(dynamicStates);
 
     // --- Pipeline layout ---
-    std::vector<VkPushConstantRange> pushConstantRanges;
-    pushConstantRanges.emplace_back();
-    pushConstantRanges.back().offset = 0;
-    pushConstantRanges.back().size = static_cast<uint32_t>(sizeof(PushConstant));
-    pushConstantRanges.back().stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    builder.SetPushConstantRanges(pushConstantRanges);
+    // The shadow pass reads the light matrix from the same camera data as the main pass
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_vkDescriptorSetLayout };
+    builder.SetDescriptorSetLayouts(descriptorSetLayouts);
     
     // --- Shaders ---
     builder
@@ -887,10 +1673,11 @@ bool Application::InitShadowPass()
         .SetFragmentShaderFilePath("Resources/Shaders/shadow_frag.spv");
 
     builder.SetRenderPass(m_shadowRenderPass);
+    builder.SetPipelineCache(m_pipelineCache.GetHandle());
 
     if (!builder.Build())
     {
-        std::cout << "Failed to build pipeline for shadow pass!" << std::endl;
+        LOG_ERROR("Failed to build pipeline for shadow pass!");
         return false;
     }
 
@@ -915,7 +1702,8 @@ bool Application::InitRenderPass()
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // We don't use stencil testing, so we don't care for now
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // We don't use stencil testing, so we don't care for now
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Offscreen images are never presented, but may be copied into the readback buffer
+    colorAttachment.finalLayout = m_launchOptions.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference colorAttachmentReference = {};
     colorAttachmentReference.attachment = 0; // This is reflected in the "layout(location = 0) out color" in the fragment shader
@@ -958,20 +1746,29 @@ bool Application::InitRenderPass()
     depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
     depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
+    // Makes the rendered image visible to the copy into the readback buffer after the render pass
+    VkSubpassDependency readbackDependency = {};
+    readbackDependency.srcSubpass = 0;
+    readbackDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    readbackDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    readbackDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    readbackDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    readbackDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
     std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
-    std::array<VkSubpassDependency, 2> dependencies = { subpassDependency, depthDependency };
+    std::array<VkSubpassDependency, 3> dependencies = { subpassDependency, depthDependency, readbackDependency };
     VkRenderPassCreateInfo renderPassCreateInfo = {};
     renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     renderPassCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
     renderPassCreateInfo.pAttachments = attachments.data();
     renderPassCreateInfo.subpassCount = 1;
     renderPassCreateInfo.pSubpasses = &subpassDescription;
-    renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(dependencies.size()) - (m_launchOptions.headless ? 0 : 1);
     renderPassCreateInfo.pDependencies = dependencies.data();
 
     if (vkCreateRenderPass(VulkanContext::GetLogicalDevice(), &renderPassCreateInfo, nullptr, &m_vkRenderPass) != VK_SUCCESS)
     {
-        std::cout << "Failed to create render pass!" << std::endl;
+        LOG_ERROR("Failed to create render pass!");
         return false;
     }
 
@@ -996,13 +1793,13 @@ bool Application::InitDepthStencilImage()
             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
     {
-        std::cout << "Failed to create Vulkan image for the depth buffer!" << std::endl;
+        LOG_ERROR("Failed to create Vulkan image for the depth buffer!");
         return false;
     }
 
     if (!m_vkDepthBufferImageView.Create(m_vkDepthBufferImage.GetHandle(), VK_FORMAT_D32_SFLOAT, VK_IMAGE_ASPECT_DEPTH_BIT))
     {
-        std::cout << "Failed to create Vulkan image view for the depth buffer!" << std::endl;
+        LOG_ERROR("Failed to create Vulkan image view for the depth buffer!");
         return false;
     }
 
@@ -1037,7 +1834,7 @@ bool Application::InitFramebuffers()
 
         if (vkCreateFramebuffer(VulkanContext::GetLogicalDevice(), &framebufferCreateInfo, nullptr, &m_frameDataList[i].framebuffer) != VK_SUCCESS)
         {
-            std::cout << " FAILED!" << std::endl;
+            LOG_ERROR("Failed to create framebuffer!");
             return false;
         }
     }
@@ -1057,10 +1854,26 @@ bool Application::InitCommandPool()
 
     if (vkCreateCommandPool(VulkanContext::GetLogicalDevice(), &commandPoolInfo, nullptr, &m_vkCommandPool) != VK_SUCCESS)
     {
-        std::cout << "Failed to create command pool!" << std::endl;
+        LOG_ERROR("Failed to create command pool!");
         return false;
     }
 
+    // Command pools are not thread-safe, so each recording worker gets its own pool per frame
+    uint32_t recordingWorkerCount = glm::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_RECORDING_WORKERS);
+    m_recordingJobSystem.Start(recordingWorkerCount);
+    for (size_t i = 0; i < m_frameDataList.size(); ++i)
+    {
+        m_frameDataList[i].tileGroupCommandPools.resize(recordingWorkerCount, VK_NULL_HANDLE);
+        for (uint32_t j = 0; j < recordingWorkerCount; ++j)
+        {
+            if (vkCreateCommandPool(VulkanContext::GetLogicalDevice(), &commandPoolInfo, nullptr, &m_frameDataList[i].tileGroupCommandPools[j]) != VK_SUCCESS)
+            {
+                LOG_ERROR("Failed to create command pool for the tile groups!");
+                return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -1080,7 +1893,7 @@ bool Application::InitCommandBuffers()
     commandBuffers.resize(m_maxFramesInFlight);
     if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &commandBufferInfo, commandBuffers.data()) != VK_SUCCESS)
     {
-        std::cout << "Failed to create command buffers!" << std::endl;
+        LOG_ERROR("Failed to create command buffers!");
         return false;
     }
 
@@ -1093,10 +1906,10 @@ bool Application::InitCommandBuffers()
 }
 
 /**
- * @brief Initializes descriptors
+ * @brief Initializes the shadow map sampler and the descriptor set layout, which the pipelines depend on
  * @return Returns true if the initialization was successful. Returns false otherwise.
  */
-bool Application::InitDescriptors()
+bool Application::InitDescriptorSetLayout()
 {
     VkSamplerCreateInfo samplerInfo = {};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -1107,27 +1920,27 @@ bool Application::InitDescriptors()
     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
     samplerInfo.anisotropyEnable = VK_FALSE;
     samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.compareEnable = VK_TRUE; // Depth comparison is done (and filtered) by the hardware
+    samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
     samplerInfo.maxLod = 0.0f;
     if (vkCreateSampler(VulkanContext::GetLogicalDevice(), &samplerInfo, nullptr, &m_shadowMapSampler) != VK_SUCCESS)
     {
-        std::cerr << "[Application] Failed to create sampler for the shadow map!" << std::endl;
+        LOG_ERROR("[Application] Failed to create sampler for the shadow map!");
         return false;
     }
 
     VkDescriptorSetLayoutBinding cameraUBOBinding = {};
     cameraUBOBinding.binding = 0;
-    cameraUBOBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    cameraUBOBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     cameraUBOBinding.descriptorCount = 1;
-    cameraUBOBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    cameraUBOBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
     VkDescriptorSetLayoutBinding lightUBOBinding = {};
     lightUBOBinding.binding = 1;
-    lightUBOBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    lightUBOBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     lightUBOBinding.descriptorCount = 1;
     lightUBOBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
@@ -1145,29 +1958,41 @@ bool Application::InitDescriptors()
 
     if (vkCreateDescriptorSetLayout(VulkanContext::GetLogicalDevice(), &layoutInfo, nullptr, &m_vkDescriptorSetLayout) != VK_SUCCESS)
     {
-        std::cerr << "[Application] Failed to create descriptor layout for the UBO!" << std::endl;
+        LOG_ERROR("[Application] Failed to create descriptor layout for the UBO!");
         return false;
     }
 
-    VkDeviceSize cameraUBOBufferSize = sizeof(CameraData) * m_frameDataList.size();
-    VkDeviceSize lightUBOBufferSize = sizeof(LightData) * m_frameDataList.size();
-    for (size_t i = 0; i < m_frameDataList.size(); i++)
+    return true;
+}
+
+/**
+ * @brief Initializes the uniform buffer and the descriptor sets. Requires the descriptor set layout.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitDescriptors()
+{
+    // A single persistently mapped uniform buffer is shared by all frames. Each frame
+    // sub-allocates from its own slice, and the descriptors are bound with dynamic offsets.
+    const VkDeviceSize UNIFORM_BUFFER_FRAME_SIZE = 64 * 1024;
+    if (!m_uniformBufferRing.Create(m_maxFramesInFlight, UNIFORM_BUFFER_FRAME_SIZE))
     {
-        if (!m_frameDataList[i].cameraDataUniformBuffer.Create(cameraUBOBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
-        {
-            std::cerr << "[Application] Failed to create uniform buffer for camera data!" << std::endl;
-            return false;
-        }
-        if (!m_frameDataList[i].lightDataUniformBuffer.Create(lightUBOBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
-        {
-            std::cerr << "[Application] Failed to create uniform buffer for light data!" << std::endl;
-            return false;
-        }
+        LOG_ERROR("[Application] Failed to create uniform buffer ring!");
+        return false;
+    }
+
+    // Every frame allocates its camera and light data from its slice
+    VkDeviceSize alignment = m_uniformBufferRing.GetAlignment();
+    VkDeviceSize frameUniformSize = (sizeof(CameraData) + alignment - 1) / alignment * alignment
+        + (sizeof(LightData) + alignment - 1) / alignment * alignment;
+    if (frameUniformSize > UNIFORM_BUFFER_FRAME_SIZE)
+    {
+        LOG_ERROR("[Application] The uniform buffer slice of " << UNIFORM_BUFFER_FRAME_SIZE << " bytes cannot hold the " << frameUniformSize << " bytes of uniforms of a frame!");
+        return false;
     }
 
     std::array<VkDescriptorPoolSize, 2> poolSizes = {};
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = m_maxFramesInFlight;
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = m_maxFramesInFlight * 2;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     poolSizes[1].descriptorCount = m_maxFramesInFlight;
 
@@ -1179,7 +2004,7 @@ bool Application::InitDescriptors()
 
     if (vkCreateDescriptorPool(VulkanContext::GetLogicalDevice(), &poolInfo, nullptr, &m_vkDescriptorPool) != VK_SUCCESS)
     {
-        std::cerr << "[Application] Failed to create descriptor pool!" << std::endl;
+        LOG_ERROR("[Application] Failed to create descriptor pool!");
         return false;
     }
 
@@ -1194,22 +2019,22 @@ bool Application::InitDescriptors()
     VkResult r = vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &descriptorsAllocInfo, descriptorSets.data());
     if (r != VK_SUCCESS)
     {
-        std::cerr << "[Application] Failed to allocate descriptor sets!" << std::endl;
+        LOG_ERROR("[Application] Failed to allocate descriptor sets!");
         if (r == VK_ERROR_OUT_OF_HOST_MEMORY)
         {
-            std::cerr << "[Application] Out of host memory!" << std::endl;
+            LOG_ERROR("[Application] Out of host memory!");
         }
         else if (r == VK_ERROR_OUT_OF_DEVICE_MEMORY)
         {
-            std::cerr << "[Application] Out of device memory!" << std::endl;
+            LOG_ERROR("[Application] Out of device memory!");
         }
         else if (r == VK_ERROR_FRAGMENTED_POOL)
         {
-            std::cerr << "[Application] Fragmented pool!" << std::endl;
+            LOG_ERROR("[Application] Fragmented pool!");
         }
         else if (r == VK_ERROR_OUT_OF_POOL_MEMORY)
         {
-            std::cerr << "[Application] Out of pool memory!" << std::endl;
+            LOG_ERROR("[Application] Out of pool memory!");
         }
         return false;
     }
@@ -1220,21 +2045,21 @@ bool Application::InitDescriptors()
 
         // Camera UBO
         VkDescriptorBufferInfo cameraUBO = {};
-        cameraUBO.buffer = m_frameDataList[i].cameraDataUniformBuffer.GetHandle();
-        cameraUBO.offset = 0;
-        cameraUBO.range = sizeof(CameraData); // or VK_WHOLE_SIZE
+        cameraUBO.buffer = m_uniformBufferRing.GetHandle();
+        cameraUBO.offset = 0; // Actual offset is provided as a dynamic offset when binding
+        cameraUBO.range = sizeof(CameraData);
 
         VkWriteDescriptorSet cameraUBOWrite = {};
         cameraUBOWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         cameraUBOWrite.dstSet = m_frameDataList[i].descriptorSet;
         cameraUBOWrite.dstBinding = 0;
         cameraUBOWrite.dstArrayElement = 0;
-        cameraUBOWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        cameraUBOWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         cameraUBOWrite.descriptorCount = 1;
         cameraUBOWrite.pBufferInfo = &cameraUBO;
 
         VkDescriptorBufferInfo lightUBO = {};
-        lightUBO.buffer = m_frameDataList[i].lightDataUniformBuffer.GetHandle();
+        lightUBO.buffer = m_uniformBufferRing.GetHandle();
         lightUBO.offset = 0;
         lightUBO.range = sizeof(LightData);
 
@@ -1243,13 +2068,13 @@ bool Application::InitDescriptors()
         lightUBOWrite.dstSet = m_frameDataList[i].descriptorSet;
         lightUBOWrite.dstBinding = 1;
         lightUBOWrite.dstArrayElement = 0;
-        lightUBOWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        lightUBOWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         lightUBOWrite.descriptorCount = 1;
         lightUBOWrite.pBufferInfo = &lightUBO;
 
         VkDescriptorImageInfo shadowMap = {};
         shadowMap.sampler = m_shadowMapSampler;
-        shadowMap.imageView = m_frameDataList[i].shadowMapImageView.GetHandle();
+        shadowMap.imageView = m_shadowMapImageView.GetHandle();
         shadowMap.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 
         VkWriteDescriptorSet shadowMapWrite = {};
@@ -1277,8 +2102,8 @@ bool Application::InitGraphicsPipeline()
     VulkanGraphicsPipelineBuilder builder {};
 
     // --- Vertex input ---
-    std::vector<VkVertexInputBindingDescription> bindings = Vertex::GetBindingDescriptions();
-    std::vector<VkVertexInputAttributeDescription> attributes = Vertex::GetAttributeDescriptions();
+    std::vector<VkVertexInputBindingDescription> bindings = VulkanVertexLayout::GetBindingDescriptions();
+    std::vector<VkVertexInputAttributeDescription> attributes = VulkanVertexLayout::GetAttributeDescriptions();
     builder
         .SetVertexBindingDescriptions(bindings)
         .SetVertexAttributeDescriptions(attributes);
@@ -1313,13 +2138,6 @@ bool Application::InitGraphicsPipeline()
     builder.SetDynamicStates(dynamicStates);
 
     // --- Pipeline layout ---
-    std::vector<VkPushConstantRange> pushConstantRanges;
-    pushConstantRanges.emplace_back();
-    pushConstantRanges.back().offset = 0;
-    pushConstantRanges.back().size = static_cast<uint32_t>(sizeof(PushConstant));
-    pushConstantRanges.back().stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    builder.SetPushConstantRanges(pushConstantRanges);
-
     std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_vkDescriptorSetLayout };
     builder.SetDescriptorSetLayouts(descriptorSetLayouts);
     
@@ -1329,14 +2147,195 @@ bool Application::InitGraphicsPipeline()
         .SetFragmentShaderFilePath("Resources/Shaders/basic_frag.spv");
 
     builder.SetRenderPass(m_vkRenderPass);
+    builder.SetPipelineCache(m_pipelineCache.GetHandle());
+
+    // --- Quality presets ---
+    // Each preset is a variant of the same pipeline, with different specialization constants
+    std::vector<VkSpecializationMapEntry> specializationMapEntries =
+    {
+        { 0, offsetof(ShaderQualitySettings, pcfKernelRadius), sizeof(int32_t) },
+        { 1, offsetof(ShaderQualitySettings, shadowsEnabled), sizeof(VkBool32) },
+        { 2, offsetof(ShaderQualitySettings, specularEnabled), sizeof(VkBool32) }
+    };
+    for (size_t i = 0; i < NUM_SHADER_QUALITY_PRESETS; ++i)
+    {
+        builder.SetFragmentShaderSpecialization(specializationMapEntries, &SHADER_QUALITY_SETTINGS[i], sizeof(ShaderQualitySettings));
+        if (!builder.Build())
+        {
+            LOG_ERROR("[Application] Failed to build pipeline for the " << SHADER_QUALITY_SETTINGS[i].name << " shader quality preset!");
+            return false;
+        }
+        m_qualityPipelines[i] = builder.GetPipeline();
+
+        // Every build creates an identical pipeline layout, so only the first one is kept.
+        // A pipeline layout is no longer needed by the pipelines created with it.
+        if (i == 0)
+        {
+            m_vkPipelineLayout = builder.GetPipelineLayout();
+        }
+        else
+        {
+            vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), builder.GetPipelineLayout(), nullptr);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Initializes the compute pipeline and resources used for GPU culling
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitCullingPipeline()
+{
+    // Without multiDrawIndirect, every cluster would need its own indirect draw call, mostly
+    // for culled clusters. The CPU-culled draws are cheaper then.
+    if (!VulkanContext::GetEnabledFeatures().multiDrawIndirect)
+    {
+        LOG_INFO("[Application] multiDrawIndirect is not supported, culling is done on the CPU");
+        return true;
+    }
+
+    // --- Buffers ---
+    // Each frame holds the draw commands for the main pass followed by the ones for the shadow pass
+    VkDeviceSize drawCommandBufferSize = sizeof(VkDrawIndirectCommand) * MAX_CLUSTER_COUNT * 2;
+    for (size_t i = 0; i < m_frameDataList.size(); i++)
+    {
+        // Selected clusters change every frame, so each frame has its own cluster data
+        if (!m_frameDataList[i].clusterCullDataBuffer.Create(sizeof(ClusterCullData) * MAX_CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        {
+            LOG_ERROR("[Application] Failed to create cluster cull data buffer!");
+            return false;
+        }
+
+        // The cluster data is written every frame, so the buffer stays mapped for its lifetime
+        m_frameDataList[i].clusterCullData = reinterpret_cast<ClusterCullData*>(m_frameDataList[i].clusterCullDataBuffer.MapMemory(0, sizeof(ClusterCullData) * MAX_CLUSTER_COUNT));
+        if (m_frameDataList[i].clusterCullData == nullptr)
+        {
+            LOG_ERROR("[Application] Failed to map cluster cull data buffer!");
+            return false;
+        }
+
+        if (!m_frameDataList[i].drawCommandBuffer.Create(drawCommandBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+        {
+            LOG_ERROR("[Application] Failed to create draw command buffer!");
+            return false;
+        }
+    }
+
+    // --- Descriptors ---
+    VkDescriptorSetLayoutBinding clusterDataBinding = {};
+    clusterDataBinding.binding = 0;
+    clusterDataBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    clusterDataBinding.descriptorCount = 1;
+    clusterDataBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutBinding drawCommandBinding = {};
+    drawCommandBinding.binding = 1;
+    drawCommandBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    drawCommandBinding.descriptorCount = 1;
+    drawCommandBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings = { clusterDataBinding, drawCommandBinding };
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(VulkanContext::GetLogicalDevice(), &layoutInfo, nullptr, &m_cullDescriptorSetLayout) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Application] Failed to create descriptor set layout for GPU culling!");
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = m_maxFramesInFlight * static_cast<uint32_t>(bindings.size());
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = m_maxFramesInFlight;
+    if (vkCreateDescriptorPool(VulkanContext::GetLogicalDevice(), &poolInfo, nullptr, &m_cullDescriptorPool) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Application] Failed to create descriptor pool for GPU culling!");
+        return false;
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(m_maxFramesInFlight, m_cullDescriptorSetLayout);
+    VkDescriptorSetAllocateInfo descriptorsAllocInfo = {};
+    descriptorsAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptorsAllocInfo.descriptorPool = m_cullDescriptorPool;
+    descriptorsAllocInfo.descriptorSetCount = m_maxFramesInFlight;
+    descriptorsAllocInfo.pSetLayouts = layouts.data();
+
+    std::vector<VkDescriptorSet> descriptorSets(m_maxFramesInFlight);
+    if (vkAllocateDescriptorSets(VulkanContext::GetLogicalDevice(), &descriptorsAllocInfo, descriptorSets.data()) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Application] Failed to allocate descriptor sets for GPU culling!");
+        return false;
+    }
+
+    for (size_t i = 0; i < m_frameDataList.size(); i++)
+    {
+        m_frameDataList[i].cullDescriptorSet = descriptorSets[i];
+
+        VkDescriptorBufferInfo clusterDataInfo = {};
+        clusterDataInfo.buffer = m_frameDataList[i].clusterCullDataBuffer.GetHandle();
+        clusterDataInfo.offset = 0;
+        clusterDataInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet clusterDataWrite = {};
+        clusterDataWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        clusterDataWrite.dstSet = m_frameDataList[i].cullDescriptorSet;
+        clusterDataWrite.dstBinding = 0;
+        clusterDataWrite.dstArrayElement = 0;
+        clusterDataWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        clusterDataWrite.descriptorCount = 1;
+        clusterDataWrite.pBufferInfo = &clusterDataInfo;
+
+        VkDescriptorBufferInfo drawCommandInfo = {};
+        drawCommandInfo.buffer = m_frameDataList[i].drawCommandBuffer.GetHandle();
+        drawCommandInfo.offset = 0;
+        drawCommandInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet drawCommandWrite = {};
+        drawCommandWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        drawCommandWrite.dstSet = m_frameDataList[i].cullDescriptorSet;
+        drawCommandWrite.dstBinding = 1;
+        drawCommandWrite.dstArrayElement = 0;
+        drawCommandWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        drawCommandWrite.descriptorCount = 1;
+        drawCommandWrite.pBufferInfo = &drawCommandInfo;
+
+        std::array<VkWriteDescriptorSet, 2> writes = { clusterDataWrite, drawCommandWrite };
+        vkUpdateDescriptorSets(VulkanContext::GetLogicalDevice(), writes.size(), writes.data(), 0, nullptr);
+    }
+
+    // --- Pipeline ---
+    VulkanComputePipelineBuilder builder {};
+
+    std::vector<VkPushConstantRange> pushConstantRanges;
+    pushConstantRanges.emplace_back();
+    pushConstantRanges.back().offset = 0;
+    pushConstantRanges.back().size = static_cast<uint32_t>(sizeof(CullPushConstant));
+    pushConstantRanges.back().stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    builder.SetPushConstantRanges(pushConstantRanges);
+
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { m_cullDescriptorSetLayout };
+    builder.SetDescriptorSetLayouts(descriptorSetLayouts);
+
+    builder.SetComputeShaderFilePath("Resources/Shaders/cull_comp.spv");
+    builder.SetPipelineCache(m_pipelineCache.GetHandle());
 
     if (!builder.Build())
     {
         return false;
     }
 
-    m_vkPipelineLayout = builder.GetPipelineLayout();
-    m_vkPipeline = builder.GetPipeline();
+    m_cullPipelineLayout = builder.GetPipelineLayout();
+    m_cullPipeline = builder.GetPipeline();
+    m_gpuCullingEnabled = true;
 
     return true;
 }
@@ -1361,7 +2360,7 @@ bool Application::InitSynchronizationTools()
                 || (vkCreateSemaphore(VulkanContext::GetLogicalDevice(), &semaphoreCreateInfo, nullptr, &m_frameDataList[i].renderDoneSemaphore) != VK_SUCCESS)
                 || (vkCreateFence(VulkanContext::GetLogicalDevice(), &fenceCreateInfo, nullptr, &m_frameDataList[i].renderDoneFence) != VK_SUCCESS))
         {
-            std::cout << "Failed to create synchronization tools!" << std::endl;
+            LOG_ERROR("Failed to create synchronization tools!");
             return false;
         }
     }
@@ -1370,225 +2369,1002 @@ bool Application::InitSynchronizationTools()
 }
 
 /**
- * @brief Appends geometry vertices of a tile into a destination buffer
- * @param[in] tileData Tile whose geometry vertices to append
- * @param[in] origin Origin that the vertices are relative to (lon/lat)
- * @param[in] dest Destination buffer to append the vertices to
- * @return Number of vertices appended
+ * @brief Initializes the GPU timer used to measure the passes of each frame.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
  */
-uint32_t Application::AppendTileGeometryVertices(const TileData &tileData, const glm::dvec2 &origin, std::vector<Vertex> &dest)
+bool Application::InitGpuTimer()
 {
-    uint32_t numVerticesAdded = static_cast<uint32_t>(dest.size());
+    return m_gpuTimer.Create(m_maxFramesInFlight, MAX_GPU_ZONES_PER_FRAME);
+}
+
+/**
+ * @brief Initializes the pipeline of the performance overlay. Requires the main render pass.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitHudPipeline()
+{
+    VulkanGraphicsPipelineBuilder builder {};
+
+    // --- Vertex input ---
+    std::vector<VkVertexInputBindingDescription> bindings =
+    {
+        { 0, sizeof(HudOverlay::HudVertex), VK_VERTEX_INPUT_RATE_VERTEX }
+    };
+    std::vector<VkVertexInputAttributeDescription> attributes =
+    {
+        { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(HudOverlay::HudVertex, position) },
+        { 1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(HudOverlay::HudVertex, color) }
+    };
+    builder
+        .SetVertexBindingDescriptions(bindings)
+        .SetVertexAttributeDescriptions(attributes);
+
+    // --- Input assembly ---
+    builder.SetTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+
+    // --- Viewport and scissors ---
+    // Both are meant to be dynamic, so we only set the number of viewports and scissors, but not the actual data yet
+    builder.SetViewportCount(1);
+    builder.SetScissorCount(1);
+
+    // --- Rasterizer ---
+    builder
+        .SetPolygonMode(VK_POLYGON_MODE_FILL)
+        .SetCullMode(VK_CULL_MODE_NONE)
+        .SetFrontFace(VK_FRONT_FACE_CLOCKWISE);
+
+    // --- Multisampling ---
+
+    // --- Depth & stencil ---
+    // The overlay is always on top of the tiles
+    builder
+        .SetDepthTestEnabled(VK_FALSE)
+        .SetDepthWriteEnabled(VK_FALSE);
 
-    glm::dvec2 tileCenter = GeometryUtils::LonLatToXY(origin);
+    // --- Color blending ---
+    // The panel is translucent, so the tiles stay visible behind it
+    builder.SetAlphaBlendingEnabled(VK_TRUE);
 
-    const std::vector<BuildingData> &buildings = tileData.buildings;
+    // --- Dynamic state ---
+    // (Attributes specified here will have to be specified at drawing time)
+    std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    builder.SetDynamicStates(dynamicStates);
 
-    glm::vec3 sideColor(0.65f);
-    glm::vec3 topColor(0.9f);
-    glm::vec3 bottomColor(0.35f);
+    // --- Pipeline layout ---
+    // The vertices are already in normalized device coordinates, so no descriptor sets are needed
 
-    std::vector<glm::dvec2> pointsInTriangulation;
+    // --- Shaders ---
+    builder
+        .SetVertexShaderFilePath("Resources/Shaders/hud_vert.spv")
+        .SetFragmentShaderFilePath("Resources/Shaders/hud_frag.spv");
+
+    builder.SetRenderPass(m_vkRenderPass);
+    builder.SetPipelineCache(m_pipelineCache.GetHandle());
 
-    for (size_t i = 0; i < buildings.size(); i++)
+    if (!builder.Build())
     {
-        const BuildingData &building = buildings.at(i);
+        LOG_ERROR("[Application] Failed to build pipeline for the performance overlay!");
+        return false;
+    }
 
-        float buildingHeight = building.heightInMeters * SCALE;
-        float buildingYOffset = building.heightFromGround * SCALE;
+    m_hudPipelineLayout = builder.GetPipelineLayout();
+    m_hudPipeline = builder.GetPipeline();
 
-        std::vector<glm::dvec2> points;
-        for (size_t j = 0; j < building.outline.size(); ++j)
+    return true;
+}
+
+/**
+ * @brief Initializes the vertex buffer and the secondary command buffer of the performance overlay for each frame.
+ * @return Returns true if the initialization was successful. Returns false otherwise.
+ */
+bool Application::InitHudBuffers()
+{
+    VkCommandBufferAllocateInfo commandBufferInfo = {};
+    commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandBufferInfo.commandPool = m_vkCommandPool;
+    commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    commandBufferInfo.commandBufferCount = 1;
+
+    for (size_t i = 0; i < m_frameDataList.size(); i++)
+    {
+        // The overlay is rebuilt every frame, so each frame in flight writes its own vertices
+        if (!m_frameDataList[i].hudVertexBuffer.Create(sizeof(HudOverlay::HudVertex) * MAX_HUD_VERTICES, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
         {
-            points.push_back(GeometryUtils::LonLatToXY(building.outline[j]));
+            LOG_ERROR("[Application] Failed to create performance overlay vertex buffer!");
+            return false;
         }
 
-        for (size_t j = 0; j < points.size(); j++)
+        if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &commandBufferInfo, &m_frameDataList[i].hudCommandBuffer) != VK_SUCCESS)
         {
-            glm::dvec2 &a = points[j];
-            glm::dvec2 &b = points[(j + 1) % points.size()];
-            glm::dvec2 &c = points[(j + 2) % points.size()];
+            LOG_ERROR("[Application] Failed to allocate performance overlay command buffer!");
+            return false;
+        }
+    }
 
-            if (GeometryUtils::IsCollinear(a, b, c))
-            {
-                points.erase(points.begin() + ((j + 1) % points.size()));
-                --j;
-            }
+    return true;
+}
+
+/**
+ * @brief Passes the GPU zones of the frame's last finished commands to the profiler,
+ * and the GPU time of the whole frame to the benchmark recorder.
+ * Must only be called once the frame's fence was signaled.
+ * @param[in] frameIndex Index of the frame in the frame data list
+ */
+void Application::CollectGpuTime(uint32_t frameIndex)
+{
+    uint64_t frameNumber = 0;
+    if (!m_gpuTimer.GetResults(frameIndex, frameNumber, m_gpuZoneResults))
+    {
+        return;
+    }
+
+    for (const VulkanGpuTimer::ZoneResult &zone : m_gpuZoneResults)
+    {
+        Profiler::AddGpuEvent(zone.name, zone.startMicroseconds, static_cast<int64_t>(zone.durationMilliseconds * 1000.0));
+
+        // The first zone spans all commands of the frame
+        if (&zone == &m_gpuZoneResults.front())
+        {
+            m_benchmarkRecorder.SetGpuTime(frameNumber, zone.durationMilliseconds);
+            m_lastGpuFrameMilliseconds = zone.durationMilliseconds;
         }
+    }
+}
 
-        if (!GeometryUtils::IsPolygonCCW(points))
+/**
+ * @brief Starts recording profiler events, or stops recording and writes the recorded events to the trace file.
+ */
+void Application::ToggleProfiling()
+{
+    if (!Profiler::IsEnabled())
+    {
+        Profiler::SetEnabled(true);
+        LOG_INFO("[Application] Profiling started");
+        return;
+    }
+
+    Profiler::SetEnabled(false);
+    const std::string &traceFile = m_launchOptions.profileTraceFile.empty() ? DEFAULT_PROFILE_TRACE_FILE : m_launchOptions.profileTraceFile;
+    if (Profiler::ExportChromeTrace(traceFile))
+    {
+        LOG_INFO("[Application] Profiling stopped. Trace written to " << traceFile);
+    }
+    else
+    {
+        LOG_ERROR("[Application] Failed to write profiler trace to " << traceFile << "!");
+    }
+}
+
+/**
+ * @brief Picks up the tile meshes published by the worker threads
+ */
+void Application::CollectPublishedTileMeshes()
+{
+    PROFILE_SCOPE("Collect published tile meshes");
+
+    std::shared_ptr<const TileMesh> tileMesh;
+    while (m_publishedTileMeshes.Pop(tileMesh))
+    {
+        // Meshes of tiles that were released while being meshed are dropped
+        auto it = m_readyTileMeshes.find(tileMesh->tileKey);
+        if (it == m_readyTileMeshes.end())
+        {
+            continue;
+        }
+
+        it->second = std::move(tileMesh);
+        if (m_visibleTileSet.find(it->first) != m_visibleTileSet.end())
+        {
+            m_residentTilesDirty = true;
+        }
+    }
+}
+
+/**
+ * @brief Evicts the resident tiles that are no longer visible, and queues the
+ * visible tiles with a ready mesh for upload, nearest first.
+ */
+void Application::UpdateResidentTiles()
+{
+    // Vertices are relative to the mesh origin, which only follows the camera once it is
+    // far enough to affect precision. Rebasing means uploading every tile again.
+    glm::ivec2 meshOriginDistance = glm::abs(m_currentTileIndex - m_meshOriginTileIndex);
+    bool isMeshOriginFar = (glm::max(meshOriginDistance.x, meshOriginDistance.y) > MESH_ORIGIN_REBASE_DISTANCE);
+    bool isVertexBufferUnused = m_residentTiles.empty() && m_pendingVertexFrees.empty();
+    if (isMeshOriginFar || isVertexBufferUnused)
+    {
+        if (!isVertexBufferUnused)
+        {
+            vkDeviceWaitIdle(VulkanContext::GetLogicalDevice());
+        }
+        m_vertexAllocator.Reset();
+        m_residentTiles.clear();
+        m_pendingVertexFrees.clear();
+
+        m_meshOriginTileIndex = m_currentTileIndex;
+        m_meshOrigin = m_origin;
+        m_shadowMapDirty = true;
+    }
+
+    // Frames in flight may still draw the evicted tiles, so their ranges are freed later
+    for (auto it = m_residentTiles.begin(); it != m_residentTiles.end();)
+    {
+        if (m_visibleTileSet.find(it->first) == m_visibleTileSet.end())
+        {
+            m_pendingVertexFrees.push_back({ m_frameNumber, it->second.firstVertex, it->second.vertexCount });
+            it = m_residentTiles.erase(it);
+        }
+        else
         {
-            std::reverse(points.begin(), points.end());
+            ++it;
         }
-        // Double check if polygon is now indeed CCW
-        if (!GeometryUtils::IsPolygonCCW(points))
+    }
+
+    m_uploadQueue.clear();
+    for (const TileKey &tileKey : m_visibleTiles)
+    {
+        auto it = m_readyTileMeshes.find(tileKey);
+        if ((it != m_readyTileMeshes.end()) && (it->second != nullptr) && (m_residentTiles.find(tileKey) == m_residentTiles.end()))
         {
-            std::cout << "Polygon is still not CCW!" << std::endl;
+            m_uploadQueue.push_back(tileKey);
         }
+    }
+}
 
-        // Top
-        GeometryUtils::PolygonTriangulation(points, pointsInTriangulation);
-        for (size_t j = 0; j < pointsInTriangulation.size(); j++)
+/**
+ * @brief Uploads queued tiles to the vertex buffer until the per-frame
+ * byte or time budget is used up. At least one tile is uploaded per frame,
+ * unless the staging buffer of the transfer queue is full.
+ */
+void Application::UploadQueuedTiles()
+{
+    if (m_uploadQueue.empty())
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    glm::dvec2 meshOriginXY = GeometryUtils::LonLatToXY(m_meshOrigin);
+
+    size_t uploadedBytes = 0;
+    std::vector<TileKey> uploadedTiles;
+    for (size_t i = 0; i < m_uploadQueue.size();)
+    {
+        std::chrono::steady_clock::time_point tileStartTime = std::chrono::steady_clock::now();
+        const std::shared_ptr<const TileMesh> &readyMesh = m_readyTileMeshes[m_uploadQueue[i]];
+        uint32_t vertexCount = static_cast<uint32_t>(readyMesh->vertices.size());
+        size_t positionBytes = vertexCount * sizeof(glm::vec3);
+        size_t attributeBytes = vertexCount * sizeof(VertexAttributes);
+        size_t tileBytes = positionBytes + attributeBytes;
+
+        if (!uploadedTiles.empty())
         {
-            glm::dvec2 point = (pointsInTriangulation[j] - tileCenter) * SCALE;
-            dest.emplace_back();
-            dest.back().position.x = point.x;
-            dest.back().position.y = buildingYOffset + buildingHeight;
-            dest.back().position.z = point.y;
-            dest.back().color = topColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
+            int64_t elapsedMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+            if ((uploadedBytes + tileBytes > m_uploadBudgetBytes) || (elapsedMicroseconds >= static_cast<int64_t>(m_uploadBudgetMicroseconds)))
+            {
+                break;
+            }
         }
-        // Bottom
-        for (size_t j = pointsInTriangulation.size(); j > 0; j--)
+
+        // Tiles that do not fit stay in the queue until further tiles are evicted
+        uint32_t firstVertex = 0;
+        if ((vertexCount > 0) && !m_vertexAllocator.Allocate(vertexCount, firstVertex))
         {
-            glm::dvec2 point = (pointsInTriangulation[j - 1] - tileCenter) * SCALE;
-            dest.emplace_back();
-            dest.back().position.x = point.x;
-            dest.back().position.y = buildingYOffset;
-            dest.back().position.z = point.y;
-            dest.back().color = bottomColor;
-            dest.back().normal = { 0.0f, -1.0f, 0.0f };
+            ++i;
+            continue;
         }
 
-        // Extrude
-        for (size_t j = 0; j < points.size(); j++)
+        glm::dvec2 tileOffsetXY = (GeometryUtils::LonLatToXY(readyMesh->origin) - meshOriginXY) * SCALE;
+        glm::vec3 tileOffset(static_cast<float>(tileOffsetXY.x), 0.0f, static_cast<float>(tileOffsetXY.y));
+        auto writePositions = [&readyMesh, vertexCount, tileOffset](void *dest)
+        {
+            glm::vec3 *data = reinterpret_cast<glm::vec3*>(dest);
+            for (uint32_t j = 0; j < vertexCount; ++j)
+            {
+                data[j] = readyMesh->vertices[j].position + tileOffset;
+            }
+        };
+        auto writeAttributes = [&readyMesh, vertexCount](void *dest)
         {
-            const glm::vec2 &p0 = (points[j] - tileCenter) * SCALE;
-            const glm::vec2 &p1 = (points[(j + 1) % points.size()] - tileCenter) * SCALE;
+            VertexAttributes *data = reinterpret_cast<VertexAttributes*>(dest);
+            for (uint32_t j = 0; j < vertexCount; ++j)
+            {
+                data[j] = readyMesh->vertices[j].GetAttributes();
+            }
+        };
 
-            dest.emplace_back();
-            dest.back().position = { p0.x, buildingYOffset, p0.y };
-            dest.back().color = sideColor;
-            dest.emplace_back();
-            dest.back().position = { p1.x, buildingYOffset, p1.y };
-            dest.back().color = sideColor;
-            dest.emplace_back();
-            dest.back().position = { p1.x, buildingYOffset + buildingHeight, p1.y };
-            dest.back().color = sideColor;
-            dest.emplace_back();
-            dest.back().position = { p1.x, buildingYOffset + buildingHeight, p1.y };
-            dest.back().color = sideColor;
-            dest.emplace_back();
-            dest.back().position = { p0.x, buildingYOffset + buildingHeight, p0.y };
-            dest.back().color = sideColor;
-            dest.emplace_back();
-            dest.back().position = { p0.x, buildingYOffset, p0.y };
-            dest.back().color = sideColor;
+        if (vertexCount > 0)
+        {
+            if (m_uploadEngineEnabled)
+            {
+                // Tiles that do not fit in the staging buffer wait until earlier copies finish
+                if (!m_uploadEngine.Upload(m_positionBuffer.GetHandle(), firstVertex * sizeof(glm::vec3), positionBytes, writePositions))
+                {
+                    m_vertexAllocator.Free(firstVertex, vertexCount);
+                    break;
+                }
+                // The queued position copy still writes to the range, so it is
+                // only freed once the frames waiting on that copy are done
+                if (!m_uploadEngine.Upload(m_attributeBuffer.GetHandle(), firstVertex * sizeof(VertexAttributes), attributeBytes, writeAttributes))
+                {
+                    m_pendingVertexFrees.push_back({ m_frameNumber, firstVertex, vertexCount });
+                    break;
+                }
+            }
+            else
+            {
+                writePositions(m_positionBuffer.MapMemory(firstVertex * sizeof(glm::vec3), positionBytes));
+                m_positionBuffer.UnmapMemory();
+                writeAttributes(m_attributeBuffer.MapMemory(firstVertex * sizeof(VertexAttributes), attributeBytes));
+                m_attributeBuffer.UnmapMemory();
+            }
+        }
 
-            for (size_t k = 0; k < 2; ++k)
+        // Only the clusters and bounds are kept, relative to the mesh origin
+        ResidentTile &residentTile = m_residentTiles[m_uploadQueue[i]];
+        residentTile.firstVertex = firstVertex;
+        residentTile.vertexCount = vertexCount;
+        residentTile.mesh.tileKey = readyMesh->tileKey;
+        residentTile.mesh.origin = m_meshOrigin;
+        residentTile.mesh.bounds = AABB::Empty();
+        for (size_t lodLevel = 0; lodLevel < NUM_LOD_LEVELS; ++lodLevel)
+        {
+            residentTile.mesh.lodClusters[lodLevel].clear();
+            for (MeshCluster cluster : readyMesh->lodClusters[lodLevel])
             {
-                size_t offset = k * 3;
-                const glm::vec3 a = dest[dest.size() - 1 - (offset + 2)].position;
-                const glm::vec3 b = dest[dest.size() - 1 - (offset + 1)].position;
-                const glm::vec3 c = dest[dest.size() - 1 - (offset + 0)].position;
-
-                glm::vec3 normal = glm::normalize(glm::cross(c - a, b - a));
-                dest[dest.size() - 1 - (offset + 2)].normal = normal;
-                dest[dest.size() - 1 - (offset + 1)].normal = normal;
-                dest[dest.size() - 1 - (offset + 0)].normal = normal;
+                cluster.firstVertex += firstVertex;
+                cluster.bounds.min += tileOffset;
+                cluster.bounds.max += tileOffset;
+                residentTile.mesh.lodClusters[lodLevel].push_back(cluster);
+                residentTile.mesh.bounds.Expand(cluster.bounds);
             }
         }
+
+        m_tileStageStats.AddStageTime(TileStageStats::Stage::Upload, std::chrono::duration<double>(std::chrono::steady_clock::now() - tileStartTime).count());
+
+        uploadedBytes += tileBytes;
+        uploadedTiles.push_back(m_uploadQueue[i]);
+        m_uploadQueue.erase(m_uploadQueue.begin() + i);
+    }
+
+    // The copies of this frame become visible to rendering once the timeline value is reached
+    if (m_uploadEngineEnabled && !m_uploadEngine.Submit(m_vertexUploadValue))
+    {
+        LOG_ERROR("[Application] Failed to submit tile uploads!");
+    }
+
+    if (!uploadedTiles.empty())
+    {
+        m_tileRegistry.MarkResident(uploadedTiles, m_frameTileLatencies);
+
+        uint32_t uploadMicroseconds = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+        m_uploadStats.uploadedTiles += static_cast<uint32_t>(uploadedTiles.size());
+        m_uploadStats.uploadedBytes += uploadedBytes;
+        ++m_uploadStats.framesWithUploads;
+        m_uploadStats.totalUploadMicroseconds += uploadMicroseconds;
+        m_uploadStats.maxFrameUploadMicroseconds = glm::max(m_uploadStats.maxFrameUploadMicroseconds, uploadMicroseconds);
     }
+    m_uploadStats.maxBacklogDepth = glm::max(m_uploadStats.maxBacklogDepth, m_uploadQueue.size());
+}
 
-    // Road vertices
-    const glm::vec3 roadColor(0.0f, 0.5f, 0.5f);
-    const std::vector<HighwayData> &highways = tileData.highways;
-    for (size_t i = 0; i < highways.size(); i++)
+/**
+ * @brief Frees the vertex ranges of evicted tiles that are no longer read by any frame in flight
+ */
+void Application::ReleasePendingVertexRanges()
+{
+    while (!m_pendingVertexFrees.empty() && (m_pendingVertexFrees.front().frameNumber + m_maxFramesInFlight <= m_frameNumber))
     {
-        const HighwayData &highway = highways.at(i);
+        m_vertexAllocator.Free(m_pendingVertexFrees.front().firstVertex, m_pendingVertexFrees.front().vertexCount);
+        m_pendingVertexFrees.pop_front();
+    }
+}
 
-        double roadHeight = 0.0;
-        double width = highway.roadWidth * SCALE;
-        for (size_t j = 1; j < highway.points.size(); j++)
+/**
+ * @brief Gets the position of the mesh origin relative to the current origin
+ * @return Offset of the mesh origin (world-space)
+ */
+glm::vec3 Application::GetMeshOriginOffset() const
+{
+    glm::dvec2 offset = (GeometryUtils::LonLatToXY(m_meshOrigin) - GeometryUtils::LonLatToXY(m_origin)) * SCALE;
+    return glm::vec3(static_cast<float>(offset.x), 0.0f, static_cast<float>(offset.y));
+}
+
+/**
+ * @brief Picks the LOD level of each tile by its projected geometric error, and
+ * gathers the clusters of the picked levels into the selected clusters list.
+ * @param[in] cameraPosition Camera position
+ * @param[in] viewportHeight Height of the viewport (in pixels)
+ */
+void Application::SelectTileLods(const glm::vec3 &cameraPosition, float viewportHeight)
+{
+    // Number of pixels covered by one world unit at a distance of one world unit
+    float pixelsPerUnit = viewportHeight / (2.0f * glm::tan(glm::radians(m_camera.GetFieldOfView()) * 0.5f));
+
+    m_selectedClusters.clear();
+    m_selectedTileGroups.clear();
+    m_tileCountPerLod.fill(0);
+    m_gpuCullingOverflowTileCount = 0;
+    for (const TileKey &tileKey : m_visibleTiles)
+    {
+        auto it = m_residentTiles.find(tileKey);
+        if ((it == m_residentTiles.end()) || !it->second.mesh.bounds.IsValid())
         {
-            const glm::dvec2 &a = (GeometryUtils::LonLatToXY(highway.points[j - 1]) - tileCenter) * SCALE;
-            const glm::dvec2 &b = (GeometryUtils::LonLatToXY(highway.points[j]) - tileCenter) * SCALE;
+            continue;
+        }
+        const TileMesh &tileMesh = it->second.mesh;
 
-            glm::dvec2 dir = b - a;
-            glm::dvec2 normal(-dir.y, dir.x);
-            normal = glm::normalize(normal);
+        // Distance to the closest point of the tile, so that tiles containing the camera get full detail
+        glm::vec3 closestPoint = glm::clamp(cameraPosition, tileMesh.bounds.min, tileMesh.bounds.max);
+        float distance = glm::max(glm::distance(cameraPosition, closestPoint), 0.001f);
 
-            glm::dvec2 p0 = a + normal * width / 2.0;
-            glm::dvec2 p1 = a - normal * width / 2.0;
-            glm::dvec2 p2 = b - normal * width / 2.0;
-            glm::dvec2 p3 = b + normal * width / 2.0;
+        // Pick the coarsest level whose error projects to at most MAX_SCREEN_SPACE_ERROR pixels
+        size_t lodLevel = 0;
+        for (size_t i = NUM_LOD_LEVELS; i > 0; --i)
+        {
+            float geometricError = static_cast<float>(m_tileMeshBuilder.GetGeometricError(i - 1) * SCALE);
+            if (geometricError * pixelsPerUnit / distance <= MAX_SCREEN_SPACE_ERROR)
+            {
+                lodLevel = i - 1;
+                break;
+            }
+        }
 
-            dest.emplace_back();
-            dest.back().position = { p0.x, roadHeight, p0.y };
-            dest.back().color = roadColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
-            dest.emplace_back();
-            dest.back().position = { p1.x, roadHeight, p1.y };
-            dest.back().color = roadColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
-            dest.emplace_back();
-            dest.back().position = { p2.x, roadHeight, p2.y };
-            dest.back().color = roadColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
-            dest.emplace_back();
-            dest.back().position = { p2.x, roadHeight, p2.y };
-            dest.back().color = roadColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
-            dest.emplace_back();
-            dest.back().position = { p3.x, roadHeight, p3.y };
-            dest.back().color = roadColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
-            dest.emplace_back();
-            dest.back().position = { p0.x, roadHeight, p0.y };
-            dest.back().color = roadColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
+        // Tiles beyond the capacity of the GPU cull buffer are still drawn, by CPU culling
+        const std::vector<MeshCluster> &clusters = tileMesh.lodClusters[lodLevel];
+        if (m_selectedClusters.size() + clusters.size() > MAX_CLUSTER_COUNT)
+        {
+            ++m_gpuCullingOverflowTileCount;
+        }
+        m_selectedClusters.insert(m_selectedClusters.end(), clusters.begin(), clusters.end());
+        ++m_tileCountPerLod[lodLevel];
+
+        // Neighboring tiles are grouped by their common ancestor
+        int groupZoomOffset = glm::min(TILE_GROUP_ZOOM_OFFSET, tileKey.zoomLevel);
+        TileKey groupKey = { tileKey.index >> groupZoomOffset, tileKey.zoomLevel - groupZoomOffset };
+        std::vector<MeshCluster> &groupClusters = m_selectedTileGroups[groupKey];
+        groupClusters.insert(groupClusters.end(), clusters.begin(), clusters.end());
+    }
+}
+
+/**
+ * @brief Checks whether the cached shadow map is still valid. If not, moves the shadow map
+ * to a texel-snapped anchor near the camera, so that re-rendered shadows do not shimmer.
+ * @param[in] cameraPosition Camera position, relative to the mesh origin
+ * @param[in] lightDirection Direction of the light
+ * @return Returns true if the shadow map has to be rendered again. Returns false if the cached one can be used.
+ */
+bool Application::UpdateShadowMapAnchor(const glm::vec3 &cameraPosition, const glm::vec3 &lightDirection)
+{
+    // Only the casters inside the light box are drawn into the shadow map, so uploads, evictions
+    // and LOD switches elsewhere keep the cached one. Picking another LOD level inside it changes
+    // the casters as well.
+    auto isSameCluster = [](const MeshCluster &a, const MeshCluster &b)
+    {
+        return (a.firstVertex == b.firstVertex) && (a.vertexCount == b.vertexCount)
+            && (a.bounds.min == b.bounds.min) && (a.bounds.max == b.bounds.max);
+    };
+    bool isCameraFar = glm::distance(cameraPosition, m_shadowMapAnchor) > SHADOW_MAP_REFRESH_DISTANCE;
+    if (!m_shadowMapDirty && !isCameraFar)
+    {
+        std::vector<MeshCluster> shadowCasterClusters = GetShadowCasterClusters(m_shadowMapLightMatrix);
+        if (std::equal(m_shadowMapClusters.begin(), m_shadowMapClusters.end(), shadowCasterClusters.begin(), shadowCasterClusters.end(), isSameCluster))
+        {
+            return false;
         }
     }
 
-    // Water vertices
-    glm::vec3 waterColor { 0.8314f, 0.9451f, 0.9765f };
-    const std::vector<WaterFeatureData> &waters = tileData.waterFeatures;
-    for (size_t i = 0; i < waters.size(); ++i)
+    // Snap the anchor to whole texels in light space, so the shadow map moves
+    // with the same rasterization grid instead of resampling the casters
+    glm::vec3 worldUp(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), lightDirection, worldUp);
+    glm::vec3 lightSpaceAnchor = glm::vec3(lightRotation * glm::vec4(cameraPosition, 1.0f));
+    float texelWidth = 2.0f * SHADOW_MAP_HALF_EXTENT / SHADOW_MAP_WIDTH;
+    float texelHeight = 2.0f * SHADOW_MAP_HALF_EXTENT / SHADOW_MAP_HEIGHT;
+    lightSpaceAnchor.x = glm::round(lightSpaceAnchor.x / texelWidth) * texelWidth;
+    lightSpaceAnchor.y = glm::round(lightSpaceAnchor.y / texelHeight) * texelHeight;
+    m_shadowMapAnchor = glm::vec3(glm::inverse(lightRotation) * glm::vec4(lightSpaceAnchor, 1.0f));
+
+    glm::mat4 lightProj = glm::orthoRH_ZO(-SHADOW_MAP_HALF_EXTENT, SHADOW_MAP_HALF_EXTENT, -SHADOW_MAP_HALF_EXTENT, SHADOW_MAP_HALF_EXTENT, 1.0f, 50.0f);
+    lightProj[1][1] *= -1.0f;
+    glm::mat4 lightView = glm::lookAt(m_shadowMapAnchor - lightDirection * 5.0f, m_shadowMapAnchor, worldUp);
+    m_shadowMapLightMatrix = lightProj * lightView;
+
+    m_shadowMapClusters = GetShadowCasterClusters(m_shadowMapLightMatrix);
+    m_shadowMapDirty = false;
+    ++m_shadowMapRenderCount;
+    return true;
+}
+
+/**
+ * @brief Gathers the selected clusters that intersect the light box of a shadow map
+ * @param[in] lightMatrix Light projection-view matrix of the shadow map
+ * @return Selected clusters inside the light box
+ */
+std::vector<MeshCluster> Application::GetShadowCasterClusters(const glm::mat4 &lightMatrix) const
+{
+    Frustum lightFrustum = Frustum::FromMatrix(lightMatrix);
+    std::vector<MeshCluster> shadowCasterClusters;
+    for (const MeshCluster &cluster : m_selectedClusters)
     {
-        const WaterFeatureData &water = waters[i];
+        if (lightFrustum.IsAABBVisible(cluster.bounds))
+        {
+            shadowCasterClusters.push_back(cluster);
+        }
+    }
+    return shadowCasterClusters;
+}
+
+/**
+ * @brief Records draw commands for the clusters. Adjacent clusters are merged into a single draw call.
+ * @param[in] commandBuffer Command buffer to record the draw commands into
+ * @param[in] clusters Clusters to draw
+ * @return Number of recorded draw calls
+ */
+uint32_t Application::DrawClusters(VkCommandBuffer commandBuffer, const std::vector<MeshCluster> &clusters)
+{
+    uint32_t drawCalls = 0;
+    uint32_t rangeStart = 0;
+    uint32_t rangeCount = 0;
+    for (const MeshCluster &cluster : clusters)
+    {
+        if ((rangeCount > 0) && (rangeStart + rangeCount == cluster.firstVertex))
+        {
+            rangeCount += cluster.vertexCount;
+            continue;
+        }
+
+        if (rangeCount > 0)
+        {
+            vkCmdDraw(commandBuffer, rangeCount, 1, rangeStart, 0);
+            ++drawCalls;
+        }
+        rangeStart = cluster.firstVertex;
+        rangeCount = cluster.vertexCount;
+    }
+
+    if (rangeCount > 0)
+    {
+        vkCmdDraw(commandBuffer, rangeCount, 1, rangeStart, 0);
+        ++drawCalls;
+    }
+    return drawCalls;
+}
+
+/**
+ * @brief Records the pipeline, viewport, vertex buffer, and descriptor set bindings of a pass
+ * @param[in] commandBuffer Command buffer to record the commands into
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] isShadowPass Flag indicating whether the state of the shadow pass or the main pass is bound
+ * @param[in] dynamicOffsets Uniform buffer offsets of the camera and light data
+ */
+void Application::BindPassState(VkCommandBuffer commandBuffer, const FrameData &frameData, bool isShadowPass, const std::array<uint32_t, 2> &dynamicOffsets)
+{
+    VkExtent2D extent = isShadowPass ? VkExtent2D { SHADOW_MAP_WIDTH, SHADOW_MAP_HEIGHT } : m_vkSwapchainImageExtent;
+    VkPipelineLayout pipelineLayout = isShadowPass ? m_shadowPipelineLayout : m_vkPipelineLayout;
+
+    // Viewport and scissors are dynamic, so we set here as a command
+    VkViewport viewport {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor {};
+    scissor.offset = { 0, 0 };
+    scissor.extent = extent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, isShadowPass ? m_shadowPipeline : m_qualityPipelines[m_shaderQuality]);
+
+    // The shadow pass only reads the position stream
+    std::array<VkDeviceSize, 2> offsets = { 0, 0 };
+    std::array<VkBuffer, 2> vertexBuffers = { m_positionBuffer.GetHandle(), m_attributeBuffer.GetHandle() };
+    vkCmdBindVertexBuffers(commandBuffer, 0, isShadowPass ? 1 : 2, vertexBuffers.data(), offsets.data());
+
+    // Dynamic offsets are consumed in binding order (camera, then light)
+    vkCmdBindDescriptorSets
+    (
+        commandBuffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipelineLayout,
+        0,
+        1,
+        &frameData.descriptorSet,
+        static_cast<uint32_t>(dynamicOffsets.size()),
+        dynamicOffsets.data()
+    );
+}
+
+/**
+ * @brief Matches the cached tile group command buffers of the frame with the selected tile groups.
+ * Groups that are no longer drawn are freed, and the new or changed ones are recorded in parallel.
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] dynamicOffsets Uniform buffer offsets of the camera and light data
+ */
+void Application::UpdateTileGroupCommands(FrameData &frameData, const std::array<uint32_t, 2> &dynamicOffsets)
+{
+    // The previous use of this frame's command buffers is done, and the workers are idle
+    std::vector<uint32_t> groupCountPerWorker(frameData.tileGroupCommandPools.size(), 0);
+    for (auto it = frameData.tileGroupCommands.begin(); it != frameData.tileGroupCommands.end();)
+    {
+        if (m_selectedTileGroups.find(it->first) == m_selectedTileGroups.end())
+        {
+            std::array<VkCommandBuffer, 2> commandBuffers = { it->second.shadowCommandBuffer, it->second.mainCommandBuffer };
+            vkFreeCommandBuffers(VulkanContext::GetLogicalDevice(), frameData.tileGroupCommandPools[it->second.workerIndex], static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+            it = frameData.tileGroupCommands.erase(it);
+        }
+        else
+        {
+            ++groupCountPerWorker[it->second.workerIndex];
+            ++it;
+        }
+    }
 
-        pointsInTriangulation.clear();
-        
-        std::vector<glm::dvec2> points;
-        for (size_t j = 0; j < water.outline.size(); ++j)
+    bool needsRecording = false;
+    for (const auto &pair : m_selectedTileGroups)
+    {
+        auto it = frameData.tileGroupCommands.find(pair.first);
+        if (it == frameData.tileGroupCommands.end())
         {
-            points.push_back(GeometryUtils::LonLatToXY(water.outline[j]));
+            // New groups go to the worker with the fewest groups
+            uint32_t workerIndex = static_cast<uint32_t>(std::min_element(groupCountPerWorker.begin(), groupCountPerWorker.end()) - groupCountPerWorker.begin());
+
+            VkCommandBufferAllocateInfo commandBufferInfo = {};
+            commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            commandBufferInfo.commandPool = frameData.tileGroupCommandPools[workerIndex];
+            commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            commandBufferInfo.commandBufferCount = 2;
+
+            std::array<VkCommandBuffer, 2> commandBuffers = {};
+            if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &commandBufferInfo, commandBuffers.data()) != VK_SUCCESS)
+            {
+                LOG_ERROR("[Application] Failed to allocate secondary command buffers!");
+                continue;
+            }
+
+            TileGroupCommands tileGroup = {};
+            tileGroup.workerIndex = workerIndex;
+            tileGroup.shadowCommandBuffer = commandBuffers[0];
+            tileGroup.mainCommandBuffer = commandBuffers[1];
+            tileGroup.bounds = AABB::Empty();
+            it = frameData.tileGroupCommands.emplace(pair.first, tileGroup).first;
+            ++groupCountPerWorker[workerIndex];
         }
 
-        for (size_t j = 0; j < points.size(); j++)
+        // The command buffers stay valid as long as the same vertex ranges are drawn with the same uniform buffer offsets
+        TileGroupCommands &tileGroup = it->second;
+        auto isSameCluster = [](const MeshCluster &a, const MeshCluster &b)
+        {
+            return (a.firstVertex == b.firstVertex) && (a.vertexCount == b.vertexCount);
+        };
+        bool isUnchanged = tileGroup.isRecorded
+            && (tileGroup.dynamicOffsets == dynamicOffsets)
+            && std::equal(tileGroup.clusters.begin(), tileGroup.clusters.end(), pair.second.begin(), pair.second.end(), isSameCluster);
+        tileGroup.needsRecording = !isUnchanged;
+        if (tileGroup.needsRecording)
         {
-            glm::dvec2 &a = points[j];
-            glm::dvec2 &b = points[(j + 1) % points.size()];
-            glm::dvec2 &c = points[(j + 2) % points.size()];
+            tileGroup.clusters = pair.second;
+            tileGroup.dynamicOffsets = dynamicOffsets;
+            tileGroup.bounds = AABB::Empty();
+            tileGroup.triangleCount = 0;
+            for (const MeshCluster &cluster : tileGroup.clusters)
+            {
+                tileGroup.bounds.Expand(cluster.bounds);
+                tileGroup.triangleCount += cluster.vertexCount / 3;
+            }
+            needsRecording = true;
+        }
+    }
 
-            if (GeometryUtils::IsCollinear(a, b, c))
+    if (!needsRecording)
+    {
+        return;
+    }
+
+    // Each worker only records the groups allocated from its own command pool
+    m_recordingJobSystem.Execute([this, &frameData](uint32_t workerIndex)
+    {
+        for (auto &pair : frameData.tileGroupCommands)
+        {
+            if ((pair.second.workerIndex == workerIndex) && pair.second.needsRecording)
             {
-                points.erase(points.begin() + ((j + 1) % points.size()));
-                --j;
+                RecordTileGroupCommands(frameData, pair.second);
             }
         }
+    });
+}
+
+/**
+ * @brief Records the shadow pass and main pass secondary command buffers of a tile group.
+ * Called on the recording worker that owns the command buffers.
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] tileGroup Tile group to record
+ */
+void Application::RecordTileGroupCommands(const FrameData &frameData, TileGroupCommands &tileGroup)
+{
+    PROFILE_SCOPE("Record tile group commands");
+
+    tileGroup.needsRecording = false;
+    tileGroup.isRecorded = false;
+    tileGroup.drawCalls = 0;
+
+    for (bool isShadowPass : { true, false })
+    {
+        VkCommandBuffer commandBuffer = isShadowPass ? tileGroup.shadowCommandBuffer : tileGroup.mainCommandBuffer;
+
+        // The framebuffer is left unspecified, so that the command buffers work with every swapchain image
+        VkCommandBufferInheritanceInfo inheritanceInfo = {};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = isShadowPass ? m_shadowRenderPass : m_vkRenderPass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            LOG_ERROR("[Application] Failed to begin recording of secondary command buffer!");
+            return;
+        }
+
+        BindPassState(commandBuffer, frameData, isShadowPass, tileGroup.dynamicOffsets);
+        tileGroup.drawCalls = DrawClusters(commandBuffer, tileGroup.clusters);
 
-        if (!GeometryUtils::IsPolygonCCW(points))
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
         {
-            std::reverse(points.begin(), points.end());
+            LOG_ERROR("[Application] Failed to end recording of secondary command buffer!");
+            return;
         }
+    }
+    tileGroup.isRecorded = true;
+}
 
-        GeometryUtils::PolygonTriangulation(points, pointsInTriangulation);
+/**
+ * @brief Executes the secondary command buffers of the tile groups inside the frustum
+ * @param[in] commandBuffer Primary command buffer inside the render pass
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] isShadowPass Flag indicating whether the shadow pass or the main pass is recorded
+ * @param[in] frustum Frustum to cull the tile groups against
+ * @param[out] outStats Culling statistics for the executed draws
+ */
+void Application::ExecuteVisibleTileGroups(VkCommandBuffer commandBuffer, const FrameData &frameData, bool isShadowPass, const Frustum &frustum, CullingStats &outStats)
+{
+    outStats = {};
 
-        for (size_t j = 0; j < pointsInTriangulation.size(); j++)
+    std::vector<VkCommandBuffer> secondaryCommandBuffers;
+    for (const auto &pair : frameData.tileGroupCommands)
+    {
+        const TileGroupCommands &tileGroup = pair.second;
+        if (!tileGroup.isRecorded || (tileGroup.drawCalls == 0) || !frustum.IsAABBVisible(tileGroup.bounds))
         {
-            glm::dvec2 point = (pointsInTriangulation[j] - tileCenter) * SCALE;
-            dest.emplace_back();
-            dest.back().position.x = point.x;
-            dest.back().position.y = 0.0f;
-            dest.back().position.z = point.y;
-            dest.back().color = waterColor;
-            dest.back().normal = { 0.0f, 1.0f, 0.0f };
+            outStats.culledTriangles += tileGroup.triangleCount;
+            continue;
         }
+
+        outStats.drawnTriangles += tileGroup.triangleCount;
+        outStats.drawCalls += tileGroup.drawCalls;
+        secondaryCommandBuffers.push_back(isShadowPass ? tileGroup.shadowCommandBuffer : tileGroup.mainCommandBuffer);
+    }
+
+    if (!secondaryCommandBuffers.empty())
+    {
+        vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
+    }
+}
+
+/**
+ * @brief Records a compute dispatch that culls all clusters against the frustum and writes
+ * one indirect draw command per cluster into the frame's draw command buffer.
+ * @param[in] commandBuffer Command buffer to record the dispatch into
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] frustum Frustum to cull the clusters against
+ * @param[in] drawCommandOffset Index of the first draw command to write to
+ */
+void Application::DispatchClusterCulling(VkCommandBuffer commandBuffer, FrameData &frameData, const Frustum &frustum, uint32_t drawCommandOffset)
+{
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipelineLayout, 0, 1, &frameData.cullDescriptorSet, 0, nullptr);
+
+    CullPushConstant pushConstant = {};
+    for (size_t i = 0; i < frustum.GetPlanes().size(); ++i)
+    {
+        pushConstant.frustumPlanes[i] = frustum.GetPlanes()[i];
     }
+    pushConstant.clusterCount = static_cast<uint32_t>(m_selectedClusters.size());
+    pushConstant.drawCommandOffset = drawCommandOffset;
+    vkCmdPushConstants(commandBuffer, m_cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstant), &pushConstant);
 
-    numVerticesAdded = static_cast<uint32_t>(dest.size()) - numVerticesAdded;
-    return numVerticesAdded;
+    const uint32_t WORKGROUP_SIZE = 64; // Must match local_size_x in the shader
+    uint32_t numWorkgroups = (pushConstant.clusterCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+}
+
+/**
+ * @brief Records indirect draws for the commands written by the culling compute shader.
+ * @param[in] commandBuffer Command buffer to record the draw commands into
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] drawCommandOffset Index of the first draw command to consume
+ */
+void Application::DrawClustersIndirect(VkCommandBuffer commandBuffer, FrameData &frameData, uint32_t drawCommandOffset)
+{
+    uint32_t drawCount = static_cast<uint32_t>(m_selectedClusters.size());
+    VkDeviceSize offset = sizeof(VkDrawIndirectCommand) * drawCommandOffset;
+    uint32_t stride = sizeof(VkDrawIndirectCommand);
+
+    // The culling pipeline is only created when multiDrawIndirect is supported
+    vkCmdDrawIndirect(commandBuffer, frameData.drawCommandBuffer.GetHandle(), offset, drawCount, stride);
+}
+
+/**
+ * @brief Rebuilds the performance overlay from the current statistics, and writes its vertices to the frame's vertex buffer
+ * @param[in] frameData Data of the frame being recorded
+ * @return Number of vertices to draw
+ */
+uint32_t Application::UpdateHud(FrameData &frameData)
+{
+    if (frameData.hudVertexBuffer.GetHandle() == VK_NULL_HANDLE)
+    {
+        return 0;
+    }
+
+    // Read without the job lock, which the workers hold while they check the caches
+    size_t queuedJobCount = m_retrieveTileJobCount;
+    // Hits of any cache layer against the lookups that had to go to the download or generation at the end
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    if (m_tileDataSource != nullptr)
+    {
+        m_tileDataSource->GetCacheCounts(cacheHits, cacheMisses);
+    }
+    uint64_t cacheLookups = cacheHits + cacheMisses;
+    double averageFrameMilliseconds = m_hudOverlay.GetAverageFrameTime();
+
+    // Rendering statistics first, then streaming statistics, so that it is clear which side a slowdown comes from
+    std::vector<std::string> lines;
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1);
+
+    stream << "FPS: " << (averageFrameMilliseconds > 0.0 ? 1000.0 / averageFrameMilliseconds : 0.0) << " (" << averageFrameMilliseconds << " ms)";
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "CPU: " << m_lastCpuFrameMilliseconds << " ms  GPU: ";
+    if (m_lastGpuFrameMilliseconds >= 0.0)
+    {
+        stream << m_lastGpuFrameMilliseconds << " ms";
+    }
+    else
+    {
+        stream << "n/a";
+    }
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "Vertices: " << m_vertexAllocator.GetAllocatedSize() << " / " << MAX_VERTEX_COUNT;
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "GPU memory: " << static_cast<double>(VulkanContext::GetAllocatedMemorySize()) / (1024.0 * 1024.0) << " MB";
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "Resident tiles: " << m_residentTiles.size() << " / " << m_visibleTiles.size() << " visible";
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "Queued jobs: " << queuedJobCount;
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "Upload backlog: " << m_uploadQueue.size() << " tiles";
+    lines.push_back(stream.str());
+    stream.str("");
+
+    stream << "Tile cache hits: ";
+    if (cacheLookups > 0)
+    {
+        stream << 100.0 * cacheHits / cacheLookups << "% (" << cacheHits << " of " << cacheLookups << ")";
+    }
+    else
+    {
+        stream << "n/a";
+    }
+    lines.push_back(stream.str());
+
+    m_hudOverlay.Build(m_vkSwapchainImageExtent.width, m_vkSwapchainImageExtent.height, lines);
+
+    // Whole quads only, in case the overlay does not fit into the vertex buffer
+    const std::vector<HudOverlay::HudVertex> &vertices = m_hudOverlay.GetVertices();
+    uint32_t vertexCount = static_cast<uint32_t>(std::min<size_t>(vertices.size(), MAX_HUD_VERTICES / 6 * 6));
+    if (vertexCount > 0)
+    {
+        void *mapped = frameData.hudVertexBuffer.MapMemory(0, sizeof(HudOverlay::HudVertex) * vertexCount);
+        std::memcpy(mapped, vertices.data(), sizeof(HudOverlay::HudVertex) * vertexCount);
+        frameData.hudVertexBuffer.UnmapMemory();
+    }
+    return vertexCount;
+}
+
+/**
+ * @brief Records the draw of the performance overlay
+ * @param[in] commandBuffer Command buffer inside the main pass to record the commands into
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] vertexCount Number of vertices to draw
+ */
+void Application::DrawHud(VkCommandBuffer commandBuffer, FrameData &frameData, uint32_t vertexCount)
+{
+    VkViewport viewport {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(m_vkSwapchainImageExtent.width);
+    viewport.height = static_cast<float>(m_vkSwapchainImageExtent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor {};
+    scissor.offset = { 0, 0 };
+    scissor.extent = m_vkSwapchainImageExtent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_hudPipeline);
+
+    VkBuffer vertexBuffer = frameData.hudVertexBuffer.GetHandle();
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+
+    vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+}
+
+/**
+ * @brief Records the draw of the performance overlay into the frame's secondary command buffer
+ * @param[in] frameData Data of the frame being recorded
+ * @param[in] vertexCount Number of vertices to draw
+ * @return Returns true if the recording was successful. Returns false otherwise.
+ */
+bool Application::RecordHudCommands(FrameData &frameData, uint32_t vertexCount)
+{
+    // The framebuffer is left unspecified, like the tile group command buffers
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = m_vkRenderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    if (vkBeginCommandBuffer(frameData.hudCommandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Application] Failed to begin recording of performance overlay command buffer!");
+        return false;
+    }
+
+    DrawHud(frameData.hudCommandBuffer, frameData, vertexCount);
+
+    if (vkEndCommandBuffer(frameData.hudCommandBuffer) != VK_SUCCESS)
+    {
+        LOG_ERROR("[Application] Failed to end recording of performance overlay command buffer!");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the camera position of a camera path pose, relative to the current origin like the camera
+ * @param[in] pose Camera path pose
+ * @return Camera position
+ */
+glm::vec3 Application::GetCameraPathPosition(const CameraPath::Keyframe &pose) const
+{
+    glm::dvec2 poseXY = (GeometryUtils::LonLatToXY(pose.lonLat) - GeometryUtils::LonLatToXY(m_origin)) * SCALE;
+    return glm::vec3(static_cast<float>(poseXY.x), static_cast<float>(pose.height * SCALE), static_cast<float>(poseXY.y));
 }
 
 /**
@@ -1599,56 +3375,289 @@ void Application::UpdateCurrentTile(const glm::ivec2 &newCurrentTileIndex)
 {
     m_currentTileIndex = newCurrentTileIndex;
 
-    const int zoomLevel = 16;
-    RectD tileBounds = GeometryUtils::GetLonLatBoundsFromTile(newCurrentTileIndex.x, newCurrentTileIndex.y, zoomLevel);
+    RectD tileBounds = GeometryUtils::GetLonLatBoundsFromTile(newCurrentTileIndex.x, newCurrentTileIndex.y, BASE_ZOOM_LEVEL);
     m_origin = tileBounds.min;
+    m_residentTilesDirty = true;
+
+    UpdateVisibleTiles();
+}
+
+/**
+ * @brief Reselects the visible tiles around the current tile, updates the state
+ * each tile is requested to reach, and queues jobs for the tiles that need work.
+ */
+void Application::UpdateVisibleTiles()
+{
+    std::set<TileKey> oldVisibleTileSet(m_visibleTiles.begin(), m_visibleTiles.end());
+    m_tilePyramid.SelectTiles(m_currentTileIndex, m_viewDistance, m_visibleTiles);
+    m_visibleTileSet = std::set<TileKey>(m_visibleTiles.begin(), m_visibleTiles.end());
+
+    std::vector<TileKey> prefetchTiles;
+    m_tilePyramid.SelectTiles(m_currentTileIndex, m_viewDistance + m_prefetchDistance, prefetchTiles);
+
+    std::vector<TileKey> newlyVisibleTiles;
+    for (const TileKey &tileKey : m_visibleTiles)
+    {
+        if (oldVisibleTileSet.find(tileKey) == oldVisibleTileSet.end())
+        {
+            newlyVisibleTiles.push_back(tileKey);
+        }
+    }
+    if (!oldVisibleTileSet.empty())
+    {
+        m_prefetchPredictor.RecordNewlyVisibleTiles(newlyVisibleTiles);
+    }
+
+    // Push the far plane out to the view distance
+    RectD tileBounds = GeometryUtils::GetLonLatBoundsFromTile(m_currentTileIndex.x, m_currentTileIndex.y, BASE_ZOOM_LEVEL);
+    double tileSize = GeometryUtils::LonLatToXY(tileBounds.max).x - GeometryUtils::LonLatToXY(tileBounds.min).x;
+    m_camera.SetClipPlanes(m_camera.GetNearPlane(), static_cast<float>((m_viewDistance + 1) * tileSize * SCALE));
+
+    // Visible tiles are drawn, tiles predicted along the camera path are meshed ahead of time,
+    // and the rest of the prefetch area is only kept in the disk cache. Nearest tiles are requested first.
+    std::vector<TileKey> predictedTiles;
+    m_prefetchPredictor.GetPendingTiles(predictedTiles);
+
+    std::map<TileKey, TileRegistry::TileState> targetStates;
+    std::vector<TileKey> requestOrder;
+    for (const TileKey &tileKey : m_visibleTiles)
+    {
+        if (targetStates.emplace(tileKey, TileRegistry::TileState::Resident).second)
+        {
+            requestOrder.push_back(tileKey);
+        }
+    }
+    for (const TileKey &tileKey : prefetchTiles)
+    {
+        if (targetStates.emplace(tileKey, TileRegistry::TileState::Cached).second)
+        {
+            requestOrder.push_back(tileKey);
+        }
+    }
+    for (const TileKey &tileKey : predictedTiles)
+    {
+        auto it = targetStates.find(tileKey);
+        if (it == targetStates.end())
+        {
+            targetStates.emplace(tileKey, TileRegistry::TileState::Meshed);
+            requestOrder.push_back(tileKey);
+        }
+        else if (it->second == TileRegistry::TileState::Cached)
+        {
+            it->second = TileRegistry::TileState::Meshed;
+        }
+    }
+
+    std::set<TileKey> requestedTileSet;
+    for (const auto &pair : targetStates)
+    {
+        requestedTileSet.insert(pair.first);
+    }
 
-    const int viewDist = 1;
-    RectI oldViewArea = m_currentViewArea;
-    RectI newViewArea = {};
-    newViewArea.min = newCurrentTileIndex - viewDist;
-    newViewArea.max = newCurrentTileIndex + viewDist;
-    m_currentViewArea = newViewArea;
+    // Keep the meshes that are still needed, and make room for the ones to be published
+    for (auto it = m_readyTileMeshes.begin(); it != m_readyTileMeshes.end();)
+    {
+        auto targetIt = targetStates.find(it->first);
+        if ((targetIt == targetStates.end()) || (targetIt->second < TileRegistry::TileState::Meshed))
+        {
+            it = m_readyTileMeshes.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    for (const auto &pair : targetStates)
+    {
+        if (pair.second >= TileRegistry::TileState::Meshed)
+        {
+            m_readyTileMeshes.emplace(pair.first, nullptr);
+        }
+    }
+    m_residentTilesDirty = true;
 
-    // Remove tiles that are not part of the new view area
-    for (size_t i = m_activeTiles.size(); i > 0; --i)
+    std::lock_guard lock(m_retrieveTileJobsMutex);
+
+    // Drop the tiles and the pending jobs that are no longer needed
+    m_tileRegistry.ReleaseUnrequested(requestedTileSet);
+    for (size_t i = m_retrieveTileJobs.size(); i > 0; --i)
     {
         size_t idx = i - 1;
-        if (!RectI::IsPointInsideRect(newViewArea, m_activeTiles[idx].index))
+        TileKey tileKey = { m_retrieveTileJobs[idx].tileIndex, m_retrieveTileJobs[idx].zoomLevel };
+        if (requestedTileSet.find(tileKey) == requestedTileSet.end())
         {
-            m_activeTiles.erase(m_activeTiles.begin() + idx);
+            m_retrieveTileJobs.erase(m_retrieveTileJobs.begin() + idx);
         }
     }
 
+    // Tiles that are already in their requested state, or have work queued
+    // or in flight, do not get another job
+    for (const TileKey &tileKey : requestOrder)
     {
-        std::lock_guard tileUpdateLock(m_tilesUpdateMutex);
-        m_tilesUpdated = true;
+        if (m_tileRegistry.Request(tileKey, targetStates[tileKey]))
+        {
+            m_retrieveTileJobs.emplace_back();
+            m_retrieveTileJobs.back().tileIndex = tileKey.index;
+            m_retrieveTileJobs.back().zoomLevel = tileKey.zoomLevel;
+            m_retrieveTileJobs.back().queueTime = std::chrono::steady_clock::now();
+        }
     }
+    m_retrieveTileJobCount = m_retrieveTileJobs.size();
+}
 
+/**
+ * @brief Queues jobs that prefetch and mesh the tiles predicted along the camera path
+ * @param[in] predictedTiles Predicted tiles, in the order they are expected to be needed
+ */
+void Application::QueuePredictedTiles(const std::vector<TileKey> &predictedTiles)
+{
     std::lock_guard lock(m_retrieveTileJobsMutex);
-    int prefetchDistance = 1;
-    // Go through tiles in the new view area, and if they are also part
-    // of the old view area, skip since its data should already be in the active tiles list
-    OSMTileDataSource dataSource = {};
-    for (int dy = -viewDist - prefetchDistance; dy <= viewDist + prefetchDistance; ++dy)
+    for (const TileKey &tileKey : predictedTiles)
     {
-        for (int dx = -viewDist - prefetchDistance; dx <= viewDist + prefetchDistance; ++dx)
+        // Queued after the visible tiles, so they only use otherwise idle worker time
+        m_readyTileMeshes.emplace(tileKey, nullptr);
+        if (m_tileRegistry.Request(tileKey, TileRegistry::TileState::Meshed))
         {
-            glm::ivec2 index = newCurrentTileIndex;
-            index.x += dx;
-            index.y += dy;
+            m_retrieveTileJobs.emplace_back();
+            m_retrieveTileJobs.back().tileIndex = tileKey.index;
+            m_retrieveTileJobs.back().zoomLevel = tileKey.zoomLevel;
+            m_retrieveTileJobs.back().queueTime = std::chrono::steady_clock::now();
+        }
+    }
+    m_retrieveTileJobCount = m_retrieveTileJobs.size();
+}
 
-            if (RectI::IsPointInsideRect(oldViewArea, index))
+/**
+ * @brief Retrieves the data of a tile. Tiles coarser than the base zoom level
+ * are generated by merging the base zoom level tiles they cover.
+ * @param[in] dataSource Data source to retrieve the tile data from
+ * @param[in] tileKey Tile to retrieve
+ * @param[out] outTileData Retrieved tile data
+ * @return Returns true if the retrieval was successful. Returns false otherwise.
+ */
+bool Application::RetrieveTile(TileDataSource &dataSource, const TileKey &tileKey, TileData &outTileData)
+{
+    PROFILE_SCOPE("Decode tile");
+
+    if (tileKey.zoomLevel >= BASE_ZOOM_LEVEL)
+    {
+        return dataSource.Retrieve(tileKey.index, tileKey.zoomLevel, outTileData);
+    }
+
+    std::vector<glm::ivec2> baseTileIndices;
+    m_tilePyramid.GetBaseTileIndices(tileKey, baseTileIndices);
+
+    std::vector<TileData> baseTiles;
+    for (const glm::ivec2 &baseTileIndex : baseTileIndices)
+    {
+        baseTiles.emplace_back();
+        if (!dataSource.Retrieve(baseTileIndex, BASE_ZOOM_LEVEL, baseTiles.back()))
+        {
+            baseTiles.pop_back();
+        }
+    }
+
+    return m_tilePyramid.MergeTiles(tileKey, baseTiles, outTileData);
+}
+
+/**
+ * @brief Queries whether the data of all base zoom level tiles covered by a tile is cached
+ * @param[in] dataSource Data source to query
+ * @param[in] tileKey Tile to query
+ * @return True if all the needed tile data is cached
+ */
+bool Application::IsTileCacheAvailable(TileDataSource &dataSource, const TileKey &tileKey)
+{
+    std::vector<glm::ivec2> baseTileIndices;
+    m_tilePyramid.GetBaseTileIndices(tileKey, baseTileIndices);
+    for (const glm::ivec2 &baseTileIndex : baseTileIndices)
+    {
+        if (!dataSource.IsTileCacheAvailable(baseTileIndex, BASE_ZOOM_LEVEL))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prefetches the data of all base zoom level tiles covered by a tile
+ * @param[in] dataSource Data source to prefetch the tile data from
+ * @param[in] tileKey Tile to prefetch
+ * @return Returns true if all the needed tile data was prefetched. Returns false otherwise.
+ */
+bool Application::PrefetchTile(TileDataSource &dataSource, const TileKey &tileKey)
+{
+    PROFILE_SCOPE("Download tile");
+
+    std::vector<glm::ivec2> baseTileIndices;
+    m_tilePyramid.GetBaseTileIndices(tileKey, baseTileIndices);
+
+    bool success = true;
+    for (const glm::ivec2 &baseTileIndex : baseTileIndices)
+    {
+        success = dataSource.Prefetch(baseTileIndex, BASE_ZOOM_LEVEL) && success;
+    }
+    return success;
+}
+
+/**
+ * @brief Advances a tile through its lifecycle states until it reaches
+ * its requested state, or another worker owns it.
+ * @param[in] dataSource Data source to retrieve the tile data from
+ * @param[in] job Job of the tile to process
+ */
+void Application::ProcessTile(TileDataSource &dataSource, const RetrieveTileJob &job)
+{
+    TileKey tileKey = { job.tileIndex, job.zoomLevel };
+    TileStageStats::StageTimes stageTimes = TileStageStats::CreateEmptyStageTimes();
+    stageTimes.seconds[static_cast<size_t>(TileStageStats::Stage::QueueWait)] = std::chrono::duration<double>(std::chrono::steady_clock::now() - job.queueTime).count();
+    TileDataSource::ResetStageTimes();
+
+    TileRegistry::TileState state;
+    std::shared_ptr<const TileData> tileData;
+    bool hasWork = true;
+    while (hasWork && m_tileRegistry.BeginWork(tileKey, state, tileData))
+    {
+        switch (state)
+        {
+        case TileRegistry::TileState::Absent:
+        {
+            m_tileRegistry.FinishDownload(tileKey, PrefetchTile(dataSource, tileKey));
+            break;
+        }
+        case TileRegistry::TileState::Cached:
+        {
+            std::shared_ptr<TileData> decodedTileData = std::make_shared<TileData>();
+            if (!RetrieveTile(dataSource, tileKey, *decodedTileData))
             {
-                continue;
+                decodedTileData.reset();
             }
+            m_tileRegistry.FinishDecode(tileKey, decodedTileData);
+            break;
+        }
+        case TileRegistry::TileState::Decoded:
+        {
+            std::shared_ptr<TileMesh> tileMesh = std::make_shared<TileMesh>();
+            m_tileMeshBuilder.Build(tileKey, *tileData, *tileMesh, stageTimes);
+            tileData.reset();
 
-            m_retrieveTileJobs.emplace_back();
-            m_retrieveTileJobs.back().tileIndex = index;
-            m_retrieveTileJobs.back().zoomLevel = zoomLevel;
-            m_retrieveTileJobs.back().addImmediately = RectI::IsPointInsideRect(newViewArea, index);
+            // The mesh is immutable from here on, and shared with the render thread without copying
+            if (m_tileRegistry.FinishMesh(tileKey, tileMesh))
+            {
+                m_publishedTileMeshes.Push(tileMesh);
+            }
+            break;
+        }
+        default:
+            hasWork = false;
+            break;
         }
     }
+
+    // The data sources measured the download, disk read, parse and join stages on this thread
+    TileDataSource::AddStageTimes(stageTimes);
+    m_tileStageStats.AddTile(stageTimes);
 }
 
 /**
@@ -1658,7 +3667,8 @@ void Application::UpdateCurrentTile(const glm::ivec2 &newCurrentTileIndex)
  */
 void Application::WorkerThreadFunc(bool downloadIfNeeded)
 {
-    OSMTileDataSource dataSource = {};
+    Profiler::SetThreadName(downloadIfNeeded ? "Tile worker (download)" : "Tile worker (cache)");
+    TileDataSource &dataSource = *m_tileDataSource;
 
     while (m_workerThreadRunning)
     {
@@ -1670,7 +3680,7 @@ void Application::WorkerThreadFunc(bool downloadIfNeeded)
             {
                 size_t index = i - 1;
                 RetrieveTileJob &job = m_retrieveTileJobs[index];
-                if (dataSource.IsTileCacheAvailable(job.tileIndex, job.zoomLevel))
+                if (IsTileCacheAvailable(dataSource, { job.tileIndex, job.zoomLevel }))
                 {
                     jobs.push_back(job);
                     m_retrieveTileJobs.erase(m_retrieveTileJobs.begin() + index);
@@ -1686,6 +3696,7 @@ void Application::WorkerThreadFunc(bool downloadIfNeeded)
                 }
             }
 
+            m_retrieveTileJobCount = m_retrieveTileJobs.size();
             m_retrieveTileJobsMutex.unlock();
         }
         else
@@ -1695,29 +3706,10 @@ void Application::WorkerThreadFunc(bool downloadIfNeeded)
             continue;
         }
 
-        std::vector<TileData> tilesRetrieved;
-        for (size_t i = 0; i < jobs.size(); ++i)
-        {
-            RetrieveTileJob &job = jobs[i];
-            if (job.addImmediately)
-            {
-                tilesRetrieved.emplace_back();
-                if (!dataSource.Retrieve(job.tileIndex, job.zoomLevel, tilesRetrieved.back()))
-                {
-                    tilesRetrieved.pop_back();
-                }
-            }
-            else
-            {
-                dataSource.Prefetch(job.tileIndex, job.zoomLevel);
-            }
-        }
-
-        if (!tilesRetrieved.empty())
+        // The registry makes sure that each tile is only worked on by one thread at a time
+        for (const RetrieveTileJob &job : jobs)
         {
-            std::lock_guard lock2(m_tilesUpdateMutex);
-            m_activeTiles.insert(m_activeTiles.end(), tilesRetrieved.begin(), tilesRetrieved.end());
-            m_tilesUpdated = true;
+            ProcessTile(dataSource, job);
         }
     }
 }
@@ -0,0 +1,85 @@
+#include "Benchmark/AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> s_allocationCount(0);    // Number of allocations made through operator new
+std::atomic<uint64_t> s_allocatedBytes(0);     // Number of bytes allocated through operator new
+
+/**
+ * @brief Allocates memory and counts the allocation
+ * @param[in] size Number of bytes to allocate
+ * @return Allocated memory. nullptr if the allocation failed.
+ */
+void* CountedAllocate(std::size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+}
+
+/**
+ * @brief Gets the number of allocations made since the process started
+ * @return Allocation counts
+ */
+AllocationCounter::Counts AllocationCounter::GetCounts()
+{
+    Counts counts;
+    counts.allocations = s_allocationCount.load(std::memory_order_relaxed);
+    counts.bytes = s_allocatedBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void* operator new(std::size_t size)
+{
+    void *memory = CountedAllocate(size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    void *memory = CountedAllocate(size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
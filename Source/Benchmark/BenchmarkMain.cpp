@@ -0,0 +1,183 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Benchmark/MapBenchmark.hpp"
+#include "Core/Logger.hpp"
+#include "Map/SyntheticTileDataSource.hpp"
+
+// Command line options of the benchmark
+struct BenchmarkOptions
+{
+    std::string tileDirectory;      // Directory containing the tile files
+    uint32_t iterations;            // Number of measured iterations of each benchmark
+    std::string outputFile;         // File that the results are written to
+    std::string baselineFile;       // File with the baseline results. Empty to skip the comparison.
+    double thresholdPercent;        // Slowdown (in percent) above which a benchmark counts as a regression
+    int syntheticTilesPerSide;      // Number of generated tiles along each side of the block. 0 to load the tile files instead.
+    SyntheticTileDataSource::Settings syntheticTileSettings;    // Settings of the generated tiles
+};
+
+// Tile index and zoom level of the south-west corner of the generated tiles, where the bundled tiles are
+const glm::ivec2 SYNTHETIC_FIRST_TILE_INDEX(58206, 25822);
+const int SYNTHETIC_ZOOM_LEVEL = 16;
+
+/**
+ * @brief Prints the command line options.
+ * @param[in] programName Name of the executable
+ */
+void PrintUsage(const char *programName)
+{
+    std::cout << "Usage: " << programName << " [options]" << std::endl
+        << "  --tiles <dir>           Directory containing the map_<zoom>-<x>-<y>.osm tile files (default: Resources)" << std::endl
+        << "  --iterations <count>    Number of measured iterations of each benchmark (default: 5)" << std::endl
+        << "  --output <file>         File that the results are written to as JSON (default: benchmark_results.json)" << std::endl
+        << "  --baseline <file>       Compare the results with a JSON file written by an earlier run" << std::endl
+        << "  --threshold <percent>   Slowdown above which a benchmark counts as a regression (default: 5)" << std::endl
+        << "  --synthetic-tiles <n>   Benchmark an n x n block of generated tiles instead of the tile files" << std::endl
+        << "  --synthetic-seed <seed>               Seed of the generated city (default: 1)" << std::endl
+        << "  --synthetic-buildings <count>         Buildings per generated tile (default: 250)" << std::endl
+        << "  --synthetic-outline-vertices <count>  Vertices per building outline (default: 8)" << std::endl
+        << "  --synthetic-concavity <0..1>          How concave the outlines are (default: 0.3)" << std::endl
+        << "  --synthetic-roads <count>             Roads per generated tile (default: 60)" << std::endl
+        << "  --synthetic-water <0..1>              Fraction of each tile covered by water (default: 0.05)" << std::endl
+        << "  --synthetic-water-vertices <count>    Vertices per water outline (default: 64)" << std::endl
+        << "Exits with 2 if any benchmark regressed compared to the baseline." << std::endl;
+}
+
+/**
+ * @brief Parses the command line options.
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @param[out] outOptions Parsed options
+ * @return Returns true if all options were valid. Returns false otherwise.
+ */
+bool ParseBenchmarkOptions(int argc, char **argv, BenchmarkOptions &outOptions)
+{
+    outOptions.tileDirectory = "Resources";
+    outOptions.iterations = 5;
+    outOptions.outputFile = "benchmark_results.json";
+    outOptions.baselineFile.clear();
+    outOptions.thresholdPercent = 5.0;
+    outOptions.syntheticTilesPerSide = 0;
+    outOptions.syntheticTileSettings = SyntheticTileDataSource::GetDefaultSettings();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        // Every option takes a value
+        bool hasValue = (i + 1 < argc);
+        try
+        {
+            if ((std::strcmp(argv[i], "--tiles") == 0) && hasValue)
+            {
+                outOptions.tileDirectory = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--iterations") == 0) && hasValue)
+            {
+                outOptions.iterations = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if ((std::strcmp(argv[i], "--output") == 0) && hasValue)
+            {
+                outOptions.outputFile = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--baseline") == 0) && hasValue)
+            {
+                outOptions.baselineFile = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--threshold") == 0) && hasValue)
+            {
+                outOptions.thresholdPercent = std::stod(argv[++i]);
+            }
+            else if ((std::strcmp(argv[i], "--synthetic-tiles") == 0) && hasValue)
+            {
+                outOptions.syntheticTilesPerSide = std::stoi(argv[++i]);
+            }
+            else if (hasValue && (std::strncmp(argv[i], "--synthetic-", 12) == 0))
+            {
+                ++i;
+                if (!SyntheticTileDataSource::ParseOption(argv[i - 1], argv[i], outOptions.syntheticTileSettings))
+                {
+                    std::cerr << "Unknown or incomplete option: " << argv[i - 1] << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Invalid value for option " << argv[i - 1] << ": " << argv[i] << std::endl;
+            return false;
+        }
+    }
+
+    if (outOptions.iterations == 0)
+    {
+        std::cerr << "At least one iteration is needed" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    if (!ParseBenchmarkOptions(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Read the baseline first, so that a missing baseline does not cost a full run
+    std::vector<MapBenchmark::Result> baseline;
+    if (!options.baselineFile.empty() && !MapBenchmark::ReadJson(options.baselineFile, baseline))
+    {
+        LOG_ERROR("[MapBenchmark] Failed to read baseline " << options.baselineFile << "!");
+        return 1;
+    }
+
+    MapBenchmark benchmark;
+    benchmark.SetIterations(options.iterations);
+    if (options.syntheticTilesPerSide > 0)
+    {
+        SyntheticTileDataSource dataSource(options.syntheticTileSettings);
+        if (!benchmark.GenerateTiles(dataSource, SYNTHETIC_FIRST_TILE_INDEX, SYNTHETIC_ZOOM_LEVEL, options.syntheticTilesPerSide))
+        {
+            LOG_ERROR("[MapBenchmark] Failed to generate tiles!");
+            return 1;
+        }
+    }
+    else if (!benchmark.LoadTiles(options.tileDirectory))
+    {
+        LOG_ERROR("[MapBenchmark] No tiles found in " << options.tileDirectory << "!");
+        return 1;
+    }
+
+    benchmark.Run();
+    benchmark.PrintResults(std::cout);
+
+    if (benchmark.WriteJson(options.outputFile))
+    {
+        LOG_INFO("[MapBenchmark] Results written to " << options.outputFile);
+    }
+    else
+    {
+        LOG_ERROR("[MapBenchmark] Failed to write results to " << options.outputFile << "!");
+    }
+
+    if (!options.baselineFile.empty())
+    {
+        uint32_t regressionCount = benchmark.CompareWithBaseline(baseline, options.thresholdPercent, std::cout);
+        if (regressionCount > 0)
+        {
+            LOG_ERROR("[MapBenchmark] " << regressionCount << " benchmarks regressed compared to " << options.baselineFile);
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,558 @@
+#include "Benchmark/MapBenchmark.hpp"
+
+#include "Benchmark/AllocationCounter.hpp"
+#include "Core/Logger.hpp"
+#include "Map/OSMXmlParser.hpp"
+#include "Map/TileMeshBuilder.hpp"
+#include "Map/TileStageStats.hpp"
+#include "TileMesh.hpp"
+#include "Util/GeometryUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+/**
+ * @brief Projects a polygon to world coordinates and prepares it for triangulation
+ * the same way the tile mesh builder does: collinear points are removed and the
+ * winding is made counter-clockwise.
+ * @param[in] outline Outline of the polygon (lon/lat)
+ * @param[out] outPoints Prepared polygon (world-space)
+ */
+void PreparePolygon(const std::vector<glm::dvec2> &outline, std::vector<glm::dvec2> &outPoints)
+{
+    outPoints.clear();
+    for (const glm::dvec2 &lonLat : outline)
+    {
+        outPoints.push_back(GeometryUtils::LonLatToXY(lonLat));
+    }
+
+    for (size_t j = 0; j < outPoints.size(); j++)
+    {
+        glm::dvec2 &a = outPoints[j];
+        glm::dvec2 &b = outPoints[(j + 1) % outPoints.size()];
+        glm::dvec2 &c = outPoints[(j + 2) % outPoints.size()];
+
+        if (GeometryUtils::IsCollinear(a, b, c))
+        {
+            outPoints.erase(outPoints.begin() + ((j + 1) % outPoints.size()));
+            --j;
+        }
+    }
+
+    if (!GeometryUtils::IsPolygonCCW(outPoints))
+    {
+        std::reverse(outPoints.begin(), outPoints.end());
+    }
+}
+
+/**
+ * @brief Finds a string field in a line of JSON written by MapBenchmark::WriteJson()
+ * @param[in] line Line of JSON
+ * @param[in] key Key of the field
+ * @param[out] outValue Value of the field
+ * @return Returns true if the field was found. Returns false otherwise.
+ */
+bool FindJsonString(const std::string &line, const std::string &key, std::string &outValue)
+{
+    std::string pattern = "\"" + key + "\": \"";
+    size_t start = line.find(pattern);
+    if (start == std::string::npos)
+    {
+        return false;
+    }
+    start += pattern.size();
+    size_t end = line.find('"', start);
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+    outValue = line.substr(start, end - start);
+    return true;
+}
+
+/**
+ * @brief Finds a number field in a line of JSON written by MapBenchmark::WriteJson()
+ * @param[in] line Line of JSON
+ * @param[in] key Key of the field
+ * @param[out] outValue Value of the field
+ * @return Returns true if the field was found. Returns false otherwise.
+ */
+bool FindJsonNumber(const std::string &line, const std::string &key, double &outValue)
+{
+    std::string pattern = "\"" + key + "\": ";
+    size_t start = line.find(pattern);
+    if (start == std::string::npos)
+    {
+        return false;
+    }
+    std::istringstream valueStream(line.substr(start + pattern.size()));
+    return static_cast<bool>(valueStream >> outValue);
+}
+}
+
+/**
+ * @brief Constructor
+ */
+MapBenchmark::MapBenchmark()
+    : m_iterations(5)
+    , m_tileFiles()
+    , m_documents()
+    , m_tiles()
+    , m_results()
+    , m_checksum(0.0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+MapBenchmark::~MapBenchmark()
+{
+}
+
+/**
+ * @brief Sets the number of measured iterations of each benchmark
+ * @param[in] iterations Number of iterations
+ */
+void MapBenchmark::SetIterations(uint32_t iterations)
+{
+    m_iterations = std::max(iterations, 1u);
+}
+
+/**
+ * @brief Loads every tile file (map_<zoom>-<x>-<y>.osm) in a directory
+ * @param[in] directory Directory containing the tile files
+ * @return Returns true if at least one tile was loaded. Returns false otherwise.
+ */
+bool MapBenchmark::LoadTiles(const std::string &directory)
+{
+    m_tileFiles.clear();
+    m_documents.clear();
+    m_tiles.clear();
+
+    std::error_code errorCode;
+    std::filesystem::directory_iterator directoryIterator(directory, errorCode);
+    if (errorCode)
+    {
+        LOG_ERROR("[MapBenchmark] Failed to open directory " << directory << "!");
+        return false;
+    }
+
+    for (const std::filesystem::directory_entry &entry : directoryIterator)
+    {
+        std::string fileName = entry.path().filename().string();
+        TileFile tileFile = {};
+        char extension[8] = {};
+        if (!entry.is_regular_file()
+            || (std::sscanf(fileName.c_str(), "map_%d-%d-%d.%7s", &tileFile.tileKey.zoomLevel, &tileFile.tileKey.index.x, &tileFile.tileKey.index.y, extension) != 4)
+            || (std::string(extension) != "osm"))
+        {
+            continue;
+        }
+
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::stringstream fileContents;
+        if (file.fail() || (fileContents << file.rdbuf()).fail())
+        {
+            LOG_ERROR("[MapBenchmark] Failed to read " << entry.path().string() << "!");
+            continue;
+        }
+        tileFile.filePath = entry.path().string();
+        tileFile.xmlText = fileContents.str();
+        m_tileFiles.push_back(tileFile);
+    }
+
+    // Files are benchmarked in the same order on every run
+    std::sort(m_tileFiles.begin(), m_tileFiles.end(), [](const TileFile &a, const TileFile &b)
+    {
+        return a.tileKey < b.tileKey;
+    });
+
+    OSMXmlParser parser;
+    for (size_t i = 0; i < m_tileFiles.size(); ++i)
+    {
+        const TileFile &tileFile = m_tileFiles[i];
+        std::unique_ptr<tinyxml2::XMLDocument> document = std::make_unique<tinyxml2::XMLDocument>();
+        if (document->Parse(tileFile.xmlText.c_str(), tileFile.xmlText.size()) != tinyxml2::XML_SUCCESS)
+        {
+            LOG_ERROR("[MapBenchmark] Failed to parse " << tileFile.filePath << "!");
+            m_tileFiles.erase(m_tileFiles.begin() + i);
+            --i;
+            continue;
+        }
+
+        TileData tileData;
+        tileData.index = tileFile.tileKey.index;
+        tileData.zoomLevel = tileFile.tileKey.zoomLevel;
+        parser.RetrieveFromXML(*document, tileData);
+        m_documents.push_back(std::move(document));
+        m_tiles.push_back(std::move(tileData));
+    }
+
+    LOG_INFO("[MapBenchmark] Loaded " << m_tiles.size() << " tiles with " << GetFeatureCount() << " features from " << directory);
+    return !m_tiles.empty();
+}
+
+/**
+ * @brief Retrieves a square block of tiles from a tile data source, instead of loading tile files.
+ * The XML benchmarks are skipped for these tiles, since there is no XML.
+ * @param[in] dataSource Data source to retrieve the tiles from
+ * @param[in] firstTileIndex Tile index of the south-west corner of the block
+ * @param[in] zoomLevel Zoom level of the tiles
+ * @param[in] tilesPerSide Number of tiles along each side of the block
+ * @return Returns true if at least one tile was retrieved. Returns false otherwise.
+ */
+bool MapBenchmark::GenerateTiles(TileDataSource &dataSource, const glm::ivec2 &firstTileIndex, int zoomLevel, int tilesPerSide)
+{
+    m_tileFiles.clear();
+    m_documents.clear();
+    m_tiles.clear();
+
+    for (int y = 0; y < tilesPerSide; ++y)
+    {
+        for (int x = 0; x < tilesPerSide; ++x)
+        {
+            TileData tileData;
+            glm::ivec2 tileIndex = firstTileIndex + glm::ivec2(x, y);
+            if (!dataSource.Retrieve(tileIndex, zoomLevel, tileData))
+            {
+                LOG_ERROR("[MapBenchmark] Failed to retrieve tile " << tileIndex.x << "-" << tileIndex.y << "!");
+                continue;
+            }
+            m_tiles.push_back(std::move(tileData));
+        }
+    }
+
+    LOG_INFO("[MapBenchmark] Generated " << m_tiles.size() << " tiles with " << GetFeatureCount() << " features");
+    return !m_tiles.empty();
+}
+
+/**
+ * @brief Runs all benchmarks over the loaded tiles
+ */
+void MapBenchmark::Run()
+{
+    m_results.clear();
+    uint64_t featureCount = GetFeatureCount();
+
+    // Generated tiles have no XML to parse
+    if (!m_documents.empty())
+    {
+        // --- XML parsing ---
+        Measure("xml_parse", "feature", featureCount, [this]()
+        {
+            for (const TileFile &tileFile : m_tileFiles)
+            {
+                tinyxml2::XMLDocument document;
+                document.Parse(tileFile.xmlText.c_str(), tileFile.xmlText.size());
+                m_checksum += (document.FirstChildElement() != nullptr) ? 1.0 : 0.0;
+            }
+        });
+
+        // --- Feature extraction (node join) ---
+        OSMXmlParser parser;
+        Measure("retrieve_from_xml", "feature", featureCount, [this, &parser]()
+        {
+            for (size_t i = 0; i < m_documents.size(); ++i)
+            {
+                TileData tileData;
+                tileData.index = m_tileFiles[i].tileKey.index;
+                tileData.zoomLevel = m_tileFiles[i].tileKey.zoomLevel;
+                parser.RetrieveFromXML(*m_documents[i], tileData);
+                m_checksum += static_cast<double>(tileData.buildings.size() + tileData.highways.size() + tileData.waterFeatures.size());
+            }
+        });
+    }
+
+    // --- Projection ---
+    std::vector<glm::dvec2> lonLats;
+    std::vector<std::vector<glm::dvec2>> polygons;
+    for (const TileData &tileData : m_tiles)
+    {
+        for (const BuildingData &building : tileData.buildings)
+        {
+            lonLats.insert(lonLats.end(), building.outline.begin(), building.outline.end());
+            polygons.emplace_back();
+            PreparePolygon(building.outline, polygons.back());
+        }
+        for (const HighwayData &highway : tileData.highways)
+        {
+            lonLats.insert(lonLats.end(), highway.points.begin(), highway.points.end());
+        }
+        for (const WaterFeatureData &water : tileData.waterFeatures)
+        {
+            lonLats.insert(lonLats.end(), water.outline.begin(), water.outline.end());
+            polygons.emplace_back();
+            PreparePolygon(water.outline, polygons.back());
+        }
+    }
+    Measure("lon_lat_to_xy", "point", lonLats.size(), [this, &lonLats]()
+    {
+        glm::dvec2 sum(0.0);
+        for (const glm::dvec2 &lonLat : lonLats)
+        {
+            sum += GeometryUtils::LonLatToXY(lonLat);
+        }
+        m_checksum += sum.x + sum.y;
+    });
+
+    // --- Triangulation ---
+    Measure("polygon_triangulation", "polygon", polygons.size(), [this, &polygons]()
+    {
+        std::vector<glm::dvec2> triangles;
+        for (const std::vector<glm::dvec2> &polygon : polygons)
+        {
+            triangles.clear();
+            GeometryUtils::PolygonTriangulation(polygon, triangles);
+            m_checksum += static_cast<double>(triangles.size());
+        }
+    });
+
+    // --- Full tile mesh build ---
+    TileMeshBuilder tileMeshBuilder(MESH_SCALE);
+    Measure("tile_mesh_build", "feature", featureCount, [this, &tileMeshBuilder]()
+    {
+        for (const TileData &tileData : m_tiles)
+        {
+            TileMesh tileMesh;
+            TileStageStats::StageTimes stageTimes = TileStageStats::CreateEmptyStageTimes();
+            TileKey tileKey = { tileData.index, tileData.zoomLevel };
+            tileMeshBuilder.Build(tileKey, tileData, tileMesh, stageTimes);
+            m_checksum += static_cast<double>(tileMesh.vertices.size());
+        }
+    });
+}
+
+/**
+ * @brief Gets the results of the benchmarks run so far
+ * @return Benchmark results
+ */
+const std::vector<MapBenchmark::Result>& MapBenchmark::GetResults() const
+{
+    return m_results;
+}
+
+/**
+ * @brief Prints the results as a table
+ * @param[in] stream Stream to print to
+ */
+void MapBenchmark::PrintResults(std::ostream &stream) const
+{
+    std::ios_base::fmtflags prevFlags = stream.flags();
+    std::streamsize prevPrecision = stream.precision();
+
+    stream << "[MapBenchmark] Median of " << m_iterations << " iterations:" << std::endl;
+    stream << "[MapBenchmark]   " << std::left << std::setw(24) << "Benchmark" << std::setw(10) << "Item" << std::right
+        << std::setw(10) << "Items" << std::setw(14) << "ns/item" << std::setw(14) << "items/s"
+        << std::setw(12) << "allocs/item" << std::setw(12) << "bytes/item" << std::endl;
+    stream << std::fixed << std::setprecision(1);
+    for (const Result &result : m_results)
+    {
+        stream << "[MapBenchmark]   " << std::left << std::setw(24) << result.name << std::setw(10) << result.itemName << std::right
+            << std::setw(10) << result.itemCount
+            << std::setw(14) << result.nanosecondsPerItem
+            << std::setw(14) << result.itemsPerSecond
+            << std::setw(12) << result.allocationsPerItem
+            << std::setw(12) << result.bytesPerItem << std::endl;
+    }
+
+    stream.flags(prevFlags);
+    stream.precision(prevPrecision);
+}
+
+/**
+ * @brief Writes the results to a JSON file
+ * @param[in] filePath Path of the file
+ * @return Returns true if the file was written. Returns false otherwise.
+ */
+bool MapBenchmark::WriteJson(const std::string &filePath) const
+{
+    std::ofstream file(filePath);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    // One benchmark per line, which is what ReadJson() expects
+    file << std::fixed << std::setprecision(3);
+    file << "{" << std::endl;
+    file << "    \"tiles\": " << m_tiles.size() << "," << std::endl;
+    file << "    \"benchmarks\": [" << std::endl;
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result &result = m_results[i];
+        file << "        { \"name\": \"" << result.name << "\", \"item\": \"" << result.itemName << "\""
+            << ", \"items\": " << result.itemCount
+            << ", \"iterations\": " << result.iterations
+            << ", \"nsPerItem\": " << result.nanosecondsPerItem
+            << ", \"itemsPerSecond\": " << result.itemsPerSecond
+            << ", \"allocationsPerItem\": " << result.allocationsPerItem
+            << ", \"bytesPerItem\": " << result.bytesPerItem << " }"
+            << ((i + 1 < m_results.size()) ? "," : "") << std::endl;
+    }
+    file << "    ]" << std::endl;
+    file << "}" << std::endl;
+
+    return !file.fail();
+}
+
+/**
+ * @brief Reads the results from a JSON file written by WriteJson()
+ * @param[in] filePath Path of the file
+ * @param[out] outResults Results read from the file
+ * @return Returns true if the file was read. Returns false otherwise.
+ */
+bool MapBenchmark::ReadJson(const std::string &filePath, std::vector<Result> &outResults)
+{
+    outResults.clear();
+
+    std::ifstream file(filePath);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        Result result = {};
+        double itemCount = 0.0;
+        double iterations = 0.0;
+        if (!FindJsonString(line, "name", result.name))
+        {
+            continue;
+        }
+        if (!FindJsonString(line, "item", result.itemName)
+            || !FindJsonNumber(line, "items", itemCount)
+            || !FindJsonNumber(line, "iterations", iterations)
+            || !FindJsonNumber(line, "nsPerItem", result.nanosecondsPerItem)
+            || !FindJsonNumber(line, "itemsPerSecond", result.itemsPerSecond)
+            || !FindJsonNumber(line, "allocationsPerItem", result.allocationsPerItem)
+            || !FindJsonNumber(line, "bytesPerItem", result.bytesPerItem))
+        {
+            LOG_ERROR("[MapBenchmark] Invalid benchmark result in " << filePath << ": " << line);
+            return false;
+        }
+        result.itemCount = static_cast<uint64_t>(itemCount);
+        result.iterations = static_cast<uint32_t>(iterations);
+        outResults.push_back(result);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compares the time per item of each benchmark with a baseline, and prints the comparison as a table
+ * @param[in] baseline Baseline results
+ * @param[in] thresholdPercent Slowdown (in percent) above which a benchmark counts as a regression
+ * @param[in] stream Stream to print to
+ * @return Number of benchmarks that regressed
+ */
+uint32_t MapBenchmark::CompareWithBaseline(const std::vector<Result> &baseline, double thresholdPercent, std::ostream &stream) const
+{
+    std::ios_base::fmtflags prevFlags = stream.flags();
+    std::streamsize prevPrecision = stream.precision();
+
+    uint32_t regressionCount = 0;
+    stream << "[MapBenchmark] Comparison with the baseline (ns/item, regression above +" << thresholdPercent << "%):" << std::endl;
+    stream << "[MapBenchmark]   " << std::left << std::setw(24) << "Benchmark" << std::right
+        << std::setw(14) << "Baseline" << std::setw(14) << "Current" << std::setw(10) << "Change" << std::endl;
+    stream << std::fixed << std::setprecision(1);
+    for (const Result &result : m_results)
+    {
+        std::vector<Result>::const_iterator baselineIt = std::find_if(baseline.begin(), baseline.end(), [&result](const Result &baselineResult)
+        {
+            return baselineResult.name == result.name;
+        });
+        stream << "[MapBenchmark]   " << std::left << std::setw(24) << result.name << std::right;
+        if ((baselineIt == baseline.end()) || (baselineIt->nanosecondsPerItem <= 0.0))
+        {
+            stream << std::setw(14) << "-" << std::setw(14) << result.nanosecondsPerItem << std::setw(10) << "new" << std::endl;
+            continue;
+        }
+
+        double changePercent = 100.0 * (result.nanosecondsPerItem - baselineIt->nanosecondsPerItem) / baselineIt->nanosecondsPerItem;
+        std::ostringstream change;
+        change << std::fixed << std::setprecision(1) << std::showpos << changePercent << "%";
+        stream << std::setw(14) << baselineIt->nanosecondsPerItem << std::setw(14) << result.nanosecondsPerItem << std::setw(10) << change.str();
+        if (changePercent > thresholdPercent)
+        {
+            stream << "  REGRESSION";
+            ++regressionCount;
+        }
+        stream << std::endl;
+    }
+
+    stream.flags(prevFlags);
+    stream.precision(prevPrecision);
+    return regressionCount;
+}
+
+/**
+ * @brief Runs a benchmark once to warm up, then measures it for the configured number of iterations
+ * @param[in] name Name of the benchmark
+ * @param[in] itemName What a single item of the benchmark is
+ * @param[in] itemCount Number of items processed by each run of the body
+ * @param[in] body Work to measure
+ */
+void MapBenchmark::Measure(const std::string &name, const std::string &itemName, uint64_t itemCount, const std::function<void()> &body)
+{
+    if (itemCount == 0)
+    {
+        LOG_WARNING("[MapBenchmark] Skipping " << name << ", since the tiles have no " << itemName << "s");
+        return;
+    }
+
+    body();
+
+    std::vector<double> iterationNanoseconds;
+    AllocationCounter::Counts allocations = {};
+    for (uint32_t i = 0; i < m_iterations; ++i)
+    {
+        AllocationCounter::Counts startAllocations = AllocationCounter::GetCounts();
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        body();
+        std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+        AllocationCounter::Counts endAllocations = AllocationCounter::GetCounts();
+
+        iterationNanoseconds.push_back(std::chrono::duration<double, std::nano>(endTime - startTime).count());
+        allocations.allocations += endAllocations.allocations - startAllocations.allocations;
+        allocations.bytes += endAllocations.bytes - startAllocations.bytes;
+    }
+
+    // The median is less sensitive to the occasional iteration disturbed by the rest of the system
+    std::sort(iterationNanoseconds.begin(), iterationNanoseconds.end());
+    double medianNanoseconds = iterationNanoseconds[iterationNanoseconds.size() / 2];
+
+    Result result = {};
+    result.name = name;
+    result.itemName = itemName;
+    result.itemCount = itemCount;
+    result.iterations = m_iterations;
+    result.nanosecondsPerItem = medianNanoseconds / static_cast<double>(itemCount);
+    result.itemsPerSecond = (medianNanoseconds > 0.0) ? static_cast<double>(itemCount) * 1000000000.0 / medianNanoseconds : 0.0;
+    result.allocationsPerItem = static_cast<double>(allocations.allocations) / m_iterations / static_cast<double>(itemCount);
+    result.bytesPerItem = static_cast<double>(allocations.bytes) / m_iterations / static_cast<double>(itemCount);
+    m_results.push_back(result);
+}
+
+/**
+ * @brief Gets the number of features (buildings, highways and water features) of all tiles
+ * @return Number of features
+ */
+uint64_t MapBenchmark::GetFeatureCount() const
+{
+    uint64_t featureCount = 0;
+    for (const TileData &tileData : m_tiles)
+    {
+        featureCount += tileData.buildings.size() + tileData.highways.size() + tileData.waterFeatures.size();
+    }
+    return featureCount;
+}
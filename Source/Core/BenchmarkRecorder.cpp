@@ -0,0 +1,179 @@
+#include "Core/BenchmarkRecorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+/**
+ * @brief Constructor
+ */
+BenchmarkRecorder::BenchmarkRecorder()
+    : m_samples()
+    , m_tileLatencies()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+BenchmarkRecorder::~BenchmarkRecorder()
+{
+}
+
+/**
+ * @brief Records the measurements of a frame
+ * @param[in] sample Measurements of the frame
+ * @param[in] tileLatencies Request-to-resident latency of each tile that arrived in the frame (in seconds)
+ */
+void BenchmarkRecorder::AddFrame(const FrameSample &sample, const std::vector<double> &tileLatencies)
+{
+    m_samples.push_back(sample);
+    for (double latency : tileLatencies)
+    {
+        m_tileLatencies.push_back(latency * 1000.0);
+    }
+}
+
+/**
+ * @brief Sets the GPU time of a recorded frame, once it is known
+ * @param[in] frameNumber Number of the frame
+ * @param[in] gpuMilliseconds Time the GPU spent executing the frame's commands
+ */
+void BenchmarkRecorder::SetGpuTime(uint64_t frameNumber, double gpuMilliseconds)
+{
+    // The GPU time arrives a few frames late, so the frame is near the end
+    for (auto it = m_samples.rbegin(); it != m_samples.rend(); ++it)
+    {
+        if (it->frameNumber == frameNumber)
+        {
+            it->gpuMilliseconds = gpuMilliseconds;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether any frame was recorded
+ * @return Returns true if no frame was recorded. Returns false otherwise.
+ */
+bool BenchmarkRecorder::IsEmpty() const
+{
+    return m_samples.empty();
+}
+
+/**
+ * @brief Computes the distribution of every measurement
+ * @return Summary of the run
+ */
+BenchmarkRecorder::Summary BenchmarkRecorder::GetSummary() const
+{
+    std::vector<double> frameTimes, cpuTimes, gpuTimes, uploadedBytes;
+    Summary ret = {};
+    for (const FrameSample &sample : m_samples)
+    {
+        frameTimes.push_back(sample.frameMilliseconds);
+        cpuTimes.push_back(sample.cpuMilliseconds);
+        if (sample.gpuMilliseconds >= 0.0)
+        {
+            gpuTimes.push_back(sample.gpuMilliseconds);
+        }
+        uploadedBytes.push_back(static_cast<double>(sample.uploadedBytes));
+
+        ret.totalUploadedBytes += sample.uploadedBytes;
+        ret.totalArrivedTiles += sample.arrivedTiles;
+    }
+
+    ret.frameMilliseconds = ComputePercentiles(frameTimes);
+    ret.cpuMilliseconds = ComputePercentiles(cpuTimes);
+    ret.gpuMilliseconds = ComputePercentiles(gpuTimes);
+    ret.tileLatencyMilliseconds = ComputePercentiles(m_tileLatencies);
+    ret.uploadedBytes = ComputePercentiles(uploadedBytes);
+    return ret;
+}
+
+/**
+ * @brief Writes the summary in a human-readable form
+ * @param[in] stream Stream to write to
+ */
+void BenchmarkRecorder::PrintSummary(std::ostream &stream) const
+{
+    Summary summary = GetSummary();
+
+    auto printPercentiles = [&stream](const char *name, const Percentiles &percentiles, const char *unit)
+    {
+        stream << "[BenchmarkRecorder] " << name << ": ";
+        if (percentiles.count == 0)
+        {
+            stream << "not measured" << std::endl;
+            return;
+        }
+        stream << "p50 " << percentiles.p50 << unit << ", p95 " << percentiles.p95 << unit
+            << ", p99 " << percentiles.p99 << unit << ", max " << percentiles.max << unit
+            << " (" << percentiles.count << " samples)" << std::endl;
+    };
+
+    stream << "[BenchmarkRecorder] " << m_samples.size() << " frames, " << summary.totalArrivedTiles << " tiles arrived, "
+        << summary.totalUploadedBytes / (1024 * 1024) << " MB uploaded" << std::endl;
+    printPercentiles("Frame time", summary.frameMilliseconds, " ms");
+    printPercentiles("CPU time", summary.cpuMilliseconds, " ms");
+    printPercentiles("GPU time", summary.gpuMilliseconds, " ms");
+    printPercentiles("Tile arrival latency", summary.tileLatencyMilliseconds, " ms");
+    printPercentiles("Uploads per frame", summary.uploadedBytes, " bytes");
+}
+
+/**
+ * @brief Writes the samples of every frame as CSV
+ * @param[in] filePath CSV file
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool BenchmarkRecorder::WriteCsv(const std::string &filePath) const
+{
+    std::ofstream file(filePath, std::ios::trunc);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    // Frames without a GPU time leave the column empty
+    file << "frame,time_s,frame_ms,cpu_ms,gpu_ms,arrived_tiles,max_tile_latency_ms,uploaded_bytes\n";
+    for (const FrameSample &sample : m_samples)
+    {
+        file << sample.frameNumber << "," << sample.time << "," << sample.frameMilliseconds << "," << sample.cpuMilliseconds << ",";
+        if (sample.gpuMilliseconds >= 0.0)
+        {
+            file << sample.gpuMilliseconds;
+        }
+        file << "," << sample.arrivedTiles << "," << sample.maxTileLatencyMilliseconds << "," << sample.uploadedBytes << "\n";
+    }
+    file.close();
+
+    return !file.fail();
+}
+
+/**
+ * @brief Computes the distribution of a list of measurements, using the nearest-rank method
+ * @param[in] values Measurements
+ * @return Percentiles of the measurements. All zero if there are none.
+ */
+BenchmarkRecorder::Percentiles BenchmarkRecorder::ComputePercentiles(std::vector<double> values)
+{
+    Percentiles ret = {};
+    if (values.empty())
+    {
+        return ret;
+    }
+
+    std::sort(values.begin(), values.end());
+    auto nearestRank = [&values](double percentile)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size()));
+        return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+    };
+
+    ret.count = values.size();
+    ret.p50 = nearestRank(50.0);
+    ret.p95 = nearestRank(95.0);
+    ret.p99 = nearestRank(99.0);
+    ret.max = values.back();
+    return ret;
+}
@@ -8,6 +8,8 @@
 Camera::Camera()
 	: m_fov(90.0f)
 	, m_aspectRatio(1.0f)
+	, m_nearPlane(0.1f)
+	, m_farPlane(100.0f)
 	, m_position(0.0f)
 	, m_yaw(0.0f)
 	, m_pitch(0.0f)
@@ -62,6 +64,35 @@ float Camera::GetAspectRatio() const
 	return m_aspectRatio;
 }
 
+/**
+ * @brief Sets the distances to the camera's near and far clipping planes
+ * @param[in] nearPlane Distance to the near clipping plane
+ * @param[in] farPlane Distance to the far clipping plane
+ */
+void Camera::SetClipPlanes(const float& nearPlane, const float& farPlane)
+{
+	m_nearPlane = nearPlane;
+	m_farPlane = farPlane;
+}
+
+/**
+ * @brief Gets the distance to the camera's near clipping plane
+ * @return Distance to the near clipping plane
+ */
+float Camera::GetNearPlane() const
+{
+	return m_nearPlane;
+}
+
+/**
+ * @brief Gets the distance to the camera's far clipping plane
+ * @return Distance to the far clipping plane
+ */
+float Camera::GetFarPlane() const
+{
+	return m_farPlane;
+}
+
 /**
  * @brief Sets the camera's position
  * @param[in] position New position
@@ -179,8 +210,7 @@ glm::mat4 Camera::GetViewMatrix() const
  */
 glm::mat4 Camera::GetProjectionMatrix() const
 {
-	// TODO: Make the near and far values adjustable
-	glm::mat4 ret = glm::perspectiveRH_ZO(glm::radians(m_fov), m_aspectRatio, 0.1f, 100.0f);
+	glm::mat4 ret = glm::perspectiveRH_ZO(glm::radians(m_fov), m_aspectRatio, m_nearPlane, m_farPlane);
 	ret[1][1] *= -1.0f;
 	return ret;
 }
@@ -0,0 +1,122 @@
+#include "Core/CameraPath.hpp"
+
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Constructor
+ */
+CameraPath::CameraPath()
+    : m_keyframes()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+CameraPath::~CameraPath()
+{
+}
+
+/**
+ * @brief Loads the keyframes from a path file. Previously loaded keyframes are replaced.
+ * @param[in] filePath Path file
+ * @return Returns true if the file was read and has at least one keyframe. Returns false otherwise.
+ */
+bool CameraPath::LoadFromFile(const std::string &filePath)
+{
+    m_keyframes.clear();
+
+    std::ifstream file(filePath);
+    if (file.fail())
+    {
+        LOG_ERROR("[CameraPath] Failed to open " << filePath << "!");
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        size_t firstCharacter = line.find_first_not_of(" \t\r");
+        if ((firstCharacter == std::string::npos) || (line[firstCharacter] == '#'))
+        {
+            continue;
+        }
+
+        Keyframe keyframe;
+        std::istringstream lineStream(line);
+        if (!(lineStream >> keyframe.time >> keyframe.lonLat.x >> keyframe.lonLat.y >> keyframe.height >> keyframe.yaw >> keyframe.pitch))
+        {
+            LOG_ERROR("[CameraPath] Invalid keyframe in " << filePath << ":" << lineNumber << "!");
+            m_keyframes.clear();
+            return false;
+        }
+
+        if (!m_keyframes.empty() && (keyframe.time < m_keyframes.back().time))
+        {
+            LOG_ERROR("[CameraPath] Keyframe in " << filePath << ":" << lineNumber << " goes back in time!");
+            m_keyframes.clear();
+            return false;
+        }
+
+        m_keyframes.push_back(keyframe);
+    }
+
+    return !m_keyframes.empty();
+}
+
+/**
+ * @brief Checks whether the path has any keyframes
+ * @return Returns true if there are no keyframes. Returns false otherwise.
+ */
+bool CameraPath::IsEmpty() const
+{
+    return m_keyframes.empty();
+}
+
+/**
+ * @brief Gets the time of the last keyframe
+ * @return Duration of the path (in seconds). 0 if the path is empty.
+ */
+double CameraPath::GetDuration() const
+{
+    return m_keyframes.empty() ? 0.0 : m_keyframes.back().time;
+}
+
+/**
+ * @brief Gets the camera pose at the provided time. Times outside the path are clamped to its ends.
+ * Must not be called on an empty path.
+ * @param[in] time Time since the start of the path (in seconds)
+ * @return Interpolated camera pose
+ */
+CameraPath::Keyframe CameraPath::Sample(double time) const
+{
+    // First keyframe after the provided time
+    auto next = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time,
+        [](double t, const Keyframe &keyframe) { return t < keyframe.time; });
+    if (next == m_keyframes.begin())
+    {
+        return m_keyframes.front();
+    }
+    if (next == m_keyframes.end())
+    {
+        return m_keyframes.back();
+    }
+
+    const Keyframe &prev = *(next - 1);
+    double t = (time - prev.time) / (next->time - prev.time);
+
+    Keyframe ret;
+    ret.time = time;
+    ret.lonLat = glm::mix(prev.lonLat, next->lonLat, t);
+    ret.height = glm::mix(prev.height, next->height, t);
+    ret.yaw = glm::mix(prev.yaw, next->yaw, static_cast<float>(t));
+    ret.pitch = glm::mix(prev.pitch, next->pitch, static_cast<float>(t));
+    return ret;
+}
@@ -0,0 +1,88 @@
+#include "Core/Frustum.hpp"
+
+/**
+ * @brief Constructor
+ */
+Frustum::Frustum()
+    : m_planes()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+Frustum::~Frustum()
+{
+}
+
+/**
+ * @brief Extracts the frustum planes from a combined projection-view matrix.
+ * The projection is expected to map depth to [0, 1] (Vulkan convention).
+ * @param[in] projView Combined projection-view matrix
+ * @return Frustum of the provided matrix
+ */
+Frustum Frustum::FromMatrix(const glm::mat4 &projView)
+{
+    // glm matrices are column-major, so build the rows explicitly
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        rows[i] = glm::vec4(projView[0][i], projView[1][i], projView[2][i], projView[3][i]);
+    }
+
+    Frustum frustum;
+    frustum.m_planes[0] = rows[3] + rows[0];    // Left
+    frustum.m_planes[1] = rows[3] - rows[0];    // Right
+    frustum.m_planes[2] = rows[3] + rows[1];    // Bottom
+    frustum.m_planes[3] = rows[3] - rows[1];    // Top
+    frustum.m_planes[4] = rows[2];              // Near (z >= 0 for a [0, 1] depth range)
+    frustum.m_planes[5] = rows[3] - rows[2];    // Far
+
+    for (glm::vec4 &plane : frustum.m_planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+        {
+            plane /= length;
+        }
+    }
+
+    return frustum;
+}
+
+/**
+ * @brief Checks whether the bounding box is at least partially inside the frustum.
+ * This is conservative, so boxes near the frustum corners may be reported as visible.
+ * @param[in] box Bounding box to test
+ * @return Returns true if the bounding box is potentially visible. Returns false otherwise.
+ */
+bool Frustum::IsAABBVisible(const AABB &box) const
+{
+    glm::vec3 center = box.GetCenter();
+    glm::vec3 halfExtents = box.GetHalfExtents();
+
+    for (const glm::vec4 &plane : m_planes)
+    {
+        glm::vec3 normal(plane);
+
+        // Projected radius of the box onto the plane normal
+        float radius = glm::dot(halfExtents, glm::abs(normal));
+        float distance = glm::dot(normal, center) + plane.w;
+        if (distance < -radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Gets the frustum planes.
+ * Each plane is stored as (normal, distance), with the normal pointing inside the frustum.
+ * @return Frustum planes in the order left, right, bottom, top, near, far
+ */
+const std::array<glm::vec4, 6>& Frustum::GetPlanes() const
+{
+    return m_planes;
+}
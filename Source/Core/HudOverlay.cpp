@@ -0,0 +1,355 @@
+#include "Core/HudOverlay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+
+namespace
+{
+    const char FIRST_GLYPH_CHARACTER = 0x20;    // Character of the first glyph of the font
+    const char LAST_GLYPH_CHARACTER = 0x7E;     // Character of the last glyph of the font
+
+    // Classic 5x7 font for the printable ASCII characters. Each glyph is 5 columns
+    // from left to right, and bit N of a column is row N from the top.
+    const std::array<std::array<uint8_t, 5>, LAST_GLYPH_CHARACTER - FIRST_GLYPH_CHARACTER + 1> FONT_GLYPHS =
+    {{
+        {{ 0x00, 0x00, 0x00, 0x00, 0x00 }},     // ' '
+        {{ 0x00, 0x00, 0x5F, 0x00, 0x00 }},     // '!'
+        {{ 0x00, 0x07, 0x00, 0x07, 0x00 }},     // '"'
+        {{ 0x14, 0x7F, 0x14, 0x7F, 0x14 }},     // '#'
+        {{ 0x24, 0x2A, 0x7F, 0x2A, 0x12 }},     // '$'
+        {{ 0x23, 0x13, 0x08, 0x64, 0x62 }},     // '%'
+        {{ 0x36, 0x49, 0x55, 0x22, 0x50 }},     // '&'
+        {{ 0x00, 0x05, 0x03, 0x00, 0x00 }},     // '''
+        {{ 0x00, 0x1C, 0x22, 0x41, 0x00 }},     // '('
+        {{ 0x00, 0x41, 0x22, 0x1C, 0x00 }},     // ')'
+        {{ 0x08, 0x2A, 0x1C, 0x2A, 0x08 }},     // '*'
+        {{ 0x08, 0x08, 0x3E, 0x08, 0x08 }},     // '+'
+        {{ 0x00, 0x50, 0x30, 0x00, 0x00 }},     // ','
+        {{ 0x08, 0x08, 0x08, 0x08, 0x08 }},     // '-'
+        {{ 0x00, 0x60, 0x60, 0x00, 0x00 }},     // '.'
+        {{ 0x20, 0x10, 0x08, 0x04, 0x02 }},     // '/'
+        {{ 0x3E, 0x51, 0x49, 0x45, 0x3E }},     // '0'
+        {{ 0x00, 0x42, 0x7F, 0x40, 0x00 }},     // '1'
+        {{ 0x42, 0x61, 0x51, 0x49, 0x46 }},     // '2'
+        {{ 0x21, 0x41, 0x45, 0x4B, 0x31 }},     // '3'
+        {{ 0x18, 0x14, 0x12, 0x7F, 0x10 }},     // '4'
+        {{ 0x27, 0x45, 0x45, 0x45, 0x39 }},     // '5'
+        {{ 0x3C, 0x4A, 0x49, 0x49, 0x30 }},     // '6'
+        {{ 0x01, 0x71, 0x09, 0x05, 0x03 }},     // '7'
+        {{ 0x36, 0x49, 0x49, 0x49, 0x36 }},     // '8'
+        {{ 0x06, 0x49, 0x49, 0x29, 0x1E }},     // '9'
+        {{ 0x00, 0x36, 0x36, 0x00, 0x00 }},     // ':'
+        {{ 0x00, 0x56, 0x36, 0x00, 0x00 }},     // ';'
+        {{ 0x08, 0x14, 0x22, 0x41, 0x00 }},     // '<'
+        {{ 0x14, 0x14, 0x14, 0x14, 0x14 }},     // '='
+        {{ 0x00, 0x41, 0x22, 0x14, 0x08 }},     // '>'
+        {{ 0x02, 0x01, 0x51, 0x09, 0x06 }},     // '?'
+        {{ 0x32, 0x49, 0x79, 0x41, 0x3E }},     // '@'
+        {{ 0x7E, 0x11, 0x11, 0x11, 0x7E }},     // 'A'
+        {{ 0x7F, 0x49, 0x49, 0x49, 0x36 }},     // 'B'
+        {{ 0x3E, 0x41, 0x41, 0x41, 0x22 }},     // 'C'
+        {{ 0x7F, 0x41, 0x41, 0x22, 0x1C }},     // 'D'
+        {{ 0x7F, 0x49, 0x49, 0x49, 0x41 }},     // 'E'
+        {{ 0x7F, 0x09, 0x09, 0x09, 0x01 }},     // 'F'
+        {{ 0x3E, 0x41, 0x49, 0x49, 0x7A }},     // 'G'
+        {{ 0x7F, 0x08, 0x08, 0x08, 0x7F }},     // 'H'
+        {{ 0x00, 0x41, 0x7F, 0x41, 0x00 }},     // 'I'
+        {{ 0x20, 0x40, 0x41, 0x3F, 0x01 }},     // 'J'
+        {{ 0x7F, 0x08, 0x14, 0x22, 0x41 }},     // 'K'
+        {{ 0x7F, 0x40, 0x40, 0x40, 0x40 }},     // 'L'
+        {{ 0x7F, 0x02, 0x0C, 0x02, 0x7F }},     // 'M'
+        {{ 0x7F, 0x04, 0x08, 0x10, 0x7F }},     // 'N'
+        {{ 0x3E, 0x41, 0x41, 0x41, 0x3E }},     // 'O'
+        {{ 0x7F, 0x09, 0x09, 0x09, 0x06 }},     // 'P'
+        {{ 0x3E, 0x41, 0x51, 0x21, 0x5E }},     // 'Q'
+        {{ 0x7F, 0x09, 0x19, 0x29, 0x46 }},     // 'R'
+        {{ 0x46, 0x49, 0x49, 0x49, 0x31 }},     // 'S'
+        {{ 0x01, 0x01, 0x7F, 0x01, 0x01 }},     // 'T'
+        {{ 0x3F, 0x40, 0x40, 0x40, 0x3F }},     // 'U'
+        {{ 0x1F, 0x20, 0x40, 0x20, 0x1F }},     // 'V'
+        {{ 0x3F, 0x40, 0x38, 0x40, 0x3F }},     // 'W'
+        {{ 0x63, 0x14, 0x08, 0x14, 0x63 }},     // 'X'
+        {{ 0x07, 0x08, 0x70, 0x08, 0x07 }},     // 'Y'
+        {{ 0x61, 0x51, 0x49, 0x45, 0x43 }},     // 'Z'
+        {{ 0x00, 0x7F, 0x41, 0x41, 0x00 }},     // '['
+        {{ 0x02, 0x04, 0x08, 0x10, 0x20 }},     // '\'
+        {{ 0x00, 0x41, 0x41, 0x7F, 0x00 }},     // ']'
+        {{ 0x04, 0x02, 0x01, 0x02, 0x04 }},     // '^'
+        {{ 0x40, 0x40, 0x40, 0x40, 0x40 }},     // '_'
+        {{ 0x00, 0x01, 0x02, 0x04, 0x00 }},     // '`'
+        {{ 0x20, 0x54, 0x54, 0x54, 0x78 }},     // 'a'
+        {{ 0x7F, 0x48, 0x44, 0x44, 0x38 }},     // 'b'
+        {{ 0x38, 0x44, 0x44, 0x44, 0x20 }},     // 'c'
+        {{ 0x38, 0x44, 0x44, 0x48, 0x7F }},     // 'd'
+        {{ 0x38, 0x54, 0x54, 0x54, 0x18 }},     // 'e'
+        {{ 0x08, 0x7E, 0x09, 0x01, 0x02 }},     // 'f'
+        {{ 0x0C, 0x52, 0x52, 0x52, 0x3E }},     // 'g'
+        {{ 0x7F, 0x08, 0x04, 0x04, 0x78 }},     // 'h'
+        {{ 0x00, 0x44, 0x7D, 0x40, 0x00 }},     // 'i'
+        {{ 0x20, 0x40, 0x44, 0x3D, 0x00 }},     // 'j'
+        {{ 0x7F, 0x10, 0x28, 0x44, 0x00 }},     // 'k'
+        {{ 0x00, 0x41, 0x7F, 0x40, 0x00 }},     // 'l'
+        {{ 0x7C, 0x04, 0x18, 0x04, 0x78 }},     // 'm'
+        {{ 0x7C, 0x08, 0x04, 0x04, 0x78 }},     // 'n'
+        {{ 0x38, 0x44, 0x44, 0x44, 0x38 }},     // 'o'
+        {{ 0x7C, 0x14, 0x14, 0x14, 0x08 }},     // 'p'
+        {{ 0x08, 0x14, 0x14, 0x18, 0x7C }},     // 'q'
+        {{ 0x7C, 0x08, 0x04, 0x04, 0x08 }},     // 'r'
+        {{ 0x48, 0x54, 0x54, 0x54, 0x20 }},     // 's'
+        {{ 0x04, 0x3F, 0x44, 0x40, 0x20 }},     // 't'
+        {{ 0x3C, 0x40, 0x40, 0x20, 0x7C }},     // 'u'
+        {{ 0x1C, 0x20, 0x40, 0x20, 0x1C }},     // 'v'
+        {{ 0x3C, 0x40, 0x30, 0x40, 0x3C }},     // 'w'
+        {{ 0x44, 0x28, 0x10, 0x28, 0x44 }},     // 'x'
+        {{ 0x0C, 0x50, 0x50, 0x50, 0x3C }},     // 'y'
+        {{ 0x44, 0x64, 0x54, 0x4C, 0x44 }},     // 'z'
+        {{ 0x00, 0x08, 0x36, 0x41, 0x00 }},     // '{'
+        {{ 0x00, 0x00, 0x7F, 0x00, 0x00 }},     // '|'
+        {{ 0x00, 0x41, 0x36, 0x08, 0x00 }},     // '}'
+        {{ 0x10, 0x08, 0x08, 0x10, 0x08 }}      // '~'
+    }};
+}
+
+/**
+ * @brief Constructor
+ */
+HudOverlay::HudOverlay()
+    : m_frameTimes()
+    , m_nextFrameTimeIndex(0)
+    , m_frameTimeCount(0)
+    , m_vertices()
+    , m_viewportSize(1.0f, 1.0f)
+    , m_isVisible(false)
+{
+    m_frameTimes.resize(FRAME_HISTORY_SIZE, 0.0);
+}
+
+/**
+ * @brief Destructor
+ */
+HudOverlay::~HudOverlay()
+{
+}
+
+/**
+ * @brief Sets whether the overlay is drawn
+ * @param[in] isVisible Flag indicating whether the overlay is drawn
+ */
+void HudOverlay::SetVisible(bool isVisible)
+{
+    m_isVisible = isVisible;
+}
+
+/**
+ * @brief Checks whether the overlay is drawn
+ * @return Returns true if the overlay is drawn. Returns false otherwise.
+ */
+bool HudOverlay::IsVisible() const
+{
+    return m_isVisible;
+}
+
+/**
+ * @brief Adds the time of a frame to the graph. Frame times are recorded even while
+ * the overlay is hidden, so that the graph is filled in as soon as it is shown.
+ * @param[in] milliseconds Frame time
+ */
+void HudOverlay::AddFrameTime(double milliseconds)
+{
+    m_frameTimes[m_nextFrameTimeIndex] = milliseconds;
+    m_nextFrameTimeIndex = (m_nextFrameTimeIndex + 1) % FRAME_HISTORY_SIZE;
+    m_frameTimeCount = std::min(m_frameTimeCount + 1, FRAME_HISTORY_SIZE);
+}
+
+/**
+ * @brief Gets the average time of the frames in the graph
+ * @return Average frame time (in milliseconds). 0 if no frame was recorded.
+ */
+double HudOverlay::GetAverageFrameTime() const
+{
+    if (m_frameTimeCount == 0)
+    {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < m_frameTimeCount; ++i)
+    {
+        sum += m_frameTimes[i];
+    }
+    return sum / static_cast<double>(m_frameTimeCount);
+}
+
+/**
+ * @brief Rebuilds the vertices of the overlay
+ * @param[in] viewportWidth Width of the viewport (in pixels)
+ * @param[in] viewportHeight Height of the viewport (in pixels)
+ * @param[in] lines Lines of text shown above the frame time graph. Only printable ASCII characters are drawn.
+ */
+void HudOverlay::Build(uint32_t viewportWidth, uint32_t viewportHeight, const std::vector<std::string> &lines)
+{
+    m_vertices.clear();
+    m_viewportSize = glm::vec2(std::max(viewportWidth, 1u), std::max(viewportHeight, 1u));
+
+    const float charAdvance = (GLYPH_WIDTH + 1) * PIXEL_SCALE;
+    const float lineHeight = (GLYPH_HEIGHT + 2) * PIXEL_SCALE;
+
+    size_t maxLineLength = 0;
+    for (const std::string &line : lines)
+    {
+        maxLineLength = std::max(maxLineLength, line.size());
+    }
+    float textWidth = static_cast<float>(maxLineLength) * charAdvance;
+    float graphWidth = static_cast<float>(FRAME_HISTORY_SIZE) * GRAPH_BAR_WIDTH;
+    float textHeight = static_cast<float>(lines.size()) * lineHeight;
+
+    float panelX = MARGIN;
+    float panelY = MARGIN;
+    float panelWidth = std::max(textWidth, graphWidth) + 2.0f * MARGIN;
+    float panelHeight = textHeight + GRAPH_HEIGHT + 3.0f * MARGIN;
+    AddRect(panelX, panelY, panelWidth, panelHeight, PackColor(0, 0, 0, 160));
+
+    // --- Text ---
+    uint32_t textColor = PackColor(255, 255, 255, 255);
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        AddText(panelX + MARGIN, panelY + MARGIN + static_cast<float>(i) * lineHeight, lines[i], textColor);
+    }
+
+    // --- Frame time graph ---
+    float graphX = panelX + MARGIN;
+    float graphY = panelY + 2.0f * MARGIN + textHeight;
+    float graphBottom = graphY + GRAPH_HEIGHT;
+    AddRect(graphX, graphY, graphWidth, GRAPH_HEIGHT, PackColor(255, 255, 255, 24));
+
+    // Oldest frame on the left, newest on the right
+    size_t oldestIndex = (m_nextFrameTimeIndex + FRAME_HISTORY_SIZE - m_frameTimeCount) % FRAME_HISTORY_SIZE;
+    size_t firstBar = FRAME_HISTORY_SIZE - m_frameTimeCount;
+    for (size_t i = 0; i < m_frameTimeCount; ++i)
+    {
+        double milliseconds = m_frameTimes[(oldestIndex + i) % FRAME_HISTORY_SIZE];
+        float barHeight = static_cast<float>(std::min(milliseconds / GRAPH_MAX_MILLISECONDS, 1.0)) * GRAPH_HEIGHT;
+
+        uint32_t barColor = PackColor(80, 220, 80, 220);
+        if (milliseconds > TARGET_MILLISECONDS_30)
+        {
+            barColor = PackColor(230, 60, 60, 220);
+        }
+        else if (milliseconds > TARGET_MILLISECONDS_60)
+        {
+            barColor = PackColor(230, 200, 60, 220);
+        }
+
+        float barX = graphX + static_cast<float>(firstBar + i) * GRAPH_BAR_WIDTH;
+        AddRect(barX, graphBottom - barHeight, GRAPH_BAR_WIDTH - 1.0f, barHeight, barColor);
+    }
+
+    // Reference lines at 60 and 30 FPS
+    for (double targetMilliseconds : { TARGET_MILLISECONDS_60, TARGET_MILLISECONDS_30 })
+    {
+        float lineY = graphBottom - static_cast<float>(targetMilliseconds / GRAPH_MAX_MILLISECONDS) * GRAPH_HEIGHT;
+        AddRect(graphX, lineY, graphWidth, 1.0f, PackColor(255, 255, 255, 128));
+    }
+}
+
+/**
+ * @brief Gets the vertices built by the last call to Build(), as a triangle list
+ * @return Vertices of the overlay
+ */
+const std::vector<HudOverlay::HudVertex>& HudOverlay::GetVertices() const
+{
+    return m_vertices;
+}
+
+/**
+ * @brief Packs a color into the format of the vertex colors
+ * @param[in] r Red
+ * @param[in] g Green
+ * @param[in] b Blue
+ * @param[in] a Alpha
+ * @return Packed color
+ */
+uint32_t HudOverlay::PackColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    return static_cast<uint32_t>(r)
+        | (static_cast<uint32_t>(g) << 8)
+        | (static_cast<uint32_t>(b) << 16)
+        | (static_cast<uint32_t>(a) << 24);
+}
+
+/**
+ * @brief Adds an axis-aligned rectangle
+ * @param[in] x Left edge (in pixels from the left of the viewport)
+ * @param[in] y Top edge (in pixels from the top of the viewport)
+ * @param[in] width Width (in pixels)
+ * @param[in] height Height (in pixels)
+ * @param[in] color Packed color
+ */
+void HudOverlay::AddRect(float x, float y, float width, float height, uint32_t color)
+{
+    if ((width <= 0.0f) || (height <= 0.0f))
+    {
+        return;
+    }
+
+    // The viewport is not flipped, so y = -1 is the top of the viewport
+    glm::vec2 topLeft = glm::vec2(x, y) / m_viewportSize * 2.0f - 1.0f;
+    glm::vec2 bottomRight = glm::vec2(x + width, y + height) / m_viewportSize * 2.0f - 1.0f;
+
+    HudVertex v0 = { topLeft, color };
+    HudVertex v1 = { glm::vec2(bottomRight.x, topLeft.y), color };
+    HudVertex v2 = { bottomRight, color };
+    HudVertex v3 = { glm::vec2(topLeft.x, bottomRight.y), color };
+
+    m_vertices.push_back(v0);
+    m_vertices.push_back(v1);
+    m_vertices.push_back(v2);
+    m_vertices.push_back(v0);
+    m_vertices.push_back(v2);
+    m_vertices.push_back(v3);
+}
+
+/**
+ * @brief Adds a line of text
+ * @param[in] x Left edge of the first glyph (in pixels from the left of the viewport)
+ * @param[in] y Top edge of the glyphs (in pixels from the top of the viewport)
+ * @param[in] text Text to add
+ * @param[in] color Packed color
+ */
+void HudOverlay::AddText(float x, float y, const std::string &text, uint32_t color)
+{
+    float glyphX = x;
+    for (char c : text)
+    {
+        if ((c >= FIRST_GLYPH_CHARACTER) && (c <= LAST_GLYPH_CHARACTER))
+        {
+            const std::array<uint8_t, 5> &glyph = FONT_GLYPHS[c - FIRST_GLYPH_CHARACTER];
+            for (uint32_t column = 0; column < GLYPH_WIDTH; ++column)
+            {
+                // One quad per vertical run of lit pixels
+                uint32_t row = 0;
+                while (row < GLYPH_HEIGHT)
+                {
+                    if ((glyph[column] & (1u << row)) == 0)
+                    {
+                        ++row;
+                        continue;
+                    }
+
+                    uint32_t runStart = row;
+                    while ((row < GLYPH_HEIGHT) && ((glyph[column] & (1u << row)) != 0))
+                    {
+                        ++row;
+                    }
+                    AddRect(glyphX + static_cast<float>(column) * PIXEL_SCALE,
+                        y + static_cast<float>(runStart) * PIXEL_SCALE,
+                        PIXEL_SCALE,
+                        static_cast<float>(row - runStart) * PIXEL_SCALE,
+                        color);
+                }
+            }
+        }
+        glyphX += (GLYPH_WIDTH + 1) * PIXEL_SCALE;
+    }
+}
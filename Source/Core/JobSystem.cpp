@@ -0,0 +1,125 @@
+#include "Core/JobSystem.hpp"
+
+#include "Core/Profiler.hpp"
+
+/**
+ * @brief Constructor
+ */
+JobSystem::JobSystem()
+    : m_workers()
+    , m_task()
+    , m_generation(0)
+    , m_remainingWorkers(0)
+    , m_isRunning(false)
+    , m_mutex()
+    , m_taskReady()
+    , m_taskDone()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+JobSystem::~JobSystem()
+{
+    Stop();
+}
+
+/**
+ * @brief Starts the worker threads
+ * @param[in] workerCount Number of worker threads
+ */
+void JobSystem::Start(uint32_t workerCount)
+{
+    Stop();
+
+    m_isRunning = true;
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerThreadFunc, this, i, m_generation);
+    }
+}
+
+/**
+ * @brief Stops and joins the worker threads
+ */
+void JobSystem::Stop()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_isRunning = false;
+    }
+    m_taskReady.notify_all();
+
+    for (std::thread &worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+/**
+ * @brief Runs the task once on every worker, and waits until all of them are done.
+ * Must only be called from one thread at a time.
+ * @param[in] task Task to run. Receives the index of the worker running it.
+ */
+void JobSystem::Execute(const std::function<void(uint32_t)> &task)
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+
+    std::unique_lock lock(m_mutex);
+    m_task = task;
+    m_remainingWorkers = static_cast<uint32_t>(m_workers.size());
+    ++m_generation;
+    m_taskReady.notify_all();
+
+    m_taskDone.wait(lock, [this] { return m_remainingWorkers == 0; });
+    m_task = nullptr;
+}
+
+/**
+ * @brief Gets the number of worker threads
+ * @return Number of worker threads
+ */
+uint32_t JobSystem::GetWorkerCount() const
+{
+    return static_cast<uint32_t>(m_workers.size());
+}
+
+/**
+ * @brief Worker thread function
+ * @param[in] workerIndex Index of the worker
+ * @param[in] startGeneration Number of executions started before the worker was started
+ */
+void JobSystem::WorkerThreadFunc(uint32_t workerIndex, uint64_t startGeneration)
+{
+    Profiler::SetThreadName("Job worker " + std::to_string(workerIndex));
+
+    uint64_t lastGeneration = startGeneration;
+    while (true)
+    {
+        std::function<void(uint32_t)> task;
+        {
+            std::unique_lock lock(m_mutex);
+            m_taskReady.wait(lock, [this, lastGeneration] { return !m_isRunning || (m_generation != lastGeneration); });
+            if (!m_isRunning)
+            {
+                return;
+            }
+            lastGeneration = m_generation;
+            task = m_task;
+        }
+
+        task(workerIndex);
+
+        std::lock_guard lock(m_mutex);
+        --m_remainingWorkers;
+        if (m_remainingWorkers == 0)
+        {
+            m_taskDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#include "Core/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructor
+ */
+LatencyHistogram::LatencyHistogram()
+    : m_counts()
+    , m_totalCount(0)
+    , m_minValue(0)
+    , m_maxValue(0)
+    , m_sum(0.0)
+{
+    // Exact buckets, then half as many buckets for each further power of two
+    m_counts.resize(GetBucketIndex((uint64_t(1) << MAX_VALUE_BITS) - 1) + 1, 0);
+}
+
+/**
+ * @brief Destructor
+ */
+LatencyHistogram::~LatencyHistogram()
+{
+}
+
+/**
+ * @brief Records a value
+ * @param[in] microseconds Value to record
+ */
+void LatencyHistogram::Record(uint64_t microseconds)
+{
+    uint64_t value = std::min(microseconds, (uint64_t(1) << MAX_VALUE_BITS) - 1);
+    ++m_counts[GetBucketIndex(value)];
+
+    m_minValue = (m_totalCount == 0) ? value : std::min(m_minValue, value);
+    m_maxValue = std::max(m_maxValue, value);
+    m_sum += static_cast<double>(value);
+    ++m_totalCount;
+}
+
+/**
+ * @brief Removes all recorded values
+ */
+void LatencyHistogram::Reset()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_totalCount = 0;
+    m_minValue = 0;
+    m_maxValue = 0;
+    m_sum = 0.0;
+}
+
+/**
+ * @brief Gets the number of recorded values
+ * @return Number of recorded values
+ */
+uint64_t LatencyHistogram::GetCount() const
+{
+    return m_totalCount;
+}
+
+/**
+ * @brief Gets the smallest recorded value
+ * @return Smallest recorded value. 0 if nothing was recorded.
+ */
+uint64_t LatencyHistogram::GetMin() const
+{
+    return m_minValue;
+}
+
+/**
+ * @brief Gets the largest recorded value
+ * @return Largest recorded value. 0 if nothing was recorded.
+ */
+uint64_t LatencyHistogram::GetMax() const
+{
+    return m_maxValue;
+}
+
+/**
+ * @brief Gets the mean of the recorded values
+ * @return Mean of the recorded values. 0 if nothing was recorded.
+ */
+double LatencyHistogram::GetMean() const
+{
+    return (m_totalCount == 0) ? 0.0 : m_sum / static_cast<double>(m_totalCount);
+}
+
+/**
+ * @brief Gets the value that the given percentage of the recorded values are at or below
+ * @param[in] percentile Percentile, between 0 and 100
+ * @return Highest value of the bucket containing the percentile, clamped to the recorded range.
+ * 0 if nothing was recorded.
+ */
+uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const
+{
+    if (m_totalCount == 0)
+    {
+        return 0;
+    }
+
+    // Nearest rank, like the benchmark percentiles
+    double clampedPercentile = std::clamp(percentile, 0.0, 100.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clampedPercentile / 100.0 * static_cast<double>(m_totalCount))));
+
+    uint64_t cumulativeCount = 0;
+    for (size_t i = 0; i < m_counts.size(); ++i)
+    {
+        cumulativeCount += m_counts[i];
+        if (cumulativeCount >= rank)
+        {
+            return std::clamp(GetBucketHighestValue(i), m_minValue, m_maxValue);
+        }
+    }
+    return m_maxValue;
+}
+
+/**
+ * @brief Gets the bucket that a value is counted in
+ * @param[in] value Value
+ * @return Index of the bucket
+ */
+size_t LatencyHistogram::GetBucketIndex(uint64_t value) const
+{
+    if (value < SUB_BUCKET_COUNT)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    // Keep the SUB_BUCKET_BITS most significant bits. The top one is always set,
+    // so each power of two has SUB_BUCKET_COUNT / 2 buckets.
+    uint32_t highestBit = 0;
+    while ((value >> (highestBit + 1)) != 0)
+    {
+        ++highestBit;
+    }
+    uint32_t shift = highestBit - (SUB_BUCKET_BITS - 1);
+    uint64_t subBucket = (value >> shift) - SUB_BUCKET_COUNT / 2;
+    return static_cast<size_t>(SUB_BUCKET_COUNT + (shift - 1) * (SUB_BUCKET_COUNT / 2) + subBucket);
+}
+
+/**
+ * @brief Gets the highest value counted in a bucket
+ * @param[in] bucketIndex Index of the bucket
+ * @return Highest value of the bucket
+ */
+uint64_t LatencyHistogram::GetBucketHighestValue(size_t bucketIndex) const
+{
+    if (bucketIndex < SUB_BUCKET_COUNT)
+    {
+        return bucketIndex;
+    }
+
+    uint64_t offset = bucketIndex - SUB_BUCKET_COUNT;
+    uint32_t shift = static_cast<uint32_t>(offset / (SUB_BUCKET_COUNT / 2)) + 1;
+    uint64_t topBits = offset % (SUB_BUCKET_COUNT / 2) + SUB_BUCKET_COUNT / 2;
+    return ((topBits + 1) << shift) - 1;
+}
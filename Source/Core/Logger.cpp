@@ -0,0 +1,263 @@
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+thread_local Logger::ThreadBuffer *Logger::s_currentThreadBuffer = nullptr;
+
+/**
+ * @brief Constructor
+ */
+Logger::Logger()
+    : m_minLevel(static_cast<int>(Level::Info))
+    , m_isRunning(false)
+    , m_drainThread()
+    , m_threadBuffers()
+    , m_threadBuffersMutex()
+    , m_outputMutex()
+    , m_wakeMutex()
+    , m_wakeCondition()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+Logger::~Logger()
+{
+    Stop();
+}
+
+/**
+ * @brief Starts the thread that writes the buffered messages
+ */
+void Logger::Start()
+{
+    Logger &logger = GetSingletonInstance();
+    if (logger.m_isRunning.exchange(true))
+    {
+        return;
+    }
+    logger.m_drainThread = std::thread(&Logger::DrainThreadFunc, &logger);
+}
+
+/**
+ * @brief Writes the remaining buffered messages and stops the drain thread.
+ * Messages logged afterwards are written directly.
+ */
+void Logger::Stop()
+{
+    Logger &logger = GetSingletonInstance();
+    if (!logger.m_isRunning.exchange(false))
+    {
+        return;
+    }
+
+    {
+        std::lock_guard lock(logger.m_wakeMutex);
+        logger.m_wakeCondition.notify_one();
+    }
+    logger.m_drainThread.join();
+}
+
+/**
+ * @brief Sets the least severe level that is logged
+ * @param[in] level Level
+ */
+void Logger::SetLevel(Level level)
+{
+    GetSingletonInstance().m_minLevel = static_cast<int>(level);
+}
+
+/**
+ * @brief Checks whether messages of a level are logged
+ * @param[in] level Level
+ * @return Returns true if messages of the level are logged. Returns false otherwise.
+ */
+bool Logger::IsLevelEnabled(Level level)
+{
+    return static_cast<int>(level) >= GetSingletonInstance().m_minLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Logs a message. Use the LOG_* macros instead, so that disabled messages are not formatted.
+ * @param[in] level Severity of the message
+ * @param[in] text Text of the message, without a terminating newline
+ */
+void Logger::Write(Level level, const std::string &text)
+{
+    Logger &logger = GetSingletonInstance();
+    size_t length = std::min(text.size(), MAX_MESSAGE_LENGTH);
+
+    if (!logger.m_isRunning.load(std::memory_order_acquire))
+    {
+        std::lock_guard lock(logger.m_outputMutex);
+        WriteToConsole(level, text.c_str(), length);
+        std::cout.flush();
+        return;
+    }
+
+    // Only this thread writes to its buffer, and only the drain thread reads from it
+    ThreadBuffer &buffer = logger.GetThreadBuffer();
+    uint64_t writeCount = buffer.writeCount.load(std::memory_order_relaxed);
+    uint64_t readCount = buffer.readCount.load(std::memory_order_acquire);
+    if (writeCount - readCount >= buffer.messages.size())
+    {
+        buffer.droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Message &message = buffer.messages[writeCount % buffer.messages.size()];
+    message.level = level;
+    message.timeNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    message.length = static_cast<uint32_t>(length);
+    std::memcpy(message.text, text.data(), length);
+    buffer.writeCount.store(writeCount + 1, std::memory_order_release);
+
+    // Errors are written without waiting for the next drain
+    if (level == Level::Error)
+    {
+        logger.m_wakeCondition.notify_one();
+    }
+}
+
+/**
+ * @brief Parses the name of a level
+ * @param[in] name Name of the level (debug, info, warning or error)
+ * @param[out] outLevel Parsed level
+ * @return Returns true if the name is valid. Returns false otherwise.
+ */
+bool Logger::ParseLevel(const std::string &name, Level &outLevel)
+{
+    if (name == "debug")
+    {
+        outLevel = Level::Debug;
+    }
+    else if (name == "info")
+    {
+        outLevel = Level::Info;
+    }
+    else if (name == "warning")
+    {
+        outLevel = Level::Warning;
+    }
+    else if (name == "error")
+    {
+        outLevel = Level::Error;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the singleton instance
+ * @return Singleton instance
+ */
+Logger& Logger::GetSingletonInstance()
+{
+    static Logger instance;
+    return instance;
+}
+
+/**
+ * @brief Gets the buffer of the current thread, creating it on first use
+ * @return Buffer of the current thread
+ */
+Logger::ThreadBuffer& Logger::GetThreadBuffer()
+{
+    if (s_currentThreadBuffer == nullptr)
+    {
+        std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+        buffer->messages.resize(MESSAGES_PER_THREAD);
+        buffer->writeCount = 0;
+        buffer->readCount = 0;
+        buffer->droppedCount = 0;
+
+        std::lock_guard lock(m_threadBuffersMutex);
+        s_currentThreadBuffer = buffer.get();
+        m_threadBuffers.push_back(std::move(buffer));
+    }
+    return *s_currentThreadBuffer;
+}
+
+/**
+ * @brief Function run by the drain thread
+ */
+void Logger::DrainThreadFunc()
+{
+    while (m_isRunning)
+    {
+        {
+            std::unique_lock lock(m_wakeMutex);
+            m_wakeCondition.wait_for(lock, std::chrono::milliseconds(DRAIN_INTERVAL_MILLISECONDS));
+        }
+        Drain();
+    }
+
+    // Messages logged right before stopping are still written
+    Drain();
+}
+
+/**
+ * @brief Writes the buffered messages of every thread, oldest first
+ */
+void Logger::Drain()
+{
+    // Copy the messages out first, so that the threads can reuse their slots while the console is written
+    std::vector<Message> messages;
+    uint64_t droppedCount = 0;
+    {
+        std::lock_guard lock(m_threadBuffersMutex);
+        for (const std::unique_ptr<ThreadBuffer> &buffer : m_threadBuffers)
+        {
+            uint64_t readCount = buffer->readCount.load(std::memory_order_relaxed);
+            uint64_t writeCount = buffer->writeCount.load(std::memory_order_acquire);
+            for (uint64_t i = readCount; i < writeCount; ++i)
+            {
+                messages.push_back(buffer->messages[i % buffer->messages.size()]);
+            }
+            buffer->readCount.store(writeCount, std::memory_order_release);
+            droppedCount += buffer->droppedCount.exchange(0, std::memory_order_relaxed);
+        }
+    }
+    if (messages.empty() && (droppedCount == 0))
+    {
+        return;
+    }
+
+    // Each thread's messages are already in order, so a stable sort keeps them that way
+    std::stable_sort(messages.begin(), messages.end(), [](const Message &a, const Message &b)
+    {
+        return a.timeNanoseconds < b.timeNanoseconds;
+    });
+
+    std::lock_guard lock(m_outputMutex);
+    for (const Message &message : messages)
+    {
+        WriteToConsole(message.level, message.text, message.length);
+    }
+    if (droppedCount > 0)
+    {
+        std::cerr << "[Logger] " << droppedCount << " messages dropped because a log buffer was full\n";
+    }
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+/**
+ * @brief Writes a message to the console stream of its level
+ * @param[in] level Severity of the message
+ * @param[in] text Text of the message
+ * @param[in] length Number of characters in the text
+ */
+void Logger::WriteToConsole(Level level, const char *text, size_t length)
+{
+    std::ostream &stream = (level >= Level::Warning) ? std::cerr : std::cout;
+    stream.write(text, static_cast<std::streamsize>(length));
+    stream.put('\n');
+}
@@ -0,0 +1,260 @@
+#include "Core/Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+thread_local Profiler::ThreadBuffer *Profiler::s_currentThreadBuffer = nullptr;
+
+namespace
+{
+    /**
+     * @brief Writes a string as a JSON string literal
+     * @param[in] stream Stream to write to
+     * @param[in] value String to write
+     */
+    void WriteJsonString(std::ostream &stream, const std::string &value)
+    {
+        stream << '"';
+        for (char c : value)
+        {
+            if ((c == '"') || (c == '\\'))
+            {
+                stream << '\\';
+            }
+            stream << c;
+        }
+        stream << '"';
+    }
+}
+
+/**
+ * @brief Constructor
+ */
+Profiler::ScopedTimer::ScopedTimer(const char *name)
+    : m_name(Profiler::IsEnabled() ? name : nullptr)
+    , m_startTime()
+{
+    if (m_name != nullptr)
+    {
+        m_startTime = std::chrono::steady_clock::now();
+    }
+}
+
+/**
+ * @brief Destructor
+ */
+Profiler::ScopedTimer::~ScopedTimer()
+{
+    if (m_name != nullptr)
+    {
+        Profiler::AddEvent(m_name, m_startTime, std::chrono::steady_clock::now());
+    }
+}
+
+/**
+ * @brief Constructor
+ */
+Profiler::Profiler()
+    : m_enabled(false)
+    , m_epoch(std::chrono::steady_clock::now())
+    , m_threadBuffers()
+    , m_gpuBuffer()
+    , m_threadBuffersMutex()
+{
+    // The GPU track is listed after every thread
+    m_gpuBuffer = CreateBuffer(UINT32_MAX, "GPU");
+}
+
+/**
+ * @brief Destructor
+ */
+Profiler::~Profiler()
+{
+}
+
+/**
+ * @brief Enables or disables the recording of events. Recorded events are kept.
+ * @param[in] enabled Flag indicating whether events are recorded
+ */
+void Profiler::SetEnabled(bool enabled)
+{
+    GetSingletonInstance().m_enabled = enabled;
+}
+
+/**
+ * @brief Checks whether events are recorded
+ * @return Returns true if events are recorded. Returns false otherwise.
+ */
+bool Profiler::IsEnabled()
+{
+    return GetSingletonInstance().m_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Names the current thread in the exported trace
+ * @param[in] name Name of the thread
+ */
+void Profiler::SetThreadName(const std::string &name)
+{
+    ThreadBuffer &buffer = GetSingletonInstance().GetThreadBuffer();
+    std::lock_guard lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+/**
+ * @brief Records an event on the current thread, if the profiler is enabled
+ * @param[in] name Name of the event
+ * @param[in] startTime Start time
+ * @param[in] endTime End time
+ */
+void Profiler::AddEvent(const char *name, std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.startMicroseconds = ToMicroseconds(startTime);
+    event.durationMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    PushEvent(GetSingletonInstance().GetThreadBuffer(), event);
+}
+
+/**
+ * @brief Records an event on the GPU track, if the profiler is enabled
+ * @param[in] name Name of the event
+ * @param[in] startMicroseconds Start time since the profiler epoch
+ * @param[in] durationMicroseconds Duration
+ */
+void Profiler::AddGpuEvent(const char *name, int64_t startMicroseconds, int64_t durationMicroseconds)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    PushEvent(*GetSingletonInstance().m_gpuBuffer, { name, startMicroseconds, durationMicroseconds });
+}
+
+/**
+ * @brief Converts a point in time to the profiler timeline
+ * @param[in] time Point in time
+ * @return Time since the profiler epoch (in microseconds)
+ */
+int64_t Profiler::ToMicroseconds(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - GetSingletonInstance().m_epoch).count();
+}
+
+/**
+ * @brief Writes the recorded events of every thread as Chrome trace-event JSON
+ * @param[in] filePath Trace file
+ * @return Returns true if the file was written successfully. Returns false otherwise.
+ */
+bool Profiler::ExportChromeTrace(const std::string &filePath)
+{
+    Profiler &profiler = GetSingletonInstance();
+
+    std::ofstream file(filePath, std::ios::trunc);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    std::lock_guard listLock(profiler.m_threadBuffersMutex);
+    std::vector<ThreadBuffer*> buffers;
+    for (const std::unique_ptr<ThreadBuffer> &buffer : profiler.m_threadBuffers)
+    {
+        buffers.push_back(buffer.get());
+    }
+    buffers.push_back(profiler.m_gpuBuffer.get());
+
+    // Complete events ("X") carry their own duration, so no begin/end pairs have to be matched
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool isFirstEvent = true;
+    for (ThreadBuffer *buffer : buffers)
+    {
+        std::lock_guard bufferLock(buffer->mutex);
+
+        file << (isFirstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+        WriteJsonString(file, buffer->threadName);
+        file << "}}";
+        isFirstEvent = false;
+
+        size_t firstIndex = buffer->events.empty() ? 0 : (buffer->nextIndex + buffer->events.size() - buffer->count) % buffer->events.size();
+        for (size_t i = 0; i < buffer->count; ++i)
+        {
+            const Event &event = buffer->events[(firstIndex + i) % buffer->events.size()];
+            file << ",\n{\"name\":";
+            WriteJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":" << event.startMicroseconds
+                << ",\"dur\":" << event.durationMicroseconds << "}";
+        }
+    }
+    file << "\n]}\n";
+    file.close();
+
+    return !file.fail();
+}
+
+/**
+ * @brief Gets the singleton instance
+ * @return Singleton instance
+ */
+Profiler& Profiler::GetSingletonInstance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+/**
+ * @brief Gets the buffer of the current thread, creating it on first use
+ * @return Buffer of the current thread
+ */
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+{
+    if (s_currentThreadBuffer == nullptr)
+    {
+        std::lock_guard lock(m_threadBuffersMutex);
+        uint32_t threadId = static_cast<uint32_t>(m_threadBuffers.size());
+        m_threadBuffers.push_back(CreateBuffer(threadId, "Thread " + std::to_string(threadId)));
+        s_currentThreadBuffer = m_threadBuffers.back().get();
+    }
+    return *s_currentThreadBuffer;
+}
+
+/**
+ * @brief Creates an empty buffer
+ * @param[in] threadId Id of the thread in the exported trace
+ * @param[in] threadName Name of the thread in the exported trace
+ * @return Created buffer
+ */
+std::unique_ptr<Profiler::ThreadBuffer> Profiler::CreateBuffer(uint32_t threadId, const std::string &threadName) const
+{
+    std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+    buffer->threadId = threadId;
+    buffer->threadName = threadName;
+    buffer->nextIndex = 0;
+    buffer->count = 0;
+    return buffer;
+}
+
+/**
+ * @brief Writes an event into a buffer, overwriting the oldest event if it is full
+ * @param[in] buffer Buffer to write to
+ * @param[in] event Event to write
+ */
+void Profiler::PushEvent(ThreadBuffer &buffer, const Event &event)
+{
+    std::lock_guard lock(buffer.mutex);
+
+    // The ring buffer is only allocated once the thread records an event, so a disabled profiler costs no memory
+    if (buffer.events.empty())
+    {
+        buffer.events.resize(GetSingletonInstance().EVENTS_PER_THREAD);
+    }
+    buffer.events[buffer.nextIndex] = event;
+    buffer.nextIndex = (buffer.nextIndex + 1) % buffer.events.size();
+    buffer.count = std::min(buffer.count + 1, buffer.events.size());
+}
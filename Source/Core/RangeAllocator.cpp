@@ -0,0 +1,130 @@
+#include "Core/RangeAllocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+/**
+ * @brief Constructor
+ * @param[in] capacity Size of the whole space
+ */
+RangeAllocator::RangeAllocator(uint32_t capacity)
+    : m_capacity(capacity)
+    , m_allocatedSize(0)
+    , m_freeRanges()
+{
+    Reset();
+}
+
+/**
+ * @brief Destructor
+ */
+RangeAllocator::~RangeAllocator()
+{
+}
+
+/**
+ * @brief Allocates a contiguous range
+ * @param[in] size Size of the range
+ * @param[out] outOffset Offset of the allocated range
+ * @return Returns true if the allocation was successful. Returns false if there is no free range large enough.
+ */
+bool RangeAllocator::Allocate(uint32_t size, uint32_t &outOffset)
+{
+    if (size == 0)
+    {
+        return false;
+    }
+
+    for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it)
+    {
+        if (it->second < size)
+        {
+            continue;
+        }
+
+        // Take the front of the free range, and keep the rest free
+        outOffset = it->first;
+        uint32_t remainingSize = it->second - size;
+        m_freeRanges.erase(it);
+        if (remainingSize > 0)
+        {
+            m_freeRanges[outOffset + size] = remainingSize;
+        }
+        m_allocatedSize += size;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Frees a range previously returned by Allocate()
+ * @param[in] offset Offset of the range
+ * @param[in] size Size of the range
+ */
+void RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+    m_allocatedSize -= size;
+
+    // Merge with the free range right after
+    auto next = m_freeRanges.find(offset + size);
+    if (next != m_freeRanges.end())
+    {
+        size += next->second;
+        m_freeRanges.erase(next);
+    }
+
+    // Merge with the free range right before
+    auto it = m_freeRanges.lower_bound(offset);
+    if (it != m_freeRanges.begin())
+    {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += size;
+            return;
+        }
+    }
+
+    m_freeRanges[offset] = size;
+}
+
+/**
+ * @brief Frees all ranges
+ */
+void RangeAllocator::Reset()
+{
+    m_allocatedSize = 0;
+    m_freeRanges.clear();
+    if (m_capacity > 0)
+    {
+        m_freeRanges[0] = m_capacity;
+    }
+}
+
+/**
+ * @brief Gets the total size of the allocated ranges
+ * @return Allocated size
+ */
+uint32_t RangeAllocator::GetAllocatedSize() const
+{
+    return m_allocatedSize;
+}
+
+/**
+ * @brief Gets the size of the largest free range
+ * @return Size of the largest free range
+ */
+uint32_t RangeAllocator::GetLargestFreeRange() const
+{
+    uint32_t largestSize = 0;
+    for (const auto &pair : m_freeRanges)
+    {
+        largestSize = std::max(largestSize, pair.second);
+    }
+    return largestSize;
+}
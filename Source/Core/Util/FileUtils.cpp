@@ -27,5 +27,32 @@ namespace FileUtils
 
         return true;
     }
-}
 
+    /**
+     * @brief Write an 8-bit RGB image to the specified file in the binary PPM format.
+     * @param[in] filePath File path
+     * @param[in] width Width of the image in pixels
+     * @param[in] height Height of the image in pixels
+     * @param[in] rgbPixels Pixels of the image, row by row from the top, 3 bytes per pixel
+     * @return Returns true if the file was successfully written. Returns false otherwise.
+     */
+    bool WriteImageAsPPM(const std::string& filePath, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgbPixels)
+    {
+        if (rgbPixels.size() < static_cast<size_t>(width) * height * 3)
+        {
+            return false;
+        }
+
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (file.fail())
+        {
+            return false;
+        }
+
+        file << "P6\n" << width << " " << height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(rgbPixels.data()), static_cast<std::streamsize>(static_cast<size_t>(width) * height * 3));
+        file.close();
+
+        return !file.fail();
+    }
+}
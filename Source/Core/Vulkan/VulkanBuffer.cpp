@@ -1,15 +1,19 @@
 #include "Core/Vulkan/VulkanBuffer.hpp"
 
+#include "Core/Logger.hpp"
 #include "Core/Vulkan/VulkanContext.hpp"
 
 #include <vulkan/vulkan_core.h>
 
-#include <iostream>
+#include <set>
 
 /**
  * @brief Constructor
  */
 VulkanBuffer::VulkanBuffer()
+    : m_vkBuffer(VK_NULL_HANDLE)
+    , m_vkMemory(VK_NULL_HANDLE)
+    , m_memorySize(0)
 {
 }
 
@@ -25,19 +29,31 @@ VulkanBuffer::~VulkanBuffer()
  * @param[in] bufferSize Buffer size
  * @param[in] usageFlags Vulkan flags describing how the buffer will be used
  * @param[in] memoryProperties Vulkan memory properties on how the buffer should be allocated in memory
+ * @param[in] queueFamilyIndices Queue families that access the buffer. If these are several distinct
+ * families, the buffer is shared between them concurrently. Otherwise, it is exclusive to one family.
  * @return Returns true if the creation was successful. Returns false otherwise.
  */
-bool VulkanBuffer::Create(VkDeviceSize bufferSize, VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties)
+bool VulkanBuffer::Create(VkDeviceSize bufferSize, VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryProperties, const std::vector<uint32_t> &queueFamilyIndices)
 {
     VkBufferCreateInfo vertexBufferInfo = {};
     vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     vertexBufferInfo.size = bufferSize;
     vertexBufferInfo.usage = usageFlags;
-    vertexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // TODO: Expose as a parameter?
+    vertexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // Sharing the buffer concurrently avoids queue family ownership transfers between the families
+    std::set<uint32_t> uniqueQueueFamilyIndices(queueFamilyIndices.begin(), queueFamilyIndices.end());
+    std::vector<uint32_t> sharedQueueFamilyIndices(uniqueQueueFamilyIndices.begin(), uniqueQueueFamilyIndices.end());
+    if (sharedQueueFamilyIndices.size() > 1)
+    {
+        vertexBufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        vertexBufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(sharedQueueFamilyIndices.size());
+        vertexBufferInfo.pQueueFamilyIndices = sharedQueueFamilyIndices.data();
+    }
 
     if (vkCreateBuffer(VulkanContext::GetLogicalDevice(), &vertexBufferInfo, nullptr, &m_vkBuffer) != VK_SUCCESS)
     {
-        std::cout << "Failed to create buffer!" << std::endl;
+        LOG_ERROR("Failed to create buffer!");
         return false;
     }
 
@@ -52,15 +68,17 @@ bool VulkanBuffer::Create(VkDeviceSize bufferSize, VkBufferUsageFlags usageFlags
     memoryAllocateInfo.allocationSize = memoryRequirements.size;
     if (!FindSuitableMemoryTypeIndex(memoryRequirements.memoryTypeBits, memoryProperties, memoryAllocateInfo.memoryTypeIndex))
     {
-        std::cout << "Failed to find a suitable memory type for the buffer!" << std::endl;
+        LOG_ERROR("Failed to find a suitable memory type for the buffer!");
         return false;
     }
 
     if (vkAllocateMemory(VulkanContext::GetLogicalDevice(), &memoryAllocateInfo, nullptr, &m_vkMemory) != VK_SUCCESS)
     {
-        std::cout << "Failed to allocate memory for the buffer!" << std::endl;
+        LOG_ERROR("Failed to allocate memory for the buffer!");
         return false;
     }
+    m_memorySize = memoryAllocateInfo.allocationSize;
+    VulkanContext::AddAllocatedMemory(m_memorySize);
 
     // --- Bind the buffer to the memory ---
     vkBindBufferMemory(VulkanContext::GetLogicalDevice(), m_vkBuffer, m_vkMemory, 0);
@@ -103,6 +121,9 @@ void VulkanBuffer::Cleanup()
     {
         vkFreeMemory(VulkanContext::GetLogicalDevice(), m_vkMemory, nullptr);
         m_vkMemory = VK_NULL_HANDLE;
+
+        VulkanContext::RemoveAllocatedMemory(m_memorySize);
+        m_memorySize = 0;
     }
 }
 
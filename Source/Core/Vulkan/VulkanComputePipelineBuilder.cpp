@@ -0,0 +1,137 @@
+#include "Core/Vulkan/VulkanComputePipelineBuilder.hpp"
+
+#include "Core/Util/FileUtils.hpp"
+#include "Core/Vulkan/VulkanContext.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+VulkanComputePipelineBuilder::VulkanComputePipelineBuilder()
+    : m_pipelineLayout(VK_NULL_HANDLE)
+    , m_pipeline(VK_NULL_HANDLE)
+    , m_pipelineCache(VK_NULL_HANDLE)
+    , m_pipelineLayoutCreateInfo()
+    , m_computeShaderCreateInfo()
+    , m_computeShaderFilePath()
+{
+    // --- Pipeline layout ---
+    m_pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    m_pipelineLayoutCreateInfo.setLayoutCount = 0;
+    m_pipelineLayoutCreateInfo.pSetLayouts = nullptr;
+    m_pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+    m_pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+    m_pipelineLayoutCreateInfo.flags = 0;
+    m_pipelineLayoutCreateInfo.pNext = nullptr;
+
+    // --- Shaders ---
+    m_computeShaderCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    m_computeShaderCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    m_computeShaderCreateInfo.module = VK_NULL_HANDLE;
+    m_computeShaderCreateInfo.pName = "main";
+    m_computeShaderCreateInfo.pSpecializationInfo = nullptr;
+    m_computeShaderCreateInfo.flags = 0;
+    m_computeShaderCreateInfo.pNext = nullptr;
+}
+
+VulkanComputePipelineBuilder::~VulkanComputePipelineBuilder()
+{
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::SetDescriptorSetLayouts(const std::vector<VkDescriptorSetLayout> &layouts)
+{
+    m_pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(layouts.size());
+    m_pipelineLayoutCreateInfo.pSetLayouts = layouts.data();
+    return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::SetPushConstantRanges(const std::vector<VkPushConstantRange> &ranges)
+{
+    m_pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(ranges.size());
+    m_pipelineLayoutCreateInfo.pPushConstantRanges = ranges.data();
+    return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::SetComputeShaderFilePath(const std::string &filePath)
+{
+    m_computeShaderFilePath = filePath;
+    return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::SetPipelineCache(const VkPipelineCache &pipelineCache)
+{
+    m_pipelineCache = pipelineCache;
+    return *this;
+}
+
+bool VulkanComputePipelineBuilder::Build()
+{
+    VkShaderModule computeShaderModule;
+    if (!CreateShaderModule(m_computeShaderFilePath, VulkanContext::GetLogicalDevice(), computeShaderModule))
+    {
+        return false;
+    }
+
+    m_computeShaderCreateInfo.module = computeShaderModule;
+
+    if (vkCreatePipelineLayout(VulkanContext::GetLogicalDevice(), &m_pipelineLayoutCreateInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), computeShaderModule, nullptr);
+        return false;
+    }
+
+    VkComputePipelineCreateInfo pipelineCreateInfo = {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage = m_computeShaderCreateInfo;
+    pipelineCreateInfo.layout = m_pipelineLayout;
+    pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE; // In case we inherit from an old pipeline
+    pipelineCreateInfo.basePipelineIndex = -1; // Optional
+
+    if (vkCreateComputePipelines(VulkanContext::GetLogicalDevice(), m_pipelineCache, 1, &pipelineCreateInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+    {
+        vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), computeShaderModule, nullptr);
+        vkDestroyPipelineLayout(VulkanContext::GetLogicalDevice(), m_pipelineLayout, nullptr);
+        m_pipelineLayout = VK_NULL_HANDLE;
+        return false;
+    }
+
+    vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), computeShaderModule, nullptr);
+
+    return true;
+}
+
+VkPipelineLayout VulkanComputePipelineBuilder::GetPipelineLayout()
+{
+    return m_pipelineLayout;
+}
+
+VkPipeline VulkanComputePipelineBuilder::GetPipeline()
+{
+    return m_pipeline;
+}
+
+/**
+ * @brief Create a shader module from the provided shader file path.
+ * @param[in] shaderFilePath Shader file path
+ * @param[in] device Logical device
+ * @param[out] outShaderModule Shader module
+ * @return Returns true if the shader module creation was successful. Returns false otherwise.
+ */
+bool VulkanComputePipelineBuilder::CreateShaderModule(const std::string& shaderFilePath, VkDevice device, VkShaderModule& outShaderModule)
+{
+    std::vector<char> shaderData;
+    if (!FileUtils::ReadFileAsBinary(shaderFilePath, shaderData))
+    {
+        return false;
+    }
+
+    VkShaderModuleCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = static_cast<uint32_t>(shaderData.size());
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderData.data());
+
+    if (vkCreateShaderModule(device, &createInfo, nullptr, &outShaderModule) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    return true;
+}
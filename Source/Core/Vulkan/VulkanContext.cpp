@@ -1,7 +1,9 @@
 #include "Core/Vulkan/VulkanContext.hpp"
 
-#include <iostream>
+#include "Core/Logger.hpp"
+
 #include <set>
+#include <string>
 #include <vulkan/vulkan_core.h>
 
 /**
@@ -13,7 +15,7 @@ VulkanContext::~VulkanContext()
 
 /**
  * @brief Initializes the Vulkan manager.
- * @param[in] window GLFW window
+ * @param[in] window GLFW window. If nullptr, the context is headless and has no surface to present to.
  * @return Returns true if the initialization was successful. Returns false otherwise.
  */
 bool VulkanContext::Initialize(GLFWwindow* window)
@@ -83,6 +85,16 @@ VkQueue VulkanContext::GetPresentQueue()
     return GetSingletonInstance().m_vkPresentQueue;
 }
 
+/**
+ * @brief Gets the Vulkan transfer queue. This is a queue of a dedicated transfer
+ * queue family if the device has one, so that uploads can overlap rendering.
+ * @return Returns the Vulkan transfer queue.
+ */
+VkQueue VulkanContext::GetTransferQueue()
+{
+    return GetSingletonInstance().m_vkTransferQueue;
+}
+
 /**
  * @brief Gets the index of the graphics queue family.
  * @return Returns the index of the graphics queue family.
@@ -101,6 +113,60 @@ uint32_t VulkanContext::GetPresentQueueIndex()
     return GetSingletonInstance().m_queueFamilyIndices.presentQueueFamilyIndex.value();
 }
 
+/**
+ * @brief Gets the index of the transfer queue family.
+ * @return Returns the index of the transfer queue family.
+ */
+uint32_t VulkanContext::GetTransferQueueIndex()
+{
+    return GetSingletonInstance().m_queueFamilyIndices.transferQueueFamilyIndex.value();
+}
+
+/**
+ * @brief Gets the physical device features that were enabled on the logical device.
+ * @return Returns the enabled physical device features.
+ */
+const VkPhysicalDeviceFeatures& VulkanContext::GetEnabledFeatures()
+{
+    return GetSingletonInstance().m_enabledFeatures;
+}
+
+/**
+ * @brief Checks whether timeline semaphores were enabled on the logical device.
+ * @return Returns true if timeline semaphores can be used. Returns false otherwise.
+ */
+bool VulkanContext::IsTimelineSemaphoreEnabled()
+{
+    return GetSingletonInstance().m_timelineSemaphoreEnabled;
+}
+
+/**
+ * @brief Records that device memory was allocated. Called by the buffer and image classes.
+ * @param[in] size Size of the allocation
+ */
+void VulkanContext::AddAllocatedMemory(VkDeviceSize size)
+{
+    GetSingletonInstance().m_allocatedMemorySize += size;
+}
+
+/**
+ * @brief Records that device memory was freed. Called by the buffer and image classes.
+ * @param[in] size Size of the freed allocation
+ */
+void VulkanContext::RemoveAllocatedMemory(VkDeviceSize size)
+{
+    GetSingletonInstance().m_allocatedMemorySize -= size;
+}
+
+/**
+ * @brief Gets the total size of the device memory allocated by the buffer and image classes.
+ * @return Size of the allocated memory (in bytes)
+ */
+VkDeviceSize VulkanContext::GetAllocatedMemorySize()
+{
+    return GetSingletonInstance().m_allocatedMemorySize.load();
+}
+
 /**
  * @brief Constructor
  */
@@ -112,6 +178,10 @@ VulkanContext::VulkanContext()
     , m_queueFamilyIndices()
     , m_vkGraphicsQueue(VK_NULL_HANDLE)
     , m_vkPresentQueue(VK_NULL_HANDLE)
+    , m_vkTransferQueue(VK_NULL_HANDLE)
+    , m_enabledFeatures()
+    , m_timelineSemaphoreEnabled(false)
+    , m_allocatedMemorySize(0)
 {
 }
 
@@ -127,7 +197,7 @@ VulkanContext& VulkanContext::GetSingletonInstance()
 
 /**
  * @brief Initialization code implemented as a member function.
- * @param[in] window GLFW window
+ * @param[in] window GLFW window. If nullptr, the context is headless and has no surface to present to.
  * @return Returns true if the initialization was successful. Returns false otherwise.
  */
 bool VulkanContext::InitInternal(GLFWwindow* window)
@@ -145,35 +215,46 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     applicationInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     applicationInfo.pEngineName = "No Engine";
     applicationInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    applicationInfo.apiVersion = VK_API_VERSION_1_1;
+    applicationInfo.apiVersion = VK_API_VERSION_1_2; // Devices that only support 1.1 still work, just without timeline semaphores
 
     VkInstanceCreateInfo instanceCreateInfo = {};
     instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     instanceCreateInfo.pApplicationInfo = &applicationInfo;
 
-    // Get GLFW required extensions for vulkan and include them in the instance creation
+    // Get GLFW required extensions for vulkan and include them in the instance creation.
+    // A headless context does not present, so it needs no surface extensions.
     uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensionNames = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    const char** glfwExtensionNames = nullptr;
+    if (window != nullptr)
+    {
+        glfwExtensionNames = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    }
     instanceCreateInfo.enabledExtensionCount = glfwExtensionCount;
     instanceCreateInfo.ppEnabledExtensionNames = glfwExtensionNames;
 
-    // Include validation layers
-    // TODO: Have a check whether the validation layer is supported or not
-    instanceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
-    instanceCreateInfo.ppEnabledLayerNames = validationLayers.data();
+    // Include validation layers if they are installed (build machines often only have the driver)
+    if (CheckInstanceLayerSupport(validationLayers))
+    {
+        instanceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
+        instanceCreateInfo.ppEnabledLayerNames = validationLayers.data();
+    }
+    else
+    {
+        LOG_WARNING("[VulkanContext] Validation layers are not available");
+    }
 
     VkResult instanceCreateResult = vkCreateInstance(&instanceCreateInfo, nullptr, &m_vkInstance);
     if (instanceCreateResult != VK_SUCCESS)
     {
-        std::cerr << "[VulkanContext] Failed to create Vulkan instance!" << std::endl;
+        LOG_ERROR("[VulkanContext] Failed to create Vulkan instance!");
         Cleanup();
         return false;
     }
 
     // --- Create surface ---
-    if (glfwCreateWindowSurface(m_vkInstance, window, nullptr, &m_vkSurface) != VK_SUCCESS)
+    if ((window != nullptr) && (glfwCreateWindowSurface(m_vkInstance, window, nullptr, &m_vkSurface) != VK_SUCCESS))
     {
-        std::cerr << "[VulkanContext] Failed to create GLFW window surface!" << std::endl;
+        LOG_ERROR("[VulkanContext] Failed to create GLFW window surface!");
         Cleanup();
         return false;
     }
@@ -183,14 +264,17 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     // (To be used when creating the logical device)
     std::vector<const char*> requiredExtensionNames =
     {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME // To allow the use of gl_BaseInstance in the shader
     };
+    if (window != nullptr)
+    {
+        requiredExtensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
-    m_vkPhysicalDevice = GetFirstSuitablePhysicalDevice(m_vkInstance, requiredExtensionNames);
+    m_vkPhysicalDevice = GetMostSuitablePhysicalDevice(m_vkInstance, requiredExtensionNames);
     if (m_vkPhysicalDevice == VK_NULL_HANDLE)
     {
-        std::cerr << "[VulkanContext] Failed to find suitable graphics card!" << std::endl;
+        LOG_ERROR("[VulkanContext] Failed to find suitable graphics card!");
         CleanupInternal();
         return false;
     }
@@ -201,7 +285,8 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     std::set<uint32_t> uniqueQueueFamilyIndices =
     {
         m_queueFamilyIndices.graphicsQueueFamilyIndex.value(),
-        m_queueFamilyIndices.presentQueueFamilyIndex.value()
+        m_queueFamilyIndices.presentQueueFamilyIndex.value(),
+        m_queueFamilyIndices.transferQueueFamilyIndex.value()
     };
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfoStructs;
     for (uint32_t queueFamilyIndex : uniqueQueueFamilyIndices)
@@ -215,12 +300,35 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
         queueCreateInfoStructs.back().pQueuePriorities = &queuePriority;
     }
 
+    // Only enable the optional features that the device actually supports
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(m_vkPhysicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures physicalDeviceFeatures = {};
-    physicalDeviceFeatures.samplerAnisotropy = VK_TRUE; // Enable anisotropic filtering
+    physicalDeviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy; // Enable anisotropic filtering
+    physicalDeviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect; // Allow multiple draws per indirect draw call
+    m_enabledFeatures = physicalDeviceFeatures;
+
+    // Timeline semaphores are core since Vulkan 1.2, but still an optional feature there
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_vkPhysicalDevice, &physicalDeviceProperties);
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures = {};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    if (physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2)
+    {
+        VkPhysicalDeviceFeatures2 supportedFeatures2 = {};
+        supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures2.pNext = &timelineSemaphoreFeatures;
+        vkGetPhysicalDeviceFeatures2(m_vkPhysicalDevice, &supportedFeatures2);
+        timelineSemaphoreFeatures.pNext = nullptr;
+    }
+    m_timelineSemaphoreEnabled = (timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE);
 
     // --- Create a logical device associated with the physical device ---
     VkDeviceCreateInfo logicalDeviceCreateInfo = {};
     logicalDeviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    logicalDeviceCreateInfo.pNext = m_timelineSemaphoreEnabled ? &timelineSemaphoreFeatures : nullptr;
     logicalDeviceCreateInfo.pEnabledFeatures = &physicalDeviceFeatures;
     logicalDeviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfoStructs.size());
     logicalDeviceCreateInfo.pQueueCreateInfos = queueCreateInfoStructs.data();
@@ -229,7 +337,7 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     logicalDeviceCreateInfo.enabledLayerCount = 0;
     if (vkCreateDevice(m_vkPhysicalDevice, &logicalDeviceCreateInfo, nullptr, &m_vkLogicalDevice) != VK_SUCCESS)
     {
-        std::cerr << "[VulkanContext] Failed to create logical device!" << std::endl;
+        LOG_ERROR("[VulkanContext] Failed to create logical device!");
         CleanupInternal();
         return false;
     }
@@ -237,6 +345,12 @@ bool VulkanContext::InitInternal(GLFWwindow* window)
     // --- Get handles to the device queues that we just created ---
     vkGetDeviceQueue(m_vkLogicalDevice, m_queueFamilyIndices.graphicsQueueFamilyIndex.value(), 0, &m_vkGraphicsQueue);
     vkGetDeviceQueue(m_vkLogicalDevice, m_queueFamilyIndices.presentQueueFamilyIndex.value(), 0, &m_vkPresentQueue);
+    vkGetDeviceQueue(m_vkLogicalDevice, m_queueFamilyIndices.transferQueueFamilyIndex.value(), 0, &m_vkTransferQueue);
+
+    if (m_queueFamilyIndices.transferQueueFamilyIndex != m_queueFamilyIndices.graphicsQueueFamilyIndex)
+    {
+        LOG_INFO("[VulkanContext] Using dedicated transfer queue family " << m_queueFamilyIndices.transferQueueFamilyIndex.value());
+    }
 
     return true;
 }
@@ -269,14 +383,18 @@ void VulkanContext::CleanupInternal()
 }
 
 /**
- * @brief Get the first graphics card that is suitable for our application.
+ * @brief Gets the most suitable graphics card for our application. Discrete GPUs are preferred,
+ * followed by integrated GPUs, virtual GPUs, and finally software (CPU) implementations.
  * @param[in] instance Vulkan instance
  * @param[in] requiredExtensions Required extensions if any
  * @return Handle to the graphics card that we found suitable. If a suitable
  * device was not found, returns VK_NULL_HANDLE.
  */
-VkPhysicalDevice VulkanContext::GetFirstSuitablePhysicalDevice(const VkInstance& instance, const std::vector<const char*>& requiredExtensions)
+VkPhysicalDevice VulkanContext::GetMostSuitablePhysicalDevice(const VkInstance& instance, const std::vector<const char*>& requiredExtensions)
 {
+    VkPhysicalDevice bestPhysicalDevice = VK_NULL_HANDLE;
+    int bestScore = 0;
+
     // First query the number of graphics card in the system
     uint32_t physicalDeviceCount = 0;
     vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr);
@@ -286,8 +404,8 @@ VkPhysicalDevice VulkanContext::GetFirstSuitablePhysicalDevice(const VkInstance&
         std::vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
         vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, physicalDevices.data());
 
-        // Go through each physical device, and check whether it is suitable or not.
-        // Once we find one, we return the device immediately.
+        // Go through each physical device, and give each suitable one a score
+        // based on its type. The highest scoring one is returned.
         for (const VkPhysicalDevice& physicalDevice : physicalDevices)
         {
             // Check if the graphics card supported the provided extensions.
@@ -297,35 +415,51 @@ VkPhysicalDevice VulkanContext::GetFirstSuitablePhysicalDevice(const VkInstance&
                 continue;
             }
 
+            QueueFamilyIndices indices = GetQueueFamilyIndices(physicalDevice, m_vkSurface);
+            if (!indices.graphicsQueueFamilyIndex.has_value() || !indices.presentQueueFamilyIndex.has_value())
+            {
+                continue;
+            }
+
             // Query physical device properties
             VkPhysicalDeviceProperties physicalDeviceProperties;
             vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
 
-            // Query physical device features
-            VkPhysicalDeviceFeatures physicalDeviceFeatures;
-            vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures);
-
-            // Check for anisotropic filtering capability (most GPUs nowadays should support this)
-            if (!physicalDeviceFeatures.samplerAnisotropy)
+            int score = 0;
+            switch (physicalDeviceProperties.deviceType)
             {
-                continue;
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+                score = 4;
+                break;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+                score = 3;
+                break;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+                score = 2;
+                break;
+            default:
+                // Software implementations (e.g. lavapipe, SwiftShader) so that the
+                // application can still run on machines without a GPU
+                score = 1;
+                break;
             }
 
-            // We can have a scoring system for each physical device and get the highest scoring
-            // one (criteria depends on our requirements). But for now, we'll just settle with the
-            // first discrete GPU that we find.
-            if (physicalDeviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+            if (score > bestScore)
             {
-                QueueFamilyIndices indices = GetQueueFamilyIndices(physicalDevice, m_vkSurface);
-                if (indices.graphicsQueueFamilyIndex.has_value() && indices.presentQueueFamilyIndex.has_value())
-                {
-                    return physicalDevice;
-                }
+                bestScore = score;
+                bestPhysicalDevice = physicalDevice;
             }
         }
     }
 
-    return VK_NULL_HANDLE;
+    if (bestPhysicalDevice != VK_NULL_HANDLE)
+    {
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(bestPhysicalDevice, &physicalDeviceProperties);
+        LOG_INFO("[VulkanContext] Using " << physicalDeviceProperties.deviceName);
+    }
+
+    return bestPhysicalDevice;
 }
 
 /**
@@ -352,6 +486,28 @@ bool VulkanContext::CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice,
     return extensionNamesSet.empty();
 }
 
+/**
+ * @brief Checks whether all the provided instance layers are installed.
+ * @param[in] layerNames List of layer names to check support
+ * @return Returns true if all the provided layers are supported. Returns false otherwise.
+ */
+bool VulkanContext::CheckInstanceLayerSupport(const std::vector<const char*>& layerNames)
+{
+    uint32_t numSupportedLayers = 0;
+    vkEnumerateInstanceLayerProperties(&numSupportedLayers, nullptr);
+
+    std::vector<VkLayerProperties> supportedLayers(numSupportedLayers);
+    vkEnumerateInstanceLayerProperties(&numSupportedLayers, supportedLayers.data());
+
+    std::set<std::string> layerNamesSet(layerNames.begin(), layerNames.end());
+    for (const VkLayerProperties& layer : supportedLayers)
+    {
+        layerNamesSet.erase(layer.layerName);
+    }
+
+    return layerNamesSet.empty();
+}
+
 /**
  * @brief Get the indices of each queue type in the physical device's queue family.
  * @param[in] physicalDevice Physical device
@@ -367,27 +523,63 @@ VulkanContext::QueueFamilyIndices VulkanContext::GetQueueFamilyIndices(VkPhysica
     std::vector<VkQueueFamilyProperties> queueFamilyProperties(numQueueFamilies);
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &numQueueFamilies, queueFamilyProperties.data());
 
+    int bestTransferScore = 0;
     for (uint32_t i = 0; i < queueFamilyProperties.size(); ++i)
     {
-        // Check if the queue family supports graphics capabilities
-        if (queueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        VkQueueFlags queueFlags = queueFamilyProperties[i].queueFlags;
+
+        // The remaining families are only searched for a transfer queue family
+        // once both a graphics and a present queue family were found
+        if (!ret.graphicsQueueFamilyIndex.has_value() || !ret.presentQueueFamilyIndex.has_value())
         {
-            ret.graphicsQueueFamilyIndex = i;
+            // Check if the queue family supports graphics capabilities
+            if (queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            {
+                ret.graphicsQueueFamilyIndex = i;
+            }
+
+            // Check if the queue family supports presentation capabilities.
+            // Without a surface nothing is presented, so the graphics family stands in for it.
+            VkBool32 presentationSupport = false;
+            if (surface != VK_NULL_HANDLE)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentationSupport);
+            }
+            else
+            {
+                presentationSupport = ((queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0);
+            }
+            if (presentationSupport)
+            {
+                ret.presentQueueFamilyIndex = i;
+            }
         }
 
-        // Check if the queue family supports presentation capabilities
-        VkBool32 presentationSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentationSupport);
-        if (presentationSupport)
+        // Graphics and compute queues support transfers even without the transfer bit.
+        // Families that do not render are preferred, since their work can run alongside rendering.
+        int transferScore = 0;
+        if ((queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0)
         {
-            ret.presentQueueFamilyIndex = i;
+            if ((queueFlags & VK_QUEUE_COMPUTE_BIT) != 0)
+            {
+                transferScore = 2;
+            }
+            else if ((queueFlags & VK_QUEUE_TRANSFER_BIT) != 0)
+            {
+                transferScore = 3;
+            }
         }
-
-        if (ret.graphicsQueueFamilyIndex.has_value() && ret.presentQueueFamilyIndex.has_value())
+        if ((transferScore > bestTransferScore) && (queueFamilyProperties[i].queueCount > 0))
         {
-            break;
+            bestTransferScore = transferScore;
+            ret.transferQueueFamilyIndex = i;
         }
     }
 
+    if (!ret.transferQueueFamilyIndex.has_value())
+    {
+        ret.transferQueueFamilyIndex = ret.graphicsQueueFamilyIndex;
+    }
+
     return ret;
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "Core/Vulkan/VulkanGpuTimer.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
+#include "Core/Vulkan/VulkanContext.hpp"
+
+#include <chrono>
+
+/**
+ * @brief Constructor
+ */
+VulkanGpuTimer::VulkanGpuTimer()
+    : m_queryPool(VK_NULL_HANDLE)
+    , m_maxZonesPerFrame(0)
+    , m_timestampPeriod(0.0)
+    , m_timestampMask(0)
+    , m_calibrationTimestamp(0)
+    , m_calibrationMicroseconds(0)
+    , m_frames()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VulkanGpuTimer::~VulkanGpuTimer()
+{
+}
+
+/**
+ * @brief Creates the query pool, and calibrates the timestamps against the CPU clock
+ * by submitting a timestamp to the graphics queue and waiting for it.
+ * @param[in] frameCount Number of frames in flight
+ * @param[in] maxZonesPerFrame Maximum number of zones per frame
+ * @return Returns true if the creation was successful. Returns false otherwise,
+ * e.g. if the graphics queue does not support timestamps.
+ */
+bool VulkanGpuTimer::Create(uint32_t frameCount, uint32_t maxZonesPerFrame)
+{
+    // Timestamps have to be supported by the graphics queue family
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanContext::GetPhysicalDevice(), &properties);
+    uint32_t numQueueFamilies = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanContext::GetPhysicalDevice(), &numQueueFamilies, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties(numQueueFamilies);
+    vkGetPhysicalDeviceQueueFamilyProperties(VulkanContext::GetPhysicalDevice(), &numQueueFamilies, queueFamilyProperties.data());
+
+    uint32_t queueFamilyIndex = VulkanContext::GetGraphicsQueueIndex();
+    uint32_t validBits = queueFamilyProperties[queueFamilyIndex].timestampValidBits;
+    if ((properties.limits.timestampPeriod <= 0.0f) || (validBits == 0))
+    {
+        LOG_WARNING("[VulkanGpuTimer] Timestamps are not supported by the graphics queue");
+        return false;
+    }
+    m_timestampPeriod = properties.limits.timestampPeriod;
+    m_timestampMask = (validBits >= 64) ? UINT64_MAX : ((uint64_t(1) << validBits) - 1);
+
+    // Two timestamps per zone: at the start and at the end. One more for the calibration.
+    m_maxZonesPerFrame = maxZonesPerFrame;
+    VkQueryPoolCreateInfo queryPoolInfo = {};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = frameCount * maxZonesPerFrame * 2 + 1;
+    if (vkCreateQueryPool(VulkanContext::GetLogicalDevice(), &queryPoolInfo, nullptr, &m_queryPool) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanGpuTimer] Failed to create timestamp query pool!");
+        return false;
+    }
+
+    m_frames.assign(frameCount, { {}, 0, false });
+
+    if (!Calibrate(queueFamilyIndex))
+    {
+        LOG_ERROR("[VulkanGpuTimer] Failed to calibrate timestamps!");
+        Cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cleans up all resources used by the timer.
+ */
+void VulkanGpuTimer::Cleanup()
+{
+    vkDestroyQueryPool(VulkanContext::GetLogicalDevice(), m_queryPool, nullptr);
+    m_queryPool = VK_NULL_HANDLE;
+    m_frames.clear();
+}
+
+/**
+ * @brief Checks whether the timer was created successfully
+ * @return Returns true if zones can be measured. Returns false otherwise.
+ */
+bool VulkanGpuTimer::IsAvailable() const
+{
+    return m_queryPool != VK_NULL_HANDLE;
+}
+
+/**
+ * @brief Resets the queries of a frame in flight. Must be recorded before any zone of the frame,
+ * outside of a render pass, and after the results of the frame's previous commands were read.
+ * @param[in] commandBuffer Command buffer of the frame
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] frameNumber Number of the frame
+ */
+void VulkanGpuTimer::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint64_t frameNumber)
+{
+    if (m_queryPool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    FrameZones &frame = m_frames[frameIndex];
+    frame.zones.clear();
+    frame.frameNumber = frameNumber;
+    frame.isSubmitted = false;
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, frameIndex * m_maxZonesPerFrame * 2, m_maxZonesPerFrame * 2);
+}
+
+/**
+ * @brief Writes the start timestamp of a zone
+ * @param[in] commandBuffer Command buffer of the frame
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] name Name of the zone. Must outlive the timer.
+ * @return Index of the zone, to end it with. UINT32_MAX if the frame has no queries left.
+ */
+uint32_t VulkanGpuTimer::BeginZone(VkCommandBuffer commandBuffer, uint32_t frameIndex, const char *name)
+{
+    if ((m_queryPool == VK_NULL_HANDLE) || (m_frames[frameIndex].zones.size() >= m_maxZonesPerFrame))
+    {
+        return UINT32_MAX;
+    }
+
+    FrameZones &frame = m_frames[frameIndex];
+    uint32_t zoneIndex = static_cast<uint32_t>(frame.zones.size());
+    uint32_t firstQuery = (frameIndex * m_maxZonesPerFrame + zoneIndex) * 2;
+    frame.zones.push_back({ name, firstQuery });
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, firstQuery);
+    return zoneIndex;
+}
+
+/**
+ * @brief Writes the end timestamp of a zone
+ * @param[in] commandBuffer Command buffer of the frame
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[in] zoneIndex Index of the zone returned when it was started
+ */
+void VulkanGpuTimer::EndZone(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t zoneIndex)
+{
+    if ((m_queryPool == VK_NULL_HANDLE) || (zoneIndex >= m_frames[frameIndex].zones.size()))
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, m_frames[frameIndex].zones[zoneIndex].firstQuery + 1);
+}
+
+/**
+ * @brief Marks the commands of a frame as submitted, so that their results are read back
+ * @param[in] frameIndex Index of the frame in flight
+ */
+void VulkanGpuTimer::SetSubmitted(uint32_t frameIndex)
+{
+    if (m_queryPool != VK_NULL_HANDLE)
+    {
+        m_frames[frameIndex].isSubmitted = true;
+    }
+}
+
+/**
+ * @brief Reads back the zones of the frame's last submitted commands, once. Must only be called
+ * after the frame's fence was waited on.
+ * @param[in] frameIndex Index of the frame in flight
+ * @param[out] outFrameNumber Number of the frame that wrote the zones
+ * @param[out] outResults Measured zones
+ * @return Returns true if there were results to read. Returns false otherwise.
+ */
+bool VulkanGpuTimer::GetResults(uint32_t frameIndex, uint64_t &outFrameNumber, std::vector<ZoneResult> &outResults)
+{
+    outResults.clear();
+    if ((m_queryPool == VK_NULL_HANDLE) || !m_frames[frameIndex].isSubmitted || m_frames[frameIndex].zones.empty())
+    {
+        return false;
+    }
+
+    FrameZones &frame = m_frames[frameIndex];
+    frame.isSubmitted = false;
+    outFrameNumber = frame.frameNumber;
+
+    // Every zone of the frame uses consecutive queries from the start of its range
+    std::vector<uint64_t> timestamps(frame.zones.size() * 2);
+    VkResult result = vkGetQueryPoolResults
+    (
+        VulkanContext::GetLogicalDevice(),
+        m_queryPool,
+        frame.zones.front().firstQuery,
+        static_cast<uint32_t>(timestamps.size()),
+        timestamps.size() * sizeof(uint64_t),
+        timestamps.data(),
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT
+    );
+    if (result != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < frame.zones.size(); ++i)
+    {
+        uint64_t start = timestamps[i * 2] & m_timestampMask;
+        uint64_t end = timestamps[i * 2 + 1] & m_timestampMask;
+
+        ZoneResult zoneResult;
+        zoneResult.name = frame.zones[i].name;
+        zoneResult.startMicroseconds = m_calibrationMicroseconds
+            + static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(start - m_calibrationTimestamp)) * m_timestampPeriod / 1000.0);
+        zoneResult.durationMilliseconds = static_cast<double>((end - start) & m_timestampMask) * m_timestampPeriod / 1000000.0;
+        outResults.push_back(zoneResult);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes a timestamp and waits for it, to pair a timestamp value with a CPU time
+ * @param[in] queueFamilyIndex Queue family of the graphics queue
+ * @return Returns true if the calibration was successful. Returns false otherwise.
+ */
+bool VulkanGpuTimer::Calibrate(uint32_t queueFamilyIndex)
+{
+    VkDevice device = VulkanContext::GetLogicalDevice();
+
+    VkCommandPoolCreateInfo commandPoolInfo = {};
+    commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    commandPoolInfo.queueFamilyIndex = queueFamilyIndex;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    if (vkCreateCommandPool(device, &commandPoolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence = VK_NULL_HANDLE;
+    bool success = (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) == VK_SUCCESS)
+        && (vkCreateFence(device, &fenceInfo, nullptr, &fence) == VK_SUCCESS);
+
+    // The calibration query is the last one of the pool
+    uint32_t calibrationQuery = static_cast<uint32_t>(m_frames.size()) * m_maxZonesPerFrame * 2;
+    if (success)
+    {
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        vkCmdResetQueryPool(commandBuffer, m_queryPool, calibrationQuery, 1);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, calibrationQuery);
+        success = (vkEndCommandBuffer(commandBuffer) == VK_SUCCESS);
+    }
+
+    // The timestamp is written somewhere between the submission and the fence wait returning,
+    // so the middle of both is the best estimate of the matching CPU time
+    if (success)
+    {
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        std::chrono::steady_clock::time_point submitTime = std::chrono::steady_clock::now();
+        success = (vkQueueSubmit(VulkanContext::GetGraphicsQueue(), 1, &submitInfo, fence) == VK_SUCCESS)
+            && (vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS);
+        std::chrono::steady_clock::time_point doneTime = std::chrono::steady_clock::now();
+
+        m_calibrationMicroseconds = (Profiler::ToMicroseconds(submitTime) + Profiler::ToMicroseconds(doneTime)) / 2;
+    }
+
+    if (success)
+    {
+        success = (vkGetQueryPoolResults(device, m_queryPool, calibrationQuery, 1, sizeof(uint64_t), &m_calibrationTimestamp, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS);
+        m_calibrationTimestamp &= m_timestampMask;
+    }
+
+    vkDestroyFence(device, fence, nullptr);
+    vkDestroyCommandPool(device, commandPool, nullptr);
+    return success;
+}
@@ -8,6 +8,7 @@
 VulkanGraphicsPipelineBuilder::VulkanGraphicsPipelineBuilder()
     : m_pipelineLayout(VK_NULL_HANDLE)
     , m_pipeline(VK_NULL_HANDLE)
+    , m_pipelineCache(VK_NULL_HANDLE)
     , m_vertexInputCreateInfo()
     , m_inputAssemblyCreateInfo()
     , m_viewportCreateInfo()
@@ -19,6 +20,8 @@ VulkanGraphicsPipelineBuilder::VulkanGraphicsPipelineBuilder()
     , m_pipelineLayoutCreateInfo()
     , m_vertexShaderCreateInfo()
     , m_fragmentShaderCreateInfo()
+    , m_vertexSpecializationInfo()
+    , m_fragmentSpecializationInfo()
     , m_colorBlendAttachment()
     , m_vertexShaderFilePath()
     , m_fragmentShaderFilePath()
@@ -128,6 +131,17 @@ VulkanGraphicsPipelineBuilder::VulkanGraphicsPipelineBuilder()
     m_fragmentShaderCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     m_fragmentShaderCreateInfo.module = VK_NULL_HANDLE;
     m_fragmentShaderCreateInfo.pName = "main";
+
+    // --- Specialization constants ---
+    m_vertexSpecializationInfo.mapEntryCount = 0;
+    m_vertexSpecializationInfo.pMapEntries = nullptr;
+    m_vertexSpecializationInfo.dataSize = 0;
+    m_vertexSpecializationInfo.pData = nullptr;
+
+    m_fragmentSpecializationInfo.mapEntryCount = 0;
+    m_fragmentSpecializationInfo.pMapEntries = nullptr;
+    m_fragmentSpecializationInfo.dataSize = 0;
+    m_fragmentSpecializationInfo.pData = nullptr;
 }
 
 VulkanGraphicsPipelineBuilder::~VulkanGraphicsPipelineBuilder()
@@ -216,6 +230,17 @@ VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetDepthCompareOp(
     return *this;
 }
 
+VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetAlphaBlendingEnabled(const VkBool32 &flag)
+{
+    // Standard "over" blending with non-premultiplied alpha
+    m_colorBlendAttachment.blendEnable = flag;
+    m_colorBlendAttachment.srcColorBlendFactor = (flag == VK_TRUE) ? VK_BLEND_FACTOR_SRC_ALPHA : VK_BLEND_FACTOR_ONE;
+    m_colorBlendAttachment.dstColorBlendFactor = (flag == VK_TRUE) ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA : VK_BLEND_FACTOR_ZERO;
+    m_colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    m_colorBlendAttachment.dstAlphaBlendFactor = (flag == VK_TRUE) ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA : VK_BLEND_FACTOR_ZERO;
+    return *this;
+}
+
 VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetDynamicStates(const std::vector<VkDynamicState> &dynamicStates)
 {
     m_dynamicStateCreateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
@@ -249,12 +274,38 @@ VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetFragmentShaderF
     return *this;
 }
 
+VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetVertexShaderSpecialization(const std::vector<VkSpecializationMapEntry> &mapEntries, const void *data, size_t dataSize)
+{
+    m_vertexSpecializationInfo.mapEntryCount = static_cast<uint32_t>(mapEntries.size());
+    m_vertexSpecializationInfo.pMapEntries = mapEntries.data();
+    m_vertexSpecializationInfo.dataSize = dataSize;
+    m_vertexSpecializationInfo.pData = data;
+    m_vertexShaderCreateInfo.pSpecializationInfo = &m_vertexSpecializationInfo;
+    return *this;
+}
+
+VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetFragmentShaderSpecialization(const std::vector<VkSpecializationMapEntry> &mapEntries, const void *data, size_t dataSize)
+{
+    m_fragmentSpecializationInfo.mapEntryCount = static_cast<uint32_t>(mapEntries.size());
+    m_fragmentSpecializationInfo.pMapEntries = mapEntries.data();
+    m_fragmentSpecializationInfo.dataSize = dataSize;
+    m_fragmentSpecializationInfo.pData = data;
+    m_fragmentShaderCreateInfo.pSpecializationInfo = &m_fragmentSpecializationInfo;
+    return *this;
+}
+
 VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetRenderPass(const VkRenderPass &renderPass)
 {
     m_renderPass = renderPass;
     return *this;
 }
 
+VulkanGraphicsPipelineBuilder& VulkanGraphicsPipelineBuilder::SetPipelineCache(const VkPipelineCache &pipelineCache)
+{
+    m_pipelineCache = pipelineCache;
+    return *this;
+}
+
 bool VulkanGraphicsPipelineBuilder::Build()
 {
     // Create shader modules for the vertex and fragment shaders
@@ -301,7 +352,7 @@ bool VulkanGraphicsPipelineBuilder::Build()
     pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE; // In case we inherit from an old pipeline
     pipelineCreateInfo.basePipelineIndex = -1; // Optional
 
-    if (vkCreateGraphicsPipelines(VulkanContext::GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+    if (vkCreateGraphicsPipelines(VulkanContext::GetLogicalDevice(), m_pipelineCache, 1, &pipelineCreateInfo, nullptr, &m_pipeline) != VK_SUCCESS)
     {
         vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), vertexShaderModule, nullptr);
         vkDestroyShaderModule(VulkanContext::GetLogicalDevice(), fragmentShaderModule, nullptr);
@@ -1,8 +1,8 @@
 #include "Core/Vulkan/VulkanImage.hpp"
 
+#include "Core/Logger.hpp"
 #include "Core/Vulkan/VulkanContext.hpp"
 
-#include <iostream>
 
 /**
  * @brief Constructor
@@ -10,6 +10,7 @@
 VulkanImage::VulkanImage()
     : m_vkImage(VK_NULL_HANDLE)
     , m_vkMemory(VK_NULL_HANDLE)
+    , m_memorySize(0)
 {
 }
 
@@ -50,7 +51,7 @@ bool VulkanImage::Create(const uint32_t& width, const uint32_t& height, VkFormat
 
     if (vkCreateImage(VulkanContext::GetLogicalDevice(), &imageInfo, nullptr, &m_vkImage) != VK_SUCCESS)
     {
-        std::cout << "Failed to create image!" << std::endl;
+        LOG_ERROR("Failed to create image!");
         return false;
     }
 
@@ -63,9 +64,11 @@ bool VulkanImage::Create(const uint32_t& width, const uint32_t& height, VkFormat
     FindSuitableMemoryTypeIndex(memoryRequirements.memoryTypeBits, memoryProperties, allocInfo.memoryTypeIndex);
     if (vkAllocateMemory(VulkanContext::GetLogicalDevice(), &allocInfo, nullptr, &m_vkMemory) != VK_SUCCESS)
     {
-        std::cout << "Failed to allocate memory for the image!" << std::endl;
+        LOG_ERROR("Failed to allocate memory for the image!");
         return false;
     }
+    m_memorySize = allocInfo.allocationSize;
+    VulkanContext::AddAllocatedMemory(m_memorySize);
 
     vkBindImageMemory(VulkanContext::GetLogicalDevice(), m_vkImage, m_vkMemory, 0);
 
@@ -86,6 +89,9 @@ void VulkanImage::Cleanup()
     {
         vkFreeMemory(VulkanContext::GetLogicalDevice(), m_vkMemory, nullptr);
         m_vkMemory = VK_NULL_HANDLE;
+
+        VulkanContext::RemoveAllocatedMemory(m_memorySize);
+        m_memorySize = 0;
     }
 }
 
@@ -1,8 +1,8 @@
 #include "Core/Vulkan/VulkanImageView.hpp"
 
+#include "Core/Logger.hpp"
 #include "Core/Vulkan/VulkanContext.hpp"
 
-#include <iostream>
 
 /**
  * @brief Constructor
@@ -47,7 +47,7 @@ bool VulkanImageView::Create(VkImage image, VkFormat format, VkImageAspectFlags
 
     if (vkCreateImageView(VulkanContext::GetLogicalDevice(), &imageViewCreateInfo, nullptr, &m_vkImageView) != VK_SUCCESS)
     {
-        std::cout << " FAILED!" << std::endl;
+        LOG_ERROR("[VulkanImageView] Failed to create image view!");
         return false;
     }
 
@@ -0,0 +1,178 @@
+#include "Core/Vulkan/VulkanPipelineCache.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Util/FileUtils.hpp"
+#include "Core/Vulkan/VulkanContext.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+/**
+ * @brief Constructor
+ */
+VulkanPipelineCache::VulkanPipelineCache()
+    : m_vkPipelineCache(VK_NULL_HANDLE)
+    , m_filePath()
+    , m_loadedDataSize(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+}
+
+/**
+ * @brief Creates the pipeline cache, with the data of the cache file if it is valid for the current device.
+ * @param[in] filePath Path of the cache file
+ * @return Returns true if the creation was successful, even if the cache file was missing or invalid.
+ * Returns false otherwise.
+ */
+bool VulkanPipelineCache::Create(const std::string &filePath)
+{
+    m_filePath = filePath;
+    m_loadedDataSize = 0;
+
+    // Data saved by another device or driver version is ignored, and the cache starts empty
+    std::vector<char> fileContents;
+    const char *initialData = nullptr;
+    if (FileUtils::ReadFileAsBinary(filePath, fileContents) && (fileContents.size() >= sizeof(FileHeader)))
+    {
+        FileHeader fileHeader;
+        std::memcpy(&fileHeader, fileContents.data(), sizeof(FileHeader));
+
+        FileHeader deviceHeader;
+        GetDeviceHeader(deviceHeader);
+
+        bool isValid = (fileHeader.magic == deviceHeader.magic)
+            && (fileHeader.fileVersion == deviceHeader.fileVersion)
+            && (fileHeader.vendorID == deviceHeader.vendorID)
+            && (fileHeader.deviceID == deviceHeader.deviceID)
+            && (fileHeader.driverVersion == deviceHeader.driverVersion)
+            && (std::memcmp(fileHeader.pipelineCacheUUID, deviceHeader.pipelineCacheUUID, VK_UUID_SIZE) == 0)
+            && (fileHeader.dataSize == fileContents.size() - sizeof(FileHeader));
+        if (isValid)
+        {
+            initialData = fileContents.data() + sizeof(FileHeader);
+            m_loadedDataSize = static_cast<size_t>(fileHeader.dataSize);
+        }
+        else
+        {
+            LOG_WARNING("[VulkanPipelineCache] Ignoring pipeline cache saved by a different device or driver");
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = m_loadedDataSize;
+    createInfo.pInitialData = initialData;
+    if (vkCreatePipelineCache(VulkanContext::GetLogicalDevice(), &createInfo, nullptr, &m_vkPipelineCache) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanPipelineCache] Failed to create pipeline cache!");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes the data of the pipeline cache to the cache file
+ * @return Returns true if the data was written successfully. Returns false otherwise.
+ */
+bool VulkanPipelineCache::Save()
+{
+    if (m_vkPipelineCache == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(VulkanContext::GetLogicalDevice(), m_vkPipelineCache, &dataSize, nullptr) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanPipelineCache] Failed to get the size of the pipeline cache data!");
+        return false;
+    }
+
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(VulkanContext::GetLogicalDevice(), m_vkPipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanPipelineCache] Failed to get the pipeline cache data!");
+        return false;
+    }
+
+    FileHeader fileHeader;
+    GetDeviceHeader(fileHeader);
+    fileHeader.dataSize = dataSize;
+
+    // Written to a temporary file first, so that an interrupted write does not leave a truncated cache behind
+    std::string tempFilePath = m_filePath + ".tmp";
+    {
+        std::ofstream file(tempFilePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(FileHeader));
+        file.write(data.data(), static_cast<std::streamsize>(dataSize));
+        if (file.fail())
+        {
+            LOG_ERROR("[VulkanPipelineCache] Failed to write pipeline cache to " << tempFilePath << "!");
+            return false;
+        }
+    }
+
+    if (std::rename(tempFilePath.c_str(), m_filePath.c_str()) != 0)
+    {
+        LOG_ERROR("[VulkanPipelineCache] Failed to replace pipeline cache file " << m_filePath << "!");
+        std::remove(tempFilePath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cleans up all resources used by the pipeline cache.
+ */
+void VulkanPipelineCache::Cleanup()
+{
+    vkDestroyPipelineCache(VulkanContext::GetLogicalDevice(), m_vkPipelineCache, nullptr);
+    m_vkPipelineCache = VK_NULL_HANDLE;
+}
+
+/**
+ * @brief Gets the handle to the pipeline cache
+ * @return Returns the pipeline cache
+ */
+VkPipelineCache VulkanPipelineCache::GetHandle() const
+{
+    return m_vkPipelineCache;
+}
+
+/**
+ * @brief Gets the size of the data that was loaded from the cache file
+ * @return Size of the loaded data in bytes. 0 if the cache file was missing or invalid.
+ */
+size_t VulkanPipelineCache::GetLoadedDataSize() const
+{
+    return m_loadedDataSize;
+}
+
+/**
+ * @brief Fills in a file header for the current device
+ * @param[out] outHeader File header
+ */
+void VulkanPipelineCache::GetDeviceHeader(FileHeader &outHeader) const
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanContext::GetPhysicalDevice(), &properties);
+
+    std::memset(&outHeader, 0, sizeof(FileHeader));
+    outHeader.magic = FILE_MAGIC;
+    outHeader.fileVersion = FILE_VERSION;
+    outHeader.vendorID = properties.vendorID;
+    outHeader.deviceID = properties.deviceID;
+    outHeader.driverVersion = properties.driverVersion;
+    std::memcpy(outHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    outHeader.dataSize = 0;
+}
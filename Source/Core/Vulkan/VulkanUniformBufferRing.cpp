@@ -0,0 +1,132 @@
+#include "Core/Vulkan/VulkanUniformBufferRing.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Vulkan/VulkanContext.hpp"
+
+
+/**
+ * @brief Constructor
+ */
+VulkanUniformBufferRing::VulkanUniformBufferRing()
+    : m_buffer()
+    , m_mappedMemory(nullptr)
+    , m_alignment(1)
+    , m_frameSize(0)
+    , m_numFrames(0)
+    , m_frameStart(0)
+    , m_frameCursor(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VulkanUniformBufferRing::~VulkanUniformBufferRing()
+{
+}
+
+/**
+ * @brief Creates the ring buffer and maps its memory for the lifetime of the ring.
+ * @param[in] numFrames Number of frame slices
+ * @param[in] frameSize Size of each frame slice in bytes
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool VulkanUniformBufferRing::Create(uint32_t numFrames, VkDeviceSize frameSize)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(VulkanContext::GetPhysicalDevice(), &properties);
+    m_alignment = properties.limits.minUniformBufferOffsetAlignment;
+    if (m_alignment == 0)
+    {
+        m_alignment = 1;
+    }
+
+    m_numFrames = numFrames;
+    m_frameSize = (frameSize + m_alignment - 1) / m_alignment * m_alignment;
+
+    VkDeviceSize bufferSize = m_frameSize * m_numFrames;
+    if (!m_buffer.Create(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        LOG_ERROR("[VulkanUniformBufferRing] Failed to create uniform buffer!");
+        return false;
+    }
+
+    m_mappedMemory = reinterpret_cast<uint8_t*>(m_buffer.MapMemory(0, bufferSize));
+    if (m_mappedMemory == nullptr)
+    {
+        LOG_ERROR("[VulkanUniformBufferRing] Failed to map uniform buffer memory!");
+        return false;
+    }
+
+    m_frameStart = 0;
+    m_frameCursor = 0;
+
+    return true;
+}
+
+/**
+ * @brief Cleans up all resources used by the ring buffer.
+ */
+void VulkanUniformBufferRing::Cleanup()
+{
+    if (m_mappedMemory != nullptr)
+    {
+        m_buffer.UnmapMemory();
+        m_mappedMemory = nullptr;
+    }
+    m_buffer.Cleanup();
+
+    m_frameSize = 0;
+    m_numFrames = 0;
+}
+
+/**
+ * @brief Starts sub-allocating from the slice of the specified frame.
+ * Must only be called once the GPU is done with the previous use of that frame.
+ * @param[in] frameIndex Index of the frame
+ */
+void VulkanUniformBufferRing::BeginFrame(uint32_t frameIndex)
+{
+    m_frameStart = m_frameSize * (frameIndex % m_numFrames);
+    m_frameCursor = 0;
+}
+
+/**
+ * @brief Sub-allocates a block from the current frame slice.
+ * @param[in] size Size of the block in bytes
+ * @param[out] outDynamicOffset Offset of the block from the start of the buffer, to be used as a dynamic offset
+ * @return Returns a pointer to the mapped memory of the block. Returns nullptr if the current frame slice is full.
+ */
+void* VulkanUniformBufferRing::Allocate(VkDeviceSize size, uint32_t &outDynamicOffset)
+{
+    VkDeviceSize alignedSize = (size + m_alignment - 1) / m_alignment * m_alignment;
+    if (m_frameCursor + alignedSize > m_frameSize)
+    {
+        LOG_ERROR("[VulkanUniformBufferRing] Frame slice is full!");
+        return nullptr;
+    }
+
+    VkDeviceSize offset = m_frameStart + m_frameCursor;
+    m_frameCursor += alignedSize;
+
+    outDynamicOffset = static_cast<uint32_t>(offset);
+    return m_mappedMemory + offset;
+}
+
+/**
+ * @brief Gets the native Vulkan handle for the underlying buffer
+ * @return Returns the native Vulkan handle for the underlying buffer
+ */
+VkBuffer VulkanUniformBufferRing::GetHandle()
+{
+    return m_buffer.GetHandle();
+}
+
+/**
+ * @brief Gets the alignment that all allocations are rounded up to
+ * @return Returns the allocation alignment in bytes
+ */
+VkDeviceSize VulkanUniformBufferRing::GetAlignment() const
+{
+    return m_alignment;
+}
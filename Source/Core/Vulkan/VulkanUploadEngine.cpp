@@ -0,0 +1,323 @@
+#include "Core/Vulkan/VulkanUploadEngine.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Vulkan/VulkanContext.hpp"
+
+
+/**
+ * @brief Constructor
+ */
+VulkanUploadEngine::VulkanUploadEngine()
+    : m_stagingBuffer()
+    , m_stagingMemory(nullptr)
+    , m_stagingSize(0)
+    , m_stagingHead(0)
+    , m_stagingUsedBytes(0)
+    , m_pendingStagingBytes(0)
+    , m_vkCommandPool(VK_NULL_HANDLE)
+    , m_freeCommandBuffers()
+    , m_vkTimelineSemaphore(VK_NULL_HANDLE)
+    , m_lastSignalValue(0)
+    , m_pendingCopies()
+    , m_inFlightSubmissions()
+    , m_mutex()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+VulkanUploadEngine::~VulkanUploadEngine()
+{
+}
+
+/**
+ * @brief Creates the staging buffer, command pool, and timeline semaphore.
+ * Requires timeline semaphores to be enabled on the logical device.
+ * @param[in] stagingBufferSize Size of the staging ring buffer in bytes
+ * @return Returns true if the creation was successful. Returns false otherwise.
+ */
+bool VulkanUploadEngine::Create(VkDeviceSize stagingBufferSize)
+{
+    if (!VulkanContext::IsTimelineSemaphoreEnabled())
+    {
+        LOG_ERROR("[VulkanUploadEngine] Timeline semaphores are not supported!");
+        return false;
+    }
+
+    m_stagingSize = stagingBufferSize;
+    if (!m_stagingBuffer.Create(m_stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to create staging buffer!");
+        return false;
+    }
+
+    m_stagingMemory = reinterpret_cast<uint8_t*>(m_stagingBuffer.MapMemory(0, m_stagingSize));
+    if (m_stagingMemory == nullptr)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to map staging buffer memory!");
+        return false;
+    }
+
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+    commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    commandPoolCreateInfo.queueFamilyIndex = VulkanContext::GetTransferQueueIndex();
+    if (vkCreateCommandPool(VulkanContext::GetLogicalDevice(), &commandPoolCreateInfo, nullptr, &m_vkCommandPool) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to create command pool!");
+        return false;
+    }
+
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {};
+    semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphoreTypeCreateInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+    if (vkCreateSemaphore(VulkanContext::GetLogicalDevice(), &semaphoreCreateInfo, nullptr, &m_vkTimelineSemaphore) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to create timeline semaphore!");
+        return false;
+    }
+
+    m_stagingHead = 0;
+    m_stagingUsedBytes = 0;
+    m_pendingStagingBytes = 0;
+    m_lastSignalValue = 0;
+
+    return true;
+}
+
+/**
+ * @brief Cleans up all resources used by the upload engine.
+ * The transfer queue must be idle.
+ */
+void VulkanUploadEngine::Cleanup()
+{
+    vkDestroySemaphore(VulkanContext::GetLogicalDevice(), m_vkTimelineSemaphore, nullptr);
+    m_vkTimelineSemaphore = VK_NULL_HANDLE;
+
+    // Destroying the pool frees all of its command buffers
+    vkDestroyCommandPool(VulkanContext::GetLogicalDevice(), m_vkCommandPool, nullptr);
+    m_vkCommandPool = VK_NULL_HANDLE;
+    m_freeCommandBuffers.clear();
+    m_inFlightSubmissions.clear();
+    m_pendingCopies.clear();
+
+    if (m_stagingMemory != nullptr)
+    {
+        m_stagingBuffer.UnmapMemory();
+        m_stagingMemory = nullptr;
+    }
+    m_stagingBuffer.Cleanup();
+
+    m_stagingSize = 0;
+    m_stagingHead = 0;
+    m_stagingUsedBytes = 0;
+    m_pendingStagingBytes = 0;
+}
+
+/**
+ * @brief Queues a copy of data into a buffer. The data is written into the staging buffer
+ * by the provided function, and copied once the batch is submitted. Can be called from any thread.
+ * @param[in] dstBuffer Buffer to copy the data to
+ * @param[in] dstOffset Offset in the destination buffer
+ * @param[in] size Size of the data in bytes
+ * @param[in] writeFunc Function that writes the data to the provided staging memory
+ * @return Returns true if the copy was queued. Returns false if the staging buffer
+ * has no room for the data until earlier copies finish.
+ */
+bool VulkanUploadEngine::Upload(VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, const std::function<void(void*)> &writeFunc)
+{
+    std::lock_guard lock(m_mutex);
+
+    VkDeviceSize alignedSize = (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    if (alignedSize > m_stagingSize)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Upload of " << size << " bytes does not fit in the staging buffer!");
+        return false;
+    }
+
+    RecycleFinishedSubmissions();
+
+    // Allocations are contiguous, so the end of the ring is skipped if the data does not fit there.
+    // The head can sit exactly at the end of the ring, where nothing is skipped but the data still wraps.
+    VkDeviceSize freeBytes = m_stagingSize - m_stagingUsedBytes;
+    bool wraps = (m_stagingHead + alignedSize > m_stagingSize);
+    VkDeviceSize padding = wraps ? (m_stagingSize - m_stagingHead) : 0;
+    if (padding + alignedSize > freeBytes)
+    {
+        return false;
+    }
+
+    VkDeviceSize stagingOffset = wraps ? 0 : m_stagingHead;
+    writeFunc(m_stagingMemory + stagingOffset);
+
+    PendingCopy pendingCopy = {};
+    pendingCopy.dstBuffer = dstBuffer;
+    pendingCopy.region.srcOffset = stagingOffset;
+    pendingCopy.region.dstOffset = dstOffset;
+    pendingCopy.region.size = size;
+    m_pendingCopies.push_back(pendingCopy);
+
+    m_stagingHead = stagingOffset + alignedSize;
+    m_stagingUsedBytes += padding + alignedSize;
+    m_pendingStagingBytes += padding + alignedSize;
+
+    return true;
+}
+
+/**
+ * @brief Records and submits all queued copies to the transfer queue. Can be called from
+ * any thread, but must not race with other submissions to the same queue.
+ * @param[out] outSignalValue Timeline value that is signaled once the copies finish
+ * @return Returns true if the submission was successful, or if there was nothing to submit.
+ * Returns false otherwise.
+ */
+bool VulkanUploadEngine::Submit(uint64_t &outSignalValue)
+{
+    std::lock_guard lock(m_mutex);
+
+    outSignalValue = m_lastSignalValue;
+    if (m_pendingCopies.empty())
+    {
+        return true;
+    }
+
+    RecycleFinishedSubmissions();
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    if (!m_freeCommandBuffers.empty())
+    {
+        commandBuffer = m_freeCommandBuffers.back();
+        m_freeCommandBuffers.pop_back();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+        commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandBufferAllocateInfo.commandPool = m_vkCommandPool;
+        commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandBufferAllocateInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(VulkanContext::GetLogicalDevice(), &commandBufferAllocateInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            LOG_ERROR("[VulkanUploadEngine] Failed to allocate command buffer!");
+            return false;
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to begin recording of command buffer!");
+        m_freeCommandBuffers.push_back(commandBuffer);
+        return false;
+    }
+
+    // Consecutive copies to the same buffer are merged into a single copy command
+    std::vector<VkBufferCopy> regions;
+    for (size_t i = 0; i < m_pendingCopies.size(); ++i)
+    {
+        regions.push_back(m_pendingCopies[i].region);
+        if ((i + 1 == m_pendingCopies.size()) || (m_pendingCopies[i + 1].dstBuffer != m_pendingCopies[i].dstBuffer))
+        {
+            vkCmdCopyBuffer(commandBuffer, m_stagingBuffer.GetHandle(), m_pendingCopies[i].dstBuffer, static_cast<uint32_t>(regions.size()), regions.data());
+            regions.clear();
+        }
+    }
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to end recording of command buffer!");
+        m_freeCommandBuffers.push_back(commandBuffer);
+        return false;
+    }
+
+    // The semaphore signal makes the copies available to whoever waits on the value
+    uint64_t signalValue = m_lastSignalValue + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+    timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineSubmitInfo.signalSemaphoreValueCount = 1;
+    timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
+    if (vkQueueSubmit(VulkanContext::GetTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        LOG_ERROR("[VulkanUploadEngine] Failed to submit copies!");
+        m_freeCommandBuffers.push_back(commandBuffer);
+        return false;
+    }
+
+    InFlightSubmission submission = {};
+    submission.signalValue = signalValue;
+    submission.stagingBytes = m_pendingStagingBytes;
+    submission.commandBuffer = commandBuffer;
+    m_inFlightSubmissions.push_back(submission);
+
+    m_pendingCopies.clear();
+    m_pendingStagingBytes = 0;
+    m_lastSignalValue = signalValue;
+    outSignalValue = signalValue;
+
+    return true;
+}
+
+/**
+ * @brief Gets the timeline value of the latest finished submission, and recycles
+ * the staging memory and command buffers of all finished submissions.
+ * @return Returns the latest timeline value that the transfer queue has signaled.
+ */
+uint64_t VulkanUploadEngine::GetCompletedValue()
+{
+    std::lock_guard lock(m_mutex);
+    return RecycleFinishedSubmissions();
+}
+
+/**
+ * @brief Gets the timeline semaphore signaled by the submissions
+ * @return Returns the timeline semaphore
+ */
+VkSemaphore VulkanUploadEngine::GetTimelineSemaphore() const
+{
+    return m_vkTimelineSemaphore;
+}
+
+/**
+ * @brief Recycles the resources of the finished submissions. Must be called with the lock held.
+ * @return Returns the latest timeline value that the transfer queue has signaled.
+ */
+uint64_t VulkanUploadEngine::RecycleFinishedSubmissions()
+{
+    uint64_t completedValue = 0;
+    if (vkGetSemaphoreCounterValue(VulkanContext::GetLogicalDevice(), m_vkTimelineSemaphore, &completedValue) != VK_SUCCESS)
+    {
+        return 0;
+    }
+
+    while (!m_inFlightSubmissions.empty() && (m_inFlightSubmissions.front().signalValue <= completedValue))
+    {
+        m_stagingUsedBytes -= m_inFlightSubmissions.front().stagingBytes;
+        m_freeCommandBuffers.push_back(m_inFlightSubmissions.front().commandBuffer);
+        m_inFlightSubmissions.pop_front();
+    }
+
+    // Start from the beginning again once everything finished, to wrap around less often
+    if (m_stagingUsedBytes == 0)
+    {
+        m_stagingHead = 0;
+    }
+
+    return completedValue;
+}
@@ -0,0 +1,79 @@
+#include "Core/Vulkan/VulkanVertexLayout.hpp"
+
+#include "Vertex.hpp"
+
+#include <cstddef>
+
+/**
+ * @brief Gets the list of binding descriptions for a vertex
+ * @param[in] positionsOnly Flag indicating whether only the position stream is bound
+ * @return List of binding descriptions for a vertex
+ */
+std::vector<VkVertexInputBindingDescription> VulkanVertexLayout::GetBindingDescriptions(bool positionsOnly)
+{
+    std::vector<VkVertexInputBindingDescription> ret = {};
+
+    // Positions
+    ret.emplace_back();
+    ret.back().binding = 0;
+    ret.back().stride = sizeof(glm::vec3);
+    ret.back().inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    if (positionsOnly)
+    {
+        return ret;
+    }
+
+    // Other attributes
+    ret.emplace_back();
+    ret.back().binding = 1;
+    ret.back().stride = sizeof(VertexAttributes);
+    ret.back().inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return ret;
+}
+
+/**
+ * @brief Gets the list of attribute descriptions for a vertex
+ * @param[in] positionsOnly Flag indicating whether only the position is read
+ * @return List of attribute descriptions for a vertex
+ */
+std::vector<VkVertexInputAttributeDescription> VulkanVertexLayout::GetAttributeDescriptions(bool positionsOnly)
+{
+    std::vector<VkVertexInputAttributeDescription> ret = {};
+
+    // Position
+    ret.emplace_back();
+    ret.back().binding = 0;
+    ret.back().location = 0;
+    ret.back().offset = 0;
+    ret.back().format = VK_FORMAT_R32G32B32_SFLOAT; // Three 32-bit signed floats
+
+    if (positionsOnly)
+    {
+        return ret;
+    }
+
+    // Color
+    ret.emplace_back();
+    ret.back().binding = 1;
+    ret.back().location = 1;
+    ret.back().offset = offsetof(VertexAttributes, color);
+    ret.back().format = VK_FORMAT_R32G32B32_SFLOAT; // Three 32-bit signed floats
+
+    // UV
+    ret.emplace_back();
+    ret.back().binding = 1;
+    ret.back().location = 2;
+    ret.back().offset = offsetof(VertexAttributes, uv);
+    ret.back().format = VK_FORMAT_R32G32_SFLOAT; // Two 32-bit signed floats
+
+    // Normal
+    ret.emplace_back();
+    ret.back().binding = 1;
+    ret.back().location = 3;
+    ret.back().offset = offsetof(VertexAttributes, normal);
+    ret.back().format = VK_FORMAT_R32G32B32_SFLOAT; // Three 32-bit signed floats
+
+    return ret;
+}
@@ -1,13 +1,271 @@
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <string>
 
 #include "Application.hpp"
+#include "Core/Logger.hpp"
+#include "Map/SyntheticTileDataSource.hpp"
+#include "Map/TileDataSourceFactory.hpp"
 
-int main()
+const uint64_t DEFAULT_HEADLESS_FRAME_COUNT = 600;  // Number of frames rendered in headless mode if neither --frames nor --camera-path is given
+
+/**
+ * @brief Prints the command line options.
+ * @param[in] programName Name of the executable
+ */
+void PrintUsage(const char *programName)
+{
+    std::cout << "Usage: " << programName << " [options]" << std::endl
+        << "  --headless              Render into offscreen images, without a window" << std::endl
+        << "  --width <pixels>        Width of the rendered frames (default: 800)" << std::endl
+        << "  --height <pixels>       Height of the rendered frames (default: 600)" << std::endl
+        << "  --frames <count>        Number of frames to render before exiting (default: unlimited, "
+        << DEFAULT_HEADLESS_FRAME_COUNT << " in headless mode)" << std::endl
+        << "  --dump-frame <n>        Write frame n (0-based) to a PPM file. Can be repeated. Headless mode only." << std::endl
+        << "  --dump-dir <path>       Directory that dumped frames are written to (default: current directory)" << std::endl
+        << "  --camera-path <file>    Replay a camera path and record benchmark measurements, e.g. Resources/camera_path.txt" << std::endl
+        << "  --benchmark-csv <file>  File that the per-frame benchmark measurements are written to (default: benchmark.csv)" << std::endl
+        << "  --profile <file>        Profile the whole run and write a Chrome trace to the file at exit" << std::endl
+        << "                          (the P key toggles profiling in windowed mode, writing profile_trace.json)" << std::endl
+        << "  --hud                   Show the performance overlay from the start (the H key toggles it in windowed mode)" << std::endl
+        << "  --upload-budget-kb <kb> Tile vertices uploaded to the vertex buffer per frame, at most (default: 4096)" << std::endl
+        << "  --upload-budget-us <us> Time spent uploading tile vertices per frame, at most (default: 2000)" << std::endl
+        << "  --prefetch-lookahead <seconds>        How far ahead the camera path is extrapolated to prefetch tiles, 0 to disable (default: 3)" << std::endl
+        << "  --prefetch-sample-interval <seconds>  Time between samples along the extrapolated path (default: 0.25)" << std::endl
+        << "  --prefetch-smoothing <0..1>           Weight of the previous velocity when smoothing the camera velocity (default: 0.9)" << std::endl
+        << "  --prefetch-forward-bias <bias>        How much the path is bent towards where the camera looks (default: 0.5)" << std::endl
+        << "  --log-level <level>     Least severe log messages shown: debug, info, warning or error (default: info)" << std::endl
+        << "  --tile-sources <spec>   Layers that tiles are retrieved from, front to back, separated by commas" << std::endl
+        << "                          (default: " << TileDataSourceFactory::GetDefaultSpecification() << "). Layers:" << std::endl
+        << "                            memory[:<tiles>]                 Most recently used tiles (default: 256)" << std::endl
+        << "                            disk[:<directory>[:osm|binary]]  One file per tile (default: Resources, osm)" << std::endl
+        << "                            pack:<file>                      Read-only offline tile pack" << std::endl
+        << "                            network[:<host>]                 Overpass API server, last layer only" << std::endl
+        << "                            synthetic                        Generated city, last layer only" << std::endl
+        << "                          memory and disk also take write=never|retrieve|always" << std::endl
+        << "                          e.g. pack:city.pack, or memory:512,disk:cache:binary,disk:Resources:osm:write=never,network" << std::endl
+        << "  --synthetic             Generate the city instead of reading OSM data (same as --tile-sources synthetic)" << std::endl
+        << "  --synthetic-seed <seed>               Seed of the generated city (default: 1)" << std::endl
+        << "  --synthetic-buildings <count>         Buildings per generated tile (default: 250)" << std::endl
+        << "  --synthetic-outline-vertices <count>  Vertices per building outline (default: 8)" << std::endl
+        << "  --synthetic-concavity <0..1>          How concave the outlines are (default: 0.3)" << std::endl
+        << "  --synthetic-roads <count>             Roads per generated tile (default: 60)" << std::endl
+        << "  --synthetic-water <0..1>              Fraction of each tile covered by water (default: 0.05)" << std::endl
+        << "  --synthetic-water-vertices <count>    Vertices per water outline (default: 64)" << std::endl
+        << "Any --synthetic-* option also selects the generated city, unless --tile-sources is given." << std::endl;
+}
+
+/**
+ * @brief Parses the command line options.
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @param[out] outOptions Parsed options
+ * @return Returns true if all options were valid. Returns false otherwise.
+ */
+bool ParseLaunchOptions(int argc, char **argv, Application::LaunchOptions &outOptions)
+{
+    outOptions.headless = false;
+    outOptions.width = 800;
+    outOptions.height = 600;
+    outOptions.frameCount = 0;
+    outOptions.dumpFrames.clear();
+    outOptions.dumpDirectory = ".";
+    outOptions.cameraPathFile.clear();
+    outOptions.benchmarkCsvFile = "benchmark.csv";
+    outOptions.profileTraceFile.clear();
+    outOptions.showHud = false;
+    outOptions.uploadBudgetKilobytes = 4 * 1024;
+    outOptions.uploadBudgetMicroseconds = 2000;
+    outOptions.prefetchLookaheadSeconds = 3.0f;
+    outOptions.prefetchSampleInterval = 0.25f;
+    outOptions.prefetchVelocitySmoothing = 0.9f;
+    outOptions.prefetchForwardBias = 0.5f;
+    outOptions.tileSources = TileDataSourceFactory::GetDefaultSpecification();
+    outOptions.syntheticTileSettings = SyntheticTileDataSource::GetDefaultSettings();
+
+    bool frameCountGiven = false;
+    bool tileSourcesGiven = false;
+    bool syntheticTilesSelected = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        // Every option except --headless, --hud and --synthetic takes a value
+        bool hasValue = (i + 1 < argc);
+        try
+        {
+            if (std::strcmp(argv[i], "--headless") == 0)
+            {
+                outOptions.headless = true;
+            }
+            else if (std::strcmp(argv[i], "--synthetic") == 0)
+            {
+                syntheticTilesSelected = true;
+            }
+            else if (std::strcmp(argv[i], "--hud") == 0)
+            {
+                outOptions.showHud = true;
+            }
+            else if ((std::strcmp(argv[i], "--width") == 0) && hasValue)
+            {
+                outOptions.width = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if ((std::strcmp(argv[i], "--height") == 0) && hasValue)
+            {
+                outOptions.height = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if ((std::strcmp(argv[i], "--frames") == 0) && hasValue)
+            {
+                outOptions.frameCount = std::stoull(argv[++i]);
+                frameCountGiven = true;
+            }
+            else if ((std::strcmp(argv[i], "--dump-frame") == 0) && hasValue)
+            {
+                outOptions.dumpFrames.insert(std::stoull(argv[++i]));
+            }
+            else if ((std::strcmp(argv[i], "--dump-dir") == 0) && hasValue)
+            {
+                outOptions.dumpDirectory = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--camera-path") == 0) && hasValue)
+            {
+                outOptions.cameraPathFile = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--benchmark-csv") == 0) && hasValue)
+            {
+                outOptions.benchmarkCsvFile = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--profile") == 0) && hasValue)
+            {
+                outOptions.profileTraceFile = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--upload-budget-kb") == 0) && hasValue)
+            {
+                outOptions.uploadBudgetKilobytes = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if ((std::strcmp(argv[i], "--upload-budget-us") == 0) && hasValue)
+            {
+                outOptions.uploadBudgetMicroseconds = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if ((std::strcmp(argv[i], "--prefetch-lookahead") == 0) && hasValue)
+            {
+                outOptions.prefetchLookaheadSeconds = std::stof(argv[++i]);
+            }
+            else if ((std::strcmp(argv[i], "--prefetch-sample-interval") == 0) && hasValue)
+            {
+                outOptions.prefetchSampleInterval = std::stof(argv[++i]);
+            }
+            else if ((std::strcmp(argv[i], "--prefetch-smoothing") == 0) && hasValue)
+            {
+                outOptions.prefetchVelocitySmoothing = std::stof(argv[++i]);
+            }
+            else if ((std::strcmp(argv[i], "--prefetch-forward-bias") == 0) && hasValue)
+            {
+                outOptions.prefetchForwardBias = std::stof(argv[++i]);
+            }
+            else if ((std::strcmp(argv[i], "--tile-sources") == 0) && hasValue)
+            {
+                outOptions.tileSources = argv[++i];
+                tileSourcesGiven = true;
+            }
+            else if ((std::strcmp(argv[i], "--log-level") == 0) && hasValue)
+            {
+                // The log level applies to the whole process, not just the application
+                Logger::Level logLevel;
+                if (!Logger::ParseLevel(argv[++i], logLevel))
+                {
+                    std::cerr << "Invalid value for option " << argv[i - 1] << ": " << argv[i] << std::endl;
+                    return false;
+                }
+                Logger::SetLevel(logLevel);
+            }
+            else if (hasValue && (std::strncmp(argv[i], "--synthetic-", 12) == 0))
+            {
+                // Any setting of the generated tiles also selects them
+                ++i;
+                if (!SyntheticTileDataSource::ParseOption(argv[i - 1], argv[i], outOptions.syntheticTileSettings))
+                {
+                    std::cerr << "Unknown or incomplete option: " << argv[i - 1] << std::endl;
+                    return false;
+                }
+                syntheticTilesSelected = true;
+            }
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Invalid value for option " << argv[i - 1] << ": " << argv[i] << std::endl;
+            return false;
+        }
+    }
+
+    // The synthetic options then only configure a synthetic layer of the given sources
+    if (syntheticTilesSelected && !tileSourcesGiven)
+    {
+        outOptions.tileSources = "synthetic";
+    }
+
+    if ((outOptions.width == 0) || (outOptions.height == 0))
+    {
+        std::cerr << "Frame size must not be 0" << std::endl;
+        return false;
+    }
+
+    // The first tile of a frame ignores the budget, so a zero budget would stream one tile per frame
+    if ((outOptions.uploadBudgetKilobytes == 0) || (outOptions.uploadBudgetMicroseconds == 0))
+    {
+        std::cerr << "Upload budget must not be 0" << std::endl;
+        return false;
+    }
+
+    if ((outOptions.prefetchLookaheadSeconds < 0.0f) || (outOptions.prefetchSampleInterval <= 0.0f)
+        || (outOptions.prefetchVelocitySmoothing < 0.0f) || (outOptions.prefetchVelocitySmoothing >= 1.0f)
+        || (outOptions.prefetchForwardBias < 0.0f))
+    {
+        std::cerr << "Prefetch settings are out of range" << std::endl;
+        return false;
+    }
+
+    // A headless run has no window to close, so it always stops on its own.
+    // A camera path stops the run when it ends.
+    bool hasCameraPath = !outOptions.cameraPathFile.empty();
+    if (outOptions.headless && !frameCountGiven && !hasCameraPath)
+    {
+        outOptions.frameCount = DEFAULT_HEADLESS_FRAME_COUNT;
+    }
+    if (outOptions.headless && (outOptions.frameCount == 0) && !hasCameraPath)
+    {
+        std::cerr << "Headless mode needs at least one frame" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
 {
+    Application::LaunchOptions launchOptions;
+    if (!ParseLaunchOptions(argc, argv, launchOptions))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (!launchOptions.dumpFrames.empty())
+    {
+        std::error_code errorCode;
+        std::filesystem::create_directories(launchOptions.dumpDirectory, errorCode);
+    }
+
+    Logger::Start();
     {
-        Application app;
+        Application app(launchOptions);
         app.Run();
     }
+    Logger::Stop();
 
     return 0;
 }
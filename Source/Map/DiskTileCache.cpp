@@ -0,0 +1,216 @@
+#include "Map/DiskTileCache.hpp"
+
+#include "Core/Logger.hpp"
+#include "Map/TileDataSerializer.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+/**
+ * @brief Constructor
+ * @param[in] directory Directory containing the tile files
+ * @param[in] format Format of the tile files
+ * @param[in] next Data source behind the layer. nullptr if there is none.
+ * @param[in] writeBackPolicy When tiles are kept in the layer
+ */
+DiskTileCache::DiskTileCache(const std::string &directory, Format format, std::unique_ptr<TileDataSource> next, WriteBackPolicy writeBackPolicy)
+    : TileCacheLayer(std::move(next), writeBackPolicy)
+    , m_directory(directory)
+    , m_format(format)
+    , m_parser()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+DiskTileCache::~DiskTileCache()
+{
+}
+
+/**
+ * @brief Retrieves the tile as OSM XML. An OSM XML tile file is read as it is.
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outXmlText OSM XML of the tile
+ * @return True if the operation was successful. False if no data source has OSM XML of the tile.
+ */
+bool DiskTileCache::RetrieveOsmXml(const glm::ivec2 &tileIndex, const int &zoomLevel, std::string &outXmlText)
+{
+    // Requests for the raw XML count towards the statistics of the layer as well
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if ((m_format == Format::OsmXml) && HasTile(tileIndex, zoomLevel) && ReadTileFile(GetTileFilePath(tileIndex, zoomLevel), outXmlText))
+    {
+        RecordHit(startTime);
+        return true;
+    }
+    RecordMiss();
+    return TileCacheLayer::RetrieveOsmXml(tileIndex, zoomLevel, outXmlText);
+}
+
+/**
+ * @brief Gets a short description of the data source, used in the statistics
+ * @return Name of the data source
+ */
+std::string DiskTileCache::GetName() const
+{
+    return "disk " + m_directory + ((m_format == Format::OsmXml) ? " (osm, " : " (binary, ") + GetWriteBackPolicyName(m_writeBackPolicy) + ")";
+}
+
+/**
+ * @brief Queries whether the layer itself has the tile
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @return True if the layer has the tile
+ */
+bool DiskTileCache::HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel)
+{
+    std::ifstream file(GetTileFilePath(tileIndex, zoomLevel));
+    return file.good();
+}
+
+/**
+ * @brief Reads and decodes a tile file
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the loaded tile data
+ * @return True if the operation was successful.
+ */
+bool DiskTileCache::Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData)
+{
+    std::string contents;
+    if (!ReadTileFile(GetTileFilePath(tileIndex, zoomLevel), contents))
+    {
+        return false;
+    }
+
+    if (m_format == Format::OsmXml)
+    {
+        return m_parser.ParseTile(contents, tileIndex, zoomLevel, outTileData, GetThreadStageTimes());
+    }
+
+    // The binary decode is a copy of the features, so it is counted with the read
+    std::chrono::steady_clock::time_point decodeStartTime = std::chrono::steady_clock::now();
+    bool success = TileDataSerializer::Deserialize(contents, outTileData);
+    GetThreadStageTimes().seconds[static_cast<size_t>(TileStageStats::Stage::DiskRead)] += std::chrono::duration<double>(std::chrono::steady_clock::now() - decodeStartTime).count();
+    return success;
+}
+
+/**
+ * @brief Writes a tile file in the binary format. Decoded tiles cannot be turned back into
+ * OSM XML, so this fails for the OSM XML format.
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[in] tileData Tile data to keep
+ * @return True if the operation was successful.
+ */
+bool DiskTileCache::Store(const glm::ivec2 &tileIndex, const int &zoomLevel, const TileData &tileData)
+{
+    if (m_format != Format::Binary)
+    {
+        return false;
+    }
+
+    std::string contents;
+    TileDataSerializer::Serialize(tileData, contents);
+    return WriteTileFile(GetTileFilePath(tileIndex, zoomLevel), contents);
+}
+
+/**
+ * @brief Retrieves a tile the layer does not have from the next data source, and keeps it
+ * in the layer unless the write-back policy is Never. The OSM XML format keeps the XML of
+ * the next data source as it is, if the next data source has XML.
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the retrieved tile data. nullptr when
+ * prefetching, in which case the tile only needs to be kept.
+ * @return True if the operation was successful.
+ */
+bool DiskTileCache::Fill(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData *outTileData)
+{
+    if ((m_format == Format::Binary) || (m_writeBackPolicy == WriteBackPolicy::Never) || (m_next == nullptr))
+    {
+        return TileCacheLayer::Fill(tileIndex, zoomLevel, outTileData);
+    }
+
+    std::string xmlText;
+    if (!m_next->RetrieveOsmXml(tileIndex, zoomLevel, xmlText))
+    {
+        // Data sources without XML, such as the binary caches, are passed through without keeping the tile
+        LOG_DEBUG("[DiskTileCache] No OSM XML of tile " << zoomLevel << "-" << tileIndex.x << "-" << tileIndex.y << " to keep in " << m_directory);
+        return (outTileData != nullptr) ? m_next->Retrieve(tileIndex, zoomLevel, *outTileData) : m_next->Prefetch(tileIndex, zoomLevel);
+    }
+
+    if (!WriteTileFile(GetTileFilePath(tileIndex, zoomLevel), xmlText))
+    {
+        LOG_WARNING("[DiskTileCache] Failed to keep tile " << zoomLevel << "-" << tileIndex.x << "-" << tileIndex.y << " in " << m_directory);
+    }
+    return (outTileData == nullptr) || m_parser.ParseTile(xmlText, tileIndex, zoomLevel, *outTileData, GetThreadStageTimes());
+}
+
+/**
+ * @brief Gets the path of the file of a tile
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @return File path for the specified tile index and zoom level
+ */
+std::string DiskTileCache::GetTileFilePath(const glm::ivec2 &tileIndex, const int &zoomLevel) const
+{
+    std::stringstream ss;
+    ss << m_directory << "/map_" << zoomLevel << "-" << tileIndex.x << "-" << tileIndex.y << ((m_format == Format::OsmXml) ? ".osm" : ".tile");
+    return ss.str();
+}
+
+/**
+ * @brief Reads a tile file, and records the time as the disk read stage
+ * @param[in] filePath Path of the file
+ * @param[out] outContents Contents of the file
+ * @return True if the file was read.
+ */
+bool DiskTileCache::ReadTileFile(const std::string &filePath, std::string &outContents)
+{
+    std::chrono::steady_clock::time_point readStartTime = std::chrono::steady_clock::now();
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream fileContents;
+    bool isFileRead = !file.fail() && !(fileContents << file.rdbuf()).fail();
+    outContents = isFileRead ? fileContents.str() : std::string();
+    GetThreadStageTimes().seconds[static_cast<size_t>(TileStageStats::Stage::DiskRead)] += std::chrono::duration<double>(std::chrono::steady_clock::now() - readStartTime).count();
+    return isFileRead;
+}
+
+/**
+ * @brief Writes a tile file. The file is written under a temporary name first, so that
+ * a reader never sees a partially written file. The temporary name is unique to the
+ * calling thread, so that threads writing the same tile do not write into each other's file.
+ * @param[in] filePath Path of the file
+ * @param[in] contents Contents of the file
+ * @return True if the file was written.
+ */
+bool DiskTileCache::WriteTileFile(const std::string &filePath, const std::string &contents)
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(m_directory, errorCode);
+
+    std::stringstream temporaryFilePath;
+    temporaryFilePath << filePath << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+    bool isFileWritten = false;
+    {
+        std::ofstream file(temporaryFilePath.str(), std::ios::binary | std::ios::trunc);
+        isFileWritten = !file.fail() && file.write(contents.data(), contents.size()) && file.flush();
+    }
+
+    if (isFileWritten)
+    {
+        std::filesystem::rename(temporaryFilePath.str(), filePath, errorCode);
+        isFileWritten = !errorCode;
+    }
+    if (!isFileWritten)
+    {
+        std::filesystem::remove(temporaryFilePath.str(), errorCode);
+    }
+    return isFileWritten;
+}
@@ -0,0 +1,101 @@
+#include "Map/MemoryTileCache.hpp"
+
+/**
+ * @brief Constructor
+ * @param[in] capacity Maximum number of tiles kept
+ * @param[in] next Data source behind the layer. nullptr if there is none.
+ * @param[in] writeBackPolicy When tiles are kept in the layer
+ */
+MemoryTileCache::MemoryTileCache(size_t capacity, std::unique_ptr<TileDataSource> next, WriteBackPolicy writeBackPolicy)
+    : TileCacheLayer(std::move(next), writeBackPolicy)
+    , m_mutex()
+    , m_capacity(capacity)
+    , m_entries()
+    , m_recentUse()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+MemoryTileCache::~MemoryTileCache()
+{
+}
+
+/**
+ * @brief Gets a short description of the data source, used in the statistics
+ * @return Name of the data source
+ */
+std::string MemoryTileCache::GetName() const
+{
+    std::lock_guard lock(m_mutex);
+    return "memory " + std::to_string(m_entries.size()) + "/" + std::to_string(m_capacity) + " tiles";
+}
+
+/**
+ * @brief Queries whether the layer itself has the tile
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @return True if the layer has the tile
+ */
+bool MemoryTileCache::HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel)
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.find({ tileIndex, zoomLevel }) != m_entries.end();
+}
+
+/**
+ * @brief Loads a tile the layer has, and marks it as the most recently used
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the loaded tile data
+ * @return True if the operation was successful.
+ */
+bool MemoryTileCache::Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData)
+{
+    std::lock_guard lock(m_mutex);
+    std::map<TileKey, Entry>::iterator it = m_entries.find({ tileIndex, zoomLevel });
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+
+    m_recentUse.splice(m_recentUse.begin(), m_recentUse, it->second.recentUseIterator);
+    outTileData = it->second.tileData;
+    return true;
+}
+
+/**
+ * @brief Keeps a tile in the layer, evicting the least recently used tile if the cache is full
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[in] tileData Tile data to keep
+ * @return True if the operation was successful.
+ */
+bool MemoryTileCache::Store(const glm::ivec2 &tileIndex, const int &zoomLevel, const TileData &tileData)
+{
+    if (m_capacity == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard lock(m_mutex);
+    TileKey tileKey = { tileIndex, zoomLevel };
+    std::map<TileKey, Entry>::iterator it = m_entries.find(tileKey);
+    if (it != m_entries.end())
+    {
+        m_recentUse.splice(m_recentUse.begin(), m_recentUse, it->second.recentUseIterator);
+        it->second.tileData = tileData;
+        return true;
+    }
+
+    while (m_entries.size() >= m_capacity)
+    {
+        m_entries.erase(m_recentUse.back());
+        m_recentUse.pop_back();
+    }
+
+    m_recentUse.push_front(tileKey);
+    m_entries[tileKey] = { tileData, m_recentUse.begin() };
+    return true;
+}
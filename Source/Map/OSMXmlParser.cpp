@@ -0,0 +1,323 @@
+#include "Map/OSMXmlParser.hpp"
+
+#include <cstring>
+#include <glm/glm.hpp>
+#include <tinyxml2.h>
+
+#include <chrono>
+#include <map>
+
+/**
+ * @brief Constructor
+ */
+OSMXmlParser::OSMXmlParser()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+OSMXmlParser::~OSMXmlParser()
+{
+}
+
+/**
+ * @brief Parses the OSM XML of a tile and retrieves its tile data. The XML parse
+ * and the node join are timed as separate stages.
+ * @param[in] xmlText OSM XML of the tile
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the retrieved tile data
+ * @param[in,out] ioStageTimes Stage times that the parse and join times are added to
+ * @return True if the operation was successful.
+ */
+bool OSMXmlParser::ParseTile(const std::string &xmlText, const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData, TileStageStats::StageTimes &ioStageTimes)
+{
+    std::chrono::steady_clock::time_point parseStartTime = std::chrono::steady_clock::now();
+    tinyxml2::XMLDocument document;
+    bool isParsed = (document.Parse(xmlText.c_str(), xmlText.size()) == tinyxml2::XML_SUCCESS) && (document.FirstChildElement(OSM_ELEMENT_STR) != nullptr);
+    std::chrono::steady_clock::time_point joinStartTime = std::chrono::steady_clock::now();
+    ioStageTimes.seconds[static_cast<size_t>(TileStageStats::Stage::XmlParse)] += std::chrono::duration<double>(joinStartTime - parseStartTime).count();
+    if (!isParsed)
+    {
+        return false;
+    }
+
+    outTileData.index = tileIndex;
+    outTileData.zoomLevel = zoomLevel;
+    bool success = RetrieveFromXML(document, outTileData);
+    ioStageTimes.seconds[static_cast<size_t>(TileStageStats::Stage::NodeJoin)] += std::chrono::duration<double>(std::chrono::steady_clock::now() - joinStartTime).count();
+    return success;
+}
+
+/**
+ * @brief Retrieves tile data from the given xml document
+ * @param[in] xml XML document object
+ * @param[out] outTileData TileData object that will contain the retrieved tile data
+ * @return True if the operation was successful.
+ */
+bool OSMXmlParser::RetrieveFromXML(const tinyxml2::XMLDocument &xml, TileData &outTileData)
+{
+    const tinyxml2::XMLElement *rootElement = xml.FirstChildElement(OSM_ELEMENT_STR);
+
+    const tinyxml2::XMLElement *boundsElement = rootElement->FirstChildElement("bounds");
+    outTileData.bounds.min.x = boundsElement->DoubleAttribute("minlon");
+    outTileData.bounds.min.y = boundsElement->DoubleAttribute("minlat");
+    outTileData.bounds.max.x = boundsElement->DoubleAttribute("maxlon");
+    outTileData.bounds.max.y = boundsElement->DoubleAttribute("maxlat");
+
+    std::map<int32_t, glm::dvec2> nodeIDToLonLat;
+
+    const tinyxml2::XMLElement *nodeElement = xml.FirstChildElement(OSM_ELEMENT_STR)->FirstChildElement(NODE_ELEMENT_STR);
+    while (nodeElement != nullptr)
+    {
+        int32_t nodeId = nodeElement->IntAttribute(NODE_ID_ATTRIBUTE_STR);
+        if (nodeId != 0) // TODO: Not sure if 0 is a valid node ID
+        {
+            double lon = nodeElement->FloatAttribute(NODE_LON_ATTRIBUTE_STR);
+            double lat = nodeElement->FloatAttribute(NODE_LAT_ATTRIBUTE_STR);
+            nodeIDToLonLat[nodeId] = glm::dvec2(lon, lat);
+        }
+        nodeElement = nodeElement->NextSiblingElement(NODE_ELEMENT_STR);
+    }
+
+    const tinyxml2::XMLElement *wayElement = xml.FirstChildElement(OSM_ELEMENT_STR)->FirstChildElement(WAY_ELEMENT_STR);
+    while (wayElement != nullptr)
+    {
+        if (HasChildTag(wayElement, BUILDING_TAG_KEY_STR)
+            || HasChildTag(wayElement, BUILDING_PART_TAG_KEY_STR))
+        {
+            outTileData.buildings.emplace_back();
+            if (!RetrieveBuildingData(wayElement, nodeIDToLonLat, outTileData.buildings.back()))
+            {
+                outTileData.buildings.pop_back();
+            }
+        }
+        else if (HasChildTag(wayElement, HIGHWAY_TAG_KEY_STR))
+        {
+            outTileData.highways.emplace_back();
+            if (!RetrieveHighwayData(wayElement, nodeIDToLonLat, outTileData.highways.back()))
+            {
+                outTileData.highways.pop_back();
+            }
+        }
+        else if (HasWaterData(wayElement))
+        {
+            outTileData.waterFeatures.emplace_back();
+            if (!RetrieveWaterData(wayElement, nodeIDToLonLat, outTileData.waterFeatures.back()))
+            {
+                outTileData.waterFeatures.pop_back();
+            }
+        }
+
+        wayElement = wayElement->NextSiblingElement(WAY_ELEMENT_STR);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Retrieves building data from the given xml element
+ * @param[in] element XML element object
+ * @param[in] nodeIDToLonLat Map containing the mapping between a node ID and its lon/lat position
+ * @param[out] outBuildingData BuildingData object that will contain the retrieved building data
+ * @return True if the operation was successful.
+ */
+bool OSMXmlParser::RetrieveBuildingData(const tinyxml2::XMLElement *element, const std::map<int32_t, glm::dvec2> &nodeIDToLonLat, BuildingData &outBuildingData)
+{
+    const tinyxml2::XMLElement *nodeRefElement = element->FirstChildElement(WAY_NODE_ELEMENT_STR);
+    while (nodeRefElement != nullptr)
+    {
+        int32_t nodeId = nodeRefElement->IntAttribute(WAY_NODE_REF_ATTRIBUTE_STR);
+        if (nodeIDToLonLat.find(nodeId) != nodeIDToLonLat.end())
+        {
+            double lon = nodeIDToLonLat.at(nodeId).x;
+            double lat = nodeIDToLonLat.at(nodeId).y;
+            outBuildingData.outline.emplace_back(lon, lat);
+        }
+        nodeRefElement = nodeRefElement->NextSiblingElement(WAY_NODE_ELEMENT_STR);
+    }
+
+    if (outBuildingData.outline.size() == 0)
+    {
+        return false;
+    }
+
+    if (outBuildingData.outline[0] == outBuildingData.outline.back())
+    {
+        outBuildingData.outline.pop_back();
+    }
+
+    const tinyxml2::XMLAttribute *heightAttrib = GetChildTagValue(element, BUILDING_HEIGHT_TAG_KEY_STR);
+    const tinyxml2::XMLAttribute *minHeightAttrib = GetChildTagValue(element, BUILDING_MIN_HEIGHT_TAG_KEY_STR);
+    const tinyxml2::XMLAttribute *buildingLevelsAttrib = GetChildTagValue(element, BUILDING_LEVELS_TAG_KEY_STR);
+    const tinyxml2::XMLAttribute *buildingMinLevelsAttrib = GetChildTagValue(element, BUILDING_MIN_LEVELS_TAG_KEY_STR);
+    // height has priority over building:levels
+    if (heightAttrib != nullptr)
+    {
+        outBuildingData.heightInMeters = heightAttrib->DoubleValue();
+    }
+    else if (buildingLevelsAttrib != nullptr)
+    {
+        outBuildingData.heightInMeters = buildingLevelsAttrib->DoubleValue() * METERS_PER_LEVEL;
+    }
+    // min_height has priority over building:min_levels
+    if (minHeightAttrib != nullptr)
+    {
+        outBuildingData.heightFromGround = minHeightAttrib->DoubleValue();
+        if (heightAttrib != nullptr)
+        {
+            outBuildingData.heightInMeters -= minHeightAttrib->DoubleValue();
+        }
+    }
+    else if (buildingMinLevelsAttrib != nullptr)
+    {
+        outBuildingData.heightFromGround = buildingMinLevelsAttrib->DoubleValue() * METERS_PER_LEVEL;
+        if (heightAttrib != nullptr)
+        {
+            outBuildingData.heightInMeters = glm::max(heightAttrib->DoubleValue() - outBuildingData.heightFromGround, METERS_PER_LEVEL);
+        }
+        else if (buildingLevelsAttrib != nullptr)
+        {
+            outBuildingData.heightInMeters -= outBuildingData.heightFromGround;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Retrieves highway data from the given xml element
+ * @param[in] element XML element object
+ * @param[in] nodeIDToLonLat Map containing the mapping between a node ID and its lon/lat position
+ * @param[out] outHighwayData HighwayData object that will contain the retrieved highway data
+ * @return True if the operation was successful.
+ */
+bool OSMXmlParser::RetrieveHighwayData(const tinyxml2::XMLElement *element, const std::map<int32_t, glm::dvec2> &nodeIDToLonLat, HighwayData &outHighwayData)
+{
+    const tinyxml2::XMLElement *nodeRefElement = element->FirstChildElement(WAY_NODE_ELEMENT_STR);
+    while (nodeRefElement != nullptr)
+    {
+        int32_t nodeId = nodeRefElement->IntAttribute(WAY_NODE_REF_ATTRIBUTE_STR);
+        if (nodeIDToLonLat.find(nodeId) != nodeIDToLonLat.end())
+        {
+            double lon = nodeIDToLonLat.at(nodeId).x;
+            double lat = nodeIDToLonLat.at(nodeId).y;
+            outHighwayData.points.emplace_back(lon, lat);
+        }
+        nodeRefElement = nodeRefElement->NextSiblingElement(WAY_NODE_ELEMENT_STR);
+    }
+
+    if (outHighwayData.points.size() == 0)
+    {
+        return false;
+    }
+
+    double numLanes = 1.0;
+    double width = RESIDENTIAL_HIGHWAY_LANE_WIDTH_METERS;
+    const tinyxml2::XMLAttribute *highwayTypeAttrib = GetChildTagValue(element, HIGHWAY_TAG_KEY_STR);
+    if (highwayTypeAttrib != nullptr)
+    {
+        if (strcmp(highwayTypeAttrib->Value(), "primary") == 0)
+        {
+            width = PRIMARY_HIGHWAY_LANE_WIDTH_METERS;
+        }
+    }
+    const tinyxml2::XMLAttribute *lanesAttrib = GetChildTagValue(element, HIGHWAY_LANES_TAG_KEY_STR);
+    if (lanesAttrib != nullptr)
+    {
+        numLanes = lanesAttrib->DoubleValue();
+    }
+    outHighwayData.roadWidth = width * numLanes;
+
+    return true;
+}
+
+/**
+ * @brief Retrieve water feature data from the given xml element
+ * @param[in] element XML element object
+ * @param[in] nodeIDToLonLat Map containing the mapping between a node ID and its lon/lat position
+ * @param[out] outWaterData WaterFeatureData object that will contain the retrieved water feature data
+ * @return True if the operation was successful.
+ */
+bool OSMXmlParser::RetrieveWaterData(const tinyxml2::XMLElement *element, const std::map<int32_t, glm::dvec2> &nodeIDToLonLat, WaterFeatureData &outWaterData)
+{
+    const tinyxml2::XMLElement *nodeRefElement = element->FirstChildElement(WAY_NODE_ELEMENT_STR);
+    while (nodeRefElement != nullptr)
+    {
+        int32_t nodeId = nodeRefElement->IntAttribute(WAY_NODE_REF_ATTRIBUTE_STR);
+        if (nodeIDToLonLat.find(nodeId) != nodeIDToLonLat.end())
+        {
+            double lon = nodeIDToLonLat.at(nodeId).x;
+            double lat = nodeIDToLonLat.at(nodeId).y;
+            outWaterData.outline.emplace_back(lon, lat);
+        }
+        nodeRefElement = nodeRefElement->NextSiblingElement(WAY_NODE_ELEMENT_STR);
+    }
+
+    if (outWaterData.outline.size() == 0)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool OSMXmlParser::HasChildTag(const tinyxml2::XMLElement *parent, const char *key)
+{
+    const tinyxml2::XMLElement *curr = parent->FirstChildElement(TAG_ELEMENT_STR);
+    while (curr != nullptr)
+    {
+        const tinyxml2::XMLAttribute *attrib = curr->FindAttribute(TAG_KEY_ATTRIBUTE_STR);
+        if (attrib != nullptr)
+        {
+            if (strcmp(attrib->Value(), key) == 0)
+            {
+                return true;
+            }
+        }
+        curr = curr->NextSiblingElement(TAG_ELEMENT_STR);
+    }
+
+    return false;
+}
+
+const tinyxml2::XMLAttribute* OSMXmlParser::GetChildTagValue(const tinyxml2::XMLElement *parent, const char *key)
+{
+    const tinyxml2::XMLElement *curr = parent->FirstChildElement(TAG_ELEMENT_STR);
+    while (curr != nullptr)
+    {
+        const tinyxml2::XMLAttribute *attrib = curr->FindAttribute(TAG_KEY_ATTRIBUTE_STR);
+        if (attrib != nullptr)
+        {
+            if (strcmp(attrib->Value(), key) == 0)
+            {
+                return curr->FindAttribute(TAG_VALUE_ATTRIBUTE_STR);
+            }
+        }
+        curr = curr->NextSiblingElement(TAG_ELEMENT_STR);
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Checks whether the given xml element contains data for a water feature
+ * @param[in] element XML element
+ * @return True if the given XML element contains data for a water feature 
+ */
+bool OSMXmlParser::HasWaterData(const tinyxml2::XMLElement *element)
+{
+    if (HasChildTag(element, WATER_KEY_STR))
+    {
+        return true;
+    }
+
+    const tinyxml2::XMLAttribute *naturalAttrib = GetChildTagValue(element, NATURAL_KEY_STR);
+    if (naturalAttrib != nullptr)
+    {
+        return strcmp(naturalAttrib->Value(), NATURAL_WATER_VALUE_STR) == 0;
+    }
+
+    return false;
+}
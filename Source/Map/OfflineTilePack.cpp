@@ -0,0 +1,217 @@
+#include "Map/OfflineTilePack.hpp"
+
+#include "Core/Logger.hpp"
+#include "Map/TileDataSerializer.hpp"
+
+#include <chrono>
+
+namespace
+{
+/**
+ * @brief Reads a value from a pack file
+ * @param[in,out] ioFile Pack file
+ * @param[out] outValue Value read
+ * @return Returns true if the value was read. Returns false if the file ended.
+ */
+template <typename T>
+bool ReadValue(std::istream &ioFile, T &outValue)
+{
+    return static_cast<bool>(ioFile.read(reinterpret_cast<char*>(&outValue), sizeof(T)));
+}
+
+/**
+ * @brief Writes a value to a pack file
+ * @param[in,out] ioFile Pack file
+ * @param[in] value Value to write
+ */
+template <typename T>
+void WriteValue(std::ostream &ioFile, const T &value)
+{
+    ioFile.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}
+
+/**
+ * @brief Constructor. Reads the index of the pack; a missing or damaged pack is logged
+ * and treated as empty.
+ * @param[in] filePath Path of the pack file
+ * @param[in] next Data source behind the layer. nullptr if there is none.
+ */
+OfflineTilePack::OfflineTilePack(const std::string &filePath, std::unique_ptr<TileDataSource> next)
+    : TileCacheLayer(std::move(next), WriteBackPolicy::Never)
+    , m_filePath(filePath)
+    , m_fileMutex()
+    , m_file(filePath, std::ios::binary)
+    , m_index()
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t tileCount = 0;
+    if (!ReadValue(m_file, magic) || (magic != MAGIC) || !ReadValue(m_file, version) || (version != VERSION) || !ReadValue(m_file, tileCount))
+    {
+        LOG_ERROR("[OfflineTilePack] " << filePath << " is not a tile pack!");
+        m_file.close();
+        return;
+    }
+
+    // Damaged entries must not point past the end of the file
+    std::streampos indexStart = m_file.tellg();
+    m_file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(m_file.tellg());
+    m_file.seekg(indexStart);
+
+    for (uint32_t i = 0; i < tileCount; ++i)
+    {
+        TileKey tileKey = {};
+        IndexEntry entry = {};
+        if (!ReadValue(m_file, tileKey.zoomLevel) || !ReadValue(m_file, tileKey.index.x) || !ReadValue(m_file, tileKey.index.y)
+            || !ReadValue(m_file, entry.offset) || !ReadValue(m_file, entry.size)
+            || (entry.offset > fileSize) || (entry.size > fileSize - entry.offset))
+        {
+            LOG_ERROR("[OfflineTilePack] The index of " << filePath << " is damaged!");
+            m_index.clear();
+            m_file.close();
+            return;
+        }
+        m_index[tileKey] = entry;
+    }
+
+    LOG_INFO("[OfflineTilePack] Opened " << filePath << " with " << m_index.size() << " tiles");
+}
+
+/**
+ * @brief Destructor
+ */
+OfflineTilePack::~OfflineTilePack()
+{
+}
+
+/**
+ * @brief Queries whether the pack file was opened
+ * @return True if the index of the pack was read
+ */
+bool OfflineTilePack::IsOpen() const
+{
+    return m_file.is_open();
+}
+
+/**
+ * @brief Gets a short description of the data source, used in the statistics
+ * @return Name of the data source
+ */
+std::string OfflineTilePack::GetName() const
+{
+    return "pack " + m_filePath + " (" + std::to_string(m_index.size()) + " tiles)";
+}
+
+/**
+ * @brief Builds a pack file from tiles retrieved from a data source
+ * @param[in] filePath Path of the pack file
+ * @param[in] dataSource Data source to retrieve the tiles from
+ * @param[in] tileKeys Tiles to put in the pack
+ * @return Returns true if the pack was written. Tiles that cannot be retrieved are
+ * logged and left out. Returns false if no tile could be retrieved, or the file cannot be written.
+ */
+bool OfflineTilePack::Write(const std::string &filePath, TileDataSource &dataSource, const std::vector<TileKey> &tileKeys)
+{
+    std::vector<TileKey> packedTileKeys;
+    std::vector<std::string> encodedTiles;
+    for (const TileKey &tileKey : tileKeys)
+    {
+        TileData tileData;
+        if (!dataSource.Retrieve(tileKey.index, tileKey.zoomLevel, tileData))
+        {
+            LOG_ERROR("[OfflineTilePack] Failed to retrieve tile " << tileKey.zoomLevel << "-" << tileKey.index.x << "-" << tileKey.index.y << "!");
+            continue;
+        }
+        packedTileKeys.push_back(tileKey);
+        encodedTiles.emplace_back();
+        TileDataSerializer::Serialize(tileData, encodedTiles.back());
+    }
+
+    if (packedTileKeys.empty())
+    {
+        return false;
+    }
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    // The tiles follow the header and the index, in the same order as the index
+    const uint64_t INDEX_ENTRY_SIZE = sizeof(int32_t) * 3 + sizeof(uint64_t) * 2;
+    uint64_t offset = sizeof(uint32_t) * 3 + INDEX_ENTRY_SIZE * packedTileKeys.size();
+    WriteValue(file, MAGIC);
+    WriteValue(file, VERSION);
+    WriteValue(file, static_cast<uint32_t>(packedTileKeys.size()));
+    for (size_t i = 0; i < packedTileKeys.size(); ++i)
+    {
+        WriteValue(file, static_cast<int32_t>(packedTileKeys[i].zoomLevel));
+        WriteValue(file, static_cast<int32_t>(packedTileKeys[i].index.x));
+        WriteValue(file, static_cast<int32_t>(packedTileKeys[i].index.y));
+        WriteValue(file, offset);
+        WriteValue(file, static_cast<uint64_t>(encodedTiles[i].size()));
+        offset += encodedTiles[i].size();
+    }
+    for (const std::string &encodedTile : encodedTiles)
+    {
+        file.write(encodedTile.data(), encodedTile.size());
+    }
+
+    LOG_INFO("[OfflineTilePack] Wrote " << packedTileKeys.size() << " tiles to " << filePath);
+    return !file.fail();
+}
+
+/**
+ * @brief Queries whether the layer itself has the tile
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @return True if the layer has the tile
+ */
+bool OfflineTilePack::HasTile(const glm::ivec2 &tileIndex, const int &zoomLevel)
+{
+    return m_index.find({ tileIndex, zoomLevel }) != m_index.end();
+}
+
+/**
+ * @brief Reads and decodes a tile from the pack file
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the loaded tile data
+ * @return True if the operation was successful.
+ */
+bool OfflineTilePack::Load(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData)
+{
+    std::map<TileKey, IndexEntry>::const_iterator it = m_index.find({ tileIndex, zoomLevel });
+    if (it == m_index.end())
+    {
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point readStartTime = std::chrono::steady_clock::now();
+    std::string encodedTile(it->second.size, '\0');
+    bool success = false;
+    {
+        // Threads share the read position of the file
+        std::lock_guard lock(m_fileMutex);
+        m_file.clear();
+        success = m_file.seekg(it->second.offset) && m_file.read(&encodedTile[0], encodedTile.size());
+    }
+    success = success && TileDataSerializer::Deserialize(encodedTile, outTileData);
+    GetThreadStageTimes().seconds[static_cast<size_t>(TileStageStats::Stage::DiskRead)] += std::chrono::duration<double>(std::chrono::steady_clock::now() - readStartTime).count();
+    return success;
+}
+
+/**
+ * @brief Packs are read-only, so nothing is kept
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[in] tileData Tile data to keep
+ * @return False
+ */
+bool OfflineTilePack::Store(const glm::ivec2 &/*tileIndex*/, const int &/*zoomLevel*/, const TileData &/*tileData*/)
+{
+    return false;
+}
@@ -0,0 +1,256 @@
+#include "Map/SyntheticTileDataSource.hpp"
+
+#include "Util/GeometryUtils.hpp"
+
+#include <glm/ext/scalar_constants.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+/**
+ * @brief Constructor
+ * @param[in] settings Settings of the generated tiles
+ */
+SyntheticTileDataSource::SyntheticTileDataSource(const Settings &settings)
+    : TileDataSource()
+    , m_settings(settings)
+{
+    m_settings.verticesPerOutline = std::max(m_settings.verticesPerOutline, 3u);
+    m_settings.verticesPerWaterOutline = std::max(m_settings.verticesPerWaterOutline, 3u);
+    m_settings.concavity = glm::clamp(m_settings.concavity, 0.0, 0.95);
+    m_settings.waterAreaFraction = glm::clamp(m_settings.waterAreaFraction, 0.0, 0.95);
+}
+
+/**
+ * @brief Destructor
+ */
+SyntheticTileDataSource::~SyntheticTileDataSource()
+{
+}
+
+/**
+ * @brief Generates the tile data
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the generated tile data
+ * @return True if the operation was successful.
+ */
+bool SyntheticTileDataSource::Retrieve(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // Each tile has its own generator, so that a tile does not depend on which tiles were generated before it
+    std::seed_seq seedSequence = { m_settings.seed, static_cast<uint32_t>(tileIndex.x), static_cast<uint32_t>(tileIndex.y), static_cast<uint32_t>(zoomLevel) };
+    std::mt19937 random(seedSequence);
+
+    outTileData.index = tileIndex;
+    outTileData.zoomLevel = zoomLevel;
+    outTileData.bounds = GeometryUtils::GetLonLatBoundsFromTile(tileIndex.x, tileIndex.y, zoomLevel);
+
+    // Features are generated in meters, then converted back to lon/lat
+    glm::dvec2 tileMin = GeometryUtils::LonLatToXY(outTileData.bounds.min);
+    glm::dvec2 tileMax = GeometryUtils::LonLatToXY(outTileData.bounds.max);
+    glm::dvec2 tileSize = tileMax - tileMin;
+
+    // --- Water ---
+    if (m_settings.waterAreaFraction > 0.0)
+    {
+        // The outer vertices are pulled inwards by half the concavity on average, which the radius makes up for
+        double area = m_settings.waterAreaFraction * tileSize.x * tileSize.y;
+        double radius = glm::sqrt(area / glm::pi<double>()) / (1.0 - 0.25 * m_settings.concavity);
+        radius = glm::min(radius, 0.5 * glm::min(tileSize.x, tileSize.y));
+        glm::dvec2 center(GetRandom(random, tileMin.x + radius, tileMax.x - radius), GetRandom(random, tileMin.y + radius, tileMax.y - radius));
+
+        outTileData.waterFeatures.emplace_back();
+        GenerateOutline(random, center, radius, m_settings.verticesPerWaterOutline, m_settings.concavity, outTileData.waterFeatures.back().outline);
+    }
+
+    // --- Buildings ---
+    outTileData.buildings.reserve(outTileData.buildings.size() + m_settings.buildingsPerTile);
+    for (uint32_t i = 0; i < m_settings.buildingsPerTile; ++i)
+    {
+        double radius = GetRandom(random, MIN_BUILDING_RADIUS, MAX_BUILDING_RADIUS);
+        glm::dvec2 center(GetRandom(random, tileMin.x, tileMax.x), GetRandom(random, tileMin.y, tileMax.y));
+
+        outTileData.buildings.emplace_back();
+        BuildingData &building = outTileData.buildings.back();
+        building.heightInMeters = GetRandom(random, MIN_BUILDING_HEIGHT, MAX_BUILDING_HEIGHT);
+        building.heightFromGround = 0.0;
+        GenerateOutline(random, center, radius, m_settings.verticesPerOutline, m_settings.concavity, building.outline);
+    }
+
+    // --- Roads ---
+    // Roads alternate between crossing the tile from west to east and from south to north
+    outTileData.highways.reserve(outTileData.highways.size() + m_settings.roadsPerTile);
+    for (uint32_t i = 0; i < m_settings.roadsPerTile; ++i)
+    {
+        bool isEastWest = (i % 2 == 0);
+        double offset = GetRandom(random, 0.0, 1.0);
+
+        outTileData.highways.emplace_back();
+        HighwayData &highway = outTileData.highways.back();
+        highway.roadWidth = LANE_WIDTH * static_cast<double>(1 + static_cast<uint32_t>(GetRandom(random, 0.0, static_cast<double>(MAX_LANES))));
+        for (uint32_t j = 0; j <= ROAD_SEGMENTS; ++j)
+        {
+            double along = static_cast<double>(j) / ROAD_SEGMENTS;
+            double across = glm::clamp(offset + GetRandom(random, -ROAD_WOBBLE, ROAD_WOBBLE), 0.0, 1.0);
+            glm::dvec2 t = isEastWest ? glm::dvec2(along, across) : glm::dvec2(across, along);
+            glm::dvec2 point = tileMin + t * tileSize;
+            highway.points.push_back(GeometryUtils::XYToLonLat(point.x, point.y));
+        }
+    }
+
+    RecordHit(startTime);
+    return true;
+}
+
+/**
+ * @brief Queries whether there is a tile cache available for the specified tile index and zoom level.
+ * Every tile can be generated, so there always is.
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @return True
+ */
+bool SyntheticTileDataSource::IsTileCacheAvailable(const glm::ivec2 &/*tileIndex*/, const int &/*zoomLevel*/)
+{
+    return true;
+}
+
+/**
+ * @brief Prefetches the tile data. Tiles are generated when they are retrieved, so there is nothing to do.
+ * @param[in] tileIndex Tile index of the tile to prefetch
+ * @param[in] zoomLevel Zoom level
+ * @return True
+ */
+bool SyntheticTileDataSource::Prefetch(const glm::ivec2 &/*tileIndex*/, const int &/*zoomLevel*/)
+{
+    return true;
+}
+
+/**
+ * @brief Gets a short description of the data source, used in the statistics
+ * @return Name of the data source
+ */
+std::string SyntheticTileDataSource::GetName() const
+{
+    return "synthetic seed " + std::to_string(m_settings.seed);
+}
+
+/**
+ * @brief Gets the settings of the generated tiles
+ * @return Settings
+ */
+const SyntheticTileDataSource::Settings& SyntheticTileDataSource::GetSettings() const
+{
+    return m_settings;
+}
+
+/**
+ * @brief Gets the default settings, which generate tiles about as dense as the bundled OSM tiles
+ * @return Default settings
+ */
+SyntheticTileDataSource::Settings SyntheticTileDataSource::GetDefaultSettings()
+{
+    Settings settings = {};
+    settings.seed = 1;
+    settings.buildingsPerTile = 250;
+    settings.verticesPerOutline = 8;
+    settings.concavity = 0.3;
+    settings.roadsPerTile = 60;
+    settings.waterAreaFraction = 0.05;
+    settings.verticesPerWaterOutline = 64;
+    return settings;
+}
+
+/**
+ * @brief Applies a command line option to the settings, if it is one of the --synthetic-* options
+ * @param[in] name Name of the option
+ * @param[in] value Value of the option
+ * @param[in,out] ioSettings Settings to apply the option to
+ * @return Returns true if the option is a setting of the synthetic tiles. Returns false otherwise.
+ * Throws std::invalid_argument or std::out_of_range if the value is not a valid number.
+ */
+bool SyntheticTileDataSource::ParseOption(const char *name, const char *value, Settings &ioSettings)
+{
+    if (std::strcmp(name, "--synthetic-seed") == 0)
+    {
+        ioSettings.seed = static_cast<uint32_t>(std::stoul(value));
+    }
+    else if (std::strcmp(name, "--synthetic-buildings") == 0)
+    {
+        ioSettings.buildingsPerTile = static_cast<uint32_t>(std::stoul(value));
+    }
+    else if (std::strcmp(name, "--synthetic-outline-vertices") == 0)
+    {
+        ioSettings.verticesPerOutline = static_cast<uint32_t>(std::stoul(value));
+    }
+    else if (std::strcmp(name, "--synthetic-concavity") == 0)
+    {
+        ioSettings.concavity = std::stod(value);
+    }
+    else if (std::strcmp(name, "--synthetic-roads") == 0)
+    {
+        ioSettings.roadsPerTile = static_cast<uint32_t>(std::stoul(value));
+    }
+    else if (std::strcmp(name, "--synthetic-water") == 0)
+    {
+        ioSettings.waterAreaFraction = std::stod(value);
+    }
+    else if (std::strcmp(name, "--synthetic-water-vertices") == 0)
+    {
+        ioSettings.verticesPerWaterOutline = static_cast<uint32_t>(std::stoul(value));
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets a uniformly distributed random number. Computed from the raw output of the
+ * generator, which unlike the standard distributions is the same on every platform.
+ * @param[in,out] ioRandom Random number generator
+ * @param[in] min Smallest value
+ * @param[in] max Largest value
+ * @return Random number in [min, max)
+ */
+double SyntheticTileDataSource::GetRandom(std::mt19937 &ioRandom, double min, double max)
+{
+    double t = static_cast<double>(ioRandom()) / 4294967296.0;
+    return min + (max - min) * t;
+}
+
+/**
+ * @brief Generates a star-shaped polygon around a center. The outline never intersects
+ * itself, since its vertices are sorted by angle around the center.
+ * @param[in,out] ioRandom Random number generator
+ * @param[in] center Center of the polygon (world-space, in meters)
+ * @param[in] radius Distance from the center to the outer vertices (in meters)
+ * @param[in] vertexCount Number of vertices
+ * @param[in] concavity How deep every other vertex is pulled towards the center, in [0, 1)
+ * @param[out] outOutline Outline of the polygon (lon/lat)
+ */
+void SyntheticTileDataSource::GenerateOutline(std::mt19937 &ioRandom, const glm::dvec2 &center, double radius, uint32_t vertexCount, double concavity, std::vector<glm::dvec2> &outOutline) const
+{
+    // Each vertex is jittered within its own angular slice, so the angles stay sorted
+    double slice = 2.0 * glm::pi<double>() / vertexCount;
+    double startAngle = GetRandom(ioRandom, 0.0, slice);
+
+    outOutline.clear();
+    outOutline.reserve(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        double angle = startAngle + slice * (i + GetRandom(ioRandom, 0.1, 0.9));
+        double vertexRadius = radius;
+        if (i % 2 == 1)
+        {
+            vertexRadius *= 1.0 - concavity * GetRandom(ioRandom, 0.5, 1.0);
+        }
+
+        glm::dvec2 point = center + vertexRadius * glm::dvec2(glm::cos(angle), glm::sin(angle));
+        outOutline.push_back(GeometryUtils::XYToLonLat(point.x, point.y));
+    }
+}
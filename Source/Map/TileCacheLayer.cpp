@@ -0,0 +1,247 @@
+#include "Map/TileCacheLayer.hpp"
+
+#include "Core/Logger.hpp"
+
+#include <chrono>
+
+/**
+ * @brief Constructor
+ * @param[in] next Data source behind the layer. nullptr if there is none.
+ * @param[in] writeBackPolicy When tiles are kept in the layer
+ */
+TileCacheLayer::TileCacheLayer(std::unique_ptr<TileDataSource> next, WriteBackPolicy writeBackPolicy)
+    : TileDataSource()
+    , m_next(std::move(next))
+    , m_writeBackPolicy(writeBackPolicy)
+    , m_fillMutex()
+    , m_fillDone()
+    , m_fillingTiles()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TileCacheLayer::~TileCacheLayer()
+{
+}
+
+/**
+ * @brief Retrieves the tile data from the layer, or from the next data source if the layer does not have it
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the retrieved tile data
+ * @return True if the operation was successful.
+ */
+bool TileCacheLayer::Retrieve(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (HasTile(tileIndex, zoomLevel) && Load(tileIndex, zoomLevel, outTileData))
+    {
+        RecordHit(startTime);
+        return true;
+    }
+
+    // Another thread may have kept the tile while this one waited for it
+    TileKey tileKey = { tileIndex, zoomLevel };
+    BeginFill(tileKey);
+    if (HasTile(tileIndex, zoomLevel))
+    {
+        if (Load(tileIndex, zoomLevel, outTileData))
+        {
+            EndFill(tileKey);
+            RecordHit(startTime);
+            return true;
+        }
+
+        // A damaged entry is treated as missing, so the next data source can replace it
+        LOG_WARNING("[TileCacheLayer] Failed to load tile " << zoomLevel << "-" << tileIndex.x << "-" << tileIndex.y << " from " << GetName());
+        outTileData = TileData();
+    }
+
+    RecordMiss();
+    bool success = Fill(tileIndex, zoomLevel, &outTileData);
+    EndFill(tileKey);
+    return success;
+}
+
+/**
+ * @brief Queries whether the layer or any data source behind it has the tile without downloading it
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @return True if there is a tile cache available
+ */
+bool TileCacheLayer::IsTileCacheAvailable(const glm::ivec2 &tileIndex, const int &zoomLevel)
+{
+    return HasTile(tileIndex, zoomLevel) || ((m_next != nullptr) && m_next->IsTileCacheAvailable(tileIndex, zoomLevel));
+}
+
+/**
+ * @brief Prefetches the tile data. With the Always write-back policy, a tile the layer
+ * does not have is retrieved and kept. Otherwise the next data source prefetches it.
+ * @param[in] tileIndex Tile index of the tile to prefetch
+ * @param[in] zoomLevel Zoom level
+ * @return True if the operation was successful
+ */
+bool TileCacheLayer::Prefetch(const glm::ivec2 &tileIndex, const int &zoomLevel)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (HasTile(tileIndex, zoomLevel))
+    {
+        RecordHit(startTime);
+        return true;
+    }
+
+    if (m_writeBackPolicy == WriteBackPolicy::Always)
+    {
+        // Another thread may have kept the tile while this one waited for it
+        TileKey tileKey = { tileIndex, zoomLevel };
+        BeginFill(tileKey);
+        if (HasTile(tileIndex, zoomLevel))
+        {
+            EndFill(tileKey);
+            RecordHit(startTime);
+            return true;
+        }
+
+        RecordMiss();
+        bool success = Fill(tileIndex, zoomLevel, nullptr);
+        EndFill(tileKey);
+        return success;
+    }
+
+    RecordMiss();
+    return (m_next != nullptr) && m_next->Prefetch(tileIndex, zoomLevel);
+}
+
+/**
+ * @brief Retrieves the tile as OSM XML from the next data source
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outXmlText OSM XML of the tile
+ * @return True if the operation was successful. False if no data source has OSM XML of the tile.
+ */
+bool TileCacheLayer::RetrieveOsmXml(const glm::ivec2 &tileIndex, const int &zoomLevel, std::string &outXmlText)
+{
+    return (m_next != nullptr) && m_next->RetrieveOsmXml(tileIndex, zoomLevel, outXmlText);
+}
+
+/**
+ * @brief Gets the write-back policy of the layer
+ * @return Write-back policy
+ */
+TileCacheLayer::WriteBackPolicy TileCacheLayer::GetWriteBackPolicy() const
+{
+    return m_writeBackPolicy;
+}
+
+/**
+ * @brief Gets the name of a write-back policy, as used in the data source specification
+ * @param[in] writeBackPolicy Write-back policy
+ * @return Name of the write-back policy
+ */
+const char* TileCacheLayer::GetWriteBackPolicyName(WriteBackPolicy writeBackPolicy)
+{
+    switch (writeBackPolicy)
+    {
+    case WriteBackPolicy::Never:
+        return "never";
+    case WriteBackPolicy::OnRetrieve:
+        return "retrieve";
+    case WriteBackPolicy::Always:
+        return "always";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * @brief Prints the row of the statistics table of this layer, and of the data sources behind it
+ * @param[in] stream Stream to print to
+ */
+void TileCacheLayer::PrintStatsRows(std::ostream &stream) const
+{
+    TileDataSource::PrintStatsRows(stream);
+    if (m_next != nullptr)
+    {
+        m_next->PrintStatsRows(stream);
+    }
+}
+
+/**
+ * @brief Gets how many lookups this layer and the cache layers behind it served, and
+ * how many fell through all of them
+ * @param[out] outCacheHits Number of lookups served by a cache layer
+ * @param[out] outCacheMisses Number of lookups that no cache layer could serve
+ */
+void TileCacheLayer::GetCacheCounts(uint64_t &outCacheHits, uint64_t &outCacheMisses) const
+{
+    // The misses of the last cache layer are the lookups that fell through all of them. The data
+    // source behind it may not count every lookup it gets, e.g. prefetches it has nothing to do for.
+    uint64_t nextCacheHits = 0;
+    uint64_t nextCacheMisses = 0;
+    const TileCacheLayer *nextCacheLayer = dynamic_cast<const TileCacheLayer*>(m_next.get());
+    if (nextCacheLayer != nullptr)
+    {
+        nextCacheLayer->GetCacheCounts(nextCacheHits, nextCacheMisses);
+    }
+
+    std::lock_guard lock(m_statsMutex);
+    outCacheHits = m_hitCount + nextCacheHits;
+    outCacheMisses = (nextCacheLayer != nullptr) ? nextCacheMisses : m_missCount;
+}
+
+/**
+ * @brief Retrieves a tile the layer does not have from the next data source, and keeps it
+ * in the layer unless the write-back policy is Never.
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outTileData TileData object that will contain the retrieved tile data. nullptr when
+ * prefetching, in which case the tile only needs to be kept.
+ * @return True if the operation was successful.
+ */
+bool TileCacheLayer::Fill(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData *outTileData)
+{
+    if (m_next == nullptr)
+    {
+        return false;
+    }
+
+    TileData prefetchedTileData;
+    TileData &tileData = (outTileData != nullptr) ? *outTileData : prefetchedTileData;
+    if (!m_next->Retrieve(tileIndex, zoomLevel, tileData))
+    {
+        return false;
+    }
+
+    // Failing to keep the tile does not fail the retrieval, the tile is just retrieved again next time
+    if ((m_writeBackPolicy != WriteBackPolicy::Never) && !Store(tileIndex, zoomLevel, tileData))
+    {
+        LOG_WARNING("[TileCacheLayer] Failed to keep tile " << zoomLevel << "-" << tileIndex.x << "-" << tileIndex.y << " in " << GetName());
+    }
+    return true;
+}
+
+/**
+ * @brief Claims the filling of a tile for the calling thread. Waits while another thread fills it.
+ * @param[in] tileKey Tile to fill
+ */
+void TileCacheLayer::BeginFill(const TileKey &tileKey)
+{
+    std::unique_lock lock(m_fillMutex);
+    m_fillDone.wait(lock, [this, &tileKey]() { return m_fillingTiles.count(tileKey) == 0; });
+    m_fillingTiles.insert(tileKey);
+}
+
+/**
+ * @brief Releases the filling of a tile, and wakes the threads waiting for it
+ * @param[in] tileKey Tile that was filled
+ */
+void TileCacheLayer::EndFill(const TileKey &tileKey)
+{
+    {
+        std::lock_guard lock(m_fillMutex);
+        m_fillingTiles.erase(tileKey);
+    }
+    m_fillDone.notify_all();
+}
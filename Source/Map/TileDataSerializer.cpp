@@ -0,0 +1,196 @@
+#include "Map/TileDataSerializer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief Appends a value to the encoded bytes
+ * @param[in] value Value to append
+ * @param[in,out] ioBytes Encoded bytes
+ */
+template <typename T>
+void Write(const T &value, std::string &ioBytes)
+{
+    ioBytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief Appends a list of points to the encoded bytes, preceded by their number
+ * @param[in] points Points to append
+ * @param[in,out] ioBytes Encoded bytes
+ */
+void WritePoints(const std::vector<glm::dvec2> &points, std::string &ioBytes)
+{
+    Write(static_cast<uint32_t>(points.size()), ioBytes);
+    ioBytes.append(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(glm::dvec2));
+}
+
+// Reads values from encoded bytes, failing instead of reading past their end
+struct Reader
+{
+    const std::string &bytes;   // Encoded bytes
+    size_t offset;              // Offset of the next value to read
+
+    /**
+     * @brief Reads a value
+     * @param[out] outValue Value read
+     * @return Returns true if the value was read. Returns false if the bytes ended.
+     */
+    template <typename T>
+    bool Read(T &outValue)
+    {
+        if (bytes.size() - offset < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&outValue, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    /**
+     * @brief Reads the number of items of a list
+     * @param[in] minItemSize Smallest encoded size of an item
+     * @param[out] outCount Number of items
+     * @return Returns true if the number was read. Returns false if the bytes ended, or
+     * are too short to hold that many items.
+     */
+    bool ReadCount(size_t minItemSize, uint32_t &outCount)
+    {
+        return Read(outCount) && ((bytes.size() - offset) / minItemSize >= outCount);
+    }
+
+    /**
+     * @brief Reads a list of points preceded by their number
+     * @param[out] outPoints Points read
+     * @return Returns true if the points were read. Returns false if the bytes ended.
+     */
+    bool ReadPoints(std::vector<glm::dvec2> &outPoints)
+    {
+        uint32_t count = 0;
+        if (!ReadCount(sizeof(glm::dvec2), count))
+        {
+            return false;
+        }
+        outPoints.resize(count);
+        std::memcpy(outPoints.data(), bytes.data() + offset, count * sizeof(glm::dvec2));
+        offset += count * sizeof(glm::dvec2);
+        return true;
+    }
+};
+}
+
+/**
+ * @brief Encodes tile data
+ * @param[in] tileData Tile data to encode
+ * @param[out] outBytes Encoded tile data
+ */
+void TileDataSerializer::Serialize(const TileData &tileData, std::string &outBytes)
+{
+    outBytes.clear();
+    Write(MAGIC, outBytes);
+    Write(VERSION, outBytes);
+    Write(static_cast<int32_t>(tileData.index.x), outBytes);
+    Write(static_cast<int32_t>(tileData.index.y), outBytes);
+    Write(static_cast<int32_t>(tileData.zoomLevel), outBytes);
+    Write(tileData.bounds.min, outBytes);
+    Write(tileData.bounds.max, outBytes);
+
+    Write(static_cast<uint32_t>(tileData.buildings.size()), outBytes);
+    for (const BuildingData &building : tileData.buildings)
+    {
+        Write(building.heightInMeters, outBytes);
+        Write(building.heightFromGround, outBytes);
+        WritePoints(building.outline, outBytes);
+    }
+
+    Write(static_cast<uint32_t>(tileData.highways.size()), outBytes);
+    for (const HighwayData &highway : tileData.highways)
+    {
+        Write(highway.numLanes, outBytes);
+        Write(highway.roadWidth, outBytes);
+        WritePoints(highway.points, outBytes);
+    }
+
+    Write(static_cast<uint32_t>(tileData.waterFeatures.size()), outBytes);
+    for (const WaterFeatureData &water : tileData.waterFeatures)
+    {
+        WritePoints(water.outline, outBytes);
+    }
+}
+
+/**
+ * @brief Decodes tile data encoded by Serialize()
+ * @param[in] bytes Encoded tile data
+ * @param[out] outTileData Decoded tile data
+ * @return Returns true if the tile data was decoded. Returns false if the bytes are
+ * truncated, or were encoded by another version.
+ */
+bool TileDataSerializer::Deserialize(const std::string &bytes, TileData &outTileData)
+{
+    Reader reader = { bytes, 0 };
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!reader.Read(magic) || (magic != MAGIC) || !reader.Read(version) || (version != VERSION))
+    {
+        return false;
+    }
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t zoomLevel = 0;
+    if (!reader.Read(x) || !reader.Read(y) || !reader.Read(zoomLevel)
+        || !reader.Read(outTileData.bounds.min) || !reader.Read(outTileData.bounds.max))
+    {
+        return false;
+    }
+    outTileData.index = glm::ivec2(x, y);
+    outTileData.zoomLevel = zoomLevel;
+
+    // Counts are checked against the remaining bytes, so that damaged data cannot cause huge allocations
+    uint32_t count = 0;
+    if (!reader.ReadCount(sizeof(double) * 2 + sizeof(uint32_t), count))
+    {
+        return false;
+    }
+    outTileData.buildings.resize(count);
+    for (BuildingData &building : outTileData.buildings)
+    {
+        if (!reader.Read(building.heightInMeters) || !reader.Read(building.heightFromGround) || !reader.ReadPoints(building.outline))
+        {
+            return false;
+        }
+    }
+
+    if (!reader.ReadCount(sizeof(uint32_t) + sizeof(double) + sizeof(uint32_t), count))
+    {
+        return false;
+    }
+    outTileData.highways.resize(count);
+    for (HighwayData &highway : outTileData.highways)
+    {
+        if (!reader.Read(highway.numLanes) || !reader.Read(highway.roadWidth) || !reader.ReadPoints(highway.points))
+        {
+            return false;
+        }
+    }
+
+    if (!reader.ReadCount(sizeof(uint32_t), count))
+    {
+        return false;
+    }
+    outTileData.waterFeatures.resize(count);
+    for (WaterFeatureData &water : outTileData.waterFeatures)
+    {
+        if (!reader.ReadPoints(water.outline))
+        {
+            return false;
+        }
+    }
+
+    return reader.offset == bytes.size();
+}
@@ -0,0 +1,138 @@
+#include "Map/TileDataSource.hpp"
+
+#include <iomanip>
+
+/**
+ * @brief Constructor
+ */
+TileDataSource::TileDataSource()
+    : m_statsMutex()
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_hitLatencies()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TileDataSource::~TileDataSource()
+{
+}
+
+/**
+ * @brief Retrieves the tile as OSM XML, for caches that store the XML as it is
+ * @param[in] tileIndex Tile index
+ * @param[in] zoomLevel Zoom level
+ * @param[out] outXmlText OSM XML of the tile
+ * @return True if the operation was successful. False if the data source has no OSM XML of the tile.
+ */
+bool TileDataSource::RetrieveOsmXml(const glm::ivec2 &/*tileIndex*/, const int &/*zoomLevel*/, std::string &/*outXmlText*/)
+{
+    return false;
+}
+
+/**
+ * @brief Adds the time that the data sources spent in each tile pipeline stage on the
+ * calling thread since the last reset
+ * @param[in,out] ioStageTimes Stage times that the times of the data sources are added to
+ */
+void TileDataSource::AddStageTimes(TileStageStats::StageTimes &ioStageTimes)
+{
+    const TileStageStats::StageTimes &threadStageTimes = GetThreadStageTimes();
+    for (size_t i = 0; i < TileStageStats::NUM_STAGES; ++i)
+    {
+        ioStageTimes.seconds[i] += threadStageTimes.seconds[i];
+    }
+}
+
+/**
+ * @brief Resets the time that the data sources spent in each stage on the calling thread
+ */
+void TileDataSource::ResetStageTimes()
+{
+    GetThreadStageTimes() = TileStageStats::CreateEmptyStageTimes();
+}
+
+/**
+ * @brief Prints the hits, misses and hit latencies of the data source as a table
+ * @param[in] stream Stream to print to
+ * @param[in] title Title of the table
+ */
+void TileDataSource::PrintStats(std::ostream &stream, const std::string &title) const
+{
+    std::ios_base::fmtflags prevFlags = stream.flags();
+    std::streamsize prevPrecision = stream.precision();
+
+    stream << "[TileDataSource] " << title << " (latencies in ms):" << std::endl;
+    stream << "[TileDataSource]   " << std::left << std::setw(40) << "Layer" << std::right
+        << std::setw(8) << "Hits" << std::setw(8) << "Misses" << std::setw(10) << "Mean"
+        << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "Max" << std::endl;
+    stream << std::fixed << std::setprecision(2);
+    PrintStatsRows(stream);
+
+    stream.flags(prevFlags);
+    stream.precision(prevPrecision);
+}
+
+/**
+ * @brief Prints the row of the statistics table of this data source, and of the data sources behind it
+ * @param[in] stream Stream to print to
+ */
+void TileDataSource::PrintStatsRows(std::ostream &stream) const
+{
+    std::string name = GetName();
+    std::lock_guard lock(m_statsMutex);
+    stream << "[TileDataSource]   " << std::left << std::setw(40) << name << std::right
+        << std::setw(8) << m_hitCount
+        << std::setw(8) << m_missCount
+        << std::setw(10) << m_hitLatencies.GetMean() / 1000.0
+        << std::setw(10) << m_hitLatencies.GetValueAtPercentile(50.0) / 1000.0
+        << std::setw(10) << m_hitLatencies.GetValueAtPercentile(99.0) / 1000.0
+        << std::setw(10) << m_hitLatencies.GetMax() / 1000.0 << std::endl;
+}
+
+/**
+ * @brief Gets how many lookups the cache layers of the hierarchy served, and how many
+ * fell through them to the data source at the end. A data source that is not a cache
+ * layer counts every lookup it received as a cache miss.
+ * @param[out] outCacheHits Number of lookups served by a cache layer
+ * @param[out] outCacheMisses Number of lookups that no cache layer could serve
+ */
+void TileDataSource::GetCacheCounts(uint64_t &outCacheHits, uint64_t &outCacheMisses) const
+{
+    std::lock_guard lock(m_statsMutex);
+    outCacheHits = 0;
+    outCacheMisses = m_hitCount + m_missCount;
+}
+
+/**
+ * @brief Gets the time that the data sources spent in each stage on the calling thread.
+ * Each thread works on one tile at a time, so the times belong to its current tile.
+ * @return Stage times of the calling thread
+ */
+TileStageStats::StageTimes& TileDataSource::GetThreadStageTimes()
+{
+    static thread_local TileStageStats::StageTimes s_threadStageTimes = TileStageStats::CreateEmptyStageTimes();
+    return s_threadStageTimes;
+}
+
+/**
+ * @brief Records a retrieval served by this data source
+ * @param[in] startTime Time the retrieval started
+ */
+void TileDataSource::RecordHit(const std::chrono::steady_clock::time_point &startTime)
+{
+    std::lock_guard lock(m_statsMutex);
+    ++m_hitCount;
+    m_hitLatencies.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count()));
+}
+
+/**
+ * @brief Records a retrieval this data source could not serve by itself
+ */
+void TileDataSource::RecordMiss()
+{
+    std::lock_guard lock(m_statsMutex);
+    ++m_missCount;
+}
@@ -0,0 +1,172 @@
+#include "Map/TileDataSourceFactory.hpp"
+
+#include "Core/Logger.hpp"
+#include "Map/DiskTileCache.hpp"
+#include "Map/MemoryTileCache.hpp"
+#include "Map/OfflineTilePack.hpp"
+#include "Map/OSMTileDataSource.hpp"
+
+#include <exception>
+
+/**
+ * @brief Builds the hierarchy of data sources given by a specification
+ * @param[in] specification Specification of the hierarchy
+ * @param[in] syntheticSettings Settings of the generated tiles, used by the synthetic source
+ * @return Front layer of the hierarchy. Returns nullptr if the specification is invalid.
+ */
+std::unique_ptr<TileDataSource> TileDataSourceFactory::Create(const std::string &specification, const SyntheticTileDataSource::Settings &syntheticSettings)
+{
+    std::vector<std::string> layers = Split(specification, ',');
+
+    // The hierarchy is built from the back, since each layer owns the one behind it
+    std::unique_ptr<TileDataSource> dataSource;
+    for (size_t i = layers.size(); i > 0; --i)
+    {
+        std::vector<std::string> fields = Split(layers[i - 1], ':');
+        bool isLastLayer = (i == layers.size());
+        if (!isLastLayer && ((fields[0] == "network") || (fields[0] == "synthetic")))
+        {
+            LOG_ERROR("[TileDataSourceFactory] " << fields[0] << " can only be the last layer of " << specification << "!");
+            return nullptr;
+        }
+
+        dataSource = CreateLayer(fields, std::move(dataSource), syntheticSettings);
+        if (dataSource == nullptr)
+        {
+            LOG_ERROR("[TileDataSourceFactory] Invalid layer " << layers[i - 1] << " in " << specification << "!");
+            return nullptr;
+        }
+    }
+
+    return dataSource;
+}
+
+/**
+ * @brief Gets the specification used when none is given: the bundled OSM tiles,
+ * with downloaded tiles added next to them
+ * @return Default specification
+ */
+const char* TileDataSourceFactory::GetDefaultSpecification()
+{
+    return "disk:Resources:osm,network:overpass-api.de";
+}
+
+/**
+ * @brief Builds a single layer
+ * @param[in] fields Type and settings of the layer
+ * @param[in] next Data source behind the layer. nullptr if there is none.
+ * @param[in] syntheticSettings Settings of the generated tiles, used by the synthetic source
+ * @return Layer. Returns nullptr if the layer specification is invalid.
+ */
+std::unique_ptr<TileDataSource> TileDataSourceFactory::CreateLayer(const std::vector<std::string> &fields, std::unique_ptr<TileDataSource> next, const SyntheticTileDataSource::Settings &syntheticSettings)
+{
+    // The write-back policy can be given anywhere after the type
+    const std::string &type = fields[0];
+    std::vector<std::string> settings;
+    bool hasWriteBackPolicy = false;
+    TileCacheLayer::WriteBackPolicy writeBackPolicy = TileCacheLayer::WriteBackPolicy::Never;
+    for (size_t i = 1; i < fields.size(); ++i)
+    {
+        if (fields[i].compare(0, 6, "write=") == 0)
+        {
+            if (!ParseWriteBackPolicy(fields[i].substr(6), writeBackPolicy))
+            {
+                return nullptr;
+            }
+            hasWriteBackPolicy = true;
+        }
+        else
+        {
+            settings.push_back(fields[i]);
+        }
+    }
+
+    if ((type == "memory") && (settings.size() <= 1))
+    {
+        size_t capacity = 256;
+        try
+        {
+            capacity = settings.empty() ? capacity : std::stoul(settings[0]);
+        }
+        catch (const std::exception &)
+        {
+            return nullptr;
+        }
+        return std::make_unique<MemoryTileCache>(capacity, std::move(next), hasWriteBackPolicy ? writeBackPolicy : TileCacheLayer::WriteBackPolicy::OnRetrieve);
+    }
+    else if ((type == "disk") && (settings.size() <= 2))
+    {
+        std::string directory = (settings.size() >= 1) ? settings[0] : "Resources";
+        DiskTileCache::Format format = DiskTileCache::Format::OsmXml;
+        if ((settings.size() >= 2) && (settings[1] == "binary"))
+        {
+            format = DiskTileCache::Format::Binary;
+        }
+        else if ((settings.size() >= 2) && (settings[1] != "osm"))
+        {
+            return nullptr;
+        }
+        return std::make_unique<DiskTileCache>(directory, format, std::move(next), hasWriteBackPolicy ? writeBackPolicy : TileCacheLayer::WriteBackPolicy::Always);
+    }
+    else if ((type == "pack") && (settings.size() == 1) && !hasWriteBackPolicy)
+    {
+        std::unique_ptr<OfflineTilePack> pack = std::make_unique<OfflineTilePack>(settings[0], std::move(next));
+        if (!pack->IsOpen())
+        {
+            return nullptr;
+        }
+        return pack;
+    }
+    else if ((type == "network") && (settings.size() <= 1) && !hasWriteBackPolicy)
+    {
+        return std::make_unique<OSMTileDataSource>(settings.empty() ? "overpass-api.de" : settings[0]);
+    }
+    else if ((type == "synthetic") && settings.empty() && !hasWriteBackPolicy)
+    {
+        return std::make_unique<SyntheticTileDataSource>(syntheticSettings);
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Parses the name of a write-back policy
+ * @param[in] name Name of the policy
+ * @param[out] outWriteBackPolicy Parsed write-back policy
+ * @return Returns true if the name is a write-back policy. Returns false otherwise.
+ */
+bool TileDataSourceFactory::ParseWriteBackPolicy(const std::string &name, TileCacheLayer::WriteBackPolicy &outWriteBackPolicy)
+{
+    const TileCacheLayer::WriteBackPolicy policies[] = { TileCacheLayer::WriteBackPolicy::Never, TileCacheLayer::WriteBackPolicy::OnRetrieve, TileCacheLayer::WriteBackPolicy::Always };
+    for (TileCacheLayer::WriteBackPolicy policy : policies)
+    {
+        if (name == TileCacheLayer::GetWriteBackPolicyName(policy))
+        {
+            outWriteBackPolicy = policy;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Splits a string at a separator
+ * @param[in] text String to split
+ * @param[in] separator Separator
+ * @return Parts of the string
+ */
+std::vector<std::string> TileDataSourceFactory::Split(const std::string &text, char separator)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true)
+    {
+        size_t end = text.find(separator, start);
+        parts.push_back(text.substr(start, (end == std::string::npos) ? std::string::npos : end - start));
+        if (end == std::string::npos)
+        {
+            return parts;
+        }
+        start = end + 1;
+    }
+}
@@ -0,0 +1,469 @@
+#include "Map/TileMeshBuilder.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Profiler.hpp"
+#include "Util/GeometryUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Constructor
+ * @param[in] scale Scale from meters to world units
+ */
+TileMeshBuilder::TileMeshBuilder(double scale)
+    : m_scale(scale)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TileMeshBuilder::~TileMeshBuilder()
+{
+}
+
+/**
+ * @brief Generates the tile-local mesh of every LOD level of a tile
+ * @param[in] tileKey Tile
+ * @param[in] tileData Data of the tile
+ * @param[out] outTileMesh Generated tile mesh
+ * @param[in,out] ioStageTimes Stage times of the tile job, which the triangulation and mesh build times are added to
+ */
+void TileMeshBuilder::Build(const TileKey &tileKey, const TileData &tileData, TileMesh &outTileMesh, TileStageStats::StageTimes &ioStageTimes) const
+{
+    PROFILE_SCOPE("Build tile mesh");
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    double triangulationSeconds = 0.0;
+
+    // Vertices are relative to the tile itself, so that the mesh stays
+    // valid when the global origin moves
+    outTileMesh.tileKey = tileKey;
+    outTileMesh.origin = tileData.bounds.min;
+    outTileMesh.bounds = AABB::Empty();
+    outTileMesh.vertices.clear();
+
+    // Every LOD level of every tile is kept in the vertex buffer,
+    // and the level to draw is picked per tile each frame.
+    for (size_t lodLevel = 0; lodLevel < NUM_LOD_LEVELS; ++lodLevel)
+    {
+        outTileMesh.lodClusters[lodLevel].clear();
+        AppendTileGeometryVertices(tileData, outTileMesh.origin, lodLevel, outTileMesh.vertices, outTileMesh.lodClusters[lodLevel], triangulationSeconds);
+        for (const MeshCluster &cluster : outTileMesh.lodClusters[lodLevel])
+        {
+            outTileMesh.bounds.Expand(cluster.bounds);
+        }
+    }
+
+    // Triangulation is reported as its own stage, so the mesh build time excludes it
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    ioStageTimes.seconds[static_cast<size_t>(TileStageStats::Stage::Triangulation)] += triangulationSeconds;
+    ioStageTimes.seconds[static_cast<size_t>(TileStageStats::Stage::MeshBuild)] += buildSeconds - triangulationSeconds;
+}
+
+/**
+ * @brief Gets the maximum deviation of a LOD level from the full detail mesh
+ * @param[in] lodLevel LOD level
+ * @return Geometric error of the LOD level (in meters)
+ */
+double TileMeshBuilder::GetGeometricError(size_t lodLevel) const
+{
+    return LOD_SETTINGS[lodLevel].geometricError;
+}
+
+/**
+ * @brief Appends geometry vertices of a tile into a destination buffer
+ * @param[in] tileData Tile whose geometry vertices to append
+ * @param[in] origin Origin that the vertices are relative to (lon/lat)
+ * @param[in] lodLevel LOD level to generate the vertices for
+ * @param[in] dest Destination buffer to append the vertices to
+ * @param[out] outClusters List where the clusters making up the appended vertices will be added to
+ * @param[in,out] ioTriangulationSeconds Time spent triangulating polygons, which the triangulation time of the tile is added to
+ * @return Number of vertices appended
+ */
+uint32_t TileMeshBuilder::AppendTileGeometryVertices(const TileData &tileData, const glm::dvec2 &origin, size_t lodLevel, std::vector<Vertex> &dest, std::vector<MeshCluster> &outClusters, double &ioTriangulationSeconds) const
+{
+    uint32_t numVerticesAdded = static_cast<uint32_t>(dest.size());
+
+    glm::dvec2 tileCenter = GeometryUtils::LonLatToXY(origin);
+    const LodSettings &lodSettings = LOD_SETTINGS[lodLevel];
+
+    // Features are grouped into a grid of cells within the tile, and each
+    // non-empty cell becomes a separate cluster with its own bounding box.
+    const size_t numCells = CLUSTER_GRID_SIZE * CLUSTER_GRID_SIZE;
+    std::vector<std::vector<size_t>> cells(numCells);
+
+    // Building vertices
+    const std::vector<BuildingData> &buildings = tileData.buildings;
+    for (size_t i = 0; i < buildings.size(); i++)
+    {
+        if (!buildings[i].outline.empty())
+        {
+            cells[GetClusterCellIndex(tileData.bounds, buildings[i].outline[0])].push_back(i);
+        }
+    }
+    for (size_t i = 0; i < numCells; ++i)
+    {
+        uint32_t firstVertex = static_cast<uint32_t>(dest.size());
+        for (size_t buildingIndex : cells[i])
+        {
+            AppendBuildingVertices(buildings[buildingIndex], tileCenter, lodSettings, dest, ioTriangulationSeconds);
+        }
+        AppendMeshCluster(dest, firstVertex, outClusters);
+        cells[i].clear();
+    }
+
+    // Road vertices
+    const std::vector<HighwayData> &highways = tileData.highways;
+    for (size_t i = 0; i < highways.size(); i++)
+    {
+        if (!highways[i].points.empty())
+        {
+            cells[GetClusterCellIndex(tileData.bounds, highways[i].points[0])].push_back(i);
+        }
+    }
+    for (size_t i = 0; i < numCells; ++i)
+    {
+        uint32_t firstVertex = static_cast<uint32_t>(dest.size());
+        for (size_t highwayIndex : cells[i])
+        {
+            AppendHighwayVertices(highways[highwayIndex], tileCenter, lodSettings, dest);
+        }
+        AppendMeshCluster(dest, firstVertex, outClusters);
+        cells[i].clear();
+    }
+
+    // Water vertices
+    const std::vector<WaterFeatureData> &waters = tileData.waterFeatures;
+    for (size_t i = 0; i < waters.size(); ++i)
+    {
+        if (!waters[i].outline.empty())
+        {
+            cells[GetClusterCellIndex(tileData.bounds, waters[i].outline[0])].push_back(i);
+        }
+    }
+    for (size_t i = 0; i < numCells; ++i)
+    {
+        uint32_t firstVertex = static_cast<uint32_t>(dest.size());
+        for (size_t waterIndex : cells[i])
+        {
+            AppendWaterFeatureVertices(waters[waterIndex], tileCenter, lodSettings, dest, ioTriangulationSeconds);
+        }
+        AppendMeshCluster(dest, firstVertex, outClusters);
+        cells[i].clear();
+    }
+
+    numVerticesAdded = static_cast<uint32_t>(dest.size()) - numVerticesAdded;
+    return numVerticesAdded;
+}
+
+/**
+ * @brief Appends the geometry vertices of a building into a destination buffer
+ * @param[in] building Building whose geometry vertices to append
+ * @param[in] tileCenter Origin that the vertices are relative to (world-space)
+ * @param[in] lodSettings Settings of the LOD level to generate the vertices for
+ * @param[in] dest Destination buffer to append the vertices to
+ * @param[in,out] ioTriangulationSeconds Time spent triangulating polygons, which the triangulation time of the roof is added to
+ */
+void TileMeshBuilder::AppendBuildingVertices(const BuildingData &building, const glm::dvec2 &tileCenter, const LodSettings &lodSettings, std::vector<Vertex> &dest, double &ioTriangulationSeconds) const
+{
+    glm::vec3 sideColor(0.65f);
+    glm::vec3 topColor(0.9f);
+    glm::vec3 bottomColor(0.35f);
+
+    std::vector<glm::dvec2> pointsInTriangulation;
+
+    float buildingHeight = building.heightInMeters * m_scale;
+    float buildingYOffset = building.heightFromGround * m_scale;
+
+    std::vector<glm::dvec2> points;
+    for (size_t j = 0; j < building.outline.size(); ++j)
+    {
+        points.push_back(GeometryUtils::LonLatToXY(building.outline[j]));
+    }
+
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        glm::dvec2 &a = points[j];
+        glm::dvec2 &b = points[(j + 1) % points.size()];
+        glm::dvec2 &c = points[(j + 2) % points.size()];
+
+        if (GeometryUtils::IsCollinear(a, b, c))
+        {
+            points.erase(points.begin() + ((j + 1) % points.size()));
+            --j;
+        }
+    }
+
+    // Coarser LOD levels drop small buildings and simplify the outlines of the rest
+    if ((lodSettings.minBuildingArea > 0.0) && (GeometryUtils::PolygonArea(points) < lodSettings.minBuildingArea))
+    {
+        return;
+    }
+    if (lodSettings.useOrientedBoxes)
+    {
+        std::vector<glm::dvec2> boxCorners;
+        if (GeometryUtils::ComputeOrientedBoundingBox(points, boxCorners))
+        {
+            points = boxCorners;
+        }
+    }
+    else if (lodSettings.simplifyTolerance > 0.0)
+    {
+        std::vector<glm::dvec2> simplifiedPoints;
+        GeometryUtils::SimplifyPolygon(points, lodSettings.simplifyTolerance, simplifiedPoints);
+
+        // Keep the original outline if it collapsed during simplification
+        if (!simplifiedPoints.empty())
+        {
+            points = simplifiedPoints;
+        }
+    }
+
+    if (!GeometryUtils::IsPolygonCCW(points))
+    {
+        std::reverse(points.begin(), points.end());
+    }
+    // Double check if polygon is now indeed CCW
+    if (!GeometryUtils::IsPolygonCCW(points))
+    {
+        LOG_DEBUG("Polygon is still not CCW!");
+    }
+
+    // Top
+    std::chrono::steady_clock::time_point triangulationStartTime = std::chrono::steady_clock::now();
+    GeometryUtils::PolygonTriangulation(points, pointsInTriangulation);
+    ioTriangulationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - triangulationStartTime).count();
+    for (size_t j = 0; j < pointsInTriangulation.size(); j++)
+    {
+        glm::dvec2 point = (pointsInTriangulation[j] - tileCenter) * m_scale;
+        dest.emplace_back();
+        dest.back().position.x = point.x;
+        dest.back().position.y = buildingYOffset + buildingHeight;
+        dest.back().position.z = point.y;
+        dest.back().color = topColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+    }
+    // Bottom
+    for (size_t j = pointsInTriangulation.size(); lodSettings.includeBottomFaces && (j > 0); j--)
+    {
+        glm::dvec2 point = (pointsInTriangulation[j - 1] - tileCenter) * m_scale;
+        dest.emplace_back();
+        dest.back().position.x = point.x;
+        dest.back().position.y = buildingYOffset;
+        dest.back().position.z = point.y;
+        dest.back().color = bottomColor;
+        dest.back().normal = { 0.0f, -1.0f, 0.0f };
+    }
+
+    // Extrude
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        const glm::vec2 &p0 = (points[j] - tileCenter) * m_scale;
+        const glm::vec2 &p1 = (points[(j + 1) % points.size()] - tileCenter) * m_scale;
+
+        dest.emplace_back();
+        dest.back().position = { p0.x, buildingYOffset, p0.y };
+        dest.back().color = sideColor;
+        dest.emplace_back();
+        dest.back().position = { p1.x, buildingYOffset, p1.y };
+        dest.back().color = sideColor;
+        dest.emplace_back();
+        dest.back().position = { p1.x, buildingYOffset + buildingHeight, p1.y };
+        dest.back().color = sideColor;
+        dest.emplace_back();
+        dest.back().position = { p1.x, buildingYOffset + buildingHeight, p1.y };
+        dest.back().color = sideColor;
+        dest.emplace_back();
+        dest.back().position = { p0.x, buildingYOffset + buildingHeight, p0.y };
+        dest.back().color = sideColor;
+        dest.emplace_back();
+        dest.back().position = { p0.x, buildingYOffset, p0.y };
+        dest.back().color = sideColor;
+
+        for (size_t k = 0; k < 2; ++k)
+        {
+            size_t offset = k * 3;
+            const glm::vec3 a = dest[dest.size() - 1 - (offset + 2)].position;
+            const glm::vec3 b = dest[dest.size() - 1 - (offset + 1)].position;
+            const glm::vec3 c = dest[dest.size() - 1 - (offset + 0)].position;
+
+            glm::vec3 normal = glm::normalize(glm::cross(c - a, b - a));
+            dest[dest.size() - 1 - (offset + 2)].normal = normal;
+            dest[dest.size() - 1 - (offset + 1)].normal = normal;
+            dest[dest.size() - 1 - (offset + 0)].normal = normal;
+        }
+    }
+}
+
+/**
+ * @brief Appends the geometry vertices of a highway into a destination buffer
+ * @param[in] highway Highway whose geometry vertices to append
+ * @param[in] tileCenter Origin that the vertices are relative to (world-space)
+ * @param[in] lodSettings Settings of the LOD level to generate the vertices for
+ * @param[in] dest Destination buffer to append the vertices to
+ */
+void TileMeshBuilder::AppendHighwayVertices(const HighwayData &highway, const glm::dvec2 &tileCenter, const LodSettings &lodSettings, std::vector<Vertex> &dest) const
+{
+    const glm::vec3 roadColor(0.0f, 0.5f, 0.5f);
+
+    std::vector<glm::dvec2> points;
+    for (size_t j = 0; j < highway.points.size(); ++j)
+    {
+        points.push_back(GeometryUtils::LonLatToXY(highway.points[j]));
+    }
+    if (lodSettings.simplifyTolerance > 0.0)
+    {
+        std::vector<glm::dvec2> simplifiedPoints;
+        GeometryUtils::SimplifyLine(points, lodSettings.simplifyTolerance, simplifiedPoints);
+        points = simplifiedPoints;
+    }
+
+    double roadHeight = 0.0;
+    double width = highway.roadWidth * m_scale;
+    for (size_t j = 1; j < points.size(); j++)
+    {
+        const glm::dvec2 &a = (points[j - 1] - tileCenter) * m_scale;
+        const glm::dvec2 &b = (points[j] - tileCenter) * m_scale;
+
+        glm::dvec2 dir = b - a;
+        glm::dvec2 normal(-dir.y, dir.x);
+        normal = glm::normalize(normal);
+
+        glm::dvec2 p0 = a + normal * width / 2.0;
+        glm::dvec2 p1 = a - normal * width / 2.0;
+        glm::dvec2 p2 = b - normal * width / 2.0;
+        glm::dvec2 p3 = b + normal * width / 2.0;
+
+        dest.emplace_back();
+        dest.back().position = { p0.x, roadHeight, p0.y };
+        dest.back().color = roadColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+        dest.emplace_back();
+        dest.back().position = { p1.x, roadHeight, p1.y };
+        dest.back().color = roadColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+        dest.emplace_back();
+        dest.back().position = { p2.x, roadHeight, p2.y };
+        dest.back().color = roadColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+        dest.emplace_back();
+        dest.back().position = { p2.x, roadHeight, p2.y };
+        dest.back().color = roadColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+        dest.emplace_back();
+        dest.back().position = { p3.x, roadHeight, p3.y };
+        dest.back().color = roadColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+        dest.emplace_back();
+        dest.back().position = { p0.x, roadHeight, p0.y };
+        dest.back().color = roadColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+    }
+}
+
+/**
+ * @brief Appends the geometry vertices of a water feature into a destination buffer
+ * @param[in] water Water feature whose geometry vertices to append
+ * @param[in] tileCenter Origin that the vertices are relative to (world-space)
+ * @param[in] lodSettings Settings of the LOD level to generate the vertices for
+ * @param[in] dest Destination buffer to append the vertices to
+ * @param[in,out] ioTriangulationSeconds Time spent triangulating polygons, which the triangulation time of the water feature is added to
+ */
+void TileMeshBuilder::AppendWaterFeatureVertices(const WaterFeatureData &water, const glm::dvec2 &tileCenter, const LodSettings &lodSettings, std::vector<Vertex> &dest, double &ioTriangulationSeconds) const
+{
+    glm::vec3 waterColor { 0.8314f, 0.9451f, 0.9765f };
+
+    std::vector<glm::dvec2> pointsInTriangulation;
+
+    std::vector<glm::dvec2> points;
+    for (size_t j = 0; j < water.outline.size(); ++j)
+    {
+        points.push_back(GeometryUtils::LonLatToXY(water.outline[j]));
+    }
+
+    for (size_t j = 0; j < points.size(); j++)
+    {
+        glm::dvec2 &a = points[j];
+        glm::dvec2 &b = points[(j + 1) % points.size()];
+        glm::dvec2 &c = points[(j + 2) % points.size()];
+
+        if (GeometryUtils::IsCollinear(a, b, c))
+        {
+            points.erase(points.begin() + ((j + 1) % points.size()));
+            --j;
+        }
+    }
+
+    if (lodSettings.simplifyTolerance > 0.0)
+    {
+        std::vector<glm::dvec2> simplifiedPoints;
+        GeometryUtils::SimplifyPolygon(points, lodSettings.simplifyTolerance, simplifiedPoints);
+
+        // Keep the original outline if it collapsed during simplification
+        if (!simplifiedPoints.empty())
+        {
+            points = simplifiedPoints;
+        }
+    }
+
+    if (!GeometryUtils::IsPolygonCCW(points))
+    {
+        std::reverse(points.begin(), points.end());
+    }
+
+    std::chrono::steady_clock::time_point triangulationStartTime = std::chrono::steady_clock::now();
+    GeometryUtils::PolygonTriangulation(points, pointsInTriangulation);
+    ioTriangulationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - triangulationStartTime).count();
+
+    for (size_t j = 0; j < pointsInTriangulation.size(); j++)
+    {
+        glm::dvec2 point = (pointsInTriangulation[j] - tileCenter) * m_scale;
+        dest.emplace_back();
+        dest.back().position.x = point.x;
+        dest.back().position.y = 0.0f;
+        dest.back().position.z = point.y;
+        dest.back().color = waterColor;
+        dest.back().normal = { 0.0f, 1.0f, 0.0f };
+    }
+}
+
+/**
+ * @brief Gets the index of the clustering grid cell that contains the specified point
+ * @param[in] tileBounds Tile bounds (lon/lat)
+ * @param[in] lonLat Point (lon/lat)
+ * @return Index of the grid cell containing the point
+ */
+size_t TileMeshBuilder::GetClusterCellIndex(const RectD &tileBounds, const glm::dvec2 &lonLat) const
+{
+    glm::dvec2 size = tileBounds.max - tileBounds.min;
+    glm::dvec2 t = (lonLat - tileBounds.min) / size;
+    int cellX = glm::clamp(static_cast<int>(t.x * CLUSTER_GRID_SIZE), 0, static_cast<int>(CLUSTER_GRID_SIZE) - 1);
+    int cellY = glm::clamp(static_cast<int>(t.y * CLUSTER_GRID_SIZE), 0, static_cast<int>(CLUSTER_GRID_SIZE) - 1);
+    return static_cast<size_t>(cellY) * CLUSTER_GRID_SIZE + static_cast<size_t>(cellX);
+}
+
+/**
+ * @brief Adds a cluster for the vertices appended since firstVertex, if there are any
+ * @param[in] vertices Vertex buffer containing the cluster vertices
+ * @param[in] firstVertex Index of the first vertex of the cluster
+ * @param[out] outClusters List where the cluster will be added to
+ */
+void TileMeshBuilder::AppendMeshCluster(const std::vector<Vertex> &vertices, uint32_t firstVertex, std::vector<MeshCluster> &outClusters) const
+{
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size()) - firstVertex;
+    if (vertexCount == 0)
+    {
+        return;
+    }
+
+    MeshCluster cluster = {};
+    cluster.firstVertex = firstVertex;
+    cluster.vertexCount = vertexCount;
+    cluster.bounds = AABB::Empty();
+    for (size_t i = firstVertex; i < vertices.size(); ++i)
+    {
+        cluster.bounds.Expand(vertices[i].position);
+    }
+    outClusters.push_back(cluster);
+}
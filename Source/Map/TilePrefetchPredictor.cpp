@@ -0,0 +1,245 @@
+#include "Map/TilePrefetchPredictor.hpp"
+
+#include "Util/GeometryUtils.hpp"
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief Constructor
+ */
+TilePrefetchPredictor::TilePrefetchPredictor()
+    : m_lookaheadSeconds(3.0f)
+    , m_sampleInterval(0.25f)
+    , m_velocitySmoothing(0.9f)
+    , m_forwardBias(0.5f)
+    , m_currentTime(0.0)
+    , m_position(0.0)
+    , m_velocity(0.0)
+    , m_forward(0.0)
+    , m_lastPredictedPath()
+    , m_pendingTiles()
+    , m_stats()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TilePrefetchPredictor::~TilePrefetchPredictor()
+{
+}
+
+/**
+ * @brief Sets how far ahead the camera path is extrapolated
+ * @param[in] lookaheadSeconds Lookahead time (in seconds)
+ */
+void TilePrefetchPredictor::SetLookaheadSeconds(float lookaheadSeconds)
+{
+    m_lookaheadSeconds = glm::max(lookaheadSeconds, 0.0f);
+}
+
+/**
+ * @brief Sets the time between samples along the extrapolated path
+ * @param[in] sampleInterval Sample interval (in seconds)
+ */
+void TilePrefetchPredictor::SetSampleInterval(float sampleInterval)
+{
+    m_sampleInterval = glm::max(sampleInterval, 0.01f);
+}
+
+/**
+ * @brief Sets the weight of the previous velocity when smoothing the camera velocity
+ * @param[in] velocitySmoothing Smoothing weight in [0, 1). 0 disables smoothing.
+ */
+void TilePrefetchPredictor::SetVelocitySmoothing(float velocitySmoothing)
+{
+    m_velocitySmoothing = glm::clamp(velocitySmoothing, 0.0f, 0.99f);
+}
+
+/**
+ * @brief Sets how much the extrapolated path is bent towards the camera's forward vector
+ * @param[in] forwardBias Forward bias. 0 follows the velocity only.
+ */
+void TilePrefetchPredictor::SetForwardBias(float forwardBias)
+{
+    m_forwardBias = glm::max(forwardBias, 0.0f);
+}
+
+/**
+ * @brief Updates the camera motion used for the prediction. Called once per frame.
+ * @param[in] position Camera position (world-space, in meters)
+ * @param[in] displacement Camera displacement during the frame (world-space, in meters)
+ * @param[in] forward Camera forward vector projected onto the ground
+ * @param[in] deltaTime Frame time (in seconds)
+ */
+void TilePrefetchPredictor::Update(const glm::dvec2 &position, const glm::dvec2 &displacement, const glm::dvec2 &forward, float deltaTime)
+{
+    m_currentTime += deltaTime;
+    m_position = position;
+    m_forward = forward;
+
+    if (deltaTime > 0.0f)
+    {
+        // Exponential smoothing so that short key taps do not swing the prediction around
+        glm::dvec2 velocity = displacement / static_cast<double>(deltaTime);
+        m_velocity = m_velocity * static_cast<double>(m_velocitySmoothing) + velocity * (1.0 - m_velocitySmoothing);
+    }
+
+    // Predictions that did not become visible well after they were expected are dropped
+    for (auto it = m_pendingTiles.begin(); it != m_pendingTiles.end();)
+    {
+        if (m_currentTime - it->second > 2.0 * m_lookaheadSeconds)
+        {
+            ++m_stats.expiredTiles;
+            it = m_pendingTiles.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Forgets the camera motion, so that a camera placed somewhere else is not taken as moving there
+ */
+void TilePrefetchPredictor::ResetMotion()
+{
+    m_velocity = glm::dvec2(0.0);
+    m_lastPredictedPath.clear();
+}
+
+/**
+ * @brief Extrapolates the camera path and gets the tiles that will become visible along it.
+ * Nothing is returned if the path still crosses the same tiles as the last prediction.
+ * @param[in] tilePyramid Tile pyramid used to select the visible tiles
+ * @param[in] viewDistance View distance (in base zoom level tiles)
+ * @param[in] visibleTiles Tiles that are currently visible
+ * @param[out] outTiles Newly predicted tiles, in the order they are expected to be needed
+ * @return True if new tiles were predicted
+ */
+bool TilePrefetchPredictor::PredictTiles(const TilePyramid &tilePyramid, int viewDistance, const std::set<TileKey> &visibleTiles, std::vector<TileKey> &outTiles)
+{
+    outTiles.clear();
+
+    double speed = glm::length(m_velocity);
+    if ((speed < 0.01) || (m_lookaheadSeconds <= 0.0f))
+    {
+        m_lastPredictedPath.clear();
+        return false;
+    }
+
+    // Bend the path towards where the camera is looking, but only while moving forward
+    glm::dvec2 direction = m_velocity / speed;
+    double forwardLength = glm::length(m_forward);
+    if (forwardLength > 0.0)
+    {
+        glm::dvec2 forward = m_forward / forwardLength;
+        direction += forward * (m_forwardBias * glm::max(glm::dot(direction, forward), 0.0));
+        direction = glm::normalize(direction);
+    }
+
+    // Base zoom level tiles crossed by the extrapolated path
+    std::vector<glm::ivec2> path;
+    for (float t = m_sampleInterval; t <= m_lookaheadSeconds + 0.001f; t += m_sampleInterval)
+    {
+        glm::dvec2 position = m_position + direction * (speed * t);
+        glm::dvec2 lonLat = GeometryUtils::XYToLonLat(position.x, position.y);
+        glm::ivec2 tileIndex = GeometryUtils::LonLatToTileIndex(lonLat.x, lonLat.y, tilePyramid.GetBaseZoomLevel());
+        if (path.empty() || (path.back() != tileIndex))
+        {
+            path.push_back(tileIndex);
+        }
+    }
+
+    if (path == m_lastPredictedPath)
+    {
+        return false;
+    }
+    m_lastPredictedPath = path;
+
+    // Tiles that would be visible from each point of the path, nearest point first
+    std::vector<TileKey> tilesAtPoint;
+    for (const glm::ivec2 &tileIndex : path)
+    {
+        tilePyramid.SelectTiles(tileIndex, viewDistance, tilesAtPoint);
+        for (const TileKey &tileKey : tilesAtPoint)
+        {
+            if ((visibleTiles.find(tileKey) != visibleTiles.end()) || IsPending(tileKey))
+            {
+                continue;
+            }
+
+            m_pendingTiles[tileKey] = m_currentTime;
+            ++m_stats.predictedTiles;
+            outTiles.push_back(tileKey);
+            if (outTiles.size() >= MAX_TILES_PER_PREDICTION)
+            {
+                return true;
+            }
+        }
+    }
+
+    return !outTiles.empty();
+}
+
+/**
+ * @brief Queries whether a tile was predicted and has not become visible or expired yet
+ * @param[in] tileKey Tile to query
+ * @return True if the tile prediction is still pending
+ */
+bool TilePrefetchPredictor::IsPending(const TileKey &tileKey) const
+{
+    return m_pendingTiles.find(tileKey) != m_pendingTiles.end();
+}
+
+/**
+ * @brief Gets the tiles that were predicted and have not become visible or expired yet
+ * @param[out] outTiles Pending tiles
+ */
+void TilePrefetchPredictor::GetPendingTiles(std::vector<TileKey> &outTiles) const
+{
+    outTiles.clear();
+    for (const auto &pair : m_pendingTiles)
+    {
+        outTiles.push_back(pair.first);
+    }
+}
+
+/**
+ * @brief Records the tiles that just became visible, to measure the prediction hit rate
+ * @param[in] newlyVisibleTiles Tiles that just became visible
+ */
+void TilePrefetchPredictor::RecordNewlyVisibleTiles(const std::vector<TileKey> &newlyVisibleTiles)
+{
+    for (const TileKey &tileKey : newlyVisibleTiles)
+    {
+        auto it = m_pendingTiles.find(tileKey);
+        if (it != m_pendingTiles.end())
+        {
+            ++m_stats.hits;
+            m_pendingTiles.erase(it);
+        }
+        else
+        {
+            ++m_stats.misses;
+        }
+    }
+}
+
+/**
+ * @brief Gets the prediction statistics since the last reset
+ * @return Prediction statistics
+ */
+const TilePrefetchPredictor::Stats& TilePrefetchPredictor::GetStats() const
+{
+    return m_stats;
+}
+
+/**
+ * @brief Resets the prediction statistics
+ */
+void TilePrefetchPredictor::ResetStats()
+{
+    m_stats = {};
+}
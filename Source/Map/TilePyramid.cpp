@@ -0,0 +1,328 @@
+#include "Map/TilePyramid.hpp"
+
+#include "Core/Logger.hpp"
+#include "Util/GeometryUtils.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+#include <utility>
+
+/**
+ * @brief Constructor
+ * @param[in] baseZoomLevel Zoom level of the tiles nearest to the camera
+ * @param[in] minZoomLevel Zoom level of the coarsest tiles
+ */
+TilePyramid::TilePyramid(int baseZoomLevel, int minZoomLevel)
+    : m_baseZoomLevel(baseZoomLevel)
+    , m_minZoomLevel(glm::min(minZoomLevel, baseZoomLevel))
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TilePyramid::~TilePyramid()
+{
+}
+
+/**
+ * @brief Gets the zoom level of the tiles nearest to the camera
+ * @return Base zoom level
+ */
+int TilePyramid::GetBaseZoomLevel() const
+{
+    return m_baseZoomLevel;
+}
+
+/**
+ * @brief Gets the zoom level of the coarsest tiles
+ * @return Minimum zoom level
+ */
+int TilePyramid::GetMinZoomLevel() const
+{
+    return m_minZoomLevel;
+}
+
+/**
+ * @brief Selects the tiles that cover the area within the view distance of the camera.
+ * The selected tiles do not overlap, and are sorted from nearest to furthest.
+ * @param[in] baseTileIndex Index of the base zoom level tile containing the camera
+ * @param[in] viewDistance View distance (in base zoom level tiles)
+ * @param[out] outTiles List of selected tiles
+ */
+void TilePyramid::SelectTiles(const glm::ivec2 &baseTileIndex, int viewDistance, std::vector<TileKey> &outTiles) const
+{
+    outTiles.clear();
+
+    // Start from the coarsest tiles around the camera, and split them
+    // into finer tiles as they get closer to the camera
+    int shift = m_baseZoomLevel - m_minZoomLevel;
+    int tileSize = 1 << shift;
+    glm::ivec2 rootCameraIndex(baseTileIndex.x >> shift, baseTileIndex.y >> shift);
+    int rootRadius = (viewDistance + tileSize - 1) / tileSize;
+    int numTilesPerAxis = 1 << m_minZoomLevel;
+    for (int dy = -rootRadius; dy <= rootRadius; ++dy)
+    {
+        for (int dx = -rootRadius; dx <= rootRadius; ++dx)
+        {
+            TileKey rootKey = {};
+            rootKey.index = rootCameraIndex + glm::ivec2(dx, dy);
+            rootKey.zoomLevel = m_minZoomLevel;
+            if ((rootKey.index.x < 0) || (rootKey.index.y < 0) || (rootKey.index.x >= numTilesPerAxis) || (rootKey.index.y >= numTilesPerAxis))
+            {
+                continue;
+            }
+
+            SelectTilesRecursive(rootKey, baseTileIndex, viewDistance, outTiles);
+        }
+    }
+
+    std::sort(outTiles.begin(), outTiles.end(), [this, &baseTileIndex](const TileKey &a, const TileKey &b)
+    {
+        return GetBaseDistance(a, baseTileIndex) < GetBaseDistance(b, baseTileIndex);
+    });
+}
+
+/**
+ * @brief Gets the indices of the base zoom level tiles covered by the specified tile
+ * @param[in] tileKey Tile
+ * @param[out] outIndices List of base zoom level tile indices
+ */
+void TilePyramid::GetBaseTileIndices(const TileKey &tileKey, std::vector<glm::ivec2> &outIndices) const
+{
+    outIndices.clear();
+
+    int tileSize = 1 << (m_baseZoomLevel - tileKey.zoomLevel);
+    for (int y = 0; y < tileSize; ++y)
+    {
+        for (int x = 0; x < tileSize; ++x)
+        {
+            outIndices.push_back(tileKey.index * tileSize + glm::ivec2(x, y));
+        }
+    }
+}
+
+/**
+ * @brief Merges the data of base zoom level tiles into a single coarser tile.
+ * The merged features are simplified based on the zoom level of the coarser tile.
+ * @param[in] tileKey Coarser tile to generate
+ * @param[in] baseTiles Data of the base zoom level tiles covered by the coarser tile
+ * @param[out] outTileData Merged tile data
+ * @return Returns true if the merge was successful. Returns false otherwise.
+ */
+bool TilePyramid::MergeTiles(const TileKey &tileKey, const std::vector<TileData> &baseTiles, TileData &outTileData) const
+{
+    if (baseTiles.empty())
+    {
+        LOG_ERROR("[TilePyramid] No base tiles to merge for tile " << tileKey.zoomLevel << "-" << tileKey.index.x << "-" << tileKey.index.y);
+        return false;
+    }
+
+    SimplificationSettings settings = GetSimplificationSettings(tileKey.zoomLevel);
+
+    outTileData = {};
+    outTileData.index = tileKey.index;
+    outTileData.zoomLevel = tileKey.zoomLevel;
+    outTileData.bounds = GeometryUtils::GetLonLatBoundsFromTile(tileKey.index.x, tileKey.index.y, tileKey.zoomLevel);
+
+    // Ways crossing tile boundaries are contained in every base tile they touch,
+    // so features are identified by their first point and point count to skip duplicates.
+    std::set<std::tuple<double, double, size_t>> mergedFeatures;
+    auto isDuplicate = [&mergedFeatures](const std::vector<glm::dvec2> &points)
+    {
+        return !mergedFeatures.insert(std::make_tuple(points[0].x, points[0].y, points.size())).second;
+    };
+
+    std::vector<glm::dvec2> points, simplifiedPoints;
+
+    std::vector<std::pair<double, BuildingData>> buildings;
+    std::vector<HighwayData> highways;
+    for (const TileData &baseTile : baseTiles)
+    {
+        // Buildings
+        for (const BuildingData &building : baseTile.buildings)
+        {
+            if ((building.outline.size() < 3) || isDuplicate(building.outline))
+            {
+                continue;
+            }
+
+            points.clear();
+            for (const glm::dvec2 &lonLat : building.outline)
+            {
+                points.push_back(GeometryUtils::LonLatToXY(lonLat));
+            }
+
+            double area = GeometryUtils::PolygonArea(points);
+            if (area < settings.minFeatureArea)
+            {
+                continue;
+            }
+
+            GeometryUtils::SimplifyPolygon(points, settings.simplifyTolerance, simplifiedPoints);
+            if (simplifiedPoints.empty())
+            {
+                continue;
+            }
+
+            buildings.emplace_back(area, building);
+            buildings.back().second.outline.clear();
+            for (const glm::dvec2 &point : simplifiedPoints)
+            {
+                buildings.back().second.outline.push_back(GeometryUtils::XYToLonLat(point.x, point.y));
+            }
+        }
+
+        // Highways
+        for (const HighwayData &highway : baseTile.highways)
+        {
+            if ((highway.points.size() < 2) || (highway.roadWidth < settings.minRoadWidth) || isDuplicate(highway.points))
+            {
+                continue;
+            }
+
+            points.clear();
+            for (const glm::dvec2 &lonLat : highway.points)
+            {
+                points.push_back(GeometryUtils::LonLatToXY(lonLat));
+            }
+            GeometryUtils::SimplifyLine(points, settings.simplifyTolerance, simplifiedPoints);
+
+            highways.push_back(highway);
+            highways.back().points.clear();
+            for (const glm::dvec2 &point : simplifiedPoints)
+            {
+                highways.back().points.push_back(GeometryUtils::XYToLonLat(point.x, point.y));
+            }
+        }
+
+        // Water features
+        for (const WaterFeatureData &water : baseTile.waterFeatures)
+        {
+            if ((water.outline.size() < 3) || isDuplicate(water.outline))
+            {
+                continue;
+            }
+
+            points.clear();
+            for (const glm::dvec2 &lonLat : water.outline)
+            {
+                points.push_back(GeometryUtils::LonLatToXY(lonLat));
+            }
+            if (GeometryUtils::PolygonArea(points) < settings.minFeatureArea)
+            {
+                continue;
+            }
+
+            GeometryUtils::SimplifyPolygon(points, settings.simplifyTolerance, simplifiedPoints);
+            if (simplifiedPoints.empty())
+            {
+                continue;
+            }
+
+            outTileData.waterFeatures.emplace_back();
+            for (const glm::dvec2 &point : simplifiedPoints)
+            {
+                outTileData.waterFeatures.back().outline.push_back(GeometryUtils::XYToLonLat(point.x, point.y));
+            }
+        }
+    }
+
+    // Keep the cost of a merged tile bounded regardless of how dense the area is
+    if (buildings.size() > MAX_BUILDINGS_PER_TILE)
+    {
+        std::nth_element(buildings.begin(), buildings.begin() + MAX_BUILDINGS_PER_TILE, buildings.end(),
+            [](const std::pair<double, BuildingData> &a, const std::pair<double, BuildingData> &b)
+            {
+                return a.first > b.first;
+            });
+        buildings.resize(MAX_BUILDINGS_PER_TILE);
+    }
+    if (highways.size() > MAX_HIGHWAYS_PER_TILE)
+    {
+        std::stable_sort(highways.begin(), highways.end(), [](const HighwayData &a, const HighwayData &b)
+        {
+            return a.roadWidth > b.roadWidth;
+        });
+        highways.resize(MAX_HIGHWAYS_PER_TILE);
+    }
+
+    for (std::pair<double, BuildingData> &building : buildings)
+    {
+        outTileData.buildings.push_back(std::move(building.second));
+    }
+    outTileData.highways = std::move(highways);
+
+    return true;
+}
+
+/**
+ * @brief Gets the distance of a tile from the camera, in base zoom level tiles
+ * @param[in] tileKey Tile
+ * @param[in] baseTileIndex Index of the base zoom level tile containing the camera
+ * @return Chebyshev distance between the tile and the camera tile
+ */
+int TilePyramid::GetBaseDistance(const TileKey &tileKey, const glm::ivec2 &baseTileIndex) const
+{
+    int tileSize = 1 << (m_baseZoomLevel - tileKey.zoomLevel);
+    glm::ivec2 min = tileKey.index * tileSize;
+    glm::ivec2 max = min + glm::ivec2(tileSize - 1);
+
+    glm::ivec2 distance = glm::max(glm::max(min - baseTileIndex, baseTileIndex - max), glm::ivec2(0));
+    return glm::max(distance.x, distance.y);
+}
+
+/**
+ * @brief Adds the tile to the selection, or its children if it is close enough to the camera
+ * @param[in] tileKey Tile
+ * @param[in] baseTileIndex Index of the base zoom level tile containing the camera
+ * @param[in] viewDistance View distance (in base zoom level tiles)
+ * @param[out] outTiles List of selected tiles
+ */
+void TilePyramid::SelectTilesRecursive(const TileKey &tileKey, const glm::ivec2 &baseTileIndex, int viewDistance, std::vector<TileKey> &outTiles) const
+{
+    int distance = GetBaseDistance(tileKey, baseTileIndex);
+    if (distance > viewDistance)
+    {
+        return;
+    }
+
+    int tileSize = 1 << (m_baseZoomLevel - tileKey.zoomLevel);
+    if ((tileKey.zoomLevel >= m_baseZoomLevel) || (distance * 2 >= SPLIT_DISTANCE * tileSize))
+    {
+        outTiles.push_back(tileKey);
+        return;
+    }
+
+    for (int y = 0; y < 2; ++y)
+    {
+        for (int x = 0; x < 2; ++x)
+        {
+            TileKey childKey = {};
+            childKey.index = tileKey.index * 2 + glm::ivec2(x, y);
+            childKey.zoomLevel = tileKey.zoomLevel + 1;
+            SelectTilesRecursive(childKey, baseTileIndex, viewDistance, outTiles);
+        }
+    }
+}
+
+/**
+ * @brief Gets the settings used to simplify features merged into a tile of the specified zoom level
+ * @param[in] zoomLevel Zoom level of the merged tile
+ * @return Simplification settings
+ */
+TilePyramid::SimplificationSettings TilePyramid::GetSimplificationSettings(int zoomLevel) const
+{
+    // Each zoom level coarser covers twice the distance, so the allowed error doubles as well
+    int levelsFromBase = glm::max(m_baseZoomLevel - zoomLevel, 0);
+    double scale = static_cast<double>(1 << levelsFromBase);
+
+    SimplificationSettings settings = {};
+    settings.simplifyTolerance = 2.0 * scale;
+    settings.minFeatureArea = 25.0 * scale * scale;
+    settings.minRoadWidth = 2.0 * levelsFromBase;
+    return settings;
+}
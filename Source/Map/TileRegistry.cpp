@@ -0,0 +1,438 @@
+#include "Map/TileRegistry.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ */
+TileRegistry::TileRegistry()
+    : m_entries()
+    , m_mutex()
+    , m_coalescedRequests(0)
+    , m_residentLatencyCount(0)
+    , m_totalResidentLatency(0.0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TileRegistry::~TileRegistry()
+{
+}
+
+/**
+ * @brief Requests a tile to reach the specified state. Requesting a lower state than the
+ * current one releases the memory of the tile. The request is coalesced if work for the
+ * tile is already queued or in flight.
+ * @param[in] tileKey Tile
+ * @param[in] targetState State the tile should reach
+ * @return True if a job has to be queued for the tile
+ */
+bool TileRegistry::Request(const TileKey &tileKey, TileState targetState)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(tileKey);
+    if (it == m_entries.end())
+    {
+        TileEntry newEntry = {};
+        newEntry.state = TileState::Absent;
+        newEntry.targetState = TileState::Absent;
+        newEntry.inFlight = false;
+        newEntry.queued = false;
+        newEntry.memoryBytes = 0;
+        it = m_entries.emplace(tileKey, newEntry).first;
+    }
+
+    TileEntry &entry = it->second;
+    if ((targetState == TileState::Resident) && (entry.targetState != TileState::Resident))
+    {
+        entry.residentRequestTime = std::chrono::steady_clock::now();
+    }
+    entry.targetState = targetState;
+    ReleaseExcessData(entry);
+
+    if (!NeedsWork(entry))
+    {
+        EraseIfUnused(it);
+        return false;
+    }
+    if (entry.queued || entry.inFlight)
+    {
+        ++m_coalescedRequests;
+        return false;
+    }
+
+    entry.queued = true;
+    return true;
+}
+
+/**
+ * @brief Releases all tiles that are not in the provided set.
+ * Queued jobs of the released tiles are expected to be dropped by the caller.
+ * @param[in] requestedTiles Tiles to keep
+ */
+void TileRegistry::ReleaseUnrequested(const std::set<TileKey> &requestedTiles)
+{
+    std::lock_guard lock(m_mutex);
+
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        auto current = it++;
+        if (requestedTiles.find(current->first) != requestedTiles.end())
+        {
+            continue;
+        }
+
+        current->second.targetState = TileState::Absent;
+        current->second.queued = false;
+        ReleaseExcessData(current->second);
+        EraseIfUnused(current);
+    }
+}
+
+/**
+ * @brief Gets the current state of a tile
+ * @param[in] tileKey Tile
+ * @return Current state. Absent if the tile is not in the registry.
+ */
+TileRegistry::TileState TileRegistry::GetState(const TileKey &tileKey) const
+{
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(tileKey);
+    return (it != m_entries.end()) ? it->second.state : TileState::Absent;
+}
+
+/**
+ * @brief Marks the tile as being worked on, if there is any work left to do for it.
+ * Work stops at the Meshed state, since making a tile resident is done by the render thread.
+ * @param[in] tileKey Tile
+ * @param[out] outState State the tile was in before the work started
+ * @param[out] outTileData Decoded tile data, if the tile is Decoded
+ * @return True if there is work to do. The caller must call one of the Finish functions afterwards.
+ */
+bool TileRegistry::BeginWork(const TileKey &tileKey, TileState &outState, std::shared_ptr<const TileData> &outTileData)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(tileKey);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+
+    // Another worker already owns the tile, and will carry it on to its target state
+    TileEntry &entry = it->second;
+    entry.queued = false;
+    if (entry.inFlight || !NeedsWork(entry))
+    {
+        return false;
+    }
+
+    outState = entry.state;
+    switch (entry.state)
+    {
+    case TileState::Absent:
+        entry.state = TileState::Downloading;
+        break;
+    case TileState::Cached:
+        entry.state = TileState::Decoding;
+        break;
+    case TileState::Decoded:
+        outTileData = entry.tileData;
+        break;
+    default:
+        return false;
+    }
+
+    entry.inFlight = true;
+    return true;
+}
+
+/**
+ * @brief Finishes the download of a tile
+ * @param[in] tileKey Tile
+ * @param[in] success Flag indicating whether the tile is now in the disk cache
+ */
+void TileRegistry::FinishDownload(const TileKey &tileKey, bool success)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(tileKey);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    TileEntry &entry = it->second;
+    entry.inFlight = false;
+    if (success)
+    {
+        entry.state = TileState::Cached;
+    }
+    else
+    {
+        // Stop retrying until the tile is requested again
+        entry.state = TileState::Absent;
+        entry.targetState = TileState::Absent;
+    }
+    EraseIfUnused(it);
+}
+
+/**
+ * @brief Finishes the decoding of a tile
+ * @param[in] tileKey Tile
+ * @param[in] tileData Decoded tile data. nullptr if the decoding failed.
+ */
+void TileRegistry::FinishDecode(const TileKey &tileKey, std::shared_ptr<const TileData> tileData)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(tileKey);
+    if (it == m_entries.end())
+    {
+        return;
+    }
+
+    TileEntry &entry = it->second;
+    entry.inFlight = false;
+    if (tileData != nullptr)
+    {
+        entry.state = TileState::Decoded;
+        entry.memoryBytes = EstimateTileDataBytes(*tileData);
+        entry.tileData = std::move(tileData);
+    }
+    else
+    {
+        // Stop retrying until the tile is requested again
+        entry.state = TileState::Cached;
+        entry.targetState = std::min(entry.targetState, TileState::Cached);
+    }
+    ReleaseExcessData(entry);
+    EraseIfUnused(it);
+}
+
+/**
+ * @brief Finishes the meshing of a tile
+ * @param[in] tileKey Tile
+ * @param[in] tileMesh Tile mesh
+ * @return True if the mesh is still needed and should be published to the render thread
+ */
+bool TileRegistry::FinishMesh(const TileKey &tileKey, std::shared_ptr<const TileMesh> tileMesh)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_entries.find(tileKey);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+
+    // The decoded data is not needed anymore once the mesh exists
+    TileEntry &entry = it->second;
+    entry.inFlight = false;
+    entry.state = TileState::Meshed;
+    entry.tileData.reset();
+    entry.memoryBytes = EstimateTileMeshBytes(*tileMesh);
+    entry.tileMesh = std::move(tileMesh);
+    ReleaseExcessData(entry);
+
+    bool isNeeded = (entry.state == TileState::Meshed);
+    EraseIfUnused(it);
+    return isNeeded;
+}
+
+/**
+ * @brief Marks the meshed tiles that the render thread started drawing as Resident
+ * @param[in] tileKeys Tiles being drawn
+ * @param[out] outLatencies Time from the resident request until the tile became resident, for each tile that became resident (in seconds)
+ */
+void TileRegistry::MarkResident(const std::vector<TileKey> &tileKeys, std::vector<double> &outLatencies)
+{
+    std::lock_guard lock(m_mutex);
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (const TileKey &tileKey : tileKeys)
+    {
+        auto it = m_entries.find(tileKey);
+        if (it == m_entries.end())
+        {
+            continue;
+        }
+
+        TileEntry &entry = it->second;
+        if ((entry.targetState == TileState::Resident) && (entry.state == TileState::Meshed))
+        {
+            entry.state = TileState::Resident;
+            double latency = std::chrono::duration<double>(now - entry.residentRequestTime).count();
+            m_totalResidentLatency += latency;
+            ++m_residentLatencyCount;
+            outLatencies.push_back(latency);
+        }
+    }
+}
+
+/**
+ * @brief Gets the registry statistics. Latency statistics are accumulated since the last reset.
+ * @return Registry statistics
+ */
+TileRegistry::Stats TileRegistry::GetStats() const
+{
+    std::lock_guard lock(m_mutex);
+
+    Stats stats = {};
+    for (const auto &pair : m_entries)
+    {
+        const TileEntry &entry = pair.second;
+        ++stats.tileCountPerState[static_cast<size_t>(entry.state)];
+        if (entry.state == TileState::Decoded)
+        {
+            stats.decodedBytes += entry.memoryBytes;
+        }
+        else if (entry.state >= TileState::Meshed)
+        {
+            stats.meshBytes += entry.memoryBytes;
+        }
+    }
+    stats.coalescedRequests = m_coalescedRequests;
+    stats.residentLatencyCount = m_residentLatencyCount;
+    stats.totalResidentLatency = m_totalResidentLatency;
+    return stats;
+}
+
+/**
+ * @brief Resets the accumulated statistics
+ */
+void TileRegistry::ResetStats()
+{
+    std::lock_guard lock(m_mutex);
+
+    m_coalescedRequests = 0;
+    m_residentLatencyCount = 0;
+    m_totalResidentLatency = 0.0;
+}
+
+/**
+ * @brief Gets the name of a tile state
+ * @param[in] state Tile state
+ * @return Name of the state
+ */
+const char* TileRegistry::GetStateName(TileState state)
+{
+    switch (state)
+    {
+    case TileState::Absent:
+        return "Absent";
+    case TileState::Downloading:
+        return "Downloading";
+    case TileState::Cached:
+        return "Cached";
+    case TileState::Decoding:
+        return "Decoding";
+    case TileState::Decoded:
+        return "Decoded";
+    case TileState::Meshed:
+        return "Meshed";
+    case TileState::Resident:
+        return "Resident";
+    default:
+        return "Unknown";
+    }
+}
+
+/**
+ * @brief Drops the in-memory data of a tile that goes beyond its target state.
+ * Must be called with the registry lock held.
+ * @param[in] entry Tile entry
+ */
+void TileRegistry::ReleaseExcessData(TileEntry &entry)
+{
+    if ((entry.state == TileState::Resident) && (entry.targetState != TileState::Resident))
+    {
+        entry.state = TileState::Meshed;
+    }
+
+    // Data of a tile being worked on is released once the work finishes
+    if (entry.inFlight)
+    {
+        return;
+    }
+
+    if ((entry.targetState < TileState::Meshed) && (entry.state == TileState::Meshed))
+    {
+        entry.tileMesh.reset();
+        entry.memoryBytes = 0;
+        entry.state = TileState::Cached;
+    }
+    if ((entry.targetState < TileState::Decoded) && (entry.state == TileState::Decoded))
+    {
+        entry.tileData.reset();
+        entry.memoryBytes = 0;
+        entry.state = TileState::Cached;
+    }
+}
+
+/**
+ * @brief Queries whether a worker still has work to do for the tile.
+ * Must be called with the registry lock held.
+ * @param[in] entry Tile entry
+ * @return True if the tile has not reached min(target state, Meshed) yet
+ */
+bool TileRegistry::NeedsWork(const TileEntry &entry) const
+{
+    return entry.state < std::min(entry.targetState, TileState::Meshed);
+}
+
+/**
+ * @brief Removes the entry if it is idle and no longer requested.
+ * Must be called with the registry lock held.
+ * @param[in] it Iterator to the tile entry
+ */
+void TileRegistry::EraseIfUnused(std::map<TileKey, TileEntry>::iterator it)
+{
+    const TileEntry &entry = it->second;
+    if (!entry.inFlight && (entry.targetState == TileState::Absent) && (entry.state <= TileState::Cached))
+    {
+        m_entries.erase(it);
+    }
+}
+
+/**
+ * @brief Estimates the memory used by decoded tile data
+ * @param[in] tileData Tile data
+ * @return Approximate size (in bytes)
+ */
+size_t TileRegistry::EstimateTileDataBytes(const TileData &tileData)
+{
+    size_t bytes = sizeof(TileData);
+    for (const BuildingData &building : tileData.buildings)
+    {
+        bytes += sizeof(BuildingData) + building.outline.size() * sizeof(glm::dvec2);
+    }
+    for (const HighwayData &highway : tileData.highways)
+    {
+        bytes += sizeof(HighwayData) + highway.points.size() * sizeof(glm::dvec2);
+    }
+    for (const WaterFeatureData &water : tileData.waterFeatures)
+    {
+        bytes += sizeof(WaterFeatureData) + water.outline.size() * sizeof(glm::dvec2);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Estimates the memory used by a tile mesh
+ * @param[in] tileMesh Tile mesh
+ * @return Approximate size (in bytes)
+ */
+size_t TileRegistry::EstimateTileMeshBytes(const TileMesh &tileMesh)
+{
+    size_t bytes = sizeof(TileMesh) + tileMesh.vertices.size() * sizeof(Vertex);
+    for (const std::vector<MeshCluster> &clusters : tileMesh.lodClusters)
+    {
+        bytes += clusters.size() * sizeof(MeshCluster);
+    }
+    return bytes;
+}
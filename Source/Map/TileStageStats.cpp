@@ -0,0 +1,131 @@
+#include "Map/TileStageStats.hpp"
+
+#include <iomanip>
+
+/**
+ * @brief Constructor
+ */
+TileStageStats::TileStageStats()
+    : m_histograms()
+    , m_mutex()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TileStageStats::~TileStageStats()
+{
+}
+
+/**
+ * @brief Records the stages that a tile job went through. Skipped stages are not recorded.
+ * @param[in] stageTimes Time the job spent in each stage
+ */
+void TileStageStats::AddTile(const StageTimes &stageTimes)
+{
+    std::lock_guard lock(m_mutex);
+    for (size_t i = 0; i < NUM_STAGES; ++i)
+    {
+        if (stageTimes.seconds[i] > 0.0)
+        {
+            m_histograms[i].Record(static_cast<uint64_t>(stageTimes.seconds[i] * 1000000.0));
+        }
+    }
+}
+
+/**
+ * @brief Records the time a tile spent in a single stage
+ * @param[in] stage Stage
+ * @param[in] seconds Time spent in the stage (in seconds)
+ */
+void TileStageStats::AddStageTime(Stage stage, double seconds)
+{
+    std::lock_guard lock(m_mutex);
+    m_histograms[static_cast<size_t>(stage)].Record(static_cast<uint64_t>(seconds * 1000000.0));
+}
+
+/**
+ * @brief Removes all recorded times
+ */
+void TileStageStats::Reset()
+{
+    std::lock_guard lock(m_mutex);
+    for (LatencyHistogram &histogram : m_histograms)
+    {
+        histogram.Reset();
+    }
+}
+
+/**
+ * @brief Prints the count, percentiles and maximum of each stage as a table
+ * @param[in] stream Stream to print to
+ */
+void TileStageStats::Print(std::ostream &stream) const
+{
+    std::lock_guard lock(m_mutex);
+
+    std::ios_base::fmtflags prevFlags = stream.flags();
+    std::streamsize prevPrecision = stream.precision();
+
+    stream << "[TileStageStats] Time per tile in each stage (ms):" << std::endl;
+    stream << "[TileStageStats]   " << std::left << std::setw(16) << "Stage" << std::right
+        << std::setw(8) << "Count" << std::setw(10) << "Mean" << std::setw(10) << "p50"
+        << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "Max" << std::endl;
+    stream << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < NUM_STAGES; ++i)
+    {
+        const LatencyHistogram &histogram = m_histograms[i];
+        stream << "[TileStageStats]   " << std::left << std::setw(16) << GetStageName(static_cast<Stage>(i)) << std::right
+            << std::setw(8) << histogram.GetCount()
+            << std::setw(10) << histogram.GetMean() / 1000.0
+            << std::setw(10) << histogram.GetValueAtPercentile(50.0) / 1000.0
+            << std::setw(10) << histogram.GetValueAtPercentile(90.0) / 1000.0
+            << std::setw(10) << histogram.GetValueAtPercentile(99.0) / 1000.0
+            << std::setw(10) << histogram.GetMax() / 1000.0 << std::endl;
+    }
+
+    stream.flags(prevFlags);
+    stream.precision(prevPrecision);
+}
+
+/**
+ * @brief Creates a record of a tile job that skipped every stage
+ * @return Empty stage times
+ */
+TileStageStats::StageTimes TileStageStats::CreateEmptyStageTimes()
+{
+    StageTimes stageTimes;
+    stageTimes.seconds.fill(0.0);
+    return stageTimes;
+}
+
+/**
+ * @brief Gets the name of a stage
+ * @param[in] stage Stage
+ * @return Name of the stage
+ */
+const char* TileStageStats::GetStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::QueueWait:
+        return "Queue wait";
+    case Stage::Download:
+        return "Download";
+    case Stage::DiskRead:
+        return "Disk read";
+    case Stage::XmlParse:
+        return "XML parse";
+    case Stage::NodeJoin:
+        return "Node join";
+    case Stage::Triangulation:
+        return "Triangulation";
+    case Stage::MeshBuild:
+        return "Mesh build";
+    case Stage::Upload:
+        return "Upload";
+    default:
+        return "Unknown";
+    }
+}
@@ -0,0 +1,343 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/LatencyHistogram.hpp"
+#include "Core/Logger.hpp"
+#include "Core/RangeAllocator.hpp"
+#include "Map/MemoryTileCache.hpp"
+#include "Map/TileDataSerializer.hpp"
+#include "Map/TileDataSource.hpp"
+#include "Map/TileRegistry.hpp"
+
+// Number of checks that failed so far
+int g_failedCheckCount = 0;
+
+// Reports a failed check with its location, and carries on with the next check
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " #condition << std::endl; \
+            ++g_failedCheckCount; \
+        } \
+    } while (false)
+
+/**
+ * Data source that makes up empty tiles, and counts how many it was asked for
+ */
+class CountingTileDataSource : public TileDataSource
+{
+public:
+    uint32_t retrieveCount = 0;     // Number of retrieved tiles
+
+    /**
+     * @brief Retrieves an empty tile
+     * @param[in] tileIndex Tile index
+     * @param[in] zoomLevel Zoom level
+     * @param[out] outTileData TileData object that will contain the tile data
+     * @return True
+     */
+    bool Retrieve(const glm::ivec2 &tileIndex, const int &zoomLevel, TileData &outTileData) override
+    {
+        ++retrieveCount;
+        outTileData = TileData();
+        outTileData.index = tileIndex;
+        outTileData.zoomLevel = zoomLevel;
+        return true;
+    }
+
+    /**
+     * @brief Queries whether there is a tile cache available
+     * @return True
+     */
+    bool IsTileCacheAvailable(const glm::ivec2 &/*tileIndex*/, const int &/*zoomLevel*/) override
+    {
+        return true;
+    }
+
+    /**
+     * @brief Prefetches the tile data. Tiles are made up when they are retrieved, so there is nothing to do.
+     * @return True
+     */
+    bool Prefetch(const glm::ivec2 &/*tileIndex*/, const int &/*zoomLevel*/) override
+    {
+        return true;
+    }
+
+    /**
+     * @brief Gets a short description of the data source, used in the statistics
+     * @return Name of the data source
+     */
+    std::string GetName() const override
+    {
+        return "counting";
+    }
+};
+
+/**
+ * @brief Checks first-fit allocation, and the merging of freed ranges
+ */
+void TestRangeAllocator()
+{
+    RangeAllocator allocator(100);
+    uint32_t offsets[3] = {};
+    CHECK(allocator.Allocate(30, offsets[0]) && (offsets[0] == 0));
+    CHECK(allocator.Allocate(30, offsets[1]) && (offsets[1] == 30));
+    CHECK(allocator.Allocate(30, offsets[2]) && (offsets[2] == 60));
+    CHECK(allocator.GetAllocatedSize() == 90);
+    CHECK(allocator.GetLargestFreeRange() == 10);
+
+    uint32_t offset = 0;
+    CHECK(!allocator.Allocate(20, offset));
+
+    // The first range large enough is used, even if a later one fits better
+    allocator.Free(offsets[1], 30);
+    CHECK(allocator.GetLargestFreeRange() == 30);
+    CHECK(allocator.Allocate(10, offset) && (offset == 30));
+
+    // Freed ranges merge with the free ranges on both sides
+    allocator.Free(offsets[0], 30);
+    CHECK(allocator.GetLargestFreeRange() == 30);
+    allocator.Free(offset, 10);
+    CHECK(allocator.GetLargestFreeRange() == 60);
+    allocator.Free(offsets[2], 30);
+    CHECK(allocator.GetAllocatedSize() == 0);
+    CHECK(allocator.GetLargestFreeRange() == 100);
+
+    CHECK(allocator.Allocate(100, offset) && (offset == 0));
+    allocator.Reset();
+    CHECK(allocator.GetAllocatedSize() == 0);
+    CHECK(allocator.GetLargestFreeRange() == 100);
+}
+
+/**
+ * @brief Checks that a tile goes through every state up to Resident, and back when it is released
+ */
+void TestTileRegistry()
+{
+    TileRegistry registry;
+    TileKey tileKey = { glm::ivec2(58206, 25822), 16 };
+    TileRegistry::TileState state = TileRegistry::TileState::Absent;
+    std::shared_ptr<const TileData> tileData;
+
+    CHECK(registry.Request(tileKey, TileRegistry::TileState::Resident));
+    CHECK(!registry.Request(tileKey, TileRegistry::TileState::Resident));
+    CHECK(registry.GetStats().coalescedRequests == 1);
+
+    CHECK(registry.BeginWork(tileKey, state, tileData) && (state == TileRegistry::TileState::Absent));
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Downloading);
+    CHECK(!registry.BeginWork(tileKey, state, tileData));
+    registry.FinishDownload(tileKey, true);
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Cached);
+
+    CHECK(registry.BeginWork(tileKey, state, tileData) && (state == TileRegistry::TileState::Cached));
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Decoding);
+    std::shared_ptr<TileData> decodedTileData = std::make_shared<TileData>();
+    decodedTileData->index = tileKey.index;
+    decodedTileData->zoomLevel = tileKey.zoomLevel;
+    registry.FinishDecode(tileKey, decodedTileData);
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Decoded);
+
+    CHECK(registry.BeginWork(tileKey, state, tileData) && (state == TileRegistry::TileState::Decoded));
+    CHECK(tileData == decodedTileData);
+    std::shared_ptr<TileMesh> tileMesh = std::make_shared<TileMesh>();
+    tileMesh->tileKey = tileKey;
+    CHECK(registry.FinishMesh(tileKey, tileMesh));
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Meshed);
+
+    // Making the tile resident is up to the render thread, so there is no work left for the workers
+    CHECK(!registry.BeginWork(tileKey, state, tileData));
+    std::vector<double> latencies;
+    registry.MarkResident({ tileKey }, latencies);
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Resident);
+    CHECK((latencies.size() == 1) && (latencies[0] >= 0.0));
+    CHECK(registry.GetStats().residentLatencyCount == 1);
+
+    // Lowering the target releases the mesh, and releasing the tile forgets it
+    CHECK(!registry.Request(tileKey, TileRegistry::TileState::Cached));
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Cached);
+    registry.ReleaseUnrequested({});
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Absent);
+    CHECK(registry.GetStats().tileCountPerState[static_cast<size_t>(TileRegistry::TileState::Absent)] == 0);
+
+    // A failed download stops retrying until the tile is requested again
+    CHECK(registry.Request(tileKey, TileRegistry::TileState::Meshed));
+    CHECK(registry.BeginWork(tileKey, state, tileData) && (state == TileRegistry::TileState::Absent));
+    registry.FinishDownload(tileKey, false);
+    CHECK(!registry.BeginWork(tileKey, state, tileData));
+    CHECK(registry.Request(tileKey, TileRegistry::TileState::Meshed));
+
+    // A failed decode leaves the tile in the disk cache
+    CHECK(registry.BeginWork(tileKey, state, tileData) && (state == TileRegistry::TileState::Absent));
+    registry.FinishDownload(tileKey, true);
+    CHECK(registry.BeginWork(tileKey, state, tileData) && (state == TileRegistry::TileState::Cached));
+    registry.FinishDecode(tileKey, nullptr);
+    CHECK(registry.GetState(tileKey) == TileRegistry::TileState::Cached);
+    CHECK(!registry.BeginWork(tileKey, state, tileData));
+}
+
+/**
+ * @brief Checks that percentiles stay within the relative error of the histogram
+ */
+void TestLatencyHistogram()
+{
+    LatencyHistogram histogram;
+    CHECK(histogram.GetCount() == 0);
+    CHECK(histogram.GetValueAtPercentile(50.0) == 0);
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.Record(value);
+    }
+    CHECK(histogram.GetCount() == 1000);
+    CHECK(histogram.GetMin() == 1);
+    CHECK(histogram.GetMax() == 1000);
+    CHECK(histogram.GetMean() == 500.5);
+
+    // Small values are counted exactly, larger ones within about 3%
+    CHECK(histogram.GetValueAtPercentile(5.0) == 50);
+    uint64_t expectedValues[] = { 500, 900, 990 };
+    double percentiles[] = { 50.0, 90.0, 99.0 };
+    for (size_t i = 0; i < 3; ++i)
+    {
+        uint64_t value = histogram.GetValueAtPercentile(percentiles[i]);
+        CHECK((value >= expectedValues[i]) && (value <= expectedValues[i] * 103 / 100));
+    }
+    CHECK(histogram.GetValueAtPercentile(0.0) == 1);
+    CHECK(histogram.GetValueAtPercentile(100.0) == 1000);
+
+    histogram.Reset();
+    CHECK(histogram.GetCount() == 0);
+    histogram.Record(123456);
+    CHECK(histogram.GetValueAtPercentile(50.0) == 123456);
+}
+
+/**
+ * @brief Checks that decoding an encoded tile gives back the same tile, and that damaged bytes are rejected
+ */
+void TestTileDataSerializer()
+{
+    TileData tileData;
+    tileData.index = glm::ivec2(58206, 25822);
+    tileData.zoomLevel = 16;
+    tileData.bounds.min = glm::dvec2(139.7, 35.6);
+    tileData.bounds.max = glm::dvec2(139.8, 35.7);
+    BuildingData building;
+    building.heightInMeters = 42.5;
+    building.heightFromGround = 3.0;
+    building.outline = { glm::dvec2(139.71, 35.61), glm::dvec2(139.72, 35.61), glm::dvec2(139.72, 35.62) };
+    tileData.buildings.push_back(building);
+    tileData.buildings.push_back(BuildingData());
+    HighwayData highway;
+    highway.numLanes = 4;
+    highway.roadWidth = 12.0;
+    highway.points = { glm::dvec2(139.70, 35.60), glm::dvec2(139.80, 35.70) };
+    tileData.highways.push_back(highway);
+    WaterFeatureData water;
+    water.outline = { glm::dvec2(139.75, 35.65), glm::dvec2(139.76, 35.65), glm::dvec2(139.76, 35.66), glm::dvec2(139.75, 35.66) };
+    tileData.waterFeatures.push_back(water);
+
+    std::string bytes;
+    TileDataSerializer::Serialize(tileData, bytes);
+    TileData decodedTileData;
+    CHECK(TileDataSerializer::Deserialize(bytes, decodedTileData));
+    CHECK(decodedTileData.index == tileData.index);
+    CHECK(decodedTileData.zoomLevel == tileData.zoomLevel);
+    CHECK((decodedTileData.bounds.min == tileData.bounds.min) && (decodedTileData.bounds.max == tileData.bounds.max));
+    CHECK(decodedTileData.buildings.size() == tileData.buildings.size());
+    for (size_t i = 0; (i < decodedTileData.buildings.size()) && (i < tileData.buildings.size()); ++i)
+    {
+        CHECK(decodedTileData.buildings[i].heightInMeters == tileData.buildings[i].heightInMeters);
+        CHECK(decodedTileData.buildings[i].heightFromGround == tileData.buildings[i].heightFromGround);
+        CHECK(decodedTileData.buildings[i].outline == tileData.buildings[i].outline);
+    }
+    CHECK(decodedTileData.highways.size() == 1);
+    if (decodedTileData.highways.size() == 1)
+    {
+        CHECK(decodedTileData.highways[0].numLanes == highway.numLanes);
+        CHECK(decodedTileData.highways[0].roadWidth == highway.roadWidth);
+        CHECK(decodedTileData.highways[0].points == highway.points);
+    }
+    CHECK((decodedTileData.waterFeatures.size() == 1) && (decodedTileData.waterFeatures[0].outline == water.outline));
+
+    // Encoding the decoded tile again gives the same bytes
+    std::string decodedBytes;
+    TileDataSerializer::Serialize(decodedTileData, decodedBytes);
+    CHECK(decodedBytes == bytes);
+
+    // Truncated or extended bytes, and bytes of another version, are rejected
+    bool anyTruncationAccepted = false;
+    for (size_t size = 0; size < bytes.size(); ++size)
+    {
+        TileData truncatedTileData;
+        anyTruncationAccepted |= TileDataSerializer::Deserialize(bytes.substr(0, size), truncatedTileData);
+    }
+    CHECK(!anyTruncationAccepted);
+    CHECK(!TileDataSerializer::Deserialize(bytes + '\0', decodedTileData));
+    std::string otherVersionBytes = bytes;
+    ++otherVersionBytes[sizeof(uint32_t)];
+    CHECK(!TileDataSerializer::Deserialize(otherVersionBytes, decodedTileData));
+}
+
+/**
+ * @brief Checks that the memory cache keeps the most recently used tiles, and evicts the least recently used one
+ */
+void TestMemoryTileCache()
+{
+    std::unique_ptr<CountingTileDataSource> countingSource = std::make_unique<CountingTileDataSource>();
+    CountingTileDataSource &next = *countingSource;
+    MemoryTileCache cache(2, std::move(countingSource), TileCacheLayer::WriteBackPolicy::OnRetrieve);
+
+    const int zoomLevel = 16;
+    const glm::ivec2 tileA(1, 1);
+    const glm::ivec2 tileB(2, 1);
+    const glm::ivec2 tileC(3, 1);
+    TileData tileData;
+    CHECK(cache.Retrieve(tileA, zoomLevel, tileData) && (tileData.index == tileA));
+    CHECK(cache.Retrieve(tileB, zoomLevel, tileData) && (tileData.index == tileB));
+    CHECK(next.retrieveCount == 2);
+    CHECK(cache.GetName() == "memory 2/2 tiles");
+
+    // A is used again, so B is the least recently used tile when C comes in
+    CHECK(cache.Retrieve(tileA, zoomLevel, tileData) && (tileData.index == tileA));
+    CHECK(next.retrieveCount == 2);
+    CHECK(cache.Retrieve(tileC, zoomLevel, tileData) && (tileData.index == tileC));
+    CHECK(next.retrieveCount == 3);
+    CHECK(cache.GetName() == "memory 2/2 tiles");
+
+    CHECK(cache.Retrieve(tileA, zoomLevel, tileData) && (tileData.index == tileA));
+    CHECK(cache.Retrieve(tileC, zoomLevel, tileData) && (tileData.index == tileC));
+    CHECK(next.retrieveCount == 3);
+    CHECK(cache.Retrieve(tileB, zoomLevel, tileData) && (tileData.index == tileB));
+    CHECK(next.retrieveCount == 4);
+
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    cache.GetCacheCounts(cacheHits, cacheMisses);
+    CHECK((cacheHits == 3) && (cacheMisses == 4));
+}
+
+int main()
+{
+    Logger::Start();
+    TestRangeAllocator();
+    TestTileRegistry();
+    TestLatencyHistogram();
+    TestTileDataSerializer();
+    TestMemoryTileCache();
+    Logger::Stop();
+
+    if (g_failedCheckCount > 0)
+    {
+        std::cerr << g_failedCheckCount << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
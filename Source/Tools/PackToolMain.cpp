@@ -0,0 +1,151 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.hpp"
+#include "Map/OfflineTilePack.hpp"
+#include "Map/SyntheticTileDataSource.hpp"
+#include "Map/TileDataSourceFactory.hpp"
+#include "Map/TileKey.hpp"
+
+// Command line options of the pack tool
+struct PackToolOptions
+{
+    std::string outputFile;         // Pack file to write
+    std::string tileSources;        // Specification of the data sources the tiles are retrieved from
+    int zoomLevel;                  // Zoom level of the packed tiles
+    glm::ivec2 minTileIndex;        // Tile index of the south-west corner of the packed block
+    glm::ivec2 maxTileIndex;        // Tile index of the north-east corner of the packed block
+    SyntheticTileDataSource::Settings syntheticTileSettings;    // Settings of the generated tiles
+};
+
+/**
+ * @brief Prints the command line options.
+ * @param[in] programName Name of the executable
+ */
+void PrintUsage(const char *programName)
+{
+    std::cout << "Usage: " << programName << " --output <file> --tiles <minX>,<minY>,<maxX>,<maxY> [options]" << std::endl
+        << "  --output <file>         Pack file to write" << std::endl
+        << "  --tiles <x0>,<y0>,<x1>,<y1>  Block of tiles to pack, inclusive" << std::endl
+        << "  --zoom <level>          Zoom level of the tiles (default: 16)" << std::endl
+        << "  --sources <spec>        Data sources to retrieve the tiles from, in the same form as the viewer's" << std::endl
+        << "                          --tile-sources (default: disk:Resources:osm:write=never)" << std::endl
+        << "  --synthetic-*           Settings of the synthetic source, as in the viewer" << std::endl;
+}
+
+/**
+ * @brief Parses the command line options.
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @param[out] outOptions Parsed options
+ * @return Returns true if all options were valid. Returns false otherwise.
+ */
+bool ParsePackToolOptions(int argc, char **argv, PackToolOptions &outOptions)
+{
+    outOptions.outputFile.clear();
+    outOptions.tileSources = "disk:Resources:osm:write=never";
+    outOptions.zoomLevel = 16;
+    outOptions.minTileIndex = glm::ivec2(0);
+    outOptions.maxTileIndex = glm::ivec2(-1);
+    outOptions.syntheticTileSettings = SyntheticTileDataSource::GetDefaultSettings();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        // Every option takes a value
+        bool hasValue = (i + 1 < argc);
+        try
+        {
+            if ((std::strcmp(argv[i], "--output") == 0) && hasValue)
+            {
+                outOptions.outputFile = argv[++i];
+            }
+            else if ((std::strcmp(argv[i], "--tiles") == 0) && hasValue)
+            {
+                glm::ivec2 &minIndex = outOptions.minTileIndex;
+                glm::ivec2 &maxIndex = outOptions.maxTileIndex;
+                if (std::sscanf(argv[++i], "%d,%d,%d,%d", &minIndex.x, &minIndex.y, &maxIndex.x, &maxIndex.y) != 4)
+                {
+                    std::cerr << "Invalid value for option " << argv[i - 1] << ": " << argv[i] << std::endl;
+                    return false;
+                }
+            }
+            else if ((std::strcmp(argv[i], "--zoom") == 0) && hasValue)
+            {
+                outOptions.zoomLevel = std::stoi(argv[++i]);
+            }
+            else if ((std::strcmp(argv[i], "--sources") == 0) && hasValue)
+            {
+                outOptions.tileSources = argv[++i];
+            }
+            else if (hasValue && (std::strncmp(argv[i], "--synthetic-", 12) == 0))
+            {
+                ++i;
+                if (!SyntheticTileDataSource::ParseOption(argv[i - 1], argv[i], outOptions.syntheticTileSettings))
+                {
+                    std::cerr << "Unknown or incomplete option: " << argv[i - 1] << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Invalid value for option " << argv[i - 1] << ": " << argv[i] << std::endl;
+            return false;
+        }
+    }
+
+    if (outOptions.outputFile.empty() || glm::any(glm::greaterThan(outOptions.minTileIndex, outOptions.maxTileIndex)))
+    {
+        std::cerr << "An output file and a block of tiles are needed" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    PackToolOptions options;
+    if (!ParsePackToolOptions(argc, argv, options))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    Logger::Start();
+    std::unique_ptr<TileDataSource> dataSource = TileDataSourceFactory::Create(options.tileSources, options.syntheticTileSettings);
+    bool success = (dataSource != nullptr);
+    if (success)
+    {
+        std::vector<TileKey> tileKeys;
+        for (int y = options.minTileIndex.y; y <= options.maxTileIndex.y; ++y)
+        {
+            for (int x = options.minTileIndex.x; x <= options.maxTileIndex.x; ++x)
+            {
+                tileKeys.push_back({ glm::ivec2(x, y), options.zoomLevel });
+            }
+        }
+
+        success = OfflineTilePack::Write(options.outputFile, *dataSource, tileKeys);
+        if (!success)
+        {
+            LOG_ERROR("[MapPackTool] Failed to write " << options.outputFile << "!");
+        }
+    }
+    Logger::Stop();
+
+    if (dataSource != nullptr)
+    {
+        dataSource->PrintStats(std::cout, "Tile sources");
+    }
+
+    return success ? 0 : 1;
+}
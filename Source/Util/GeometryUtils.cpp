@@ -4,6 +4,8 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 const double EARTH_RADIUS = 6378137.0;
 
@@ -112,6 +114,218 @@ void PolygonTriangulation(const std::vector<glm::dvec2> &polygonPoints, std::vec
 	}
 }
 
+/**
+ * @brief Computes the absolute area of the provided polygon
+ * @param[in] polygonPoints Polygon points
+ * @return Area of the polygon (in the squared units of the points)
+ */
+double PolygonArea(const std::vector<glm::dvec2> &polygonPoints)
+{
+	double sum = 0.0;
+	for (size_t i = 0; i < polygonPoints.size(); i++)
+	{
+		const glm::dvec2 &p0 = polygonPoints[i];
+		const glm::dvec2 &p1 = polygonPoints[(i + 1) % polygonPoints.size()];
+
+		sum += p0.x * p1.y - p1.x * p0.y;
+	}
+
+	return glm::abs(sum) * 0.5;
+}
+
+/**
+ * @brief Computes the distance of a point from the line segment ab
+ * @param[in] point Point
+ * @param[in] a Start of the segment
+ * @param[in] b End of the segment
+ * @return Distance of the point from the segment
+ */
+static double PointSegmentDistance(const glm::dvec2 &point, const glm::dvec2 &a, const glm::dvec2 &b)
+{
+	glm::dvec2 ab = b - a;
+	double lengthSquared = glm::dot(ab, ab);
+	if (lengthSquared <= 0.0)
+	{
+		return glm::distance(point, a);
+	}
+
+	double t = glm::clamp(glm::dot(point - a, ab) / lengthSquared, 0.0, 1.0);
+	return glm::distance(point, a + ab * t);
+}
+
+/**
+ * @brief Simplifies the provided line using the Douglas-Peucker algorithm
+ * @param[in] linePoints Line points
+ * @param[in] tolerance Maximum allowed distance between the original and the simplified line
+ * @param[out] outPoints Simplified line points. The first and last points are always kept.
+ */
+void SimplifyLine(const std::vector<glm::dvec2> &linePoints, const double &tolerance, std::vector<glm::dvec2> &outPoints)
+{
+	outPoints.clear();
+
+	if (linePoints.size() < 3)
+	{
+		outPoints.assign(linePoints.begin(), linePoints.end());
+		return;
+	}
+
+	std::vector<bool> keep(linePoints.size(), false);
+	keep.front() = true;
+	keep.back() = true;
+
+	// Iterative version to avoid deep recursion on long lines
+	std::vector<std::pair<size_t, size_t>> segments;
+	segments.emplace_back(0, linePoints.size() - 1);
+	while (!segments.empty())
+	{
+		std::pair<size_t, size_t> segment = segments.back();
+		segments.pop_back();
+
+		double maxDistance = 0.0;
+		size_t maxIndex = segment.first;
+		for (size_t i = segment.first + 1; i < segment.second; ++i)
+		{
+			double distance = PointSegmentDistance(linePoints[i], linePoints[segment.first], linePoints[segment.second]);
+			if (distance > maxDistance)
+			{
+				maxDistance = distance;
+				maxIndex = i;
+			}
+		}
+
+		if (maxDistance > tolerance)
+		{
+			keep[maxIndex] = true;
+			segments.emplace_back(segment.first, maxIndex);
+			segments.emplace_back(maxIndex, segment.second);
+		}
+	}
+
+	for (size_t i = 0; i < linePoints.size(); ++i)
+	{
+		if (keep[i])
+		{
+			outPoints.push_back(linePoints[i]);
+		}
+	}
+}
+
+/**
+ * @brief Simplifies the provided closed polygon outline using the Douglas-Peucker algorithm
+ * @param[in] polygonPoints Polygon points. The outline is treated as closed.
+ * @param[in] tolerance Maximum allowed distance between the original and the simplified outline
+ * @param[out] outPoints Simplified polygon points. Empty if the polygon collapsed to less than 3 points.
+ */
+void SimplifyPolygon(const std::vector<glm::dvec2> &polygonPoints, const double &tolerance, std::vector<glm::dvec2> &outPoints)
+{
+	outPoints.clear();
+
+	if (polygonPoints.size() < 3)
+	{
+		return;
+	}
+
+	// Split the outline at the point farthest from the first point,
+	// then simplify both halves as open lines.
+	size_t farthestIndex = 0;
+	double farthestDistance = 0.0;
+	for (size_t i = 1; i < polygonPoints.size(); ++i)
+	{
+		double distance = glm::distance(polygonPoints[0], polygonPoints[i]);
+		if (distance > farthestDistance)
+		{
+			farthestDistance = distance;
+			farthestIndex = i;
+		}
+	}
+
+	if (farthestIndex == 0)
+	{
+		return;
+	}
+
+	std::vector<glm::dvec2> firstHalf(polygonPoints.begin(), polygonPoints.begin() + farthestIndex + 1);
+	std::vector<glm::dvec2> secondHalf(polygonPoints.begin() + farthestIndex, polygonPoints.end());
+	secondHalf.push_back(polygonPoints[0]);
+
+	std::vector<glm::dvec2> simplifiedFirstHalf, simplifiedSecondHalf;
+	SimplifyLine(firstHalf, tolerance, simplifiedFirstHalf);
+	SimplifyLine(secondHalf, tolerance, simplifiedSecondHalf);
+
+	// Both halves share their end points, so skip the duplicates
+	outPoints.insert(outPoints.end(), simplifiedFirstHalf.begin(), simplifiedFirstHalf.end() - 1);
+	outPoints.insert(outPoints.end(), simplifiedSecondHalf.begin(), simplifiedSecondHalf.end() - 1);
+
+	if (outPoints.size() < 3)
+	{
+		outPoints.clear();
+	}
+}
+
+/**
+ * @brief Computes the minimum-area oriented bounding box of the provided polygon.
+ * The box is aligned to one of the polygon edges.
+ * @param[in] polygonPoints Polygon points
+ * @param[out] outCorners Corners of the oriented bounding box, in counter-clockwise order
+ * @return Returns true if the box was computed. Returns false if the polygon has less than 3 points.
+ */
+bool ComputeOrientedBoundingBox(const std::vector<glm::dvec2> &polygonPoints, std::vector<glm::dvec2> &outCorners)
+{
+	outCorners.clear();
+
+	if (polygonPoints.size() < 3)
+	{
+		return false;
+	}
+
+	double bestArea = std::numeric_limits<double>::max();
+	glm::dvec2 bestAxisX(1.0, 0.0), bestAxisY(0.0, 1.0);
+	glm::dvec2 bestMin(0.0), bestMax(0.0);
+	for (size_t i = 0; i < polygonPoints.size(); ++i)
+	{
+		glm::dvec2 edge = polygonPoints[(i + 1) % polygonPoints.size()] - polygonPoints[i];
+		double edgeLength = glm::length(edge);
+		if (edgeLength <= 0.0)
+		{
+			continue;
+		}
+
+		glm::dvec2 axisX = edge / edgeLength;
+		glm::dvec2 axisY(-axisX.y, axisX.x);
+
+		glm::dvec2 min(std::numeric_limits<double>::max());
+		glm::dvec2 max(std::numeric_limits<double>::lowest());
+		for (const glm::dvec2 &point : polygonPoints)
+		{
+			glm::dvec2 projected(glm::dot(point, axisX), glm::dot(point, axisY));
+			min = glm::min(min, projected);
+			max = glm::max(max, projected);
+		}
+
+		double area = (max.x - min.x) * (max.y - min.y);
+		if (area < bestArea)
+		{
+			bestArea = area;
+			bestAxisX = axisX;
+			bestAxisY = axisY;
+			bestMin = min;
+			bestMax = max;
+		}
+	}
+
+	if (bestArea == std::numeric_limits<double>::max())
+	{
+		return false;
+	}
+
+	outCorners.push_back(bestAxisX * bestMin.x + bestAxisY * bestMin.y);
+	outCorners.push_back(bestAxisX * bestMax.x + bestAxisY * bestMin.y);
+	outCorners.push_back(bestAxisX * bestMax.x + bestAxisY * bestMax.y);
+	outCorners.push_back(bestAxisX * bestMin.x + bestAxisY * bestMax.y);
+
+	return true;
+}
+
 /**
  * @brief Converts the provided longitude-latitude coordinates to cartesian coordinates
  * @param[in] lonlat Longitude-latitude coordinates
@@ -11,12 +11,9 @@ cmake -B ./build .
 # Copy compile_commands.json from the build folder to the working directory
 cp ./build/compile_commands.json ./compile_commands.json
 
+# The shaders are compiled by the build as well
 cd build
 make
 
 cd ..
-glslangValidator -S vert -e main -o Resources/Shaders/basic_vert.spv -V Resources/Shaders/basic_vert.glsl
-glslangValidator -S frag -e main -o Resources/Shaders/basic_frag.spv -V Resources/Shaders/basic_frag.glsl
-glslangValidator -S vert -e main -o Resources/Shaders/shadow_vert.spv -V Resources/Shaders/shadow_vert.glsl
-glslangValidator -S frag -e main -o Resources/Shaders/shadow_frag.spv -V Resources/Shaders/shadow_frag.glsl
 cp -r Resources build/